@@ -26,10 +26,25 @@
  *   05-01-2023        iammingge                1. Fix function W25Qxx_ Reset timing error, resulting in invalid device restart
  *                                              2. Add W25Qxx status register to restore factory parameter function W25Qxx_ SetFactory_ WriteStatusRegister
  *                                              3. Support for multiple device mounting
+ *   10-18-2026        iammingge                1. Add erase/program start function (no wait for end) for parallel operation
+ *                                              2. Add continuous read function W25Qxx_Read_Start/Stream/Stop
+ *                                              3. Add software die select of stacked die chip (W25Q01/W25Q02)
+ *                                              4. Add error code W25Qxx_ERR_NOTFOUND/W25Qxx_ERR_FULL of storage modules
+ *                                              5. Add error code W25Qxx_ERR_CHECKSUM of integrity module
+ *                                              6. Add buffer check W25Qxx_isBlank/isProgrammable/isEqual (SIMD/word kernel),
+ *                                                 W25Qxx_Program skips the erase when the data only clears bits
+ *                                              7. Add SFDP parser W25Qxx_QuerySFDP (JESD216), W25Qxx_config takes geometry, timing
+ *                                                 and 4 Byte address instruction from SFDP
  *
 **/
 
 #include "W25Qxx.h"
+#include <string.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------------------------------
    |                                                     NOR FLASH                                                      |
@@ -54,6 +69,25 @@
 #define rbit(val, x)     (((val) & (1<<(x)))>>(x))							/* Read  1 bit */
 #define wbit(val, x, a)  (val = ((val) & ~(1<<(x))) | ((a)<<(x)))			/* Write 1 bit */
 #define noruint(val)     (val = !!(val))									/* Normalize data while keeping the logical value unchanged */
+#if W25QXX_STATS
+#define W25QXX_STAT(dev, x)          ((dev)->stats.x)							/* Update statistic */
+#define W25QXX_SPI(dev, kind, data)  ((dev)->stats.kind++, (dev)->port.spi_rw(data))	/* SPI Read and Write of Byte, counted as kind */
+#else
+#define W25QXX_STAT(dev, x)          ((void)0)
+#define W25QXX_SPI(dev, kind, data)  (dev)->port.spi_rw(data)
+#endif
+#if W25QXX_WEAR
+#define W25QXX_WEAR_ADD(dev, kind, sector, num)  W25Qxx_WearAdd(&(dev)->wear, &(dev)->wear.kind, sector, num)	/* Count erase of sector range */
+#else
+#define W25QXX_WEAR_ADD(dev, kind, sector, num)  ((void)0)
+#endif
+#if W25QXX_LATENCY
+#define W25QXX_LAT_START(dev)           W25Qxx_LatencyStart(dev)								/* Start time of operation */
+#define W25QXX_LAT_ADD(dev, cls, start) W25Qxx_LatencyAdd(&(dev)->latency.op[cls], dev, start)	/* Record time since start in class cls */
+#else
+#define W25QXX_LAT_START(dev)           0
+#define W25QXX_LAT_ADD(dev, cls, start) ((void)(cls), (void)(start))
+#endif
 static uint8_t BcdToByte(uint16_t num)										/* Calculate BCD(0 - 597) convert 1Byte(0 - 255) example : 20(0x14) ---> 0x20 */
 {
 	uint8_t d1, d2, d3;
@@ -67,6 +101,188 @@ static uint8_t BcdToByte(uint16_t num)										/* Calculate BCD(0 - 597) conver
 
 	return d1;
 }
+#if W25QXX_WEAR
+static void W25Qxx_WearAdd(W25Qxx_WEAR_t *wear, uint32_t *kind, uint32_t SectorAddr, uint32_t NumSector)	/* Add one erase to the sectors of an erase instruction */
+{
+    (*kind)++;
+    wear->numChange++;
+    if (wear->count == NULL) return;
+
+    while (NumSector-- && SectorAddr < wear->numSector)
+    {
+        wear->count[SectorAddr++]++;
+    }
+}
+#endif
+#if W25QXX_LATENCY
+static uint32_t W25Qxx_LatencyStart(W25Qxx_t *dev)										/* spi_timeus (0 : no counter) */
+{
+    return (dev->port.spi_timeus != NULL) ? dev->port.spi_timeus() : 0;
+}
+static uint32_t W25Qxx_LatencyBucket(uint32_t time)										/* Bucket of time (us) : 1 << SUBBIT buckets per power of 2 */
+{
+    uint32_t val = time;
+    uint32_t e = 0;
+
+    if (time < (1u << W25QXX_LATENCY_SUBBIT)) return time;
+
+    /* e : most significant bit of time */
+    if (val >> 16) { e += 16; val >>= 16; }
+    if (val >> 8)  { e += 8;  val >>= 8;  }
+    if (val >> 4)  { e += 4;  val >>= 4;  }
+    if (val >> 2)  { e += 2;  val >>= 2;  }
+    if (val >> 1)  { e += 1; }
+    if (e >= 29) return W25QXX_LATENCY_BUCKET - 1;
+
+    /* group of the power of 2, the SUBBIT bits below the most significant bit */
+    return ((e - W25QXX_LATENCY_SUBBIT + 1) << W25QXX_LATENCY_SUBBIT)
+         + ((time >> (e - W25QXX_LATENCY_SUBBIT)) & ((1u << W25QXX_LATENCY_SUBBIT) - 1));
+}
+static void W25Qxx_LatencyAdd(W25Qxx_LATENCY_HIST_t *hist, W25Qxx_t *dev, uint32_t start)	/* Record time since start */
+{
+    uint32_t time = 0;
+
+    if (dev->port.spi_timeus == NULL) return;
+
+    time = dev->port.spi_timeus() - start;
+    hist->bucket[W25Qxx_LatencyBucket(time)]++;
+    hist->sum += time;
+    if (time > hist->max) hist->max = time;
+    hist->num++;
+}
+#endif
+static void W25Qxx_DieAddr(W25Qxx_t *dev, uint32_t ByteAddr)					/* Select the die of byte address (stacked die chip), the status register is the one of the selected die */
+{
+    if (dev->numDie > 1 && (uint8_t)(ByteAddr / W25Qxx_DIESIZE) != dev->activeDie)
+    {
+        W25Qxx_DieSelect(dev, (uint8_t)(ByteAddr / W25Qxx_DIESIZE));
+    }
+}
+static void W25Qxx_ExtAddr(W25Qxx_t *dev, uint8_t Cmd4B, uint32_t ByteAddr)				/* Set the extended address register of a 3 Byte address instruction */
+{
+#if W25QXX_4BADDR == 0
+    /* The chip <= 16MB and the 4 Byte address instruction do not use the extended address register */
+    if (dev->sizeChip <= 0x1000000 || Cmd4B != 0x00) return;
+
+    if (ByteAddr > 0xFFFFFF)
+    {
+        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((ByteAddr) >> 24));
+    }
+    else
+    {
+        W25Qxx_WriteExtendedRegister(dev, 0x00);
+    }
+#else
+    (void)dev;
+    (void)Cmd4B;
+    (void)ByteAddr;
+#endif
+}
+static void W25Qxx_AddrCmd(W25Qxx_t *dev, uint8_t Cmd, uint8_t Cmd4B, uint32_t ByteAddr)	/* Send instruction and address (Cmd4B : 4 Byte address instruction, 0x00 : none) */
+{
+#if W25QXX_4BADDR
+    (void)Cmd4B;
+    W25QXX_SPI(dev, byteCmd, Cmd);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 24));
+#else
+    if (Cmd4B != 0x00)
+    {
+        W25QXX_SPI(dev, byteCmd, Cmd4B);
+        W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 24));
+    }
+    else
+    {
+        W25QXX_SPI(dev, byteCmd, Cmd);
+    }
+#endif
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
+}
+#if W25QXX_SUPPORT_SFDP
+#define W25QXX_CMD4B(cmd)  (cmd)																/* 4 Byte address instruction found by SFDP */
+static uint8_t W25Qxx_SFDP_Erase4B(W25Qxx_t *dev, uint32_t Size)							/* 4 Byte address instruction of erase size (0x00 : none) */
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        if (dev->sfdp.erase[i].size == Size) return dev->sfdp.erase[i].cmd4B;
+    }
+
+    return 0x00;
+}
+#else
+#define W25QXX_CMD4B(cmd)  0x00
+#endif
+static uint32_t W25Qxx_TypTime(W25Qxx_t *dev, W25Qxx_OP Op)								/* Calibrated typical time of operation (us, 0 : not calibrated) */
+{
+    switch (Op)
+    {
+        case W25Qxx_OP_PROGRAM_PAGE:  return dev->timing.ProgrTimePage;
+        case W25Qxx_OP_ERASE_SECTOR:  return dev->timing.EraseTimeSector;
+        case W25Qxx_OP_ERASE_BLOCK32: return dev->timing.EraseTimeBlock32;
+        case W25Qxx_OP_ERASE_BLOCK64: return dev->timing.EraseTimeBlock64;
+        default:                      return 0;
+    }
+}
+static void W25Qxx_Hold(W25Qxx_t *dev, uint32_t start, uint32_t until)					/* Wait until the time since start reaches until (us), whole ms by spi_delayms */
+{
+    uint32_t now = dev->port.spi_timeus() - start;
+
+    if (now >= until) return;
+    if (until - now >= 1000) dev->port.spi_delayms((until - now) / 1000);
+
+    while ((uint32_t)(dev->port.spi_timeus() - start) < until);
+}
+#if W25QXX_AUTO_POWER
+static uint32_t W25Qxx_Power_Now(W25Qxx_t *dev)											/* spi_timeus (0 : no counter) */
+{
+    return (dev->port.spi_timeus != NULL) ? dev->port.spi_timeus() : 0;
+}
+static void W25Qxx_Power_Time(W25Qxx_t *dev, uint32_t now)								/* Add the time since the last update to the current power state */
+{
+    if (dev->power.state == W25Qxx_POWER_DOWN) dev->power.timeDown += now - dev->power.lastChange;
+    else dev->power.timeStandby += now - dev->power.lastChange;
+
+    dev->power.lastChange = now;
+}
+static void W25Qxx_Power_Wake(W25Qxx_t *dev)												/* Release from deep power-down and wait tRES1 */
+{
+    uint32_t start = 0;
+
+    /* tDP since the power-down (+1 : resolution of the counter) */
+    if (dev->port.spi_timeus != NULL) W25Qxx_Hold(dev, dev->power.lastChange, W25QXX_POWER_TDP + 1);
+
+    start = W25Qxx_Power_Now(dev);
+    W25Qxx_Power_Time(dev, start);
+
+    /* CS enable */
+    dev->port.spi_cs_L();
+
+    /* release power-down */
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_POWEREN);
+
+    /* CS disable */
+    dev->port.spi_cs_H();
+
+    /* tRES1 (+1 : resolution of the counter) */
+    if (dev->port.spi_timeus != NULL) W25Qxx_Hold(dev, dev->port.spi_timeus(), W25QXX_POWER_TRES1 + 1);
+    else dev->port.spi_delayms(1);
+
+    dev->power.state = W25Qxx_POWER_STANDBY;
+    dev->power.numWake++;
+    dev->power.timeWake += W25Qxx_Power_Now(dev) - start;
+}
+static void W25Qxx_Power_Access(W25Qxx_t *dev)											/* Release on access, time of the last command */
+{
+    if (dev->power.state == W25Qxx_POWER_DOWN) W25Qxx_Power_Wake(dev);
+    if (dev->power.idleTime != 0) dev->power.lastAccess = dev->port.spi_timeus();
+}
+#define W25QXX_CS_L(dev)  do { W25Qxx_Power_Access(dev); (dev)->port.spi_cs_L(); } while (0)	/* CS enable, the chip is released first */
+#else
+#define W25QXX_CS_L(dev)  (dev)->port.spi_cs_L()
+#endif
 /* W25Qxx Cache */
 static uint8_t W25QXX_CACHE[W25Qxx_SECTORSIZE];
 /* W25Qxx Info List */
@@ -97,18 +313,18 @@ uint16_t W25Qxx_ID_Manufacturer(W25Qxx_t *dev)																						/* Read Manu
     uint16_t IDByte = 0;
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set power enable */
-    dev->port.spi_rw(W25Q_CMD_MANUFACTURER);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_MANUFACTURER);
 
     /* read ID */
-    dev->port.spi_rw(W25Q_DUMMY);
-    dev->port.spi_rw(W25Q_DUMMY);
-    dev->port.spi_rw(0x00);
+    W25QXX_SPI(dev, byteAddr, W25Q_DUMMY);
+    W25QXX_SPI(dev, byteAddr, W25Q_DUMMY);
+    W25QXX_SPI(dev, byteAddr, 0x00);
     do
     {
-        IDByte = dev->port.spi_rw(W25Q_DUMMY);
+        IDByte = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY);
         ID |= IDByte << (i * 8);
     } while (i--);
 
@@ -127,13 +343,13 @@ uint32_t W25Qxx_ID_JEDEC(W25Qxx_t *dev)																					 			/* Read JEDEC  I
     uint32_t IDByte = 0;
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read JEDEC ID */
-    dev->port.spi_rw(W25Q_CMD_JEDECID);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_JEDECID);
     do
     {
-        IDByte = dev->port.spi_rw(W25Q_DUMMY);
+        IDByte = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY);
         ID |= IDByte << (i * 8);
     } while (i--);
 
@@ -149,20 +365,20 @@ uint64_t W25Qxx_ID_Unique(W25Qxx_t *dev)																							/* Read Unique ID
     uint64_t IDByte = 0;
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read Unique ID */
-    dev->port.spi_rw(W25Q_CMD_UNIQUEID);
-    dev->port.spi_rw(W25Q_DUMMY);
-    dev->port.spi_rw(W25Q_DUMMY);
-    dev->port.spi_rw(W25Q_DUMMY);
-    dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_UNIQUEID);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
 #if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
 #endif
     do
     {
-        IDByte = dev->port.spi_rw(W25Q_DUMMY);
+        IDByte = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY);
         ID |= IDByte << (i * 8);
     } while (i--);
 
@@ -175,25 +391,28 @@ uint64_t W25Qxx_ID_Unique(W25Qxx_t *dev)																							/* Read Unique ID
 void W25Qxx_Reset(W25Qxx_t *dev)																									/* Software reset */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set reset enable */
-    dev->port.spi_rw(W25Q_CMD_ENRESET);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ENRESET);
 
     /* CS disable */
     dev->port.spi_cs_H();
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* reset device */
-    dev->port.spi_rw(W25Q_CMD_RESETDEV);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_RESETDEV);
 
     /* CS disable */
     dev->port.spi_cs_H();
 
     /* tRST (30us) */
     dev->port.spi_delayms(1);
+
+    /* die 0 is selected after reset */
+    dev->activeDie = 0;
 }
 void W25Qxx_PowerEnable(W25Qxx_t *dev)   																							/* Power Enable */
 {
@@ -201,13 +420,18 @@ void W25Qxx_PowerEnable(W25Qxx_t *dev)   																							/* Power Enable
     dev->port.spi_cs_L();
 
     /* set power enable */
-    dev->port.spi_rw(W25Q_CMD_POWEREN);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_POWEREN);
 
     /* CS disable */
     dev->port.spi_cs_H();
 
     /* tRES1 max = 3us */
     dev->port.spi_delayms(1);
+
+#if W25QXX_AUTO_POWER
+    W25Qxx_Power_Time(dev, W25Qxx_Power_Now(dev));
+    dev->power.state = W25Qxx_POWER_STANDBY;
+#endif
 }
 void W25Qxx_PowerDisable(W25Qxx_t *dev)  																							/* Power Disable */
 {
@@ -215,13 +439,18 @@ void W25Qxx_PowerDisable(W25Qxx_t *dev)  																							/* Power Disable
     dev->port.spi_cs_L();
 
     /* set power disable */
-    dev->port.spi_rw(W25Q_CMD_POWERDEN);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_POWERDEN);
 
     /* CS disable */
     dev->port.spi_cs_H();
 
     /* tDP max = 3us */
     dev->port.spi_delayms(1);
+
+#if W25QXX_AUTO_POWER
+    W25Qxx_Power_Time(dev, W25Qxx_Power_Now(dev));
+    dev->power.state = W25Qxx_POWER_DOWN;
+#endif
 }
 void W25Qxx_VolatileSR_WriteEnable(W25Qxx_t *dev)																					/* Write Enable for Volatile Status Register */
 {
@@ -230,10 +459,10 @@ void W25Qxx_VolatileSR_WriteEnable(W25Qxx_t *dev)																					/* Write E
     **/
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* Determine if volatile SR is enable */
-    dev->port.spi_rw(W25Q_CMD_VOLATILESREN);
+    W25QXX_SPI(dev, byteWrite, W25Q_CMD_VOLATILESREN);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -241,10 +470,10 @@ void W25Qxx_VolatileSR_WriteEnable(W25Qxx_t *dev)																					/* Write E
 void W25Qxx_WriteEnable(W25Qxx_t *dev)   																							/* Write Enable */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set write enable */
-    dev->port.spi_rw(W25Q_CMD_WEN);
+    W25QXX_SPI(dev, byteWrite, W25Q_CMD_WEN);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -255,10 +484,10 @@ void W25Qxx_WriteEnable(W25Qxx_t *dev)   																							/* Write Enable
 void W25Qxx_WriteDisable(W25Qxx_t *dev)   																						    /* Write Disable */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set write disable */
-    dev->port.spi_rw(W25Q_CMD_WDEN);
+    W25QXX_SPI(dev, byteWrite, W25Q_CMD_WDEN);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -269,10 +498,10 @@ void W25Qxx_WriteDisable(W25Qxx_t *dev)   																						    /* Write Dis
 void W25Qxx_4ByteMode(W25Qxx_t *dev)																								/* Set 4 bytes address mode */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set 4 byte address mode */
-    dev->port.spi_rw(W25Q_CMD_4ByteAddrEN);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_4ByteAddrEN);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -283,10 +512,10 @@ void W25Qxx_4ByteMode(W25Qxx_t *dev)																								/* Set 4 bytes addre
 void W25Qxx_3ByteMode(W25Qxx_t *dev)																								/* Set 3 bytes address mode */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set 3 byte address mode */
-    dev->port.spi_rw(W25Q_CMD_4ByteAddrDEN);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_4ByteAddrDEN);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -312,10 +541,10 @@ void W25Qxx_Suspend(W25Qxx_t *dev)																							 		/* Erase/Program sus
     **/
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-    dev->port.spi_rw(W25Q_CMD_EWSUSPEND);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_EWSUSPEND);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -332,10 +561,10 @@ void W25Qxx_Suspend(W25Qxx_t *dev)																							 		/* Erase/Program sus
 void W25Qxx_Resume(W25Qxx_t *dev)																							 	 	/* Erase/Program resume  (SUS = 1) */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-    dev->port.spi_rw(W25Q_CMD_EWRESUME);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_EWRESUME);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -349,6 +578,20 @@ void W25Qxx_Resume(W25Qxx_t *dev)																							 	 	/* Erase/Program res
     /* read back Suspend Bit */
     W25Qxx_ReadStatusRegister(dev, 2);
 }
+void W25Qxx_DieSelect(W25Qxx_t *dev, uint8_t Die)																					/* Software die select (stacked die chip) */
+{
+    /* CS enable */
+    W25QXX_CS_L(dev);
+
+    /* select die */
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_DIESELECT);
+    W25QXX_SPI(dev, byteAddr, Die);
+
+    /* CS disable */
+    dev->port.spi_cs_H();
+
+    dev->activeDie = Die;
+}
 /* W25Qxx Read sector/block lock of current address status */
 uint8_t W25Qxx_ReadLock(W25Qxx_t *dev, uint32_t ByteAddr)												   		 					/* Read current Sector/Block Lock Status */
 {
@@ -367,19 +610,19 @@ uint8_t W25Qxx_ReadLock(W25Qxx_t *dev, uint32_t ByteAddr)
 #endif
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read block lock status */
-    dev->port.spi_rw(W25Q_CMD_RBLOCKLOCK);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_RBLOCKLOCK);
 
     /* write address */
 #if W25QXX_4BADDR
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 24));
 #endif
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    ret = dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
+    ret = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -398,11 +641,11 @@ uint8_t W25Qxx_ReadLock(W25Qxx_t *dev, uint32_t ByteAddr)
 void W25Qxx_ReadExtendedRegister(W25Qxx_t *dev)																						/* Read  Extended Address Register */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write extended address register */
-    dev->port.spi_rw(W25Q_CMD_REXTREG);
-    dev->ExtendedRegister = dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_REXTREG);
+    dev->ExtendedRegister = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -413,12 +656,12 @@ void W25Qxx_WriteExtendedRegister(W25Qxx_t *dev, uint8_t ExtendedAddr)
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write extended address register */
     dev->ExtendedRegister = ExtendedAddr;
-    dev->port.spi_rw(W25Q_CMD_WEXTREG);
-    dev->port.spi_rw(ExtendedAddr);
+    W25QXX_SPI(dev, byteExtReg, W25Q_CMD_WEXTREG);
+    W25QXX_SPI(dev, byteExtReg, ExtendedAddr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -430,14 +673,14 @@ void W25Qxx_WriteExtendedRegister(W25Qxx_t *dev, uint8_t ExtendedAddr)
 void W25Qxx_ReadStatusRegister(W25Qxx_t *dev, uint8_t Select_SR_1_2_3)																/* Read  Status Register1/2/3 */
 {
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read status register */
     switch (Select_SR_1_2_3)
     {
-        case 1: dev->port.spi_rw(W25Q_CMD_RSREG1); dev->StatusRegister1 = dev->port.spi_rw(W25Q_DUMMY); break;
-        case 2: dev->port.spi_rw(W25Q_CMD_RSREG2); dev->StatusRegister2 = dev->port.spi_rw(W25Q_DUMMY); break;
-        case 3: dev->port.spi_rw(W25Q_CMD_RSREG3); dev->StatusRegister3 = dev->port.spi_rw(W25Q_DUMMY); break;
+        case 1: W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSREG1); dev->StatusRegister1 = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY); break;
+        case 2: W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSREG2); dev->StatusRegister2 = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY); break;
+        case 3: W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSREG3); dev->StatusRegister3 = W25QXX_SPI(dev, byteRegister, W25Q_DUMMY); break;
         default: break;
     }
 
@@ -450,14 +693,14 @@ void W25Qxx_WriteStatusRegister(W25Qxx_t *dev, uint8_t Select_SR_1_2_3, uint8_t
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write status register */
     switch (Select_SR_1_2_3)
     {
-        case 1: dev->StatusRegister1 = Data; dev->port.spi_rw(W25Q_CMD_WSREG1);  dev->port.spi_rw(Data); break;
-        case 2: dev->StatusRegister2 = Data; dev->port.spi_rw(W25Q_CMD_WSREG2);  dev->port.spi_rw(Data); break;
-        case 3: dev->StatusRegister3 = Data; dev->port.spi_rw(W25Q_CMD_WSREG3);  dev->port.spi_rw(Data); break;
+        case 1: dev->StatusRegister1 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG1);  W25QXX_SPI(dev, byteRegister, Data); break;
+        case 2: dev->StatusRegister2 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG2);  W25QXX_SPI(dev, byteRegister, Data); break;
+        case 3: dev->StatusRegister3 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG3);  W25QXX_SPI(dev, byteRegister, Data); break;
         default: break;
     }
 
@@ -480,14 +723,14 @@ void W25Qxx_VolatileSR_WriteStatusRegister(W25Qxx_t *dev, uint8_t Select_SR_1_2_
     W25Qxx_VolatileSR_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write status register */
     switch (Select_SR_1_2_3)
     {
-        case 1: dev->StatusRegister1 = Data; dev->port.spi_rw(W25Q_CMD_WSREG1);  dev->port.spi_rw(Data); break;
-        case 2: dev->StatusRegister2 = Data; dev->port.spi_rw(W25Q_CMD_WSREG2);  dev->port.spi_rw(Data); break;
-        case 3: dev->StatusRegister3 = Data; dev->port.spi_rw(W25Q_CMD_WSREG3);  dev->port.spi_rw(Data); break;
+        case 1: dev->StatusRegister1 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG1);  W25QXX_SPI(dev, byteRegister, Data); break;
+        case 2: dev->StatusRegister2 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG2);  W25QXX_SPI(dev, byteRegister, Data); break;
+        case 3: dev->StatusRegister3 = Data; W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSREG3);  W25QXX_SPI(dev, byteRegister, Data); break;
         default: break;
     }
 
@@ -778,10 +1021,13 @@ void W25Qxx_WBit_ADP(W25Qxx_t *dev, uint8_t bit)
 }
 uint8_t W25Qxx_ReadStatus(W25Qxx_t *dev)																							/* Read current chip running status */
 {
+    uint32_t latStart = W25QXX_LAT_START(dev);
     uint8_t ret = 0;
 
+    W25QXX_STAT(dev, numStatusPoll++);
     ret |= W25Qxx_RBit_BUSY(dev);
     ret |= W25Qxx_RBit_SUS(dev) << 1;
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_STATUS, latStart);
 
     return (1 << ret);
 }
@@ -809,12 +1055,61 @@ void W25Qxx_isStatus(W25Qxx_t *dev, uint8_t Select_Status, uint32_t timeout, W25
         if (time-- == 0) break;
 
         dev->port.spi_delayms(1);
+        W25QXX_STAT(dev, timeBusy += 1000);
 
-    } while (time);
+    } while (1);
 
     /* current status err */
     *err = W25Qxx_ERR_STATUS;
 }
+void W25Qxx_isStatus_Timed(W25Qxx_t *dev, uint8_t Select_Status, W25Qxx_OP Op, uint32_t timeout, W25Qxx_ERR *err)					/* Determine current running status by the polling schedule of the calibrated time */
+{
+    uint32_t typ = W25Qxx_TypTime(dev, Op);
+    uint32_t start = 0;
+    uint32_t next = 0;
+    uint32_t step = 0;
+    uint32_t fine = 0;
+    uint32_t near = 0;
+
+    /* not calibrated : poll each 1ms */
+    if (typ == 0 || dev->port.spi_timeus == NULL)
+    {
+        W25Qxx_isStatus(dev, Select_Status, timeout, err);
+        return;
+    }
+
+    start = dev->port.spi_timeus();
+    step = (typ >> 6) ? (typ >> 6) : 1;
+    if (step > 1000) step = 1000;
+    fine = (typ >> 11) ? (typ >> 11) : 1;
+    near = typ >> 6;
+
+    /* sleep 7/8 of the typical time */
+    next = typ - (typ >> 3);
+    W25Qxx_Hold(dev, start, next);
+
+    /* poll each 1/64 of the typical time (1ms at most) up to twice the typical time,
+     * each 1/2048 within 1/64 of the typical time where the operation is expected to end */
+    while (next < 2 * typ)
+    {
+        if ((W25Qxx_STATUS)W25Qxx_ReadStatus(dev) & Select_Status)
+        {
+            W25QXX_STAT(dev, timeBusy += dev->port.spi_timeus() - start);
+            *err = W25Qxx_ERR_NONE;
+            return;
+        }
+        if (next + near < typ) next = (next + step + near < typ) ? next + step : typ - near;
+        else if (next < typ + near) next += fine;
+        else next += step;
+        W25Qxx_Hold(dev, start, next);
+    }
+
+    /* slower than twice the typical time : poll each 1ms up to the max time */
+    next = dev->port.spi_timeus() - start;
+    W25QXX_STAT(dev, timeBusy += next);
+    next /= 1000;
+    W25Qxx_isStatus(dev, Select_Status, (timeout > next) ? timeout - next : 0, err);
+}
 /* W25Qxx Sector/Blcok Lock protect for " WPS = 1 "
  * WPS = 0 : The Device will only utilize CMP, TB, BP[3:0] bits to protect specific areas of the array.
  * WPS = 1 : The Device will utilize the Individual Block Locks for write protection.
@@ -841,10 +1136,10 @@ void W25Qxx_Global_UnLock(W25Qxx_t *dev, W25Qxx_ERR *err)																			/* G
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set all block unlocked */
-    dev->port.spi_rw(W25Q_CMD_WALLBLOCKUNLOCK);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WALLBLOCKUNLOCK);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -868,10 +1163,10 @@ void W25Qxx_Global_Locked(W25Qxx_t *dev, W25Qxx_ERR *err)																			/* G
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* set all block locked */
-    dev->port.spi_rw(W25Q_CMD_WALLBLOCKLOCK);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WALLBLOCKLOCK);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -907,18 +1202,18 @@ void W25Qxx_Individual_UnLock(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read block lock status */
-    dev->port.spi_rw(W25Q_CMD_WSIGBLOCKUNLOCK);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSIGBLOCKUNLOCK);
 
     /* write address */
 #if W25QXX_4BADDR
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 24));
 #endif
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -954,18 +1249,18 @@ void W25Qxx_Individual_Locked(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* read block lock status */
-    dev->port.spi_rw(W25Q_CMD_WSIGBLOCKLOCK);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSIGBLOCKLOCK);
 
     /* write address */
 #if W25QXX_4BADDR
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 24));
 #endif
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -988,6 +1283,8 @@ void W25Qxx_Individual_Locked(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)
 **/
 void W25Qxx_Erase_Chip(W25Qxx_t *dev, W25Qxx_ERR *err)                                                              				/* Erase all chip */
 {
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
@@ -996,10 +1293,12 @@ void W25Qxx_Erase_Chip(W25Qxx_t *dev, W25Qxx_ERR *err)
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-    dev->port.spi_rw(W25Q_CMD_ECHIP);
+    W25QXX_STAT(dev, numEraseChip++);
+    W25QXX_WEAR_ADD(dev, numEraseChip, 0, dev->numSector);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ECHIP);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -1010,10 +1309,11 @@ void W25Qxx_Erase_Chip(W25Qxx_t *dev, W25Qxx_ERR *err)
     /* wait for Erase or write end */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE, dev->info.EraseMaxTimeChip, err);
     if (*err != W25Qxx_ERR_NONE) return;
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_ERASE_CHIP, latStart);
 
     *err = W25Qxx_ERR_NONE;
 }
-void W25Qxx_Erase_Block64(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)                                   					/* Erase block of 64k */
+void W25Qxx_Erase_Block64_Start(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)                                              /* Start erase block of 64k (no wait for end) */
 {
     /* Determine if Block 64 Addrress Bound */
     if (Block64Addr >= dev->numBlock)
@@ -1022,6 +1322,9 @@ void W25Qxx_Erase_Block64(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)
         return;
     }
 
+    /* Select the die of address */
+    W25Qxx_DieAddr(dev, Block64Addr * dev->sizeBlock);
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
@@ -1029,37 +1332,19 @@ void W25Qxx_Erase_Block64(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)
     /* calculate sector address */
     Block64Addr *= dev->sizeBlock;
 
-#if W25QXX_4BADDR == 0
-    /* Address > 0xFFFFFF */
-    if (Block64Addr > 0xFFFFFF)
-    {
-        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((Block64Addr) >> 24));
-    }
-    else
-    {
-        W25Qxx_WriteExtendedRegister(dev, 0x00);
-    }
-#endif
+    /* Address > 0xFFFFFF (3 Byte address mode) */
+    W25Qxx_ExtAddr(dev, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x10000)), Block64Addr);
 
     /* write enable */
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_E64KBLOCK);
-    dev->port.spi_rw((uint8_t)((Block64Addr) >> 24));
-    dev->port.spi_rw((uint8_t)((Block64Addr) >> 16));
-    dev->port.spi_rw((uint8_t)((Block64Addr) >> 8));
-    dev->port.spi_rw((uint8_t)Block64Addr);
-#else
-    dev->port.spi_rw(W25Q_CMD_E64KBLOCK);
-    dev->port.spi_rw((uint8_t)((Block64Addr) >> 16));
-    dev->port.spi_rw((uint8_t)((Block64Addr) >> 8));
-    dev->port.spi_rw((uint8_t)Block64Addr);
-#endif
+    W25QXX_STAT(dev, numEraseBlock64++);
+    W25QXX_WEAR_ADD(dev, numEraseBlock64, Block64Addr / dev->sizeSector, dev->sizeBlock / dev->sizeSector);
+    W25Qxx_AddrCmd(dev, W25Q_CMD_E64KBLOCK, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x10000)), Block64Addr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -1067,13 +1352,24 @@ void W25Qxx_Erase_Block64(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)
     /* write disable */
     W25Qxx_WriteDisable(dev);
 
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Erase_Block64(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)                                   					/* Erase block of 64k */
+{
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
+    /* start erase */
+    W25Qxx_Erase_Block64_Start(dev, Block64Addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.EraseMaxTimeBlock64, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_ERASE_BLOCK64, dev->info.EraseMaxTimeBlock64, err);
     if (*err != W25Qxx_ERR_NONE) return;
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_ERASE_BLOCK64, latStart);
 
     *err = W25Qxx_ERR_NONE;
 }
-void W25Qxx_Erase_Block32(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)                                   					/* Erase block of 32k */
+void W25Qxx_Erase_Block32_Start(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)                                              /* Start erase block of 32k (no wait for end) */
 {
     /* Determine if Block 32 Addrress Bound */
     if (Block32Addr >= dev->numBlock * 2)
@@ -1082,6 +1378,9 @@ void W25Qxx_Erase_Block32(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)
         return;
     }
 
+    /* Select the die of address */
+    W25Qxx_DieAddr(dev, Block32Addr * (dev->sizeBlock >> 1));
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
@@ -1089,37 +1388,19 @@ void W25Qxx_Erase_Block32(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)
     /* calculate sector address */
     Block32Addr *= (dev->sizeBlock >> 1);		/* Block32Addr *= (dev->sizeBlock / 2); */
 
-#if W25QXX_4BADDR == 0
-    /* Address > 0xFFFFFF */
-    if (Block32Addr > 0xFFFFFF)
-    {
-        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((Block32Addr) >> 24));
-    }
-    else
-    {
-        W25Qxx_WriteExtendedRegister(dev, 0x00);
-    }
-#endif
+    /* Address > 0xFFFFFF (3 Byte address mode) */
+    W25Qxx_ExtAddr(dev, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x8000)), Block32Addr);
 
     /* write enable */
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_E32KBLOCK);
-    dev->port.spi_rw((uint8_t)((Block32Addr) >> 24));
-    dev->port.spi_rw((uint8_t)((Block32Addr) >> 16));
-    dev->port.spi_rw((uint8_t)((Block32Addr) >> 8));
-    dev->port.spi_rw((uint8_t)Block32Addr);
-#else
-    dev->port.spi_rw(W25Q_CMD_E32KBLOCK);
-    dev->port.spi_rw((uint8_t)((Block32Addr) >> 16));
-    dev->port.spi_rw((uint8_t)((Block32Addr) >> 8));
-    dev->port.spi_rw((uint8_t)Block32Addr);
-#endif
+    W25QXX_STAT(dev, numEraseBlock32++);
+    W25QXX_WEAR_ADD(dev, numEraseBlock32, Block32Addr / dev->sizeSector, (dev->sizeBlock >> 1) / dev->sizeSector);
+    W25Qxx_AddrCmd(dev, W25Q_CMD_E32KBLOCK, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x8000)), Block32Addr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -1127,13 +1408,24 @@ void W25Qxx_Erase_Block32(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)
     /* write disable */
     W25Qxx_WriteDisable(dev);
 
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Erase_Block32(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err)                                   					/* Erase block of 32k */
+{
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
+    /* start erase */
+    W25Qxx_Erase_Block32_Start(dev, Block32Addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.EraseMaxTimeBlock32, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_ERASE_BLOCK32, dev->info.EraseMaxTimeBlock32, err);
     if (*err != W25Qxx_ERR_NONE) return;
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_ERASE_BLOCK32, latStart);
 
     *err = W25Qxx_ERR_NONE;
 }
-void W25Qxx_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)                                   					/* Erase sector of 4k (Notes : 150ms) */
+void W25Qxx_Erase_Sector_Start(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)                                              /* Start erase sector of 4k (no wait for end) */
 {
     /* Determine if Sector Addrress Bound */
     if (SectorAddr >= dev->numSector)
@@ -1142,6 +1434,9 @@ void W25Qxx_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
         return;
     }
 
+    /* Select the die of address */
+    W25Qxx_DieAddr(dev, SectorAddr * dev->sizeSector);
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
@@ -1149,37 +1444,19 @@ void W25Qxx_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
     /* calculate sector address */
     SectorAddr *= dev->sizeSector;
 
-#if W25QXX_4BADDR == 0
-    /* Address > 0xFFFFFF */
-    if (SectorAddr > 0xFFFFFF)
-    {
-        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((SectorAddr) >> 24));
-    }
-    else
-    {
-        W25Qxx_WriteExtendedRegister(dev, 0x00);
-    }
-#endif
+    /* Address > 0xFFFFFF (3 Byte address mode) */
+    W25Qxx_ExtAddr(dev, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x1000)), SectorAddr);
 
     /* write enable */
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_ESECTOR);
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 24));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 8));
-    dev->port.spi_rw((uint8_t)SectorAddr);
-#else
-    dev->port.spi_rw(W25Q_CMD_ESECTOR);
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 8));
-    dev->port.spi_rw((uint8_t)SectorAddr);
-#endif
+    W25QXX_STAT(dev, numEraseSector++);
+    W25QXX_WEAR_ADD(dev, numEraseSector, SectorAddr / dev->sizeSector, 1);
+    W25Qxx_AddrCmd(dev, W25Q_CMD_ESECTOR, W25QXX_CMD4B(W25Qxx_SFDP_Erase4B(dev, 0x1000)), SectorAddr);
 
     /* CS disable */
     dev->port.spi_cs_H();
@@ -1187,9 +1464,20 @@ void W25Qxx_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
     /* write disable */
     W25Qxx_WriteDisable(dev);
 
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)                                   					/* Erase sector of 4k (Notes : 150ms) */
+{
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
+    /* start erase */
+    W25Qxx_Erase_Sector_Start(dev, SectorAddr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.EraseMaxTimeSector, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_ERASE_SECTOR, dev->info.EraseMaxTimeSector, err);
     if (*err != W25Qxx_ERR_NONE) return;
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_ERASE_SECTOR, latStart);
 
     *err = W25Qxx_ERR_NONE;
 }
@@ -1210,20 +1498,21 @@ void W25Qxx_Erase_Security(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
+    W25QXX_STAT(dev, numEraseSecurity++);
 #if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_ESECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)(SectorAddr << 4));
-    dev->port.spi_rw(0x00);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ESECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)(SectorAddr << 4));
+    W25QXX_SPI(dev, byteAddr, 0x00);
 #else
-    dev->port.spi_rw(W25Q_CMD_ESECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)(SectorAddr << 4));
-    dev->port.spi_rw(0x00);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ESECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)(SectorAddr << 4));
+    W25QXX_SPI(dev, byteAddr, 0x00);
 #endif
 
     /* CS disable */
@@ -1233,87 +1522,113 @@ void W25Qxx_Erase_Security(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
     W25Qxx_WriteDisable(dev);
 
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.EraseMaxTimeSector, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_ERASE_SECTOR, dev->info.EraseMaxTimeSector, err);
     if (*err != W25Qxx_ERR_NONE) return;
 
     *err = W25Qxx_ERR_NONE;
 }
-void W25Qxx_Read(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err)   					/* Read */
+void W25Qxx_Read_Start(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)                                                          /* Start continuous read (CS stays enabled) */
 {
-    uint16_t i = 0;
+    /* Continuous read
+     * 1. W25Qxx_Read_Start send read instruction and address, the CS stays enabled.
+     * 2. W25Qxx_Read_Stream can be called any times to clock out the following data.
+     * 3. W25Qxx_Read_Stop disable CS and end the read.
+     * Notes : In the 3-address mode, the data stream does not cross the extended address
+     *         register boundary (16MB), the 4 Byte address instruction (SFDP) has no boundary.
+    **/
+    uint8_t cmd4B = 0x00;
 
-    /* Determine if the number is 0 */
-    if (NumByteToRead == 0x00)
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= dev->sizeChip)
     {
-        *err = W25Qxx_ERR_INVALID;
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
         return;
     }
 
+    /* Select the die of address */
+    W25Qxx_DieAddr(dev, ByteAddr);
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
 
-    /* Determine if the address > dev->sizeChip */
-    if (ByteAddr + NumByteToRead > dev->sizeChip)
-    {
-        *err = W25Qxx_ERR_BYTEADDRBOUND;
-        return;
-    }
-
-#if W25QXX_4BADDR == 0
-    /* Address > 0xFFFFFF */
-    if (ByteAddr > 0xFFFFFF)
-    {
-        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((ByteAddr) >> 24));
-}
-    else
-    {
-        W25Qxx_WriteExtendedRegister(dev, 0x00);
-    }
+#if W25QXX_FASTREAD
+    cmd4B = W25QXX_CMD4B(dev->sfdp.cmdFastRead4B);
+#else
+    cmd4B = W25QXX_CMD4B(dev->sfdp.cmdRead4B);
 #endif
 
+    /* Address > 0xFFFFFF (3 Byte address mode) */
+    W25Qxx_ExtAddr(dev, cmd4B, ByteAddr);
+
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write address */
+    W25QXX_STAT(dev, numRead++);
 #if W25QXX_FASTREAD
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_FASTREAD);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    dev->port.spi_rw(W25Q_DUMMY);
-#else
-    dev->port.spi_rw(W25Q_CMD_FASTREAD);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    dev->port.spi_rw(W25Q_DUMMY);
-#endif
-#else
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_READ);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
+    W25Qxx_AddrCmd(dev, W25Q_CMD_FASTREAD, cmd4B, ByteAddr);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
 #else
-    dev->port.spi_rw(W25Q_CMD_READ);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-#endif
+    W25Qxx_AddrCmd(dev, W25Q_CMD_READ, cmd4B, ByteAddr);
 #endif
 
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Read_Stream(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t NumByteToRead)                                                 /* Continuous read data (pBuffer = NULL : discard data) */
+{
+    uint32_t i = 0;
+
     /* read data */
-    for (i = 0; i < NumByteToRead; i++)
+    W25QXX_STAT(dev, bytePayload += NumByteToRead);
+    if (pBuffer == NULL)
     {
-        pBuffer[i] = dev->port.spi_rw(W25Q_DUMMY);
+        for (i = 0; i < NumByteToRead; i++)
+        {
+            dev->port.spi_rw(W25Q_DUMMY);
+        }
     }
-
+    else
+    {
+        for (i = 0; i < NumByteToRead; i++)
+        {
+            pBuffer[i] = dev->port.spi_rw(W25Q_DUMMY);
+        }
+    }
+}
+void W25Qxx_Read_Stop(W25Qxx_t *dev)                                                                                              /* Stop continuous read */
+{
     /* CS disable */
     dev->port.spi_cs_H();
+}
+void W25Qxx_Read(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err)   					/* Read */
+{
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
+    /* Determine if the number is 0 */
+    if (NumByteToRead == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr + NumByteToRead > dev->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    /* send read instruction and address */
+    W25Qxx_Read_Start(dev, ByteAddr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* read data */
+    W25Qxx_Read_Stream(dev, pBuffer, NumByteToRead);
+
+    /* CS disable */
+    W25Qxx_Read_Stop(dev);
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_READ, latStart);
 
     *err = W25Qxx_ERR_NONE;
 }
@@ -1344,25 +1659,27 @@ void W25Qxx_Read_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, ui
     }
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write address */
+    W25QXX_STAT(dev, numRead++);
 #if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_RSECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
 #else
-    dev->port.spi_rw(W25Q_CMD_RSECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    dev->port.spi_rw(W25Q_DUMMY);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteDummy, W25Q_DUMMY);
 #endif
 
     /* read data */
+    W25QXX_STAT(dev, bytePayload += NumByteToRead);
     for (i = 0; i < NumByteToRead; i++)
     {
         pBuffer[i] = dev->port.spi_rw(W25Q_DUMMY);
@@ -1396,16 +1713,18 @@ void W25Qxx_Read_SFDP(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16
     }
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write address */
-    dev->port.spi_rw(W25Q_CMD_RSFDP);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)ByteAddr);
-    dev->port.spi_rw(0x00);
+    W25QXX_STAT(dev, numRead++);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_RSFDP);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteDummy, 0x00);
 
     /* read data */
+    W25QXX_STAT(dev, bytePayload += NumByteToRead);
     for (i = 0; i < NumByteToRead; i++)
     {
         pBuffer[i] = dev->port.spi_rw(W25Q_DUMMY);
@@ -1416,7 +1735,7 @@ void W25Qxx_Read_SFDP(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16
 
     *err = W25Qxx_ERR_NONE;
 }
-void W25Qxx_DIR_Program_Page(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err)  		/* No check Direct program Page   (0-256), Notes : no beyond page address */
+void W25Qxx_DIR_Program_Page_Start(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err)  /* Start direct program Page (no wait for end) */
 {
     /* No check Direct Page write
      * 1. Write data of the specified length at the specified address,
@@ -1434,6 +1753,9 @@ void W25Qxx_DIR_Program_Page(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
         return;
     }
 
+    /* Select the die of address */
+    W25Qxx_DieAddr(dev, ByteAddr);
+
     /* Determine if it is busy */
     W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, 0, err);
     if (*err != W25Qxx_ERR_NONE) return;
@@ -1447,39 +1769,21 @@ void W25Qxx_DIR_Program_Page(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
         return;
 }
 
-#if W25QXX_4BADDR == 0
-    /* Address > 0xFFFFFF */
-    if (ByteAddr > 0xFFFFFF)
-    {
-        W25Qxx_WriteExtendedRegister(dev, (uint8_t)((ByteAddr) >> 24));
-    }
-    else
-    {
-        W25Qxx_WriteExtendedRegister(dev, 0x00);
-    }
-#endif
+    /* Address > 0xFFFFFF (3 Byte address mode) */
+    W25Qxx_ExtAddr(dev, W25QXX_CMD4B(dev->sfdp.cmdProgram4B), ByteAddr);
 
     /* write enable */
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write address */
-#if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_WPAGE);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 24));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-#else
-    dev->port.spi_rw(W25Q_CMD_WPAGE);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
-#endif
+    W25QXX_STAT(dev, numProgram++);
+    W25Qxx_AddrCmd(dev, W25Q_CMD_WPAGE, W25QXX_CMD4B(dev->sfdp.cmdProgram4B), ByteAddr);
 
     /* write data */
+    W25QXX_STAT(dev, bytePayload += NumByteToWrite);
     for (i = 0; i < NumByteToWrite; i++)
     {
         dev->port.spi_rw(pBuffer[i]);
@@ -1491,10 +1795,22 @@ void W25Qxx_DIR_Program_Page(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
     /* write disable */
     W25Qxx_WriteDisable(dev);
 
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_DIR_Program_Page(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err)  		/* No check Direct program Page   (0-256), Notes : no beyond page address */
+{
+    uint32_t latStart = W25QXX_LAT_START(dev);
+
+    /* start program */
+    W25Qxx_DIR_Program_Page_Start(dev, pBuffer, ByteAddr, NumByteToWrite, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.ProgrMaxTimePage, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_PROGRAM_PAGE, dev->info.ProgrMaxTimePage, err);
     if (*err != W25Qxx_ERR_NONE) return;
 
+    W25QXX_LAT_ADD(dev, W25Qxx_LAT_DIR_PROGRAM, latStart);
+
     *err = W25Qxx_ERR_NONE;
 }
 void W25Qxx_DIR_Program(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)				/* No check Direct program */
@@ -1579,23 +1895,25 @@ void W25Qxx_DIR_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteA
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* write address */
+    W25QXX_STAT(dev, numProgram++);
 #if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_WSECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
 #else
-    dev->port.spi_rw(W25Q_CMD_WSECREG);
-    dev->port.spi_rw(0x00);
-    dev->port.spi_rw((uint8_t)((ByteAddr) >> 8));
-    dev->port.spi_rw((uint8_t)ByteAddr);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_WSECREG);
+    W25QXX_SPI(dev, byteAddr, 0x00);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((ByteAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)ByteAddr);
 #endif
 
     /* write data */
+    W25QXX_STAT(dev, bytePayload += NumByteToWrite);
     for (i = 0; i < NumByteToWrite; i++)
     {
         dev->port.spi_rw(pBuffer[i]);
@@ -1608,7 +1926,7 @@ void W25Qxx_DIR_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteA
     W25Qxx_WriteDisable(dev);
 
     /* wait for Erase or write end */
-    W25Qxx_isStatus(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, dev->info.ProgrMaxTimePage, err);
+    W25Qxx_isStatus_Timed(dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, W25Qxx_OP_PROGRAM_PAGE, dev->info.ProgrMaxTimePage, err);
     if (*err != W25Qxx_ERR_NONE) return;
 
     *err = W25Qxx_ERR_NONE;
@@ -1621,10 +1939,11 @@ void W25Qxx_Program(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t
      * WriteAddr      : Write address (24bit)
      * NumByteToWrite : Number of writes (max : sizeChip)
     **/
+    uint32_t latStart = W25QXX_LAT_START(dev);
+    W25Qxx_LAT latOp = W25Qxx_LAT_PROGRAM;
     uint32_t numSec = 0;
     uint16_t offSec = 0;
     uint16_t remSec = 0;
-    uint16_t i = 0;
 
     /* Determine if the number is 0 */
     if (NumByteToWrite == 0x00)
@@ -1647,32 +1966,33 @@ void W25Qxx_Program(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t
         W25Qxx_Read(dev, W25QXX_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
         if (*err != W25Qxx_ERR_NONE) return;
 
-        /* Check whether the current sector data is 0xFF */
-        for (i = 0; i < remSec; i++)
-        {
-            if (W25QXX_CACHE[offSec + i] != 0xFF) break;
-        }
-
         /*------------------------------------ Write data ---------------------------------------*/
 
-        if (i < remSec)					/* need to be erased */
+        if (W25Qxx_isEqual(W25QXX_CACHE + offSec, pBuffer, remSec))
         {
+            /* Data is already stored */
+            W25QXX_STAT(dev, numProgramSkip++);
+        }
+        else if (!W25Qxx_isProgrammable(W25QXX_CACHE + offSec, pBuffer, remSec))		/* need to be erased */
+        {
+            W25QXX_STAT(dev, numProgramErase++);
+            latOp = W25Qxx_LAT_PROGRAM_ERASE;
+
             /* erase current sector */
             W25Qxx_Erase_Sector(dev, numSec, err);
             if (*err != W25Qxx_ERR_NONE) return;
 
             /* copy data to buffer area */
-            for (i = 0; i < remSec; i++)
-            {
-                W25QXX_CACHE[offSec + i] = pBuffer[i];
-            }
+            memcpy(W25QXX_CACHE + offSec, pBuffer, remSec);
 
             /* Write the entire sector */
             W25Qxx_DIR_Program(dev, W25QXX_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
             if (*err != W25Qxx_ERR_NONE) return;
         }
-        else							/* no need to be erased */
+        else							/* no need to be erased (only clears bits) */
         {
+            W25QXX_STAT(dev, numProgramDirect++);
+
             /* Directly write the remaining section of the sector */
             W25Qxx_DIR_Program(dev, pBuffer, ByteAddr, remSec, err);
             if (*err != W25Qxx_ERR_NONE) return;
@@ -1694,6 +2014,8 @@ void W25Qxx_Program(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t
         }
     }
 
+    W25QXX_LAT_ADD(dev, latOp, latStart);
+
     *err = W25Qxx_ERR_NONE;
 }
 void W25Qxx_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err)		   	/* Check program Security (0-256 at a time) */
@@ -1707,7 +2029,6 @@ void W25Qxx_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
     uint8_t  numPage = 0;
     uint16_t offPage = 0;
     uint16_t remPage = 0;
-    uint16_t i = 0;
 
     /* Determine if the number is 0 */
     if (NumByteToWrite == 0x00)
@@ -1740,32 +2061,32 @@ void W25Qxx_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
     W25Qxx_Read_Security(dev, W25QXX_CACHE, numPage * 0x00001000, W25Qxx_PAGESIZE, err);
     if (*err != W25Qxx_ERR_NONE) return;
 
-    /* Check whether the current page data is 0xFF */
-    for (i = 0; i < remPage; i++)
-    {
-        if (W25QXX_CACHE[offPage + i] != 0xFF) break;
-    }
-
     /*------------------------------------ Write data ---------------------------------------*/
 
-    if (i < remPage)			/* need to be erased */
+    if (W25Qxx_isEqual(W25QXX_CACHE + offPage, pBuffer, remPage))
+    {
+        /* Data is already stored */
+        W25QXX_STAT(dev, numProgramSkip++);
+    }
+    else if (!W25Qxx_isProgrammable(W25QXX_CACHE + offPage, pBuffer, remPage))	/* need to be erased */
     {
+        W25QXX_STAT(dev, numProgramErase++);
+
         /* erase current page */
         W25Qxx_Erase_Security(dev, numPage, err);
         if (*err != W25Qxx_ERR_NONE) return;
 
         /* copy data to buffer area */
-        for (i = 0; i < remPage; i++)
-        {
-            W25QXX_CACHE[offPage + i] = pBuffer[i];
-        }
+        memcpy(W25QXX_CACHE + offPage, pBuffer, remPage);
 
         /* Ensure that the written data is in the same page, write the entire page */
         W25Qxx_DIR_Program_Security(dev, W25QXX_CACHE, numPage * 0x00001000, W25Qxx_PAGESIZE, err);
         if (*err != W25Qxx_ERR_NONE) return;
     }
-    else						/* no need to be erased */
+    else						/* no need to be erased (only clears bits) */
     {
+        W25QXX_STAT(dev, numProgramDirect++);
+
         /* Ensure that the written data is in the same page, directly write the remaining section of the page */
         W25Qxx_DIR_Program_Security(dev, pBuffer, ByteAddr, remPage, err);
         if (*err != W25Qxx_ERR_NONE) return;
@@ -1777,6 +2098,388 @@ void W25Qxx_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr,
 
     *err = W25Qxx_ERR_NONE;
 }
+/* W25Qxx Buffer Check
+ * Vector : AVX2 (32Byte), SSE2/NEON (16Byte), otherwise the machine word (memcpy load, no alignment needed)
+ * The checks are reduced to "is zero" : ~data (blank), new & ~old (programmable), a ^ b (equal)
+**/
+#if defined(__AVX2__)
+typedef __m256i W25QXX_VEC_t;
+#define W25QXX_VEC_LOAD(p)      _mm256_loadu_si256((const __m256i *)(p))
+#define W25QXX_VEC_AND(a, b)    _mm256_and_si256(a, b)
+#define W25QXX_VEC_OR(a, b)     _mm256_or_si256(a, b)
+#define W25QXX_VEC_XOR(a, b)    _mm256_xor_si256(a, b)
+#define W25QXX_VEC_ANDNOT(a, b) _mm256_andnot_si256(a, b)										/* ~a & b */
+#define W25QXX_VEC_ONES         _mm256_set1_epi8(-1)
+#define W25QXX_VEC_ZERO(a)      _mm256_testz_si256(a, a)
+#elif defined(__SSE2__)
+typedef __m128i W25QXX_VEC_t;
+#define W25QXX_VEC_LOAD(p)      _mm_loadu_si128((const __m128i *)(p))
+#define W25QXX_VEC_AND(a, b)    _mm_and_si128(a, b)
+#define W25QXX_VEC_OR(a, b)     _mm_or_si128(a, b)
+#define W25QXX_VEC_XOR(a, b)    _mm_xor_si128(a, b)
+#define W25QXX_VEC_ANDNOT(a, b) _mm_andnot_si128(a, b)											/* ~a & b */
+#define W25QXX_VEC_ONES         _mm_set1_epi8(-1)
+#define W25QXX_VEC_ZERO(a)      (_mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128())) == 0xFFFF)
+#elif defined(__ARM_NEON)
+typedef uint8x16_t W25QXX_VEC_t;
+#define W25QXX_VEC_LOAD(p)      vld1q_u8(p)
+#define W25QXX_VEC_AND(a, b)    vandq_u8(a, b)
+#define W25QXX_VEC_OR(a, b)     vorrq_u8(a, b)
+#define W25QXX_VEC_XOR(a, b)    veorq_u8(a, b)
+#define W25QXX_VEC_ANDNOT(a, b) vbicq_u8(b, a)													/* ~a & b */
+#define W25QXX_VEC_ONES         vdupq_n_u8(0xFF)
+#define W25QXX_VEC_ZERO(a)      ((vgetq_lane_u64(vreinterpretq_u64_u8(a), 0) | vgetq_lane_u64(vreinterpretq_u64_u8(a), 1)) == 0)
+#else
+typedef size_t W25QXX_VEC_t;
+static size_t W25Qxx_VecLoad(const uint8_t *p)												/* Load a machine word of any alignment */
+{
+    size_t w;
+
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+#define W25QXX_VEC_LOAD(p)      W25Qxx_VecLoad(p)
+#define W25QXX_VEC_AND(a, b)    ((a) & (b))
+#define W25QXX_VEC_OR(a, b)     ((a) | (b))
+#define W25QXX_VEC_XOR(a, b)    ((a) ^ (b))
+#define W25QXX_VEC_ANDNOT(a, b) (~(a) & (b))
+#define W25QXX_VEC_ONES         ((size_t)-1)
+#define W25QXX_VEC_ZERO(a)      ((a) == 0)
+#endif
+#define W25QXX_VEC              sizeof(W25QXX_VEC_t)
+uint8_t W25Qxx_isBlank(const uint8_t *pBuffer, uint32_t NumByte)							/* All data is 0xFF (erased) */
+{
+    W25QXX_VEC_t acc;
+    uint32_t i = 0;
+
+    /* 4 vector a step, one test a step */
+    for (; i + 4 * W25QXX_VEC <= NumByte; i += 4 * W25QXX_VEC)
+    {
+        acc = W25QXX_VEC_AND(W25QXX_VEC_AND(W25QXX_VEC_LOAD(pBuffer + i), W25QXX_VEC_LOAD(pBuffer + i + W25QXX_VEC)),
+                             W25QXX_VEC_AND(W25QXX_VEC_LOAD(pBuffer + i + 2 * W25QXX_VEC), W25QXX_VEC_LOAD(pBuffer + i + 3 * W25QXX_VEC)));
+        if (!W25QXX_VEC_ZERO(W25QXX_VEC_ANDNOT(acc, W25QXX_VEC_ONES))) return 0;
+    }
+    for (; i + W25QXX_VEC <= NumByte; i += W25QXX_VEC)
+    {
+        if (!W25QXX_VEC_ZERO(W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pBuffer + i), W25QXX_VEC_ONES))) return 0;
+    }
+    for (; i < NumByte; i++)
+    {
+        if (pBuffer[i] != 0xFF) return 0;
+    }
+
+    return 1;
+}
+uint8_t W25Qxx_isProgrammable(const uint8_t *pOld, const uint8_t *pNew, uint32_t NumByte)	/* New data can be programmed over old data without erase (only clears bits) */
+{
+    W25QXX_VEC_t acc;
+    uint32_t i = 0;
+
+    for (; i + 4 * W25QXX_VEC <= NumByte; i += 4 * W25QXX_VEC)
+    {
+        acc = W25QXX_VEC_OR(W25QXX_VEC_OR(W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pOld + i), W25QXX_VEC_LOAD(pNew + i)),
+                                          W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pOld + i + W25QXX_VEC), W25QXX_VEC_LOAD(pNew + i + W25QXX_VEC))),
+                            W25QXX_VEC_OR(W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pOld + i + 2 * W25QXX_VEC), W25QXX_VEC_LOAD(pNew + i + 2 * W25QXX_VEC)),
+                                          W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pOld + i + 3 * W25QXX_VEC), W25QXX_VEC_LOAD(pNew + i + 3 * W25QXX_VEC))));
+        if (!W25QXX_VEC_ZERO(acc)) return 0;
+    }
+    for (; i + W25QXX_VEC <= NumByte; i += W25QXX_VEC)
+    {
+        if (!W25QXX_VEC_ZERO(W25QXX_VEC_ANDNOT(W25QXX_VEC_LOAD(pOld + i), W25QXX_VEC_LOAD(pNew + i)))) return 0;
+    }
+    for (; i < NumByte; i++)
+    {
+        if ((pNew[i] & ~pOld[i]) != 0) return 0;
+    }
+
+    return 1;
+}
+uint8_t W25Qxx_isEqual(const uint8_t *pBuffer1, const uint8_t *pBuffer2, uint32_t NumByte)	/* Data is equal */
+{
+    W25QXX_VEC_t acc;
+    uint32_t i = 0;
+
+    for (; i + 4 * W25QXX_VEC <= NumByte; i += 4 * W25QXX_VEC)
+    {
+        acc = W25QXX_VEC_OR(W25QXX_VEC_OR(W25QXX_VEC_XOR(W25QXX_VEC_LOAD(pBuffer1 + i), W25QXX_VEC_LOAD(pBuffer2 + i)),
+                                          W25QXX_VEC_XOR(W25QXX_VEC_LOAD(pBuffer1 + i + W25QXX_VEC), W25QXX_VEC_LOAD(pBuffer2 + i + W25QXX_VEC))),
+                            W25QXX_VEC_OR(W25QXX_VEC_XOR(W25QXX_VEC_LOAD(pBuffer1 + i + 2 * W25QXX_VEC), W25QXX_VEC_LOAD(pBuffer2 + i + 2 * W25QXX_VEC)),
+                                          W25QXX_VEC_XOR(W25QXX_VEC_LOAD(pBuffer1 + i + 3 * W25QXX_VEC), W25QXX_VEC_LOAD(pBuffer2 + i + 3 * W25QXX_VEC))));
+        if (!W25QXX_VEC_ZERO(acc)) return 0;
+    }
+    for (; i + W25QXX_VEC <= NumByte; i += W25QXX_VEC)
+    {
+        if (!W25QXX_VEC_ZERO(W25QXX_VEC_XOR(W25QXX_VEC_LOAD(pBuffer1 + i), W25QXX_VEC_LOAD(pBuffer2 + i)))) return 0;
+    }
+    for (; i < NumByte; i++)
+    {
+        if (pBuffer1[i] != pBuffer2[i]) return 0;
+    }
+
+    return 1;
+}
+/* W25Qxx Timing Calibration
+ * The scratch 64k block is erased, the first page of each sector is programmed with 0x00 (all bits),
+ * then sector 0, the upper 32k block and the whole 64k block are erased.
+ * Saved record (7 x uint32_t) : magic, JEDEC ID, 4 typical time, ~sum of the first 6 words
+**/
+static uint32_t W25Qxx_Calibrate_Measure(W25Qxx_t *dev, uint32_t timeout, W25Qxx_ERR *err)										/* Time from now to the end of erase/program (us) */
+{
+    uint32_t start = dev->port.spi_timeus();
+    uint32_t time = 0;
+
+    /* poll back to back */
+    do
+    {
+        time = dev->port.spi_timeus() - start;
+        if (W25Qxx_ReadStatus(dev) & W25Qxx_STATUS_IDLE)
+        {
+            *err = W25Qxx_ERR_NONE;
+            return time;
+        }
+    } while (time <= timeout * 1000);
+
+    *err = W25Qxx_ERR_STATUS;
+    return 0;
+}
+void W25Qxx_Calibrate(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err)														/* Measure typical erase/program time on a scratch 64k block */
+{
+    W25Qxx_TIMING_t t = { 0 };
+    uint32_t numSector = dev->sizeBlock / dev->sizeSector;
+    uint32_t ByteAddr = Block64Addr * dev->sizeBlock;
+    uint32_t i = 0;
+
+    /* Determine if the microsecond counter is available */
+    if (dev->port.spi_timeus == NULL)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* empty scratch block */
+    W25Qxx_Erase_Block64(dev, Block64Addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* page program */
+    memset(W25QXX_CACHE, 0x00, dev->sizePage);
+    for (i = 0; i < numSector; i++)
+    {
+        W25Qxx_DIR_Program_Page_Start(dev, W25QXX_CACHE, ByteAddr + i * dev->sizeSector, dev->sizePage, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        t.ProgrTimePage += W25Qxx_Calibrate_Measure(dev, dev->info.ProgrMaxTimePage, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    t.ProgrTimePage /= numSector;
+
+    /* erase sector */
+    W25Qxx_Erase_Sector_Start(dev, Block64Addr * numSector, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    t.EraseTimeSector = W25Qxx_Calibrate_Measure(dev, dev->info.EraseMaxTimeSector, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* erase block of 32k */
+    W25Qxx_Erase_Block32_Start(dev, Block64Addr * 2 + 1, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    t.EraseTimeBlock32 = W25Qxx_Calibrate_Measure(dev, dev->info.EraseMaxTimeBlock32, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* erase block of 64k */
+    W25Qxx_Erase_Block64_Start(dev, Block64Addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    t.EraseTimeBlock64 = W25Qxx_Calibrate_Measure(dev, dev->info.EraseMaxTimeBlock64, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    dev->timing = t;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Calibrate_Save(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)													/* Save calibrated time in security register (ByteAddr : 0x1000/0x2000/0x3000 + offset) */
+{
+    uint32_t rec[W25QXX_CALIBRATE_SIZE / 4];
+    uint8_t i = 0;
+
+    /* Determine if it is calibrated */
+    if (dev->timing.ProgrTimePage == 0)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    rec[0] = W25QXX_CALIBRATE_MAGIC;
+    rec[1] = dev->IDJEDEC;
+    rec[2] = dev->timing.ProgrTimePage;
+    rec[3] = dev->timing.EraseTimeSector;
+    rec[4] = dev->timing.EraseTimeBlock32;
+    rec[5] = dev->timing.EraseTimeBlock64;
+    rec[6] = 0;
+    for (i = 0; i < 6; i++) rec[6] += rec[i];
+    rec[6] = ~rec[6];
+
+    W25Qxx_Program_Security(dev, (uint8_t *)rec, ByteAddr, W25QXX_CALIBRATE_SIZE, err);
+}
+void W25Qxx_Calibrate_Load(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err)													/* Load calibrated time from security register */
+{
+    uint32_t rec[W25QXX_CALIBRATE_SIZE / 4];
+    uint32_t sum = 0;
+    uint8_t i = 0;
+
+    W25Qxx_Read_Security(dev, (uint8_t *)rec, ByteAddr, W25QXX_CALIBRATE_SIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* Determine if the record is valid and of this chip */
+    for (i = 0; i < 6; i++) sum += rec[i];
+    if (rec[0] != W25QXX_CALIBRATE_MAGIC || rec[1] != dev->IDJEDEC || rec[6] != ~sum || rec[2] == 0)
+    {
+        *err = W25Qxx_ERR_NOTFOUND;
+        return;
+    }
+
+    dev->timing.ProgrTimePage    = rec[2];
+    dev->timing.EraseTimeSector  = rec[3];
+    dev->timing.EraseTimeBlock32 = rec[4];
+    dev->timing.EraseTimeBlock64 = rec[5];
+
+    *err = W25Qxx_ERR_NONE;
+}
+uint32_t W25Qxx_OpTime(W25Qxx_t *dev, W25Qxx_OP Op)																				/* Expected time of operation (us), calibrated typical time or max time */
+{
+    uint32_t typ = W25Qxx_TypTime(dev, Op);
+
+    if (typ != 0) return typ;
+
+    switch (Op)
+    {
+        case W25Qxx_OP_PROGRAM_PAGE:  return dev->info.ProgrMaxTimePage * 1000;
+        case W25Qxx_OP_ERASE_SECTOR:  return dev->info.EraseMaxTimeSector * 1000;
+        case W25Qxx_OP_ERASE_BLOCK32: return dev->info.EraseMaxTimeBlock32 * 1000;
+        case W25Qxx_OP_ERASE_BLOCK64: return dev->info.EraseMaxTimeBlock64 * 1000;
+        default:                      return 0;
+    }
+}
+#if W25QXX_AUTO_POWER
+/* W25Qxx Auto Power-Down */
+void W25Qxx_Power_Auto(W25Qxx_t *dev, uint32_t IdleTime, W25Qxx_ERR *err)															/* Set idle time of auto power-down (0 : off), clear the power accounting */
+{
+    /* Determine if the microsecond counter is available */
+    if (dev->port.spi_timeus == NULL)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    dev->power.idleTime    = IdleTime;
+    dev->power.lastAccess  = dev->port.spi_timeus();
+    dev->power.lastChange  = dev->power.lastAccess;
+    dev->power.timeStandby = 0;
+    dev->power.timeDown    = 0;
+    dev->power.numDown     = 0;
+    dev->power.numWake     = 0;
+    dev->power.timeWake    = 0;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Power_Poll(W25Qxx_t *dev)																							/* Update the power state time, deep power-down after idle time */
+{
+    uint32_t now = 0;
+
+    if (dev->port.spi_timeus == NULL) return;
+
+    now = dev->port.spi_timeus();
+    W25Qxx_Power_Time(dev, now);
+
+    /* Determine if the idle time is over */
+    if (dev->power.state != W25Qxx_POWER_STANDBY || dev->power.idleTime == 0) return;
+    if (now - dev->power.lastAccess < dev->power.idleTime * 1000) return;
+
+    /* no power-down while an erase/program runs or is suspended */
+    if (!(W25Qxx_ReadStatus(dev) & W25Qxx_STATUS_IDLE)) return;
+
+    /* CS enable */
+    dev->port.spi_cs_L();
+
+    /* set power disable */
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_POWERDEN);
+
+    /* CS disable */
+    dev->port.spi_cs_H();
+
+    W25Qxx_Power_Time(dev, dev->port.spi_timeus());
+    dev->power.state = W25Qxx_POWER_DOWN;
+    dev->power.numDown++;
+}
+#endif
+#if W25QXX_STATS
+/* W25Qxx Operation Statistic */
+void W25Qxx_Stats_Snapshot(W25Qxx_t *dev, W25Qxx_STATS_t *stats)																/* Copy of the counters */
+{
+    *stats = dev->stats;
+}
+void W25Qxx_Stats_Reset(W25Qxx_t *dev)																						/* Clear the counters */
+{
+    memset(&dev->stats, 0, sizeof(W25Qxx_STATS_t));
+}
+#endif
+#if W25QXX_LATENCY
+/* W25Qxx Latency Histogram */
+void W25Qxx_Latency_Snapshot(W25Qxx_t *dev, W25Qxx_LATENCY_t *latency)														/* Copy of the histograms */
+{
+    *latency = dev->latency;
+}
+void W25Qxx_Latency_Reset(W25Qxx_t *dev)																					/* Clear the histograms */
+{
+    memset(&dev->latency, 0, sizeof(W25Qxx_LATENCY_t));
+}
+uint32_t W25Qxx_Latency_Percentile(const W25Qxx_LATENCY_HIST_t *hist, uint32_t PerMille)									/* Time (us) of PerMille/1000 of the operations (upper bound of the bucket, 0 : none) */
+{
+    uint32_t num = hist->num;
+    uint32_t max = hist->max;
+    uint32_t rank = 0;
+    uint32_t sum = 0;
+    uint32_t grp = 0;
+    uint32_t i = 0;
+
+    if (num == 0) return 0;
+    if (PerMille >= 1000) return max;
+
+    /* rank of the operation (1 - num) */
+    rank = (uint32_t)(((uint64_t)num * PerMille + 999) / 1000);
+    if (rank == 0) rank = 1;
+
+    for (i = 0; i < W25QXX_LATENCY_BUCKET - 1; i++)
+    {
+        sum += hist->bucket[i];
+        if (sum < rank) continue;
+
+        /* upper bound of bucket, not above the max time */
+        if (i < (1u << W25QXX_LATENCY_SUBBIT)) return (i < max) ? i : max;
+        grp = i >> W25QXX_LATENCY_SUBBIT;
+        i = (((1u << W25QXX_LATENCY_SUBBIT) + (i & ((1u << W25QXX_LATENCY_SUBBIT) - 1)) + 1) << (grp - 1)) - 1;
+
+        return (i < max) ? i : max;
+    }
+
+    /* last bucket (2^29us and more) or record in progress */
+    return max;
+}
+void W25Qxx_Latency_Dump(W25Qxx_t *dev, W25Qxx_LATENCY_PCT_t *pct)															/* Percentiles of every operation class (pct[W25Qxx_LAT_NUM]) */
+{
+    W25Qxx_LATENCY_HIST_t *hist = NULL;
+    uint8_t op = 0;
+
+    for (op = 0; op < W25Qxx_LAT_NUM; op++)
+    {
+        hist = &dev->latency.op[op];
+
+        pct[op].num  = hist->num;
+        pct[op].mean = (hist->num != 0) ? (uint32_t)(hist->sum / hist->num) : 0;
+        pct[op].p50  = W25Qxx_Latency_Percentile(hist, 500);
+        pct[op].p90  = W25Qxx_Latency_Percentile(hist, 900);
+        pct[op].p99  = W25Qxx_Latency_Percentile(hist, 990);
+        pct[op].p999 = W25Qxx_Latency_Percentile(hist, 999);
+        pct[op].max  = hist->max;
+    }
+}
+#endif
 /* W25Qxx config */
 void W25Qxx_QueryChip(W25Qxx_t *dev, W25Qxx_ERR *err)																				/* Retrieve chip model and configuration information */
 {
@@ -1810,8 +2513,231 @@ void W25Qxx_QueryChip(W25Qxx_t *dev, W25Qxx_ERR *err)																				/* Retr
     dev->sizeBlock = dev->sizeSector * 16;
     dev->sizeChip = dev->sizeSector * dev->numSector;
 
+    /* calculate die num (W25Q01/W25Q02 are stacked 64MB die) */
+    dev->numDie = (dev->sizeChip > W25Qxx_DIESIZE) ? (uint8_t)(dev->sizeChip / W25Qxx_DIESIZE) : 1;
+
+    *err = W25Qxx_ERR_NONE;
+}
+#if W25QXX_SUPPORT_SFDP
+static uint32_t W25Qxx_SFDP_Get32(uint8_t *p)																						/* Little endian DWORD */
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint32_t W25Qxx_SFDP_EraseTime(uint32_t Field)																				/* Erase typical time (ms) of 7 bit field : count[4:0], unit[6:5] (1ms/16ms/128ms/1s) */
+{
+    static const uint16_t unit[4] = { 1, 16, 128, 1000 };
+
+    return ((Field & 0x1F) + 1) * unit[(Field >> 5) & 0x03];
+}
+static void W25Qxx_SFDP_ReadMode(W25Qxx_SFDP_READ_t *mode, uint32_t Field)															/* Fast read mode of 16 bit field : dummy[4:0], mode[7:5], instruction[15:8] */
+{
+    mode->numDummy = Field & 0x1F;
+    mode->numMode = (Field >> 5) & 0x07;
+    mode->cmd = (uint8_t)(Field >> 8);
+}
+void W25Qxx_QuerySFDP(W25Qxx_t *dev, W25Qxx_ERR *err)																				/* Retrieve chip geometry, timing and instruction from SFDP (JESD216) */
+{
+    W25Qxx_SFDP_t *sfdp = &dev->sfdp;
+    uint8_t table[64];
+    uint32_t dw[16];
+    uint32_t bfpt = 0;
+    uint32_t aitb = 0;
+    uint32_t mult = 0;
+    uint16_t rev = 0;
+    uint8_t numParam = 0;
+    uint8_t numDword = 0;
+    uint8_t i = 0;
+
+    memset(sfdp, 0, sizeof(W25Qxx_SFDP_t));
+    sfdp->fastRead = W25QXX_SFDP_NONE;
+
+    /* SFDP header : signature, revision, number of parameter header */
+    W25Qxx_Read_SFDP(dev, table, 0x00, 8, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (W25Qxx_SFDP_Get32(table) != W25QXX_SFDP_SIGNATURE)
+    {
+        *err = W25Qxx_ERR_NOTFOUND;
+        return;
+    }
+    sfdp->revMinor = table[4];
+    sfdp->revMajor = table[5];
+    numParam = table[6] + 1;
+
+    /* parameter header : basic flash parameter table (ID FF00h, the latest revision) and 4 Byte address instruction table (ID FF84h) */
+    for (i = 0; i < numParam && 8 + i * 8 + 8 <= W25Qxx_PAGESIZE; i++)
+    {
+        W25Qxx_Read_SFDP(dev, table, 8 + i * 8, 8, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* the table is read by 1 Byte address of W25Qxx_Read_SFDP */
+        if (table[5] != 0x00 || table[6] != 0x00) continue;
+
+        if (table[0] == 0x00 && table[7] == 0xFF && table[3] >= 9 && ((uint16_t)table[2] << 8 | table[1]) >= rev)
+        {
+            rev = (uint16_t)table[2] << 8 | table[1];
+            bfpt = table[4];
+            numDword = (table[3] > 16) ? 16 : table[3];
+            if (bfpt + numDword * 4 > W25Qxx_PAGESIZE) numDword = 0;
+        }
+        if (table[0] == 0x84 && table[7] == 0xFF && table[3] >= 2 && table[4] + 8 <= W25Qxx_PAGESIZE)
+        {
+            aitb = table[4];
+        }
+    }
+    if (numDword == 0)
+    {
+        *err = W25Qxx_ERR_NOTFOUND;
+        return;
+    }
+
+    /* basic flash parameter table */
+    W25Qxx_Read_SFDP(dev, table, bfpt, numDword * 4, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    for (i = 0; i < 16; i++) dw[i] = (i < numDword) ? W25Qxx_SFDP_Get32(&table[i * 4]) : 0;
+    sfdp->numDword = numDword;
+
+    /* DWORD1 : address Byte, fast read mode */
+    sfdp->addrBytes = (dw[0] >> 17) & 0x03;
+
+    /* DWORD2 : density (bit), the chip > 4GB is not supported */
+    if (dw[1] & 0x80000000)
+    {
+        if ((dw[1] & 0x7FFFFFFF) < 3 || (dw[1] & 0x7FFFFFFF) > 34)
+        {
+            *err = W25Qxx_ERR_INVALID;
+            return;
+        }
+        sfdp->sizeChip = (uint32_t)1 << ((dw[1] & 0x7FFFFFFF) - 3);
+    }
+    else
+    {
+        sfdp->sizeChip = (dw[1] >> 3) + 1;
+    }
+
+    /* DWORD3/4 : fast read mode 1-4-4, 1-1-4, 1-1-2, 1-2-2 */
+    if (dw[0] & (1UL << 16)) W25Qxx_SFDP_ReadMode(&sfdp->read[W25QXX_SFDP_READ_112], dw[3] & 0xFFFF);
+    if (dw[0] & (1UL << 20)) W25Qxx_SFDP_ReadMode(&sfdp->read[W25QXX_SFDP_READ_122], dw[3] >> 16);
+    if (dw[0] & (1UL << 22)) W25Qxx_SFDP_ReadMode(&sfdp->read[W25QXX_SFDP_READ_114], dw[2] >> 16);
+    if (dw[0] & (1UL << 21)) W25Qxx_SFDP_ReadMode(&sfdp->read[W25QXX_SFDP_READ_144], dw[2] & 0xFFFF);
+    for (i = 4; i > 0; i--)
+    {
+        if (sfdp->read[i - 1].cmd != 0x00)
+        {
+            sfdp->fastRead = i - 1;
+            break;
+        }
+    }
+
+    /* DWORD8/9 : erase type size (2^N Byte) and instruction */
+    for (i = 0; i < 4; i++)
+    {
+        mult = (dw[7 + (i >> 1)] >> ((i & 1) * 16)) & 0xFFFF;
+        if ((mult & 0xFF) == 0 || (mult & 0xFF) > 31) continue;
+        sfdp->erase[i].size = (uint32_t)1 << (mult & 0xFF);
+        sfdp->erase[i].cmd = (uint8_t)(mult >> 8);
+    }
+
+    /* DWORD10 (JESD216A) : erase typical time, max time = 2 * (multiplier + 1) * typical */
+    if (numDword >= 10)
+    {
+        mult = 2 * ((dw[9] & 0x0F) + 1);
+        for (i = 0; i < 4; i++)
+        {
+            if (sfdp->erase[i].size == 0) continue;
+            sfdp->erase[i].TypTime = W25Qxx_SFDP_EraseTime(dw[9] >> (4 + 7 * i));
+            sfdp->erase[i].MaxTime = sfdp->erase[i].TypTime * mult;
+        }
+    }
+
+    /* DWORD11 (JESD216A) : page size, page program time (8us/64us), chip erase time (16ms/256ms/4s/64s) */
+    sfdp->sizePage = W25Qxx_PAGESIZE;
+    if (numDword >= 11)
+    {
+        sfdp->sizePage = (uint16_t)(1 << ((dw[10] >> 4) & 0x0F));
+        mult = 2 * ((dw[10] & 0x0F) + 1);
+        sfdp->ProgTypTimePage = (((dw[10] >> 8) & 0x1F) + 1) * ((dw[10] & (1UL << 13)) ? 64 : 8);
+        sfdp->ProgMaxTimePage = sfdp->ProgTypTimePage * mult;
+        sfdp->EraseTypTimeChip = (((dw[10] >> 24) & 0x1F) + 1) * ((uint32_t)16 << (4 * ((dw[10] >> 29) & 0x03)));
+        sfdp->EraseMaxTimeChip = sfdp->EraseTypTimeChip * mult;
+    }
+
+    /* the driver erases 4KB sector, page program is 256 Byte */
+    for (i = 0; i < 4 && sfdp->erase[i].size != W25Qxx_SECTORSIZE; i++);
+    if (i == 4 || sfdp->sizePage != W25Qxx_PAGESIZE || sfdp->sizeChip < W25Qxx_BLOCKSIZE)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* 4 Byte address instruction : 4 Byte address instruction table, or DWORD16 (JESD216B) dedicated instruction set */
+    if (aitb)
+    {
+        W25Qxx_Read_SFDP(dev, table, aitb, 8, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        dw[0] = W25Qxx_SFDP_Get32(&table[0]);
+        if (dw[0] & (1UL << 0)) sfdp->cmdRead4B = W25Q_CMD_4BREAD;
+        if (dw[0] & (1UL << 1)) sfdp->cmdFastRead4B = W25Q_CMD_4BFASTREAD;
+        if (dw[0] & (1UL << 6)) sfdp->cmdProgram4B = W25Q_CMD_4BWPAGE;
+        for (i = 0; i < 4; i++)
+        {
+            if (dw[0] & (1UL << (9 + i))) sfdp->erase[i].cmd4B = table[4 + i];
+        }
+    }
+    else if (numDword >= 16 && (dw[15] & (1UL << 29)))
+    {
+        sfdp->cmdRead4B = W25Q_CMD_4BREAD;
+        sfdp->cmdFastRead4B = W25Q_CMD_4BFASTREAD;
+        sfdp->cmdProgram4B = W25Q_CMD_4BWPAGE;
+        for (i = 0; i < 4; i++)
+        {
+            if (sfdp->erase[i].cmd == W25Q_CMD_ESECTOR) sfdp->erase[i].cmd4B = W25Q_CMD_4BESECTOR;
+            if (sfdp->erase[i].cmd == W25Q_CMD_E64KBLOCK) sfdp->erase[i].cmd4B = W25Q_CMD_4BE64KBLOCK;
+        }
+    }
+
+    /* 4 Byte address instruction is only used by the chip > 16MB with read, program and erase instruction */
+    sfdp->addr4B = (sfdp->sizeChip > 0x1000000 && sfdp->cmdRead4B && sfdp->cmdFastRead4B && sfdp->cmdProgram4B);
+    if (!sfdp->addr4B)
+    {
+        sfdp->cmdRead4B = 0x00;
+        sfdp->cmdFastRead4B = 0x00;
+        sfdp->cmdProgram4B = 0x00;
+        for (i = 0; i < 4; i++) sfdp->erase[i].cmd4B = 0x00;
+    }
+
+    /* chip parameter of the chip list, the chip not in the list needs the timing of SFDP */
+    W25Qxx_QueryChip(dev, err);
+    if (*err != W25Qxx_ERR_NONE)
+    {
+        if (numDword < 11) return;
+        memset(&dev->info, 0, sizeof(W25Qxx_INFO_t));
+        dev->info.type = UNKNOWN;
+    }
+
+    /* geometry */
+    dev->sizePage = sfdp->sizePage;
+    dev->sizeSector = W25Qxx_SECTORSIZE;
+    dev->sizeBlock = W25Qxx_BLOCKSIZE;
+    dev->sizeChip = sfdp->sizeChip;
+    dev->numPage = dev->sizeChip / dev->sizePage;
+    dev->numSector = dev->sizeChip / dev->sizeSector;
+    dev->numBlock = dev->sizeChip / dev->sizeBlock;
+    dev->numDie = (dev->sizeChip > W25Qxx_DIESIZE) ? (uint8_t)(dev->sizeChip / W25Qxx_DIESIZE) : 1;
+
+    /* max time of the chip instead of the chip list (ms) */
+    for (i = 0; i < 4; i++)
+    {
+        if (sfdp->erase[i].MaxTime == 0) continue;
+        if (sfdp->erase[i].size == W25Qxx_SECTORSIZE) dev->info.EraseMaxTimeSector = sfdp->erase[i].MaxTime;
+        if (sfdp->erase[i].size == W25Qxx_BLOCKSIZE / 2) dev->info.EraseMaxTimeBlock32 = sfdp->erase[i].MaxTime;
+        if (sfdp->erase[i].size == W25Qxx_BLOCKSIZE) dev->info.EraseMaxTimeBlock64 = sfdp->erase[i].MaxTime;
+    }
+    if (sfdp->ProgMaxTimePage) dev->info.ProgrMaxTimePage = (sfdp->ProgMaxTimePage + 999) / 1000;
+    if (sfdp->EraseMaxTimeChip) dev->info.EraseMaxTimeChip = sfdp->EraseMaxTimeChip;
+
     *err = W25Qxx_ERR_NONE;
 }
+#endif
 void W25Qxx_config(W25Qxx_t *dev, W25Qxx_ERR *err)																					/* Config W25Qxx Chip */
 {
     /* Determine the validity of the port */
@@ -1824,14 +2750,24 @@ void W25Qxx_config(W25Qxx_t *dev, W25Qxx_ERR *err)																					/* Config
         return;
     }
 
+#if W25QXX_AUTO_POWER
+    /* the power state is unknown, the first command releases deep power-down */
+    memset(&dev->power, 0, sizeof(W25Qxx_POWER_t));
+    dev->power.state = W25Qxx_POWER_DOWN;
+#endif
+#if W25QXX_STATS
+    memset(&dev->stats, 0, sizeof(W25Qxx_STATS_t));
+#endif
+#if W25QXX_WEAR
+    memset(&dev->wear, 0, sizeof(W25Qxx_WEAR_t));
+#endif
+#if W25QXX_LATENCY
+    memset(&dev->latency, 0, sizeof(W25Qxx_LATENCY_t));
+#endif
+
     /* reset device */
     W25Qxx_Reset(dev);
 
-#if W25QXX_SUPPORT_SFDP
-
-    /* Support SFDP */
-
-#else
     /* Read Unique ID */
     dev->IDUnique = W25Qxx_ID_Unique(dev);
 
@@ -1841,9 +2777,19 @@ void W25Qxx_config(W25Qxx_t *dev, W25Qxx_ERR *err)																					/* Config
     /* Read JEDEC ID */
     dev->IDJEDEC = W25Qxx_ID_JEDEC(dev);
 
+#if W25QXX_SUPPORT_SFDP
+    /* Query SFDP, the chip list is the fallback of the chip without SFDP */
+    W25Qxx_QuerySFDP(dev, err);
+    if (*err == W25Qxx_ERR_NOTFOUND || *err == W25Qxx_ERR_INVALID) W25Qxx_QueryChip(dev, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+#else
     /* Query W25Qxx Type */
     W25Qxx_QueryChip(dev, err);
     if (*err != W25Qxx_ERR_NONE) return;
+#endif
+
+    /* Not calibrated (W25Qxx_Calibrate/W25Qxx_Calibrate_Load after config) */
+    memset(&dev->timing, 0, sizeof(W25Qxx_TIMING_t));
 
     /* Read Register */
     W25Qxx_ReadStatusRegister(dev, 1);
@@ -1863,9 +2809,139 @@ void W25Qxx_config(W25Qxx_t *dev, W25Qxx_ERR *err)																					/* Config
     {
         W25Qxx_3ByteMode(dev);
     }
+}
+/* W25Qxx Warm Start
+ * The MCU is reset but the chip keeps power, the saved descriptor replaces the reset (tRST wait),
+ * the Unique/Manufacturer/JEDEC ID reads, the chip query (SFDP) and the status register reads.
+**/
+static uint32_t W25Qxx_Warm_Sum(W25Qxx_WARM_t *warm)																				/* Checksum of descriptor */
+{
+    uint8_t *p = (uint8_t *)warm;
+    uint32_t sum = 0;
+    size_t i = 0;
+
+    for (i = 0; i < offsetof(W25Qxx_WARM_t, check); i++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + p[i];
+    }
 
+    return ~sum;
+}
+void W25Qxx_config_Save(W25Qxx_t *dev, W25Qxx_WARM_t *warm)																		/* Save configured device to warm start descriptor */
+{
+    /* padding bytes are part of the checksum */
+    memset(warm, 0, sizeof(W25Qxx_WARM_t));
+
+    warm->magic           = W25QXX_WARM_MAGIC;
+    warm->addrMode        = W25QXX_4BADDR;
+    warm->StatusRegister1 = dev->StatusRegister1;
+    warm->StatusRegister2 = dev->StatusRegister2;
+    warm->StatusRegister3 = dev->StatusRegister3;
+    warm->numDie          = dev->numDie;
+    warm->IDManufacturer  = dev->IDManufacturer;
+    warm->IDJEDEC         = dev->IDJEDEC;
+    warm->IDUnique        = dev->IDUnique;
+    warm->info            = dev->info;
+    warm->timing          = dev->timing;
+    warm->numBlock        = dev->numBlock;
+    warm->numPage         = dev->numPage;
+    warm->numSector       = dev->numSector;
+    warm->sizePage        = dev->sizePage;
+    warm->sizeSector      = dev->sizeSector;
+    warm->sizeBlock       = dev->sizeBlock;
+    warm->sizeChip        = dev->sizeChip;
+#if W25QXX_SUPPORT_SFDP
+    warm->sfdp            = dev->sfdp;
 #endif
+    warm->check           = W25Qxx_Warm_Sum(warm);
+}
+uint8_t W25Qxx_config_Warm(W25Qxx_t *dev, W25Qxx_WARM_t *warm, W25Qxx_ERR *err)													/* Config W25Qxx Chip from warm start descriptor (1 : warm start, 0 : cold start) */
+{
+    uint8_t die = 0;
+
+    /* Determine the validity of the port */
+    if (dev->port.spi_rw == NULL
+        || dev->port.spi_cs_H == NULL
+        || dev->port.spi_cs_L == NULL
+        || dev->port.spi_delayms == NULL)
+    {
+        *err = W25Qxx_ERR_HARDWARE;
+        return 0;
+    }
 
+#if W25QXX_AUTO_POWER
+    /* the power state is unknown, the first command releases deep power-down */
+    memset(&dev->power, 0, sizeof(W25Qxx_POWER_t));
+    dev->power.state = W25Qxx_POWER_DOWN;
+#endif
+#if W25QXX_STATS
+    memset(&dev->stats, 0, sizeof(W25Qxx_STATS_t));
+#endif
+#if W25QXX_WEAR
+    memset(&dev->wear, 0, sizeof(W25Qxx_WEAR_t));
+#endif
+#if W25QXX_LATENCY
+    memset(&dev->latency, 0, sizeof(W25Qxx_LATENCY_t));
+#endif
+
+    /* Determine if the descriptor is valid and of this chip (one JEDEC ID read) */
+    if (warm->magic == W25QXX_WARM_MAGIC
+        && warm->addrMode == W25QXX_4BADDR
+        && warm->check == W25Qxx_Warm_Sum(warm)
+        && warm->numDie >= 1 && warm->numDie <= 4
+        && warm->IDJEDEC == W25Qxx_ID_JEDEC(dev))
+    {
+        /* Determine if every die is idle, die 0 is selected at the end (StatusRegister1/2 are read) */
+        for (die = warm->numDie; die > 0; die--)
+        {
+            if (warm->numDie > 1) W25Qxx_DieSelect(dev, (uint8_t)(die - 1));
+            if (!(W25Qxx_ReadStatus(dev) & W25Qxx_STATUS_IDLE)) break;
+        }
+
+        /* Determine if the chip kept power : address mode (ADS) and status registers of the descriptor */
+        if (die == 0)
+        {
+            W25Qxx_ReadStatusRegister(dev, 3);
+            if ((dev->StatusRegister1 & 0xFC) != (warm->StatusRegister1 & 0xFC)
+                || (dev->StatusRegister2 & 0x7F) != (warm->StatusRegister2 & 0x7F)
+                || dev->StatusRegister3 != warm->StatusRegister3)
+            {
+                die = 1;
+            }
+        }
+
+        if (die == 0)
+        {
+            dev->IDManufacturer  = warm->IDManufacturer;
+            dev->IDJEDEC         = warm->IDJEDEC;
+            dev->IDUnique        = warm->IDUnique;
+            dev->info            = warm->info;
+            dev->timing          = warm->timing;
+            dev->numBlock        = warm->numBlock;
+            dev->numPage         = warm->numPage;
+            dev->numSector       = warm->numSector;
+            dev->sizePage        = warm->sizePage;
+            dev->sizeSector      = warm->sizeSector;
+            dev->sizeBlock       = warm->sizeBlock;
+            dev->sizeChip        = warm->sizeChip;
+            dev->numDie          = warm->numDie;
+#if W25QXX_SUPPORT_SFDP
+            dev->sfdp            = warm->sfdp;
+#endif
+            dev->activeDie       = 0;
+
+            *err = W25Qxx_ERR_NONE;
+            return 1;
+        }
+    }
+
+    /* cold start */
+    W25Qxx_config(dev, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    W25Qxx_config_Save(dev, warm);
+
+    return 0;
 }
 /* W25Qxx Suspend/Resume Test */
 void W25Qxx_SusResum_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err)
@@ -1900,20 +2976,22 @@ void W25Qxx_SusResum_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR
     W25Qxx_WriteEnable(dev);
 
     /* CS enable */
-    dev->port.spi_cs_L();
+    W25QXX_CS_L(dev);
 
     /* erase data */
+    W25QXX_STAT(dev, numEraseSector++);
+    W25QXX_WEAR_ADD(dev, numEraseSector, SectorAddr / dev->sizeSector, 1);
 #if W25QXX_4BADDR
-    dev->port.spi_rw(W25Q_CMD_ESECTOR);
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 24));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 8));
-    dev->port.spi_rw((uint8_t)SectorAddr);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ESECTOR);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((SectorAddr) >> 24));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((SectorAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((SectorAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)SectorAddr);
 #else
-    dev->port.spi_rw(W25Q_CMD_ESECTOR);
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 16));
-    dev->port.spi_rw((uint8_t)((SectorAddr) >> 8));
-    dev->port.spi_rw((uint8_t)SectorAddr);
+    W25QXX_SPI(dev, byteCmd, W25Q_CMD_ESECTOR);
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((SectorAddr) >> 16));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)((SectorAddr) >> 8));
+    W25QXX_SPI(dev, byteAddr, (uint8_t)SectorAddr);
 #endif
 
     /* CS disable */
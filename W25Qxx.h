@@ -26,6 +26,27 @@
  *   05-01-2023        iammingge                1. Fix function W25Qxx_ Reset timing error, resulting in invalid device restart
  *                                              2. Add W25Qxx status register to restore factory parameter function W25Qxx_ SetFactory_ WriteStatusRegister
  *                                              3. Support for multiple device mounting
+ *   10-18-2026        iammingge                1. Add erase/program start function (no wait for end) for parallel operation
+ *                                              2. Add continuous read function W25Qxx_Read_Start/Stream/Stop
+ *                                              3. Add software die select of stacked die chip (W25Q01/W25Q02)
+ *                                              4. Add error code W25Qxx_ERR_NOTFOUND/W25Qxx_ERR_FULL of storage modules
+ *                                              5. Add error code W25Qxx_ERR_CHECKSUM of integrity module
+ *                                              6. Add buffer check W25Qxx_isBlank/isProgrammable/isEqual (SIMD/word kernel),
+ *                                                 W25Qxx_Program skips the erase when the data only clears bits
+ *                                              7. Add SFDP parser W25Qxx_QuerySFDP (JESD216), W25Qxx_config takes geometry, timing
+ *                                                 and 4 Byte address instruction from SFDP
+ *                                              8. Add timing calibration W25Qxx_Calibrate, measured typical time drives the
+ *                                                 status polling schedule, optional port function spi_timeus
+ *                                              9. Add warm start W25Qxx_config_Warm, a saved device descriptor is checked with
+ *                                                 one JEDEC ID read instead of the reset and the ID/register reads
+ *                                             10. Add auto power-down W25Qxx_Power_Auto/Poll, deep power-down after idle time,
+ *                                                 release with tRES1 wait on the next access, time per power state
+ *                                             11. Add operation statistic W25Qxx_Stats_Snapshot/Reset (W25QXX_STATS), operation
+ *                                                 count, payload/overhead SPI bytes, status polls, busy time, Program decision
+ *                                             12. Add wear accounting (W25QXX_WEAR), erase count per sector of sector/block/chip
+ *                                                 erase, checkpoint and histogram in W25Qxx_Wear.c
+ *                                             13. Add latency histogram W25Qxx_Latency_Dump/Snapshot/Reset (W25QXX_LATENCY), fixed
+ *                                                 log-linear buckets per operation class timed by spi_timeus
  *
 **/
 
@@ -66,6 +87,10 @@ extern "C" {
 #define W25QXX_FASTREAD    							 0		/* 0 : No Fast Read Mode   ; 1 : Fast Read Mode */
 #define W25QXX_4BADDR      							 0		/* 0 : 3 Byte Address Mode ; 1 : 4 Byte Address Mode */
 #define W25QXX_SUPPORT_SFDP							 0		/* 0 : No support SFDP     ; 1 : Support SFDP */
+#define W25QXX_AUTO_POWER							 0		/* 0 : Manual power-down   ; 1 : Auto power-down after idle time */
+#define W25QXX_STATS								 0		/* 0 : No statistic        ; 1 : Operation statistic (dev->stats) */
+#define W25QXX_WEAR								 0		/* 0 : No wear accounting  ; 1 : Erase count per sector (dev->wear) */
+#define W25QXX_LATENCY							 0		/* 0 : No latency histogram; 1 : Latency histogram per operation (dev->latency) */
 
 /**
  * @brief W25Qxx CMD
@@ -113,6 +138,7 @@ extern "C" {
 #define W25Q_CMD_4ByteAddrDEN        				 0xE9
 #define W25Q_CMD_ENRESET             				 0x66
 #define W25Q_CMD_RESETDEV            				 0x99
+#define W25Q_CMD_DIESELECT           				 0xC2
 #define W25Q_DUMMY                   				 0xA5
 
 /**
@@ -125,6 +151,7 @@ extern "C" {
 #define W25Qxx_BLOCKSIZE						 	 0x10000
 #define W25Qxx_BLOCKPOWER							 0x10
 #define W25Qxx_SECTURITYSIZE						 0x00300
+#define W25Qxx_DIESIZE							 	 0x4000000		/* Die size of stacked die chip (W25Q01/W25Q02) */
 
 /**
  * @brief W25Qxx Address Convert
@@ -171,7 +198,10 @@ typedef enum
     W25Qxx_ERR_BLOCK64ADDRBOUND = 0x09,		         /* Block64 address out of bounds */
     W25Qxx_ERR_BLOCK32ADDRBOUND = 0x0A,		         /* Block32 address out of bounds */
     W25Qxx_ERR_WPSMODE = 0x0B,				         /* Write protect mode is error */
-    W25Qxx_ERR_HARDWARE = 0x0C				         /* SPI/QSPI BUS is hardware error */
+    W25Qxx_ERR_HARDWARE = 0x0C,				         /* SPI/QSPI BUS is hardware error */
+    W25Qxx_ERR_NOTFOUND = 0x0D,				         /* Record is not found */
+    W25Qxx_ERR_FULL = 0x0E,				             /* Storage is full */
+    W25Qxx_ERR_CHECKSUM = 0x0F				         /* Data checksum is error */
 } W25Qxx_ERR;
 
 /**
@@ -193,6 +223,34 @@ typedef enum
     W25Qxx_VOLATILE = 0x00,							 /* StatusRegister Voliate Mode */
     W25Qxx_NON_VOLATILE = 0x01 						 /* StatusRegister Non-Voliate Mode */
 } W25Qxx_SRM;                                        
+
+/**
+ * @brief W25Qxx Erase/Program Operation
+ */
+typedef enum
+{
+    W25Qxx_OP_PROGRAM_PAGE = 0x00,					 /* Program page */
+    W25Qxx_OP_ERASE_SECTOR = 0x01,					 /* Erase sector of 4k */
+    W25Qxx_OP_ERASE_BLOCK32 = 0x02,					 /* Erase block of 32k */
+    W25Qxx_OP_ERASE_BLOCK64 = 0x03					 /* Erase block of 64k */
+} W25Qxx_OP;
+
+/**
+ * @brief W25Qxx Latency Operation Class
+ */
+typedef enum
+{
+    W25Qxx_LAT_READ = 0x00,							 /* W25Qxx_Read */
+    W25Qxx_LAT_PROGRAM = 0x01,						 /* W25Qxx_Program without erase */
+    W25Qxx_LAT_PROGRAM_ERASE = 0x02,				 /* W25Qxx_Program with sector erase */
+    W25Qxx_LAT_ERASE_SECTOR = 0x03,					 /* W25Qxx_Erase_Sector */
+    W25Qxx_LAT_ERASE_BLOCK32 = 0x04,				 /* W25Qxx_Erase_Block32 */
+    W25Qxx_LAT_ERASE_BLOCK64 = 0x05,				 /* W25Qxx_Erase_Block64 */
+    W25Qxx_LAT_ERASE_CHIP = 0x06,					 /* W25Qxx_Erase_Chip */
+    W25Qxx_LAT_STATUS = 0x07,						 /* Status poll (W25Qxx_ReadStatus) */
+    W25Qxx_LAT_DIR_PROGRAM = 0x08,					 /* W25Qxx_DIR_Program_Page (every page of W25Qxx_DIR_Program) */
+    W25Qxx_LAT_NUM = 0x09							 /* Class number */
+} W25Qxx_LAT;
 													 
 /**                                                  
  * @brief W25Qxx Chip Parameter                      
@@ -207,6 +265,30 @@ typedef struct
     uint32_t EraseMaxTimeChip;      				 /* Erase Chip    max time (ms) */
 } W25Qxx_INFO_t;
 
+/**
+ * @brief W25Qxx Calibrated Timing
+ *
+ * 				W25Qxx_Calibrate measures the typical time of the chip on a scratch 64k block.
+ * 				Polling schedule : sleep 7/8 of the typical time, poll each 1/64 of the typical time (1ms at
+ * 				                   most) up to twice the typical time, then poll each 1ms up to the max time.
+ * Note:
+ * 1. The time is 0 until calibrated (or loaded by W25Qxx_Calibrate_Load), the polling is then
+ *    each 1ms as W25Qxx_isStatus.
+ * 2. The max time of W25QInfoList stays the timeout, the calibrated time only moves the polls.
+ * 3. Calibration and polling schedule need the port function spi_timeus.
+ *
+ */
+#define W25QXX_CALIBRATE_MAGIC                       0x494C4143		/* "CALI" */
+#define W25QXX_CALIBRATE_SIZE                        28				/* Saved record size (Byte) */
+
+typedef struct
+{
+    uint32_t ProgrTimePage;      					 /* Program       typical time (us) */
+    uint32_t EraseTimeSector;    					 /* Erase Sector  typical time (us) */
+    uint32_t EraseTimeBlock32;   					 /* Erase Block32 typical time (us) */
+    uint32_t EraseTimeBlock64;   					 /* Erase Block64 typical time (us) */
+} W25Qxx_TIMING_t;
+
 /**
  * @brief W25Qxx BUS Port
  */
@@ -216,8 +298,222 @@ typedef struct
     void (*spi_cs_H)(void);
     void (*spi_cs_L)(void);
     uint8_t(*spi_rw)(uint8_t data);
+    uint32_t (*spi_timeus)(void);					 /* Free running microsecond counter (optional, NULL : none) */
 } W25Qxx_PORT_t;
 
+/**
+ * @brief W25Qxx SFDP (JESD216 Serial Flash Discoverable Parameter)
+ *
+ * 				Basic flash parameter table    : density, page size, fast read mode, erase type, timing
+ * 				4 Byte address instruction table : 13h/0Ch/12h/21h/DCh instead of the extended address register
+ * Note:
+ * 1. Typical time is the value of the table, max time = 2 * (multiplier + 1) * typical time.
+ * 2. The dual/quad read modes are found for a QSPI port, the SPI port (spi_rw) reads with 03h/0Bh.
+ *
+ */
+#define W25QXX_SFDP_SIGNATURE                        0x50444653		/* "SFDP" */
+#define W25QXX_SFDP_READ_112                         0				/* Fast read mode 1-1-2 */
+#define W25QXX_SFDP_READ_122                         1				/* Fast read mode 1-2-2 */
+#define W25QXX_SFDP_READ_114                         2				/* Fast read mode 1-1-4 */
+#define W25QXX_SFDP_READ_144                         3				/* Fast read mode 1-4-4 */
+#define W25QXX_SFDP_NONE                             0xFF			/* Fast read mode is not supported */
+
+/**
+ * @brief W25Qxx SFDP Fast Read Mode
+ */
+typedef struct
+{
+    uint8_t cmd;                                     /* Instruction (0x00 : not supported) */
+    uint8_t numDummy;                                /* Dummy clocks */
+    uint8_t numMode;                                 /* Mode clocks */
+} W25Qxx_SFDP_READ_t;
+
+/**
+ * @brief W25Qxx SFDP Erase Type
+ */
+typedef struct
+{
+    uint32_t size;                                   /* Erase size (Byte, 0 : not supported) */
+    uint8_t cmd;                                     /* Instruction */
+    uint8_t cmd4B;                                   /* 4 Byte address instruction (0x00 : not supported) */
+    uint32_t TypTime;                                /* Typical time (ms) */
+    uint32_t MaxTime;                                /* Max     time (ms) */
+} W25Qxx_SFDP_ERASE_t;
+
+/**
+ * @brief W25Qxx SFDP Parameter
+ */
+typedef struct
+{
+    uint8_t revMajor;                                /* SFDP revision major */
+    uint8_t revMinor;                                /* SFDP revision minor */
+    uint8_t numDword;                                /* Basic flash parameter table length (DWORD) */
+    uint8_t addrBytes;                               /* 0 : 3 Byte only ; 1 : 3 or 4 Byte ; 2 : 4 Byte only */
+    uint8_t addr4B;                                  /* Dedicated 4 Byte address instruction set */
+    uint8_t cmdRead4B;                               /* 4 Byte address read      (0x00 : not supported) */
+    uint8_t cmdFastRead4B;                           /* 4 Byte address fast read (0x00 : not supported) */
+    uint8_t cmdProgram4B;                            /* 4 Byte address program   (0x00 : not supported) */
+    uint32_t sizeChip;                               /* Chip size (Byte) */
+    uint16_t sizePage;                               /* Page size (Byte) */
+    uint8_t fastRead;                                /* Fastest read mode (W25QXX_SFDP_READ_xxx) */
+    W25Qxx_SFDP_READ_t read[4];                      /* Fast read mode 1-1-2, 1-2-2, 1-1-4, 1-4-4 */
+    W25Qxx_SFDP_ERASE_t erase[4];                    /* Erase type 1 - 4 */
+    uint32_t ProgTypTimePage;                        /* Program    typical time (us) */
+    uint32_t ProgMaxTimePage;                        /* Program    max     time (us) */
+    uint32_t EraseTypTimeChip;                       /* Erase Chip typical time (ms) */
+    uint32_t EraseMaxTimeChip;                       /* Erase Chip max     time (ms) */
+} W25Qxx_SFDP_t;
+
+/**
+ * @brief W25Qxx Auto Power-Down (W25QXX_AUTO_POWER = 1)
+ *
+ * 				W25Qxx_Power_Poll enters deep power-down (B9h) when there was no command for the idle
+ * 				time and the chip is IDLE. The next command releases it (ABh) first and waits tRES1.
+ * 				Time per state : STANDBY (powered, including erase/program) and DOWN (deep power-down).
+ * Note:
+ * 1. W25Qxx_Power_Auto needs the port function spi_timeus, W25Qxx_Power_Poll is called by the
+ *    application (main loop or timer), not during a continuous read (W25Qxx_Read_Start/Stop).
+ * 2. The power state after W25Qxx_config is DOWN (unknown), the first command releases the chip,
+ *    so a chip left in deep power-down before the MCU reset is found.
+ * 3. W25Qxx_PowerDisable/W25Qxx_PowerEnable set the state too.
+ *
+ */
+#define W25QXX_POWER_TRES1                           3				/* Release from deep power-down time (us) */
+#define W25QXX_POWER_TDP                             3				/* Enter deep power-down time (us) */
+
+/**
+ * @brief W25Qxx Power State
+ */
+typedef enum
+{
+    W25Qxx_POWER_STANDBY = 0x00,                     /* Powered */
+    W25Qxx_POWER_DOWN = 0x01                         /* Deep power-down */
+} W25Qxx_POWER;
+
+/**
+ * @brief W25Qxx Power Accounting
+ */
+typedef struct
+{
+    W25Qxx_POWER state;                              /* Power state */
+    uint32_t idleTime;                               /* Idle time before power-down (ms, 0 : no auto power-down) */
+    uint32_t lastAccess;                             /* spi_timeus of the last command */
+    uint32_t lastChange;                             /* spi_timeus of the last state time update */
+    uint64_t timeStandby;                            /* Time in STANDBY (us) */
+    uint64_t timeDown;                               /* Time in DOWN    (us) */
+    uint32_t numDown;                                /* Auto power-down number */
+    uint32_t numWake;                                /* Release on access number */
+    uint64_t timeWake;                               /* Latency added to the first access (us) */
+} W25Qxx_POWER_t;
+
+/**
+ * @brief W25Qxx Operation Statistic (W25QXX_STATS = 1)
+ *
+ * 				Operation : read/program instructions, erase instructions by size, status polls
+ * 				SPI Byte  : payload (data read/programmed) and overhead (instruction, address, dummy,
+ * 				            WEN/WRDI, extended address register write, register/ID data)
+ * 				Program   : W25Qxx_Program/Program_Security decision per sector (page), skip/direct/erase
+ * Note:
+ * 1. Busy time is the wait of W25Qxx_isStatus/isStatus_Timed for the end of erase/program, counted
+ *    by spi_timeus of the calibrated schedule, otherwise 1ms per spi_delayms(1).
+ * 2. The counters start at 0 by W25Qxx_config/config_Warm, W25Qxx_Stats_Reset clears them.
+ * 3. The release of auto power-down (ABh) and the B9h of W25Qxx_Power_Poll are instruction bytes.
+ *
+ */
+typedef struct
+{
+    uint32_t numRead;                                /* Read instruction (array/security/SFDP) */
+    uint32_t numProgram;                             /* Page program instruction (array/security) */
+    uint32_t numEraseSector;                         /* Erase Sector   instruction */
+    uint32_t numEraseBlock32;                        /* Erase Block32  instruction */
+    uint32_t numEraseBlock64;                        /* Erase Block64  instruction */
+    uint32_t numEraseChip;                           /* Erase Chip     instruction */
+    uint32_t numEraseSecurity;                       /* Erase Security instruction */
+    uint32_t numStatusPoll;                          /* Status poll (W25Qxx_ReadStatus) */
+    uint32_t numProgramSkip;                         /* Program : data already stored, no write */
+    uint32_t numProgramDirect;                       /* Program : only clears bits, no erase */
+    uint32_t numProgramErase;                        /* Program : erase and program */
+    uint64_t bytePayload;                            /* Data Byte read/programmed */
+    uint64_t byteCmd;                                /* Instruction Byte */
+    uint64_t byteAddr;                               /* Address Byte */
+    uint64_t byteDummy;                              /* Dummy Byte */
+    uint64_t byteWrite;                              /* WEN/WRDI/volatile SR write enable Byte */
+    uint64_t byteExtReg;                             /* Extended address register write Byte */
+    uint64_t byteRegister;                           /* Status register/ID/lock data Byte */
+    uint64_t timeBusy;                               /* Busy wait time (us) */
+} W25Qxx_STATS_t;
+
+/**
+ * @brief W25Qxx Wear Accounting (W25QXX_WEAR = 1)
+ *
+ * 				Every erase instruction of the main array adds one to the erase count of the sectors
+ * 				it erases : sector 1, block32 8, block64 16, chip all sectors.
+ * Note:
+ * 1. The count array (one uint32_t per sector) is given by W25Qxx_Wear_Mount of W25Qxx_Wear.c,
+ *    without it (count = NULL) only the instruction counters run.
+ * 2. The erase is counted when the instruction is sent, an erase cut by power loss is counted.
+ * 3. W25Qxx_config/config_Warm clear the accounting, mount it after the config.
+ *
+ */
+typedef struct
+{
+    uint32_t *count;                                 /* Erase count per sector (NULL : not mounted) */
+    uint32_t numSector;                              /* Sector number of count */
+    uint32_t numEraseSector;                         /* Erase Sector  instruction */
+    uint32_t numEraseBlock32;                        /* Erase Block32 instruction */
+    uint32_t numEraseBlock64;                        /* Erase Block64 instruction */
+    uint32_t numEraseChip;                           /* Erase Chip    instruction */
+    uint32_t numChange;                              /* Erase instructions since the last checkpoint */
+} W25Qxx_WEAR_t;
+
+/**
+ * @brief W25Qxx Latency Histogram (W25QXX_LATENCY = 1)
+ *
+ * 				Bucket : fixed log-linear buckets (HDR histogram with 2 significant bits), time 0 - 3us
+ * 				         one bucket each, then 4 buckets per power of 2 (bucket width 1/4 - 1/8 of
+ * 				         the time), the last bucket holds all times of 2^29us (537s) and more
+ * 				Record : one bucket increment, no lock, no allocation, no division
+ * Note:
+ * 1. The time is taken by the port function spi_timeus, without it nothing is recorded.
+ * 2. An operation is recorded when it ends without error. W25Qxx_Program records its own reads,
+ *    sector erases, page programs and status polls in their classes as well. W25Qxx_DIR_Program
+ *    is recorded per page, the time of one page program is what a log/KV append waits for.
+ * 3. A snapshot taken during a record (other context) may miss that record, the counters are
+ *    only written by the device context.
+ * 4. The counters start at 0 by W25Qxx_config/config_Warm, W25Qxx_Latency_Reset clears them.
+ * 5. RAM : 9 classes of 113 buckets, about 4.1KB per device.
+ *
+ */
+#define W25QXX_LATENCY_SUBBIT                        2				/* Bucket per power of 2 = 1 << SUBBIT */
+#define W25QXX_LATENCY_BUCKET                        (((29 - W25QXX_LATENCY_SUBBIT + 1) << W25QXX_LATENCY_SUBBIT) + 1)	/* Bucket number (2^29us and more : last bucket) */
+
+typedef struct
+{
+    uint32_t num;                                    /* Operation number */
+    uint32_t max;                                    /* Max time (us) */
+    uint64_t sum;                                    /* Sum of time (us) */
+    uint32_t bucket[W25QXX_LATENCY_BUCKET];          /* Operation number per bucket */
+} W25Qxx_LATENCY_HIST_t;
+
+typedef struct
+{
+    W25Qxx_LATENCY_HIST_t op[W25Qxx_LAT_NUM];        /* Histogram per operation class (W25Qxx_LAT) */
+} W25Qxx_LATENCY_t;
+
+/**
+ * @brief W25Qxx Latency Percentile (us)
+ */
+typedef struct
+{
+    uint32_t num;                                    /* Operation number */
+    uint32_t mean;                                   /* Mean time */
+    uint32_t p50;                                    /* 50%   of the operations are faster or equal */
+    uint32_t p90;                                    /* 90%   */
+    uint32_t p99;                                    /* 99%   */
+    uint32_t p999;                                   /* 99.9% */
+    uint32_t max;                                    /* Max time */
+} W25Qxx_LATENCY_PCT_t;
+
 /**
  * @brief W25Qxx Chip Information
  */
@@ -225,6 +521,7 @@ typedef struct
 {
     W25Qxx_INFO_t info;								 /* Chip Parameter */
     W25Qxx_PORT_t port;								 /* BUS Port */
+    W25Qxx_TIMING_t timing;							 /* Calibrated Timing */
     uint16_t IDManufacturer;						 /* Manufacturer ID */
     uint32_t IDJEDEC;								 /* JEDEC        ID */
     uint64_t IDUnique;								 /* Unique       ID */
@@ -239,8 +536,70 @@ typedef struct
     uint8_t StatusRegister2;						 /* StatusRegister 2 */
     uint8_t StatusRegister3;						 /* StatusRegister 3 */
     uint8_t ExtendedRegister;       				 /* ExtendedRegister */
+    uint8_t numDie;									 /* Die    number */
+    uint8_t activeDie;								 /* Selected die */
+#if W25QXX_SUPPORT_SFDP
+    W25Qxx_SFDP_t sfdp;								 /* SFDP Parameter */
+#endif
+#if W25QXX_AUTO_POWER
+    W25Qxx_POWER_t power;							 /* Power Accounting */
+#endif
+#if W25QXX_STATS
+    W25Qxx_STATS_t stats;							 /* Operation Statistic */
+#endif
+#if W25QXX_WEAR
+    W25Qxx_WEAR_t wear;								 /* Wear Accounting */
+#endif
+#if W25QXX_LATENCY
+    W25Qxx_LATENCY_t latency;						 /* Latency Histogram */
+#endif
 } W25Qxx_t;
 
+/**
+ * @brief W25Qxx Warm Start Descriptor
+ *
+ * 				W25Qxx_config_Save copies the configured device to the descriptor, W25Qxx_config_Warm
+ * 				restores it after a reset of the MCU (the chip keeps power and its state).
+ * 				Check : magic, checksum, address mode, JEDEC ID (one read), the chip is IDLE and
+ * 				        StatusRegister1/2/3 (ADS included) are the saved ones.
+ * 				Fail  : W25Qxx_config (cold start) and the descriptor is saved again.
+ * Note:
+ * 1. The descriptor is kept in RAM not cleared at reset (e.g. a ".noinit" section) or in
+ *    storage of the application, it does not hold the port functions.
+ * 2. A chip that is BUSY or SUSPEND (erase/program cut by the MCU reset) takes the cold start,
+ *    the reset of W25Qxx_config ends the operation.
+ * 3. StatusRegister1/2 are read by the IDLE check and StatusRegister3 once, a chip that lost power
+ *    (ADS back to the power-up address mode, volatile SR bits reset) takes the cold start.
+ *
+ */
+#define W25QXX_WARM_MAGIC                            0x4D524157		/* "WARM" */
+
+typedef struct
+{
+    uint32_t magic;									 /* W25QXX_WARM_MAGIC */
+    uint8_t addrMode;								 /* W25QXX_4BADDR of the saved device */
+    uint8_t StatusRegister1;						 /* StatusRegister 1 (BUSY/WEL are not compared) */
+    uint8_t StatusRegister2;						 /* StatusRegister 2 (SUS is not compared) */
+    uint8_t StatusRegister3;						 /* StatusRegister 3 */
+    uint8_t numDie;									 /* Die    number */
+    uint16_t IDManufacturer;						 /* Manufacturer ID */
+    uint32_t IDJEDEC;								 /* JEDEC        ID */
+    uint64_t IDUnique;								 /* Unique       ID */
+    W25Qxx_INFO_t info;								 /* Chip Parameter */
+    W25Qxx_TIMING_t timing;							 /* Calibrated Timing */
+    uint32_t numBlock;              				 /* Block  number */
+    uint32_t numPage;               				 /* Page   number */
+    uint32_t numSector;             				 /* Sector number */
+    uint16_t sizePage;				      			 /* Page   size (Byte) */
+    uint32_t sizeSector;			      			 /* Sector size (Byte) */
+    uint32_t sizeBlock;				      			 /* Block  size (Byte) */
+    uint32_t sizeChip;				      			 /* Chip   size (Byte) */
+#if W25QXX_SUPPORT_SFDP
+    W25Qxx_SFDP_t sfdp;								 /* SFDP Parameter */
+#endif
+    uint32_t check;									 /* Checksum of the members above */
+} W25Qxx_WARM_t;
+
 /**
  * @brief W25Qxx Read Manufacturer/JEDEC/Unique ID
  */
@@ -261,6 +620,7 @@ void W25Qxx_4ByteMode(W25Qxx_t *dev);
 void W25Qxx_3ByteMode(W25Qxx_t *dev);
 void W25Qxx_Suspend(W25Qxx_t *dev);
 void W25Qxx_Resume(W25Qxx_t *dev);
+void W25Qxx_DieSelect(W25Qxx_t *dev, uint8_t Die);
 
 /**
  * @brief W25Qxx Read sector/block lock of current address status
@@ -300,6 +660,7 @@ uint8_t W25Qxx_ReadStatus(W25Qxx_t *dev);
  * @brief W25Qxx read current status
  */
 void W25Qxx_isStatus(W25Qxx_t *dev, uint8_t Select_Status, uint32_t timeout, W25Qxx_ERR *err);
+void W25Qxx_isStatus_Timed(W25Qxx_t *dev, uint8_t Select_Status, W25Qxx_OP Op, uint32_t timeout, W25Qxx_ERR *err);
 
 /**
  * @brief W25Qxx Sector/Blcok Lock protect for " WPS = 1 "
@@ -326,11 +687,72 @@ void W25Qxx_DIR_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteA
 void W25Qxx_Program(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
 void W25Qxx_Program_Security(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err);
 
+/**
+ * @brief W25Qxx Main Storage erase/program start function (no wait for end, poll BUSY with W25Qxx_isStatus)
+ */
+void W25Qxx_Erase_Block64_Start(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err);
+void W25Qxx_Erase_Block32_Start(W25Qxx_t *dev, uint32_t Block32Addr, W25Qxx_ERR *err);
+void W25Qxx_Erase_Sector_Start(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err);
+void W25Qxx_DIR_Program_Page_Start(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err);
+
+/**
+ * @brief W25Qxx Main Storage continuous read function (one CS enabled transfer of any length)
+ */
+void W25Qxx_Read_Start(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err);
+void W25Qxx_Read_Stream(W25Qxx_t *dev, uint8_t *pBuffer, uint32_t NumByteToRead);
+void W25Qxx_Read_Stop(W25Qxx_t *dev);
+
+/**
+ * @brief W25Qxx buffer check function (AVX2/SSE2/NEON or machine word kernel, selected at compile time)
+ */
+uint8_t W25Qxx_isBlank(const uint8_t *pBuffer, uint32_t NumByte);
+uint8_t W25Qxx_isProgrammable(const uint8_t *pOld, const uint8_t *pNew, uint32_t NumByte);
+uint8_t W25Qxx_isEqual(const uint8_t *pBuffer1, const uint8_t *pBuffer2, uint32_t NumByte);
+
+/**
+ * @brief W25Qxx timing calibration function (the scratch 64k block is erased, the record is saved in a security register)
+ */
+void W25Qxx_Calibrate(W25Qxx_t *dev, uint32_t Block64Addr, W25Qxx_ERR *err);
+void W25Qxx_Calibrate_Save(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err);
+void W25Qxx_Calibrate_Load(W25Qxx_t *dev, uint32_t ByteAddr, W25Qxx_ERR *err);
+uint32_t W25Qxx_OpTime(W25Qxx_t *dev, W25Qxx_OP Op);
+
+#if W25QXX_AUTO_POWER
+/**
+ * @brief W25Qxx auto power-down function
+ */
+void W25Qxx_Power_Auto(W25Qxx_t *dev, uint32_t IdleTime, W25Qxx_ERR *err);
+void W25Qxx_Power_Poll(W25Qxx_t *dev);
+#endif
+
+#if W25QXX_STATS
+/**
+ * @brief W25Qxx operation statistic function
+ */
+void W25Qxx_Stats_Snapshot(W25Qxx_t *dev, W25Qxx_STATS_t *stats);
+void W25Qxx_Stats_Reset(W25Qxx_t *dev);
+#endif
+
+#if W25QXX_LATENCY
+/**
+ * @brief W25Qxx latency histogram function
+ */
+void W25Qxx_Latency_Snapshot(W25Qxx_t *dev, W25Qxx_LATENCY_t *latency);
+void W25Qxx_Latency_Reset(W25Qxx_t *dev);
+uint32_t W25Qxx_Latency_Percentile(const W25Qxx_LATENCY_HIST_t *hist, uint32_t PerMille);
+void W25Qxx_Latency_Dump(W25Qxx_t *dev, W25Qxx_LATENCY_PCT_t *pct);
+#endif
+
 /**
  * @brief W25Qxx config function
  */
 void W25Qxx_QueryChip(W25Qxx_t *dev, W25Qxx_ERR *err);
+#if W25QXX_SUPPORT_SFDP
+void W25Qxx_QuerySFDP(W25Qxx_t *dev, W25Qxx_ERR *err);
+#endif
 void W25Qxx_config(W25Qxx_t *dev, W25Qxx_ERR *err);
+void W25Qxx_config_Save(W25Qxx_t *dev, W25Qxx_WARM_t *warm);
+uint8_t W25Qxx_config_Warm(W25Qxx_t *dev, W25Qxx_WARM_t *warm, W25Qxx_ERR *err);
 void W25Qxx_SusResum_Erase_Sector(W25Qxx_t *dev, uint32_t SectorAddr, W25Qxx_ERR *err);
 
 #ifdef __cplusplus
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Atomic.c
+ * @brief   W25Qxx power-fail atomic program
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Atomic.h"
+#include <string.h>
+
+/* Commit record
+ * | magic (4) | target (4) | crc32c (4) | seq (4) | check (4) | done (4) | reserved (8) |
+ * check : crc32c of magic ~ seq
+ * done  : 0xFFFFFFFF -> 0x00000000 when the target sector is written
+**/
+#define W25QXX_ATOMIC_CHECK   16
+#define W25QXX_ATOMIC_DONE    20
+
+/* Atomic Cache */
+static uint8_t W25QXX_ATOMIC_BUF[W25Qxx_PAGESIZE];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_Atomic_RecordAddr(W25Qxx_ATOMIC_t *at, uint32_t slot)										/* Byte address of commit record slot */
+{
+    return at->recordSector * at->dev->sizeSector + slot * W25QXX_ATOMIC_RECORD;
+}
+static uint32_t W25Qxx_Atomic_Copy(W25Qxx_ATOMIC_t *at, uint32_t SrcSector, uint32_t DstSector, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Copy sector merged with data, return crc32c */
+{
+    uint32_t src = SrcSector * at->dev->sizeSector;
+    uint32_t dst = DstSector * at->dev->sizeSector;
+    uint32_t crc = 0;
+    uint32_t off = 0;
+    uint32_t i = 0;
+
+    for (off = 0; off < at->dev->sizeSector; off += at->dev->sizePage)
+    {
+        W25Qxx_Read(at->dev, W25QXX_ATOMIC_BUF, src + off, at->dev->sizePage, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+
+        /* merge the new data of this page */
+        for (i = 0; i < at->dev->sizePage; i++)
+        {
+            if (src + off + i >= ByteAddr && src + off + i < ByteAddr + NumByte) W25QXX_ATOMIC_BUF[i] = pBuffer[src + off + i - ByteAddr];
+        }
+        crc = W25Qxx_CRC32C(crc, W25QXX_ATOMIC_BUF, at->dev->sizePage);
+
+        /* an erased page is not programmed */
+        if (W25Qxx_isBlank(W25QXX_ATOMIC_BUF, at->dev->sizePage)) continue;
+
+        W25Qxx_DIR_Program_Page(at->dev, W25QXX_ATOMIC_BUF, dst + off, at->dev->sizePage, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+    }
+
+    return crc;
+}
+static void W25Qxx_Atomic_Finish(W25Qxx_ATOMIC_t *at, uint32_t Target, uint32_t slot, W25Qxx_ERR *err)				/* Write the scratch sector to the target and mark the record done */
+{
+    uint8_t done[4] = {0x00, 0x00, 0x00, 0x00};
+
+    W25Qxx_Erase_Sector(at->dev, Target, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    W25Qxx_Atomic_Copy(at, at->scratchSector, Target, NULL, 0, 0, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    W25Qxx_DIR_Program_Page(at->dev, done, W25Qxx_Atomic_RecordAddr(at, slot) + W25QXX_ATOMIC_DONE, 4, err);
+}
+static void W25Qxx_Atomic_Scratch(W25Qxx_ATOMIC_t *at, W25Qxx_ERR *err)								/* Erased scratch sector : wait for the background erase, else erase now */
+{
+    *err = W25Qxx_ERR_NONE;
+    if (at->busy)
+    {
+        W25Qxx_isStatus(at->dev, W25Qxx_STATUS_IDLE, at->dev->info.EraseMaxTimeSector, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        at->busy = 0;
+        at->erased = 1;
+    }
+    if (at->erased) return;
+
+    W25Qxx_Erase_Sector(at->dev, at->scratchSector, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    at->erased = 1;
+}
+static void W25Qxx_Atomic_Sector(W25Qxx_ATOMIC_t *at, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Atomic write of one sector */
+{
+    uint32_t target = ByteAddr / at->dev->sizeSector;
+    uint32_t crc = 0;
+
+    W25Qxx_Atomic_Scratch(at, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* record sector is full, no record is pending */
+    if (at->slot == at->dev->sizeSector / W25QXX_ATOMIC_RECORD)
+    {
+        W25Qxx_Erase_Sector(at->dev, at->recordSector, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        at->slot = 0;
+    }
+
+    /* stage the merged sector */
+    at->erased = 0;
+    crc = W25Qxx_Atomic_Copy(at, target, at->scratchSector, pBuffer, ByteAddr, NumByte, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* commit */
+    memset(W25QXX_ATOMIC_BUF, 0xFF, W25QXX_ATOMIC_RECORD);
+    W25Qxx_Put32(W25QXX_ATOMIC_BUF, W25QXX_ATOMIC_MAGIC);
+    W25Qxx_Put32(W25QXX_ATOMIC_BUF + 4, target);
+    W25Qxx_Put32(W25QXX_ATOMIC_BUF + 8, crc);
+    W25Qxx_Put32(W25QXX_ATOMIC_BUF + 12, at->seq);
+    W25Qxx_Put32(W25QXX_ATOMIC_BUF + W25QXX_ATOMIC_CHECK, W25Qxx_CRC32C(0, W25QXX_ATOMIC_BUF, W25QXX_ATOMIC_CHECK));
+    W25Qxx_DIR_Program_Page(at->dev, W25QXX_ATOMIC_BUF, W25Qxx_Atomic_RecordAddr(at, at->slot), W25QXX_ATOMIC_RECORD, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* copy into place */
+    W25Qxx_Atomic_Finish(at, target, at->slot, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    at->slot++;
+    at->seq++;
+    at->numWrite++;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Atomic function                                                       */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Atomic_Mount(W25Qxx_ATOMIC_t *at, W25Qxx_t *dev, uint32_t ScratchSector, uint32_t RecordSector, W25Qxx_ERR *err)
+{
+    uint32_t numSlot = dev->sizeSector / W25QXX_ATOMIC_RECORD;
+    uint32_t slot = 0;
+    uint32_t last = 0xFFFFFFFF;
+    uint8_t torn = 0;
+
+    /* Determine if the reserved sectors are valid */
+    if (ScratchSector >= dev->numSector || RecordSector >= dev->numSector || ScratchSector == RecordSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(at, 0, sizeof(W25Qxx_ATOMIC_t));
+    at->dev = dev;
+    at->scratchSector = ScratchSector;
+    at->recordSector = RecordSector;
+
+    /* find the last commit record, records are appended */
+    for (slot = 0; slot < numSlot; slot++)
+    {
+        W25Qxx_Read(dev, W25QXX_ATOMIC_BUF, W25Qxx_Atomic_RecordAddr(at, slot), W25QXX_ATOMIC_RECORD, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        if (W25Qxx_isBlank(W25QXX_ATOMIC_BUF, W25QXX_ATOMIC_RECORD)) continue;
+        at->slot = slot + 1;
+
+        /* a torn record did not erase its target, a torn erase of the record sector leaves garbage
+         * anywhere, the record sector is erased before the next commit
+         */
+        if (W25Qxx_Get32(W25QXX_ATOMIC_BUF) != W25QXX_ATOMIC_MAGIC ||
+            W25Qxx_Get32(W25QXX_ATOMIC_BUF + W25QXX_ATOMIC_CHECK) != W25Qxx_CRC32C(0, W25QXX_ATOMIC_BUF, W25QXX_ATOMIC_CHECK))
+        {
+            torn = 1;
+            continue;
+        }
+
+        last = slot;
+        at->seq = W25Qxx_Get32(W25QXX_ATOMIC_BUF + 12) + 1;
+    }
+    if (torn) at->slot = numSlot;
+    *err = W25Qxx_ERR_NONE;
+    if (last == 0xFFFFFFFF) return;
+
+    W25Qxx_Read(dev, W25QXX_ATOMIC_BUF, W25Qxx_Atomic_RecordAddr(at, last), W25QXX_ATOMIC_RECORD, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (W25Qxx_Get32(W25QXX_ATOMIC_BUF + W25QXX_ATOMIC_DONE) == 0x00000000) return;
+
+    /* roll forward, the scratch sector was complete before the record */
+    if (W25Qxx_CRC32C_Flash(dev, 0, ScratchSector * dev->sizeSector, dev->sizeSector, err) != W25Qxx_Get32(W25QXX_ATOMIC_BUF + 8))
+    {
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* the scratch sector was staged for a later write, the record is an old one whose done word
+         * came back by a torn erase of the record sector, its target was written : dropped
+         */
+        at->slot = numSlot;
+        at->numStale++;
+        return;
+    }
+    W25Qxx_Atomic_Finish(at, W25Qxx_Get32(W25QXX_ATOMIC_BUF + 4), last, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    at->numRecover++;
+}
+void W25Qxx_Atomic_Program(W25Qxx_ATOMIC_t *at, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    uint32_t sector = 0;
+    uint32_t num = 0;
+
+    /* Determine if the address > dev->sizeChip */
+    if (NumByteToWrite == 0x00 || ByteAddr >= at->dev->sizeChip || NumByteToWrite > at->dev->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the range covers a reserved sector */
+    for (sector = ByteAddr / at->dev->sizeSector; sector <= (ByteAddr + NumByteToWrite - 1) / at->dev->sizeSector; sector++)
+    {
+        if (sector == at->scratchSector || sector == at->recordSector)
+        {
+            *err = W25Qxx_ERR_INVALID;
+            return;
+        }
+    }
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByteToWrite; NumByteToWrite -= num, pBuffer += num, ByteAddr += num)
+    {
+        num = at->dev->sizeSector - (ByteAddr % at->dev->sizeSector);
+        if (num > NumByteToWrite) num = NumByteToWrite;
+
+        W25Qxx_Atomic_Sector(at, pBuffer, ByteAddr, num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+void W25Qxx_Atomic_Idle(W25Qxx_ATOMIC_t *at, W25Qxx_ERR *err)
+{
+    *err = W25Qxx_ERR_NONE;
+
+    /* background erase is running */
+    if (at->busy)
+    {
+        if ((W25Qxx_ReadStatus(at->dev) & W25Qxx_STATUS_IDLE) == 0) return;
+        at->busy = 0;
+        at->erased = 1;
+    }
+    if (at->erased) return;
+
+    W25Qxx_Erase_Sector_Start(at->dev, at->scratchSector, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    at->busy = 1;
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Atomic.h
+ * @brief   W25Qxx power-fail atomic program header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_ATOMIC_H
+#define __W25QXX_ATOMIC_H
+
+#include "W25Qxx.h"
+#include "W25Qxx_CRC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Atomic Program
+ *
+ * 				W25Qxx_Program with power-fail atomic sectors, a sector has the old or the new data after
+ * 				a power loss, the Byte not written are never lost.
+ *
+ * 				1. The target sector merged with the new data is copied to the erased scratch sector
+ * 				2. A commit record {magic, target, crc32c, seq, check} is programmed to the record sector
+ * 				3. The target sector is erased and the scratch sector is copied back
+ * 				4. The done word of the commit record is programmed to 0
+ * 				5. W25Qxx_Atomic_Idle erases the scratch sector in the background for the next write,
+ * 				   a write that finds it not erased erases it first
+ *
+ * 				Mount : the last commit record of the record sector without done word is finished by
+ * 				        copying the scratch sector again (roll forward). Without a valid record the target
+ * 				        is not erased yet and keeps the old data (roll back). A record without done word
+ * 				        whose scratch sector does not match (an old record left by a torn erase of the
+ * 				        record sector) is dropped and the record sector is erased before the next commit.
+ * Note:
+ * 1. A write of several sectors is atomic per sector.
+ * 2. A write costs one more sector program (the scratch sector) than W25Qxx_Program when W25Qxx_Atomic_Idle
+ *    erased the scratch sector, else one more sector erase too.
+ * 3. The scratch sector and the record sector are reserved, a write to them is W25Qxx_ERR_INVALID.
+ * 4. W25Qxx_Atomic_Idle starts the erase and returns, call it when nothing else accesses the chip.
+ *
+ */
+#define W25QXX_ATOMIC_RECORD                         32		/* Commit record size (Byte) */
+#define W25QXX_ATOMIC_MAGIC                          0x4D4F543Cu	/* "<TOM" */
+
+/**
+ * @brief W25Qxx Atomic Program Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t scratchSector;                          /* Scratch sector */
+    uint32_t recordSector;                           /* Commit record sector */
+    uint32_t slot;                                   /* Next commit record slot */
+    uint32_t seq;                                    /* Next commit record seq */
+    uint32_t numWrite;                               /* Committed sector */
+    uint8_t erased;                                  /* Scratch sector is erased */
+    uint8_t busy;                                    /* Background erase of the scratch sector is running */
+    uint32_t numRecover;                             /* Sector finished at mount */
+    uint32_t numStale;                               /* Record dropped at mount (scratch sector does not match) */
+} W25Qxx_ATOMIC_t;
+
+/**
+ * @brief W25Qxx Atomic Program function
+ */
+void W25Qxx_Atomic_Mount(W25Qxx_ATOMIC_t *at, W25Qxx_t *dev, uint32_t ScratchSector, uint32_t RecordSector, W25Qxx_ERR *err);
+void W25Qxx_Atomic_Program(W25Qxx_ATOMIC_t *at, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Atomic_Idle(W25Qxx_ATOMIC_t *at, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Bus.c
+ * @brief   W25Qxx shared SPI bus
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Bus.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static void W25Qxx_Bus_End(W25Qxx_BUS_JOB_t *job, W25Qxx_ERR err)													/* End job */
+{
+    job->type    = W25Qxx_BUS_JOB_NONE;
+    job->started = 0;
+    *job->err    = err;
+}
+static void W25Qxx_Bus_Step(W25Qxx_BUS_t *bus, uint8_t id)															/* Start next step of job */
+{
+    W25Qxx_t *dev = bus->dev[id];
+    W25Qxx_BUS_JOB_t *job = &bus->job[id];
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+    uint32_t numSector = dev->sizeBlock / dev->sizeSector;
+    uint32_t num = 0;
+
+    if (job->type == W25Qxx_BUS_JOB_PROGRAM)
+    {
+        /* no beyond page address */
+        num = dev->sizePage - (job->Addr % dev->sizePage);
+        if (num > job->Num) num = job->Num;
+
+        W25Qxx_DIR_Program_Page_Start(dev, job->pBuffer, job->Addr, (uint16_t)num, &err);
+        if (err != W25Qxx_ERR_NONE)
+        {
+            W25Qxx_Bus_End(job, err);
+            return;
+        }
+        job->pBuffer += num;
+        job->Addr    += num;
+        job->Num     -= num;
+        job->timeout  = dev->info.ProgrMaxTimePage;
+    }
+    else
+    {
+        /* aligned 64KB block */
+        if ((job->Addr % numSector) == 0 && job->Num >= numSector)
+        {
+            W25Qxx_Erase_Block64_Start(dev, job->Addr / numSector, &err);
+            num = numSector;
+            job->timeout = dev->info.EraseMaxTimeBlock64;
+        }
+        /* aligned 32KB block, when it is faster than its sectors */
+        else if ((job->Addr % (numSector / 2)) == 0 && job->Num >= numSector / 2
+                 && W25Qxx_OpTime(dev, W25Qxx_OP_ERASE_BLOCK32) < W25Qxx_OpTime(dev, W25Qxx_OP_ERASE_SECTOR) * (numSector / 2))
+        {
+            W25Qxx_Erase_Block32_Start(dev, job->Addr / (numSector / 2), &err);
+            num = numSector / 2;
+            job->timeout = dev->info.EraseMaxTimeBlock32;
+        }
+        else
+        {
+            W25Qxx_Erase_Sector_Start(dev, job->Addr, &err);
+            num = 1;
+            job->timeout = dev->info.EraseMaxTimeSector;
+        }
+        if (err != W25Qxx_ERR_NONE)
+        {
+            W25Qxx_Bus_End(job, err);
+            return;
+        }
+        job->Addr += num;
+        job->Num  -= num;
+    }
+
+    job->started = 1;
+    job->start   = (dev->port.spi_timeus != NULL) ? dev->port.spi_timeus() : 0;
+    job->time    = 0;
+    bus->numStep++;
+}
+static uint8_t W25Qxx_Bus_Check(W25Qxx_BUS_t *bus, uint8_t id, W25Qxx_ERR *err)									/* Check device id */
+{
+    if (id >= bus->num)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return 0;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+    return 1;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Bus function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Bus_Init(W25Qxx_BUS_t *bus)
+{
+    memset(bus, 0, sizeof(W25Qxx_BUS_t));
+}
+uint8_t W25Qxx_Bus_Attach(W25Qxx_BUS_t *bus, W25Qxx_t *dev, W25Qxx_ERR *err)
+{
+    /* Determine if the bus is full */
+    if (bus->num >= W25QXX_BUS_DEVICE)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return W25QXX_BUS_ALL;
+    }
+
+    bus->dev[bus->num] = dev;
+
+    *err = W25Qxx_ERR_NONE;
+    return bus->num++;
+}
+uint8_t W25Qxx_Bus_Poll(W25Qxx_BUS_t *bus)
+{
+    W25Qxx_BUS_JOB_t *job;
+    uint8_t running = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < bus->num; i++)
+    {
+        job = &bus->job[i];
+        if (job->type == W25Qxx_BUS_JOB_NONE) continue;
+
+        /* current step is running */
+        if (job->started)
+        {
+            bus->numPoll++;
+            if (W25Qxx_ReadStatus(bus->dev[i]) & (W25Qxx_STATUS_BUSY | W25Qxx_STATUS_BUSY_AND_SUSPEND))
+            {
+                /* step time by the port clock, else counted by W25Qxx_Bus_Tick */
+                if (bus->dev[i]->port.spi_timeus != NULL) job->time = (bus->dev[i]->port.spi_timeus() - job->start) / 1000;
+                if (job->time > job->timeout)
+                {
+                    W25Qxx_Bus_End(job, W25Qxx_ERR_STATUS);
+                    continue;
+                }
+                running++;
+                continue;
+            }
+            job->started = 0;
+
+            /* job end */
+            if (job->Num == 0)
+            {
+                W25Qxx_Bus_End(job, W25Qxx_ERR_NONE);
+                continue;
+            }
+        }
+
+        /* next step */
+        W25Qxx_Bus_Step(bus, i);
+        if (job->type != W25Qxx_BUS_JOB_NONE) running++;
+    }
+
+    return running;
+}
+void W25Qxx_Bus_Wait(W25Qxx_BUS_t *bus, uint8_t id, W25Qxx_ERR *err)
+{
+    /* Determine if the id is valid */
+    if (id != W25QXX_BUS_ALL && !W25Qxx_Bus_Check(bus, id, err)) return;
+
+    /* a job that ends here writes its result to its own err (may be this one) */
+    *err = W25Qxx_ERR_NONE;
+    while (W25Qxx_Bus_Poll(bus))
+    {
+        if (id != W25QXX_BUS_ALL && bus->job[id].type == W25Qxx_BUS_JOB_NONE) break;
+
+        bus->dev[0]->port.spi_delayms(1);
+        W25Qxx_Bus_Tick(bus, 1);
+    }
+}
+void W25Qxx_Bus_Tick(W25Qxx_BUS_t *bus, uint32_t ms)
+{
+    uint8_t i = 0;
+
+    /* a device with spi_timeus measures the step time in W25Qxx_Bus_Poll */
+    for (i = 0; i < bus->num; i++)
+    {
+        if (bus->job[i].started && bus->dev[i]->port.spi_timeus == NULL) bus->job[i].time += ms;
+    }
+}
+void W25Qxx_Bus_Read(W25Qxx_BUS_t *bus, uint8_t id, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err)
+{
+    /* Determine if the id is valid */
+    if (!W25Qxx_Bus_Check(bus, id, err)) return;
+
+    /* Wait for the job of the device, the other devices go on */
+    if (bus->job[id].type != W25Qxx_BUS_JOB_NONE)
+    {
+        W25Qxx_Bus_Wait(bus, id, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    W25Qxx_Read(bus->dev[id], pBuffer, ByteAddr, NumByteToRead, err);
+}
+void W25Qxx_Bus_DIR_Program(W25Qxx_BUS_t *bus, uint8_t id, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    W25Qxx_BUS_JOB_t *job;
+
+    /* Determine if the id is valid */
+    if (!W25Qxx_Bus_Check(bus, id, err)) return;
+
+    /* Determine if the number is 0 */
+    if (NumByteToWrite == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= bus->dev[id]->sizeChip || NumByteToWrite > bus->dev[id]->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    /* Wait for the running job of the device */
+    job = &bus->job[id];
+    if (job->type != W25Qxx_BUS_JOB_NONE)
+    {
+        W25Qxx_Bus_Wait(bus, id, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    job->type    = W25Qxx_BUS_JOB_PROGRAM;
+    job->pBuffer = pBuffer;
+    job->Addr    = ByteAddr;
+    job->Num     = NumByteToWrite;
+    job->err     = err;
+    *err = W25Qxx_ERR_NONE;
+
+    /* start first step */
+    W25Qxx_Bus_Step(bus, id);
+}
+void W25Qxx_Bus_Erase(W25Qxx_BUS_t *bus, uint8_t id, uint32_t SectorAddr, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    W25Qxx_BUS_JOB_t *job;
+
+    /* Determine if the id is valid */
+    if (!W25Qxx_Bus_Check(bus, id, err)) return;
+
+    /* Determine if the number is 0 */
+    if (NumSector == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if Sector Addrress Bound */
+    if (SectorAddr >= bus->dev[id]->numSector || NumSector > bus->dev[id]->numSector - SectorAddr)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    /* Wait for the running job of the device */
+    job = &bus->job[id];
+    if (job->type != W25Qxx_BUS_JOB_NONE)
+    {
+        W25Qxx_Bus_Wait(bus, id, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    job->type    = W25Qxx_BUS_JOB_ERASE;
+    job->pBuffer = NULL;
+    job->Addr    = SectorAddr;
+    job->Num     = NumSector;
+    job->err     = err;
+    *err = W25Qxx_ERR_NONE;
+
+    /* start first step */
+    W25Qxx_Bus_Step(bus, id);
+}
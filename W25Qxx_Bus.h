@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Bus.h
+ * @brief   W25Qxx shared SPI bus header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_BUS_H
+#define __W25QXX_BUS_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Shared SPI Bus
+ *
+ * 				Several devices on one SPI bus with separate CS lines. The bus is only needed to
+ * 				send a command and to poll BUSY, so every device runs one program/erase job in
+ * 				the background and W25Qxx_Bus_Poll advances the jobs of all devices in turn.
+ *
+ * 				Program : W25Qxx_DIR_Program split into pages, one page is started per step.
+ * 				Erase   : sector range, aligned 64KB blocks are erased by W25Qxx_Erase_Block64,
+ * 				          aligned 32KB blocks by W25Qxx_Erase_Block32 when W25Qxx_OpTime is shorter.
+ * 				Read    : served at once, waits (and polls the other devices) only when the job of
+ * 				          the same device is still running.
+ * Note:
+ * 1. The devices must be configured by W25Qxx_config before W25Qxx_Bus_Attach.
+ * 2. The buffer and err of a job must stay valid until the job ends, err is written at the end.
+ * 3. A new job on a device with a running job waits for the running job first.
+ * 4. W25Qxx_Bus_Wait polls with the 1ms spi_delayms granularity of W25Qxx_isStatus, the step
+ *    time limit is the max time of W25QInfoList.
+ * 5. The step time is measured by spi_timeus, without it W25Qxx_Bus_Wait counts its delays and an
+ *    application that calls W25Qxx_Bus_Poll itself counts the time by W25Qxx_Bus_Tick (e.g. 1ms timer).
+ * 6. W25Qxx_Bus_Wait only writes its own result (invalid id) to err, a job that shares err writes
+ *    its result at the end, a new job is not started after the failure of the job it waited for.
+ *
+ */
+#define W25QXX_BUS_DEVICE                            2		/* Number of devices on the bus */
+#define W25QXX_BUS_ALL                               0xFF	/* W25Qxx_Bus_Wait : all devices */
+
+/**
+ * @brief W25Qxx Bus Job type
+ */
+typedef enum
+{
+    W25Qxx_BUS_JOB_NONE     = 0x00,                  /* No job */
+    W25Qxx_BUS_JOB_PROGRAM  = 0x01,                  /* Direct program */
+    W25Qxx_BUS_JOB_ERASE    = 0x02,                  /* Sector range erase */
+} W25Qxx_BUS_JOB;
+
+/**
+ * @brief W25Qxx Bus Job
+ */
+typedef struct
+{
+    W25Qxx_BUS_JOB type;                             /* Job type */
+    uint8_t started;                                 /* Current step is started */
+    uint8_t *pBuffer;                                /* Next data (program) */
+    uint32_t Addr;                                   /* Next byte address (program) / sector address (erase) */
+    uint32_t Num;                                    /* Remaining byte (program) / sector (erase) */
+    uint32_t start;                                  /* spi_timeus at the start of current step */
+    uint32_t time;                                   /* Wait time of current step (ms) */
+    uint32_t timeout;                                /* Max time of current step (ms) */
+    W25Qxx_ERR *err;                                 /* Job result */
+} W25Qxx_BUS_JOB_t;
+
+/**
+ * @brief W25Qxx Bus Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev[W25QXX_BUS_DEVICE];                /* Device */
+    W25Qxx_BUS_JOB_t job[W25QXX_BUS_DEVICE];         /* Background job of device */
+    uint8_t num;                                     /* Device number */
+    uint32_t numStep;                                /* Started program/erase steps */
+    uint32_t numPoll;                                /* BUSY polls */
+} W25Qxx_BUS_t;
+
+/**
+ * @brief W25Qxx Bus function
+ */
+void W25Qxx_Bus_Init(W25Qxx_BUS_t *bus);
+uint8_t W25Qxx_Bus_Attach(W25Qxx_BUS_t *bus, W25Qxx_t *dev, W25Qxx_ERR *err);
+void W25Qxx_Bus_Read(W25Qxx_BUS_t *bus, uint8_t id, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err);
+void W25Qxx_Bus_DIR_Program(W25Qxx_BUS_t *bus, uint8_t id, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Bus_Erase(W25Qxx_BUS_t *bus, uint8_t id, uint32_t SectorAddr, uint32_t NumSector, W25Qxx_ERR *err);
+uint8_t W25Qxx_Bus_Poll(W25Qxx_BUS_t *bus);
+void W25Qxx_Bus_Wait(W25Qxx_BUS_t *bus, uint8_t id, W25Qxx_ERR *err);
+void W25Qxx_Bus_Tick(W25Qxx_BUS_t *bus, uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_CRC.c
+ * @brief   W25Qxx CRC32/CRC32C/SHA-256 of RAM buffer and flash range
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *   10-18-2026        iammingge                1. Add CRC32, SHA-256 and streaming W25Qxx_Checksum of flash range
+ *                                              2. Add slice-by-8 and SSE4.2/ARMv8 CRC kernels
+ *
+**/
+
+#include "W25Qxx_CRC.h"
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+#include <string.h>
+
+/* CRC32 table (reflected polynomial 0xEDB88320) */
+static const uint32_t W25QXX_CRC32_TABLE[256] = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+    0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+    0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+    0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+    0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+    0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+    0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+    0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+    0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+    0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+    0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+    0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+    0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+    0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+    0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+    0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+    0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+    0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+    0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+    0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+    0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+    0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+/* CRC32C table (reflected polynomial 0x82F63B78) */
+static const uint32_t W25QXX_CRC32C_TABLE[256] = {
+    0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C, 0x26A1E7E8, 0xD4CA64EB,
+    0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B, 0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24,
+    0x105EC76F, 0xE235446C, 0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+    0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC, 0xBC267848, 0x4E4DFB4B,
+    0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A, 0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35,
+    0xAA64D611, 0x580F5512, 0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+    0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD, 0x1642AE59, 0xE4292D5A,
+    0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A, 0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595,
+    0x417B1DBC, 0xB3109EBF, 0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+    0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F, 0xED03A29B, 0x1F682198,
+    0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927, 0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38,
+    0xDBFC821C, 0x2997011F, 0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+    0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E, 0x4767748A, 0xB50CF789,
+    0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859, 0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46,
+    0x7198540D, 0x83F3D70E, 0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+    0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE, 0xDDE0EB2A, 0x2F8B6829,
+    0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C, 0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93,
+    0x082F63B7, 0xFA44E0B4, 0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+    0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B, 0xB4091BFF, 0x466298FC,
+    0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C, 0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033,
+    0xA24BB5A6, 0x502036A5, 0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+    0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975, 0x0E330A81, 0xFC588982,
+    0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D, 0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622,
+    0x38CC2A06, 0xCAA7A905, 0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+    0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8, 0xE52CC12C, 0x1747422F,
+    0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF, 0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0,
+    0xD3D3E1AB, 0x21B862A8, 0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+    0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78, 0x7FAB5E8C, 0x8DC0DD8F,
+    0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE, 0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1,
+    0x69E9F0D5, 0x9B8273D6, 0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+    0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69, 0xD5CF889D, 0x27A40B9E,
+    0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+
+/* SHA-256 round constant */
+static const uint32_t W25QXX_SHA256_K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+#if (W25QXX_CRC_SLICE8 == 1)
+/* slice-by-8 tables, built at first use */
+static uint32_t W25QXX_CRC32_SLICE[8][256];
+static uint32_t W25QXX_CRC32C_SLICE[8][256];
+static uint8_t W25QXX_CRC_SLICEREADY = 0;
+#endif
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_CRC_Table(const uint32_t *pTable, uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte)	/* Table driven CRC (no pre/post inversion) */
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < NumByte; i++)
+    {
+        crc = pTable[(crc ^ pBuffer[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+#if (W25QXX_CRC_SLICE8 == 1)
+static void W25Qxx_CRC_SliceBuild(uint32_t (*pSlice)[256], const uint32_t *pTable)									/* Build slice-by-8 tables */
+{
+    uint32_t i = 0;
+    uint8_t k = 0;
+
+    for (i = 0; i < 256; i++) pSlice[0][i] = pTable[i];
+    for (k = 1; k < 8; k++)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            pSlice[k][i] = (pSlice[k - 1][i] >> 8) ^ pSlice[0][pSlice[k - 1][i] & 0xFF];
+        }
+    }
+}
+static uint32_t W25Qxx_CRC_Slice8(uint32_t (*pSlice)[256], uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte)	/* Slice-by-8 CRC (no pre/post inversion) */
+{
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+
+    if (W25QXX_CRC_SLICEREADY == 0)
+    {
+        W25Qxx_CRC_SliceBuild(W25QXX_CRC32_SLICE, W25QXX_CRC32_TABLE);
+        W25Qxx_CRC_SliceBuild(W25QXX_CRC32C_SLICE, W25QXX_CRC32C_TABLE);
+        W25QXX_CRC_SLICEREADY = 1;
+    }
+
+    for (; NumByte >= 8; NumByte -= 8, pBuffer += 8)
+    {
+        lo = crc ^ ((uint32_t)pBuffer[0] | ((uint32_t)pBuffer[1] << 8) | ((uint32_t)pBuffer[2] << 16) | ((uint32_t)pBuffer[3] << 24));
+        hi = (uint32_t)pBuffer[4] | ((uint32_t)pBuffer[5] << 8) | ((uint32_t)pBuffer[6] << 16) | ((uint32_t)pBuffer[7] << 24);
+        crc = pSlice[7][lo & 0xFF] ^ pSlice[6][(lo >> 8) & 0xFF] ^ pSlice[5][(lo >> 16) & 0xFF] ^ pSlice[4][lo >> 24] ^
+              pSlice[3][hi & 0xFF] ^ pSlice[2][(hi >> 8) & 0xFF] ^ pSlice[1][(hi >> 16) & 0xFF] ^ pSlice[0][hi >> 24];
+    }
+
+    return W25Qxx_CRC_Table(pSlice[0], crc, pBuffer, NumByte);
+}
+#endif
+static uint32_t W25Qxx_SHA256_Ror(uint32_t x, uint8_t n)															/* Rotate right */
+{
+    return (x >> n) | (x << (32 - n));
+}
+static void W25Qxx_SHA256_Block(W25Qxx_SHA256_t *ctx, const uint8_t *pBlock)										/* SHA-256 compression of one 64 Byte block */
+{
+    uint32_t w[64];
+    uint32_t s[8];
+    uint32_t t1 = 0;
+    uint32_t t2 = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)pBlock[4 * i] << 24) | ((uint32_t)pBlock[4 * i + 1] << 16) | ((uint32_t)pBlock[4 * i + 2] << 8) | pBlock[4 * i + 3];
+    }
+    for (i = 16; i < 64; i++)
+    {
+        w[i] = w[i - 16] + w[i - 7] +
+               (W25Qxx_SHA256_Ror(w[i - 15], 7) ^ W25Qxx_SHA256_Ror(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (W25Qxx_SHA256_Ror(w[i - 2], 17) ^ W25Qxx_SHA256_Ror(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+
+    for (i = 0; i < 8; i++) s[i] = ctx->state[i];
+    for (i = 0; i < 64; i++)
+    {
+        t1 = s[7] + (W25Qxx_SHA256_Ror(s[4], 6) ^ W25Qxx_SHA256_Ror(s[4], 11) ^ W25Qxx_SHA256_Ror(s[4], 25)) +
+             ((s[4] & s[5]) ^ (~s[4] & s[6])) + W25QXX_SHA256_K[i] + w[i];
+        t2 = (W25Qxx_SHA256_Ror(s[0], 2) ^ W25Qxx_SHA256_Ror(s[0], 13) ^ W25Qxx_SHA256_Ror(s[0], 22)) +
+             ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = s[3] + t1;
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = t1 + t2;
+    }
+    for (i = 0; i < 8; i++) ctx->state[i] += s[i];
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               CRC function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+uint32_t W25Qxx_CRC32(uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte)										/* CRC32 (IEEE 802.3), crc = 0 at start, the result of a part is the crc of the next part */
+{
+#if defined(__ARM_FEATURE_CRC32)
+    uint32_t word = 0;
+
+    crc = ~crc;
+    for (; NumByte >= 4; NumByte -= 4, pBuffer += 4)
+    {
+        memcpy(&word, pBuffer, 4);
+        crc = __crc32w(crc, word);
+    }
+    return ~W25Qxx_CRC_Table(W25QXX_CRC32_TABLE, crc, pBuffer, NumByte);
+#elif (W25QXX_CRC_SLICE8 == 1)
+    return ~W25Qxx_CRC_Slice8(W25QXX_CRC32_SLICE, ~crc, pBuffer, NumByte);
+#else
+    return ~W25Qxx_CRC_Table(W25QXX_CRC32_TABLE, ~crc, pBuffer, NumByte);
+#endif
+}
+uint32_t W25Qxx_CRC32C(uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte)										/* CRC32C, crc = 0 at start, the result of a part is the crc of the next part */
+{
+#if defined(__SSE4_2__) && defined(__x86_64__)
+    uint64_t word = 0;
+    uint64_t reg = (uint32_t)~crc;
+
+    for (; NumByte >= 8; NumByte -= 8, pBuffer += 8)
+    {
+        memcpy(&word, pBuffer, 8);
+        reg = _mm_crc32_u64(reg, word);
+    }
+    return ~W25Qxx_CRC_Table(W25QXX_CRC32C_TABLE, (uint32_t)reg, pBuffer, NumByte);
+#elif defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+    uint32_t word = 0;
+
+    crc = ~crc;
+    for (; NumByte >= 4; NumByte -= 4, pBuffer += 4)
+    {
+        memcpy(&word, pBuffer, 4);
+#if defined(__SSE4_2__)
+        crc = _mm_crc32_u32(crc, word);
+#else
+        crc = __crc32cw(crc, word);
+#endif
+    }
+    return ~W25Qxx_CRC_Table(W25QXX_CRC32C_TABLE, crc, pBuffer, NumByte);
+#elif (W25QXX_CRC_SLICE8 == 1)
+    return ~W25Qxx_CRC_Slice8(W25QXX_CRC32C_SLICE, ~crc, pBuffer, NumByte);
+#else
+    return ~W25Qxx_CRC_Table(W25QXX_CRC32C_TABLE, ~crc, pBuffer, NumByte);
+#endif
+}
+uint32_t W25Qxx_CRC32C_Flash(W25Qxx_t *dev, uint32_t crc, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)		/* CRC32C of flash data (continuous read, W25QXX_CRC_CHUNK Byte chunk) */
+{
+    uint8_t digest[4];
+
+    W25Qxx_Checksum(dev, ByteAddr, NumByte, W25Qxx_HASH_CRC32C, crc, digest, err);
+    if (*err != W25Qxx_ERR_NONE) return crc;
+
+    return ((uint32_t)digest[0] << 24) | ((uint32_t)digest[1] << 16) | ((uint32_t)digest[2] << 8) | digest[3];
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               SHA-256 function                                                      */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_SHA256_Init(W25Qxx_SHA256_t *ctx)
+{
+    ctx->state[0] = 0x6A09E667;
+    ctx->state[1] = 0xBB67AE85;
+    ctx->state[2] = 0x3C6EF372;
+    ctx->state[3] = 0xA54FF53A;
+    ctx->state[4] = 0x510E527F;
+    ctx->state[5] = 0x9B05688C;
+    ctx->state[6] = 0x1F83D9AB;
+    ctx->state[7] = 0x5BE0CD19;
+    ctx->count = 0;
+}
+void W25Qxx_SHA256_Update(W25Qxx_SHA256_t *ctx, const uint8_t *pBuffer, uint32_t NumByte)
+{
+    uint32_t used = (uint32_t)(ctx->count & 63);
+    uint32_t num = 0;
+
+    ctx->count += NumByte;
+
+    /* fill the partial block */
+    if (used)
+    {
+        num = 64 - used;
+        if (num > NumByte) num = NumByte;
+        memcpy(ctx->buffer + used, pBuffer, num);
+        pBuffer += num;
+        NumByte -= num;
+        if (used + num < 64) return;
+        W25Qxx_SHA256_Block(ctx, ctx->buffer);
+    }
+
+    for (; NumByte >= 64; NumByte -= 64, pBuffer += 64) W25Qxx_SHA256_Block(ctx, pBuffer);
+    memcpy(ctx->buffer, pBuffer, NumByte);
+}
+void W25Qxx_SHA256_Final(W25Qxx_SHA256_t *ctx, uint8_t *pDigest)
+{
+    uint64_t bits = ctx->count << 3;
+    uint32_t used = (uint32_t)(ctx->count & 63);
+    uint8_t i = 0;
+
+    /* padding : 0x80, 0x00 ..., 64 bit length (big endian) */
+    ctx->buffer[used++] = 0x80;
+    if (used > 56)
+    {
+        memset(ctx->buffer + used, 0, 64 - used);
+        W25Qxx_SHA256_Block(ctx, ctx->buffer);
+        used = 0;
+    }
+    memset(ctx->buffer + used, 0, 56 - used);
+    for (i = 0; i < 8; i++) ctx->buffer[63 - i] = (uint8_t)(bits >> (8 * i));
+    W25Qxx_SHA256_Block(ctx, ctx->buffer);
+
+    for (i = 0; i < 32; i++) pDigest[i] = (uint8_t)(ctx->state[i >> 2] >> (24 - 8 * (i & 3)));
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Checksum function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Checksum(W25Qxx_t *dev, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_HASH Algo, uint32_t crc, uint8_t *pDigest, W25Qxx_ERR *err)
+{
+    uint8_t chunk[W25QXX_CRC_CHUNK];
+    W25Qxx_SHA256_t ctx;
+    uint32_t num = 0;
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= dev->sizeChip || NumByte > dev->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+    if (Algo != W25Qxx_HASH_CRC32 && Algo != W25Qxx_HASH_CRC32C && Algo != W25Qxx_HASH_SHA256)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    if (Algo == W25Qxx_HASH_SHA256) W25Qxx_SHA256_Init(&ctx);
+
+    /* hash while the data streams in */
+    *err = W25Qxx_ERR_NONE;
+    if (NumByte)
+    {
+        W25Qxx_Read_Start(dev, ByteAddr, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        for (; NumByte; NumByte -= num)
+        {
+            num = (NumByte > W25QXX_CRC_CHUNK) ? W25QXX_CRC_CHUNK : NumByte;
+            W25Qxx_Read_Stream(dev, chunk, num);
+            if (Algo == W25Qxx_HASH_CRC32)       crc = W25Qxx_CRC32(crc, chunk, num);
+            else if (Algo == W25Qxx_HASH_CRC32C) crc = W25Qxx_CRC32C(crc, chunk, num);
+            else                                 W25Qxx_SHA256_Update(&ctx, chunk, num);
+        }
+
+        W25Qxx_Read_Stop(dev);
+    }
+
+    if (Algo == W25Qxx_HASH_SHA256)
+    {
+        W25Qxx_SHA256_Final(&ctx, pDigest);
+        return;
+    }
+    pDigest[0] = (uint8_t)(crc >> 24);
+    pDigest[1] = (uint8_t)(crc >> 16);
+    pDigest[2] = (uint8_t)(crc >> 8);
+    pDigest[3] = (uint8_t)(crc);
+}
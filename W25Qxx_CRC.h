@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_CRC.h
+ * @brief   W25Qxx CRC32/CRC32C/SHA-256 of RAM buffer and flash range header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *   10-18-2026        iammingge                1. Add CRC32, SHA-256 and streaming W25Qxx_Checksum of flash range
+ *                                              2. Add slice-by-8 and SSE4.2/ARMv8 CRC kernels
+ *
+**/
+
+#ifndef __W25QXX_CRC_H
+#define __W25QXX_CRC_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Checksum
+ *
+ * 				CRC32  : IEEE 802.3 (zlib), reflected polynomial 0xEDB88320
+ * 				CRC32C : Castagnoli, reflected polynomial 0x82F63B78
+ * 				SHA-256: FIPS 180-4
+ *
+ * 				W25Qxx_Checksum hashes a flash range in one continuous read, each W25QXX_CRC_CHUNK
+ * 				Byte chunk is hashed as soon as it arrives, the range is never copied to RAM first.
+ * Note:
+ * 1. CRC kernel is chosen at compile time :
+ *    __SSE4_2__          : CRC32C by the SSE4.2 crc32 instruction (host tool)
+ *    __ARM_FEATURE_CRC32 : CRC32/CRC32C by the ARMv8 crc32 instruction
+ *    W25QXX_CRC_SLICE8=1 : slice-by-8 tables (16KB RAM, built at first use)
+ *    otherwise           : byte table (1KB per polynomial, const)
+ * 2. CRC digest is 4 Byte big endian, SHA-256 digest is 32 Byte.
+ * 3. The crc argument of W25Qxx_Checksum continues a CRC (0 at start), it is ignored by SHA-256.
+ *
+ */
+#define W25QXX_CRC_SLICE8                            0		/* 0 : Byte table          ; 1 : Slice-by-8 table */
+#define W25QXX_CRC_CHUNK                             256		/* Read chunk of W25Qxx_Checksum (Byte) */
+#define W25QXX_SHA256_SIZE                           32		/* SHA-256 digest size (Byte) */
+
+/**
+ * @brief W25Qxx Checksum algorithm
+ */
+typedef enum
+{
+    W25Qxx_HASH_CRC32  = 0x00,                       /* CRC32   (4 Byte digest) */
+    W25Qxx_HASH_CRC32C = 0x01,                       /* CRC32C  (4 Byte digest) */
+    W25Qxx_HASH_SHA256 = 0x02                        /* SHA-256 (32 Byte digest) */
+} W25Qxx_HASH;
+
+/**
+ * @brief W25Qxx SHA-256 context
+ */
+typedef struct
+{
+    uint32_t state[8];                               /* Hash state */
+    uint64_t count;                                  /* Hashed Byte number */
+    uint8_t buffer[64];                              /* Partial block */
+} W25Qxx_SHA256_t;
+
+/**
+ * @brief W25Qxx CRC function
+ */
+uint32_t W25Qxx_CRC32(uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte);
+uint32_t W25Qxx_CRC32C(uint32_t crc, const uint8_t *pBuffer, uint32_t NumByte);
+uint32_t W25Qxx_CRC32C_Flash(W25Qxx_t *dev, uint32_t crc, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err);
+
+/**
+ * @brief W25Qxx SHA-256 function
+ */
+void W25Qxx_SHA256_Init(W25Qxx_SHA256_t *ctx);
+void W25Qxx_SHA256_Update(W25Qxx_SHA256_t *ctx, const uint8_t *pBuffer, uint32_t NumByte);
+void W25Qxx_SHA256_Final(W25Qxx_SHA256_t *ctx, uint8_t *pDigest);
+
+/**
+ * @brief W25Qxx Checksum function
+ */
+void W25Qxx_Checksum(W25Qxx_t *dev, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_HASH Algo, uint32_t crc, uint8_t *pDigest, W25Qxx_ERR *err);
+
+/**
+ * @brief W25Qxx little endian field function (record header/checksum of the storage modules)
+ */
+static inline uint32_t W25Qxx_Get32(const uint8_t *p)																/* Little endian to uint32 */
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline void W25Qxx_Put32(uint8_t *p, uint32_t val)															/* uint32 to little endian */
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Die.c
+ * @brief   W25Qxx stacked die concurrency
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Die.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint8_t W25Qxx_Die_Of(W25Qxx_DIE_t *d, uint32_t ByteAddr)													/* Die of byte address */
+{
+    return (d->dev->numDie > 1) ? (uint8_t)(ByteAddr / W25Qxx_DIESIZE) : 0;
+}
+static void W25Qxx_Die_Mark(W25Qxx_DIE_t *d, uint8_t Die, uint32_t timeout)											/* Mark die busy */
+{
+    d->busy |= (uint8_t)(1 << Die);
+    d->time[Die] = 0;
+    d->timeout[Die] = timeout;
+}
+static void W25Qxx_Die_Tick(W25Qxx_DIE_t *d, W25Qxx_ERR *err)														/* Wait 1ms for the busy die */
+{
+    uint8_t i = 0;
+
+    d->dev->port.spi_delayms(1);
+
+    for (i = 0; i < d->dev->numDie; i++)
+    {
+        if (!(d->busy & (1 << i))) continue;
+
+        if (++d->time[i] > d->timeout[i])
+        {
+            d->busy &= (uint8_t)~(1 << i);
+            *err = W25Qxx_ERR_STATUS;
+            return;
+        }
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+static void W25Qxx_Die_Step(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t *ByteAddr, uint32_t end, W25Qxx_ERR *err)	/* Start next erase (pBuffer = NULL) or page program */
+{
+    W25Qxx_t *dev = d->dev;
+    uint8_t die = W25Qxx_Die_Of(d, *ByteAddr);
+    uint32_t num = 0;
+
+    if (pBuffer == NULL)
+    {
+        /* aligned 64KB block */
+        if ((*ByteAddr % dev->sizeBlock) == 0 && end - *ByteAddr >= dev->sizeBlock)
+        {
+            W25Qxx_Erase_Block64_Start(dev, *ByteAddr / dev->sizeBlock, err);
+            W25Qxx_Die_Mark(d, die, dev->info.EraseMaxTimeBlock64);
+            num = dev->sizeBlock;
+        }
+        /* aligned 32KB block, when it is faster than its sectors */
+        else if ((*ByteAddr % (dev->sizeBlock / 2)) == 0 && end - *ByteAddr >= dev->sizeBlock / 2
+                 && W25Qxx_OpTime(dev, W25Qxx_OP_ERASE_BLOCK32) < W25Qxx_OpTime(dev, W25Qxx_OP_ERASE_SECTOR) * (dev->sizeBlock / 2 / dev->sizeSector))
+        {
+            W25Qxx_Erase_Block32_Start(dev, *ByteAddr / (dev->sizeBlock / 2), err);
+            W25Qxx_Die_Mark(d, die, dev->info.EraseMaxTimeBlock32);
+            num = dev->sizeBlock / 2;
+        }
+        else
+        {
+            W25Qxx_Erase_Sector_Start(dev, *ByteAddr / dev->sizeSector, err);
+            W25Qxx_Die_Mark(d, die, dev->info.EraseMaxTimeSector);
+            num = dev->sizeSector;
+        }
+    }
+    else
+    {
+        /* no beyond page address */
+        num = dev->sizePage - (*ByteAddr % dev->sizePage);
+        if (num > end - *ByteAddr) num = end - *ByteAddr;
+
+        W25Qxx_DIR_Program_Page_Start(dev, pBuffer, *ByteAddr, (uint16_t)num, err);
+        W25Qxx_Die_Mark(d, die, dev->info.ProgrMaxTimePage);
+    }
+    if (*err != W25Qxx_ERR_NONE)
+    {
+        d->busy &= (uint8_t)~(1 << die);
+        return;
+    }
+
+    *ByteAddr += num;
+}
+static void W25Qxx_Die_Range(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Erase (pBuffer = NULL) or program range, die in parallel */
+{
+    uint32_t cur[W25QXX_DIE_MAX];
+    uint32_t end[W25QXX_DIE_MAX];
+    uint32_t last = ByteAddr + NumByte;
+    uint8_t numDie = d->dev->numDie;
+    uint8_t active = 0;
+    uint8_t started = 0;
+    uint8_t i = 0;
+
+    /* split range by die */
+    for (i = 0; i < numDie; i++)
+    {
+        cur[i] = (numDie > 1) ? i * W25Qxx_DIESIZE : 0;
+        end[i] = (numDie > 1) ? cur[i] + W25Qxx_DIESIZE : d->dev->sizeChip;
+        if (cur[i] < ByteAddr) cur[i] = ByteAddr;
+        if (end[i] > last) end[i] = last;
+    }
+
+    do
+    {
+        active = 0;
+        started = 0;
+
+        /* start next operation on every idle die */
+        for (i = 0; i < numDie; i++)
+        {
+            if (cur[i] >= end[i]) continue;
+            active = 1;
+
+            if (W25Qxx_Die_isBusy(d, i)) continue;
+
+            W25Qxx_Die_Step(d, (pBuffer == NULL) ? NULL : pBuffer + (cur[i] - ByteAddr), &cur[i], end[i], err);
+            if (*err != W25Qxx_ERR_NONE) return;
+            started = 1;
+        }
+
+        /* all die are busy */
+        if (active && !started)
+        {
+            W25Qxx_Die_Tick(d, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+
+    } while (active);
+
+    /* wait for end */
+    W25Qxx_Die_Wait(d, W25QXX_DIE_ALL, err);
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Die function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Die_Init(W25Qxx_DIE_t *d, W25Qxx_t *dev)
+{
+    memset(d, 0, sizeof(W25Qxx_DIE_t));
+    d->dev = dev;
+}
+uint8_t W25Qxx_Die_isBusy(W25Qxx_DIE_t *d, uint8_t Die)
+{
+    /* no operation started on die */
+    if (!(d->busy & (1 << Die))) return 0;
+
+    /* the status register is the one of the selected die */
+    if (d->dev->numDie > 1 && d->dev->activeDie != Die)
+    {
+        W25Qxx_DieSelect(d->dev, Die);
+    }
+
+    if (W25Qxx_ReadStatus(d->dev) & (W25Qxx_STATUS_BUSY | W25Qxx_STATUS_BUSY_AND_SUSPEND)) return 1;
+
+    d->busy &= (uint8_t)~(1 << Die);
+    return 0;
+}
+void W25Qxx_Die_Wait(W25Qxx_DIE_t *d, uint8_t Die, W25Qxx_ERR *err)
+{
+    uint8_t busy = 0;
+    uint8_t i = 0;
+
+    /* Determine if the die is valid */
+    if (Die != W25QXX_DIE_ALL && Die >= d->dev->numDie)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    do
+    {
+        busy = 0;
+        for (i = 0; i < d->dev->numDie; i++)
+        {
+            if (Die != W25QXX_DIE_ALL && Die != i) continue;
+            busy |= W25Qxx_Die_isBusy(d, i);
+        }
+        if (!busy) break;
+
+        W25Qxx_Die_Tick(d, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+    } while (busy);
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Die_Read(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err)
+{
+    uint32_t num = 0;
+    uint8_t die = 0;
+
+    /* Determine if the number is 0 */
+    if (NumByteToRead == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= d->dev->sizeChip || NumByteToRead > d->dev->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    d->numRead++;
+    while (NumByteToRead)
+    {
+        /* no beyond die (3-address mode : no beyond 16MB) */
+#if W25QXX_4BADDR
+        num = W25Qxx_DIESIZE - (ByteAddr % W25Qxx_DIESIZE);
+#else
+        num = 0x1000000 - (ByteAddr & 0xFFFFFF);
+#endif
+        if (num > NumByteToRead) num = NumByteToRead;
+
+        /* wait only for the die of address */
+        die = W25Qxx_Die_Of(d, ByteAddr);
+        if (W25Qxx_Die_isBusy(d, die))
+        {
+            d->numStall++;
+            W25Qxx_Die_Wait(d, die, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+
+        W25Qxx_Read_Start(d->dev, ByteAddr, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        W25Qxx_Read_Stream(d->dev, pBuffer, num);
+        W25Qxx_Read_Stop(d->dev);
+
+        pBuffer += num;
+        ByteAddr += num;
+        NumByteToRead -= num;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Die_Erase_Sector_Start(W25Qxx_DIE_t *d, uint32_t SectorAddr, W25Qxx_ERR *err)
+{
+    uint8_t die = 0;
+
+    /* Determine if Sector Addrress Bound */
+    if (SectorAddr >= d->dev->numSector)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    /* wait for the die of address */
+    die = W25Qxx_Die_Of(d, SectorAddr * d->dev->sizeSector);
+    W25Qxx_Die_Wait(d, die, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_Erase_Sector_Start(d->dev, SectorAddr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_Die_Mark(d, die, d->dev->info.EraseMaxTimeSector);
+}
+void W25Qxx_Die_DIR_Program_Page_Start(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    uint8_t die = 0;
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= d->dev->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    /* wait for the die of address */
+    die = W25Qxx_Die_Of(d, ByteAddr);
+    W25Qxx_Die_Wait(d, die, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_DIR_Program_Page_Start(d->dev, pBuffer, ByteAddr, NumByteToWrite, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_Die_Mark(d, die, d->dev->info.ProgrMaxTimePage);
+}
+void W25Qxx_Die_Erase(W25Qxx_DIE_t *d, uint32_t SectorAddr, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    /* Determine if the number is 0 */
+    if (NumSector == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if Sector Addrress Bound */
+    if (SectorAddr >= d->dev->numSector || NumSector > d->dev->numSector - SectorAddr)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Die_Range(d, NULL, SectorAddr * d->dev->sizeSector, NumSector * d->dev->sizeSector, err);
+}
+void W25Qxx_Die_DIR_Program(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    /* Determine if the number is 0 */
+    if (NumByteToWrite == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= d->dev->sizeChip || NumByteToWrite > d->dev->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Die_Range(d, pBuffer, ByteAddr, NumByteToWrite, err);
+}
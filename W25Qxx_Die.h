@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Die.h
+ * @brief   W25Qxx stacked die concurrency header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_DIE_H
+#define __W25QXX_DIE_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Stacked Die
+ *
+ * 				W25Q01/W25Q02 are stacked 64MB die. Every die runs its own erase/program and
+ * 				has its own BUSY bit, the status register is the one of the die selected by
+ * 				W25Qxx_DieSelect (0xC2).
+ *
+ * 				Busy  : the die that started an erase/program is marked busy, only a marked die
+ * 				        is polled and a read on an other die does not wait for it.
+ * 				Range : W25Qxx_Die_Erase/W25Qxx_Die_DIR_Program split the range by die and start the
+ * 				        next operation on every idle die in turn, so the dies work in parallel.
+ * 				        A 32KB block is erased instead of its sectors when W25Qxx_OpTime is shorter.
+ * Note:
+ * 1. A chip with one die (numDie = 1) works the same as W25Qxx_Read/Erase/DIR_Program.
+ * 2. W25Qxx_Die_Wait polls with the 1ms spi_delayms granularity of W25Qxx_isStatus, the time
+ *    limit is the max time of W25QInfoList.
+ *
+ */
+#define W25QXX_DIE_MAX                               4		/* Max die number */
+#define W25QXX_DIE_ALL                               0xFF	/* W25Qxx_Die_Wait : all die */
+
+/**
+ * @brief W25Qxx Stacked Die Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint8_t busy;                                    /* Bit n : die n runs an erase/program */
+    uint32_t time[W25QXX_DIE_MAX];                   /* Wait time of die operation (ms) */
+    uint32_t timeout[W25QXX_DIE_MAX];                /* Max time of die operation (ms) */
+    uint32_t numRead;                                /* Reads */
+    uint32_t numStall;                               /* Reads that waited for a busy die */
+} W25Qxx_DIE_t;
+
+/**
+ * @brief W25Qxx Stacked Die function
+ */
+void W25Qxx_Die_Init(W25Qxx_DIE_t *d, W25Qxx_t *dev);
+uint8_t W25Qxx_Die_isBusy(W25Qxx_DIE_t *d, uint8_t Die);
+void W25Qxx_Die_Wait(W25Qxx_DIE_t *d, uint8_t Die, W25Qxx_ERR *err);
+void W25Qxx_Die_Read(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err);
+void W25Qxx_Die_Erase_Sector_Start(W25Qxx_DIE_t *d, uint32_t SectorAddr, W25Qxx_ERR *err);
+void W25Qxx_Die_DIR_Program_Page_Start(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Die_Erase(W25Qxx_DIE_t *d, uint32_t SectorAddr, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_Die_DIR_Program(W25Qxx_DIE_t *d, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
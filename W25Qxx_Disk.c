@@ -0,0 +1,318 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Disk.c
+ * @brief   W25Qxx FatFs disk I/O
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Disk.h"
+#include <string.h>
+
+#define W25QXX_DISK_PERUNIT  (W25QXX_DISK_UNIT / W25QXX_DISK_SS)
+
+static W25Qxx_DISK_t *W25Qxx_DiskDrive[W25QXX_DISK_DRIVE];
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_Disk_Addr(W25Qxx_DISK_t *disk, uint32_t Unit)							/* Byte address of erase unit */
+{
+    return (disk->startSector + Unit) * disk->dev->sizeSector;
+}
+static void W25Qxx_Disk_Wait(W25Qxx_DISK_t *disk, W25Qxx_ERR *err)								/* Wait for the end of background erase */
+{
+    *err = W25Qxx_ERR_NONE;
+    if (disk->busy == 0) return;
+
+    W25Qxx_isStatus(disk->dev, W25Qxx_STATUS_IDLE, disk->dev->info.EraseMaxTimeSector, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    disk->busy = 0;
+}
+static uint8_t W25Qxx_Disk_Compatible(W25Qxx_DISK_t *disk, const uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Flash only has to clear bits (pBuffer = NULL : flash is blank) */
+{
+    uint8_t data[32];
+    uint32_t num = 0;
+    uint8_t ok = 1;
+
+    W25Qxx_Read_Start(disk->dev, ByteAddr, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    for (; ok && NumByte; NumByte -= num)
+    {
+        num = (NumByte > sizeof(data)) ? sizeof(data) : NumByte;
+        W25Qxx_Read_Stream(disk->dev, data, num);
+        if (pBuffer == NULL) ok = W25Qxx_isBlank(data, num);
+        else ok = W25Qxx_isProgrammable(data, pBuffer, num);
+        if (pBuffer != NULL) pBuffer += num;
+    }
+
+    W25Qxx_Read_Stop(disk->dev);
+
+    return ok;
+}
+static void W25Qxx_Disk_Program(W25Qxx_DISK_t *disk, uint32_t Offset, uint32_t NumByte, W25Qxx_ERR *err)	/* Program cached unit (blank pages are skipped) */
+{
+    uint32_t num = 0;
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByte; NumByte -= num, Offset += num)
+    {
+        num = disk->dev->sizePage - (Offset % disk->dev->sizePage);
+        if (num > NumByte) num = NumByte;
+
+        if (W25Qxx_isBlank(disk->buffer + Offset, num)) continue;
+
+        W25Qxx_DIR_Program(disk->dev, disk->buffer + Offset, W25Qxx_Disk_Addr(disk, disk->unit) + Offset, num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+static DRESULT W25Qxx_Disk_Result(W25Qxx_ERR err)												/* Error code to FatFs result */
+{
+    if (err == W25Qxx_ERR_NONE) return RES_OK;
+    if (err == W25Qxx_ERR_LOCK || err == W25Qxx_ERR_WPSMODE) return RES_WRPRT;
+    return RES_ERROR;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Disk function                                                         */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Disk_Attach(uint8_t pdrv, W25Qxx_DISK_t *disk, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    /* Determine if the drive and sector range is valid */
+    if (pdrv >= W25QXX_DISK_DRIVE || NumSector == 0 || NumSector > W25QXX_DISK_MAXUNIT ||
+        StartSector + NumSector > dev->numSector || dev->sizeSector != W25QXX_DISK_UNIT)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(disk, 0, sizeof(W25Qxx_DISK_t));
+    disk->dev = dev;
+    disk->startSector = StartSector;
+    disk->numSector = NumSector;
+    disk->unit = W25QXX_DISK_NONE;
+    W25Qxx_DiskDrive[pdrv] = disk;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Disk_Flush(W25Qxx_DISK_t *disk, W25Qxx_ERR *err)
+{
+    uint32_t i = 0;
+
+    W25Qxx_Disk_Wait(disk, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (disk->unit == W25QXX_DISK_NONE || disk->dirty == 0) return;
+
+    if (disk->erase)
+    {
+        /* merge clean FAT sectors from flash, then one erase */
+        for (i = 0; i < W25QXX_DISK_PERUNIT; i++)
+        {
+            if (disk->dirty & (1 << i)) continue;
+            W25Qxx_Read(disk->dev, disk->buffer + i * W25QXX_DISK_SS, W25Qxx_Disk_Addr(disk, disk->unit) + i * W25QXX_DISK_SS, W25QXX_DISK_SS, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+        W25Qxx_Erase_Sector(disk->dev, disk->startSector + disk->unit, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        W25Qxx_Disk_Program(disk, 0, W25QXX_DISK_UNIT, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        disk->numErase++;
+    }
+    else
+    {
+        /* program the dirty FAT sectors only */
+        for (i = 0; i < W25QXX_DISK_PERUNIT; i++)
+        {
+            if ((disk->dirty & (1 << i)) == 0) continue;
+            W25Qxx_Disk_Program(disk, i * W25QXX_DISK_SS, W25QXX_DISK_SS, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+    }
+
+    disk->dirty = 0;
+    disk->erase = 0;
+    disk->numFlush++;
+}
+void W25Qxx_Disk_Idle(W25Qxx_DISK_t *disk, W25Qxx_ERR *err)
+{
+    uint32_t i = 0;
+    uint32_t unit = 0;
+
+    *err = W25Qxx_ERR_NONE;
+
+    /* background erase is running */
+    if (disk->busy)
+    {
+        if ((W25Qxx_ReadStatus(disk->dev) & W25Qxx_STATUS_IDLE) == 0) return;
+        disk->busy = 0;
+    }
+
+    for (i = 0; i < disk->numSector; i++)
+    {
+        unit = (disk->next + i) % disk->numSector;
+        if ((disk->trim[unit / 8] & (1 << (unit % 8))) == 0) continue;
+        disk->trim[unit / 8] &= ~(1 << (unit % 8));
+
+        /* a blank unit is not erased again */
+        if (W25Qxx_Disk_Compatible(disk, NULL, W25Qxx_Disk_Addr(disk, unit), W25QXX_DISK_UNIT, err)) continue;
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        W25Qxx_Erase_Sector_Start(disk->dev, disk->startSector + unit, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        disk->busy = 1;
+        disk->next = unit + 1;
+        disk->numTrim++;
+        return;
+    }
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               FatFs function                                                        */
+/*---------------------------------------------------------------------------------------------------------------------*/
+DSTATUS disk_status(BYTE pdrv)
+{
+    if (pdrv >= W25QXX_DISK_DRIVE || W25Qxx_DiskDrive[pdrv] == NULL) return STA_NOINIT;
+
+    return 0;
+}
+DSTATUS disk_initialize(BYTE pdrv)
+{
+    return disk_status(pdrv);
+}
+DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+    W25Qxx_DISK_t *disk = NULL;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+    uint32_t unit = 0;
+    uint32_t idx = 0;
+
+    if (disk_status(pdrv)) return RES_NOTRDY;
+    disk = W25Qxx_DiskDrive[pdrv];
+    if (sector + count > (LBA_t)disk->numSector * W25QXX_DISK_PERUNIT) return RES_PARERR;
+
+    W25Qxx_Disk_Wait(disk, &err);
+    if (err != W25Qxx_ERR_NONE) return W25Qxx_Disk_Result(err);
+
+    for (; count; count--, sector++, buff += W25QXX_DISK_SS)
+    {
+        unit = sector / W25QXX_DISK_PERUNIT;
+        idx = sector % W25QXX_DISK_PERUNIT;
+
+        /* dirty FAT sector is served from the write cache */
+        if (unit == disk->unit && (disk->dirty & (1 << idx)))
+        {
+            memcpy(buff, disk->buffer + idx * W25QXX_DISK_SS, W25QXX_DISK_SS);
+            continue;
+        }
+
+        W25Qxx_Read(disk->dev, buff, W25Qxx_Disk_Addr(disk, unit) + idx * W25QXX_DISK_SS, W25QXX_DISK_SS, &err);
+        if (err != W25Qxx_ERR_NONE) return W25Qxx_Disk_Result(err);
+    }
+
+    return RES_OK;
+}
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    W25Qxx_DISK_t *disk = NULL;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+    uint32_t unit = 0;
+    uint32_t idx = 0;
+
+    if (disk_status(pdrv)) return RES_NOTRDY;
+    disk = W25Qxx_DiskDrive[pdrv];
+    if (sector + count > (LBA_t)disk->numSector * W25QXX_DISK_PERUNIT) return RES_PARERR;
+
+    W25Qxx_Disk_Wait(disk, &err);
+    if (err != W25Qxx_ERR_NONE) return W25Qxx_Disk_Result(err);
+
+    for (; count; count--, sector++, buff += W25QXX_DISK_SS)
+    {
+        unit = sector / W25QXX_DISK_PERUNIT;
+        idx = sector % W25QXX_DISK_PERUNIT;
+
+        /* another unit, flush the cached one */
+        if (unit != disk->unit)
+        {
+            W25Qxx_Disk_Flush(disk, &err);
+            if (err != W25Qxx_ERR_NONE) return W25Qxx_Disk_Result(err);
+            disk->unit = unit;
+            disk->dirty = 0;
+            disk->erase = 0;
+            disk->trim[unit / 8] &= ~(1 << (unit % 8));
+        }
+
+        /* once an erase is needed the unit is rewritten anyway */
+        if (disk->erase == 0)
+        {
+            if (W25Qxx_Disk_Compatible(disk, buff, W25Qxx_Disk_Addr(disk, unit) + idx * W25QXX_DISK_SS, W25QXX_DISK_SS, &err) == 0) disk->erase = 1;
+            if (err != W25Qxx_ERR_NONE) return W25Qxx_Disk_Result(err);
+        }
+
+        memcpy(disk->buffer + idx * W25QXX_DISK_SS, buff, W25QXX_DISK_SS);
+        disk->dirty |= 1 << idx;
+    }
+
+    return RES_OK;
+}
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+    W25Qxx_DISK_t *disk = NULL;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+    LBA_t *range = NULL;
+    uint32_t unit = 0;
+    uint32_t end = 0;
+
+    if (disk_status(pdrv)) return RES_NOTRDY;
+    disk = W25Qxx_DiskDrive[pdrv];
+
+    switch (cmd)
+    {
+        case CTRL_SYNC :
+            W25Qxx_Disk_Flush(disk, &err);
+            return W25Qxx_Disk_Result(err);
+        case GET_SECTOR_COUNT :
+            *(LBA_t *)buff = (LBA_t)disk->numSector * W25QXX_DISK_PERUNIT;
+            return RES_OK;
+        case GET_SECTOR_SIZE :
+            *(WORD *)buff = W25QXX_DISK_SS;
+            return RES_OK;
+        case GET_BLOCK_SIZE :
+            *(DWORD *)buff = W25QXX_DISK_PERUNIT;
+            return RES_OK;
+        case CTRL_TRIM :
+            /* only erase units fully covered by [start, end] are marked */
+            range = (LBA_t *)buff;
+            if (range[1] < range[0] || range[1] >= (LBA_t)disk->numSector * W25QXX_DISK_PERUNIT) return RES_PARERR;
+            unit = (range[0] + W25QXX_DISK_PERUNIT - 1) / W25QXX_DISK_PERUNIT;
+            end = (range[1] + 1) / W25QXX_DISK_PERUNIT;
+            for (; unit < end; unit++)
+            {
+                if (unit == disk->unit)
+                {
+                    disk->unit = W25QXX_DISK_NONE;
+                    disk->dirty = 0;
+                }
+                disk->trim[unit / 8] |= 1 << (unit % 8);
+            }
+            return RES_OK;
+        default :
+            return RES_PARERR;
+    }
+}
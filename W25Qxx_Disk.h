@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Disk.h
+ * @brief   W25Qxx FatFs disk I/O header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_DISK_H
+#define __W25QXX_DISK_H
+
+#include "W25Qxx.h"
+#include "ff.h"
+#include "diskio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx FatFs Disk
+ *
+ * 				FatFs disk I/O (disk_status/disk_initialize/disk_read/disk_write/disk_ioctl) of a sector range.
+ *
+ * 				Translation : FAT sector = 512 Byte, 8 FAT sectors in one 4KB erase unit (flash sector)
+ * 				Write cache : FAT sectors of one erase unit are collected in RAM, the unit is flushed
+ * 				              when another unit is written, at CTRL_SYNC or by W25Qxx_Disk_Flush.
+ * 				Flush       : the dirty FAT sectors are programmed directly when flash only has to clear bits,
+ * 				              otherwise the unit is merged with flash and written by one erase.
+ * 				CTRL_TRIM   : erase units covered by the range are marked, W25Qxx_Disk_Idle erases one marked
+ * 				              unit in the background, later writes there only program.
+ * Note:
+ * 1. FatFs must be configured with FF_MIN_SS = FF_MAX_SS = 512 (FF_USE_TRIM = 1 for CTRL_TRIM).
+ * 2. W25Qxx_Disk_Idle starts the erase and returns, call it when the file system is idle.
+ *
+ */
+#define W25QXX_DISK_DRIVE                            1		/* Number of physical drive */
+#define W25QXX_DISK_SS                               512	/* FAT sector size (Byte) */
+#define W25QXX_DISK_UNIT                             4096	/* Erase unit size (Byte) */
+#define W25QXX_DISK_MAXUNIT                          4096	/* Max erase unit number of a drive (TRIM map) */
+#define W25QXX_DISK_NONE                             0xFFFFFFFF	/* No cached unit */
+
+/**
+ * @brief W25Qxx FatFs Disk Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First flash sector */
+    uint32_t numSector;                              /* Flash sector number (erase unit) */
+    uint32_t unit;                                   /* Cached erase unit */
+    uint8_t dirty;                                   /* Dirty FAT sector mask of cached unit */
+    uint8_t erase;                                   /* Cached unit needs erase */
+    uint8_t busy;                                    /* Background erase is running */
+    uint32_t next;                                   /* Next unit searched for background erase */
+    uint8_t buffer[W25QXX_DISK_UNIT];                /* Cached unit */
+    uint8_t trim[W25QXX_DISK_MAXUNIT / 8];           /* Trimmed unit map */
+    uint32_t numFlush;                               /* Flushed unit */
+    uint32_t numErase;                               /* Erase at flush */
+    uint32_t numTrim;                                /* Background erase */
+} W25Qxx_DISK_t;
+
+/**
+ * @brief W25Qxx FatFs Disk function
+ */
+void W25Qxx_Disk_Attach(uint8_t pdrv, W25Qxx_DISK_t *disk, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_Disk_Flush(W25Qxx_DISK_t *disk, W25Qxx_ERR *err);
+void W25Qxx_Disk_Idle(W25Qxx_DISK_t *disk, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
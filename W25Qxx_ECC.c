@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_ECC.c
+ * @brief   W25Qxx page integrity (CRC32C/ECC)
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_ECC.h"
+#include <string.h>
+
+/* CRC32C reflected polynomial */
+#define W25QXX_ECC_POLY  0x82F63B78
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_ECC_Trailer(uint8_t *pPage)												/* Stored CRC32C of page */
+{
+    return (uint32_t)pPage[W25QXX_ECC_DATA] | ((uint32_t)pPage[W25QXX_ECC_DATA + 1] << 8) |
+           ((uint32_t)pPage[W25QXX_ECC_DATA + 2] << 16) | ((uint32_t)pPage[W25QXX_ECC_DATA + 3] << 24);
+}
+static uint8_t W25Qxx_ECC_isBlank(uint8_t *pPage)												/* Page is erased */
+{
+    return W25Qxx_isBlank(pPage, W25Qxx_PAGESIZE);
+}
+#if (W25QXX_ECC_CORRECT == 1)
+static uint32_t W25Qxx_ECC_Shift(uint32_t syndrome)												/* Syndrome of one Byte earlier (x^8) */
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        syndrome = (syndrome >> 1) ^ ((syndrome & 1) ? W25QXX_ECC_POLY : 0);
+    }
+
+    return syndrome;
+}
+static uint8_t W25Qxx_ECC_Correct(uint8_t *pPage, uint32_t syndrome)							/* Correct single bit error (1 : corrected) */
+{
+    uint32_t reg = 0;
+    uint32_t i = 0;
+    uint8_t bit = 0;
+
+    /* the error is in the trailer, data is good */
+    if ((syndrome & (syndrome - 1)) == 0) return 1;
+
+    /* a bit b of Byte i changes the CRC by x^(8 * (DATA - i)) * b */
+    for (bit = 0; bit < 8; bit++)
+    {
+        reg = (uint32_t)1 << bit;
+        for (i = W25QXX_ECC_DATA; i > 0; i--)
+        {
+            reg = W25Qxx_ECC_Shift(reg);
+            if (reg == syndrome)
+            {
+                pPage[i - 1] ^= 1 << bit;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
+static uint32_t W25Qxx_ECC_Syndrome(uint8_t *pPage)												/* CRC32C syndrome of page (0 : good or erased) */
+{
+    uint32_t syndrome = W25Qxx_ECC_Trailer(pPage) ^ W25Qxx_CRC32C(0, pPage, W25QXX_ECC_DATA);
+
+    if (syndrome != 0 && W25Qxx_ECC_isBlank(pPage)) return 0;
+
+    return syndrome;
+}
+static uint8_t W25Qxx_ECC_Check(W25Qxx_ECC_t *ecc, uint8_t *pPage)								/* Check page (0 : good/corrected ; 1 : error) */
+{
+    uint32_t syndrome = W25Qxx_ECC_Syndrome(pPage);
+
+    if (syndrome == 0) return 0;
+
+#if (W25QXX_ECC_CORRECT == 1)
+    if (W25Qxx_ECC_Correct(pPage, syndrome))
+    {
+        ecc->numCorrect++;
+        return 0;
+    }
+#endif
+
+    ecc->numError++;
+    return 1;
+}
+static uint32_t W25Qxx_ECC_PageAddr(W25Qxx_ECC_t *ecc, uint32_t Page)							/* Flash Byte address of page */
+{
+    return ecc->startSector * ecc->dev->sizeSector + Page * ecc->dev->sizePage;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               ECC function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_ECC_config(W25Qxx_ECC_t *ecc, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    /* Determine if the sector range is valid */
+    if (NumSector == 0 || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(ecc, 0, sizeof(W25Qxx_ECC_t));
+    ecc->dev = dev;
+    ecc->startSector = StartSector;
+    ecc->numSector = NumSector;
+    ecc->numPage = NumSector * (dev->sizeSector / dev->sizePage);
+    ecc->sizeData = ecc->numPage * W25QXX_ECC_DATA;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_ECC_Read(W25Qxx_ECC_t *ecc, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err)
+{
+    uint32_t page = ByteAddr / W25QXX_ECC_DATA;
+    uint32_t offset = ByteAddr % W25QXX_ECC_DATA;
+    uint32_t num = 0;
+
+    /* Determine if the address > ecc->sizeData */
+    if (ByteAddr >= ecc->sizeData || NumByteToRead > ecc->sizeData - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+    if (NumByteToRead == 0x00)
+    {
+        *err = W25Qxx_ERR_NONE;
+        return;
+    }
+
+    /* the pages of the range are continuous in flash */
+    W25Qxx_Read_Start(ecc->dev, W25Qxx_ECC_PageAddr(ecc, page), err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    for (; NumByteToRead; NumByteToRead -= num, pBuffer += num, offset = 0)
+    {
+        num = W25QXX_ECC_DATA - offset;
+        if (num > NumByteToRead) num = NumByteToRead;
+
+        W25Qxx_Read_Stream(ecc->dev, ecc->page, W25Qxx_PAGESIZE);
+        if (W25Qxx_ECC_Check(ecc, ecc->page))
+        {
+            W25Qxx_Read_Stop(ecc->dev);
+            *err = W25Qxx_ERR_CHECKSUM;
+            return;
+        }
+        memcpy(pBuffer, ecc->page + offset, num);
+    }
+
+    W25Qxx_Read_Stop(ecc->dev);
+}
+void W25Qxx_ECC_DIR_Program(W25Qxx_ECC_t *ecc, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    uint32_t page = ByteAddr / W25QXX_ECC_DATA;
+    uint32_t offset = ByteAddr % W25QXX_ECC_DATA;
+    uint32_t num = 0;
+    uint32_t crc = 0;
+
+    /* Determine if the address > ecc->sizeData */
+    if (ByteAddr >= ecc->sizeData || NumByteToWrite > ecc->sizeData - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByteToWrite; NumByteToWrite -= num, pBuffer += num, offset = 0, page++)
+    {
+        num = W25QXX_ECC_DATA - offset;
+        if (num > NumByteToWrite) num = NumByteToWrite;
+
+        memset(ecc->page, 0xFF, W25Qxx_PAGESIZE);
+        memcpy(ecc->page + offset, pBuffer, num);
+        crc = W25Qxx_CRC32C(0, ecc->page, W25QXX_ECC_DATA);
+        ecc->page[W25QXX_ECC_DATA]     = (uint8_t)(crc);
+        ecc->page[W25QXX_ECC_DATA + 1] = (uint8_t)(crc >> 8);
+        ecc->page[W25QXX_ECC_DATA + 2] = (uint8_t)(crc >> 16);
+        ecc->page[W25QXX_ECC_DATA + 3] = (uint8_t)(crc >> 24);
+
+        W25Qxx_DIR_Program_Page(ecc->dev, ecc->page, W25Qxx_ECC_PageAddr(ecc, page), W25Qxx_PAGESIZE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+void W25Qxx_ECC_Erase_Sector(W25Qxx_ECC_t *ecc, uint32_t SectorAddr, W25Qxx_ERR *err)
+{
+    /* Determine if the sector address > ecc->numSector */
+    if (SectorAddr >= ecc->numSector)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Erase_Sector(ecc->dev, ecc->startSector + SectorAddr, err);
+}
+uint32_t W25Qxx_ECC_Scrub(W25Qxx_ECC_t *ecc, uint32_t SectorAddr, uint32_t NumSector, uint32_t *pBad, uint32_t NumBad, W25Qxx_ERR *err)
+{
+    uint32_t pagePerSector = ecc->dev->sizeSector / ecc->dev->sizePage;
+    uint32_t numBad = 0;
+    uint32_t sector = 0;
+    uint32_t i = 0;
+    uint8_t bad = 0;
+
+    /* Determine if the sector range is valid */
+    if (SectorAddr >= ecc->numSector || NumSector > ecc->numSector - SectorAddr)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return 0;
+    }
+    if (NumSector == 0x00)
+    {
+        *err = W25Qxx_ERR_NONE;
+        return 0;
+    }
+
+    W25Qxx_Read_Start(ecc->dev, W25Qxx_ECC_PageAddr(ecc, SectorAddr * pagePerSector), err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    for (sector = SectorAddr; sector < SectorAddr + NumSector; sector++)
+    {
+        /* a corrected bit also needs the sector to be rewritten */
+        bad = 0;
+        for (i = 0; i < pagePerSector; i++)
+        {
+            W25Qxx_Read_Stream(ecc->dev, ecc->page, W25Qxx_PAGESIZE);
+            if (W25Qxx_ECC_Syndrome(ecc->page)) bad = 1;
+        }
+        if (bad)
+        {
+            if (numBad < NumBad) pBad[numBad] = sector;
+            numBad++;
+        }
+    }
+
+    W25Qxx_Read_Stop(ecc->dev);
+
+    return numBad;
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_ECC.h
+ * @brief   W25Qxx page integrity (CRC32C/ECC) header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_ECC_H
+#define __W25QXX_ECC_H
+
+#include "W25Qxx.h"
+#include "W25Qxx_CRC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Page Integrity
+ *
+ * 				Every flash page holds W25QXX_ECC_DATA data Byte and a CRC32C trailer (little endian).
+ *
+ * 				| data (252 Byte) | CRC32C (4 Byte) |
+ *
+ * 				Address : logical Byte address 0 ~ sizeData - 1, logical page n is flash page n of the sector range
+ * 				Read    : pages are read by one continuous read and checked, a page that is all 0xFF is erased (valid)
+ * 				ECC     : the CRC32C syndrome of a single bit error is unique within a page, so the bit is
+ * 				          found by searching the syndrome table and corrected in the read data
+ * 				Scrub   : streams a sector range, the bad sectors are reported to be rewritten by the user
+ * Note:
+ * 1. A page is programmed once after erase, the data not given in W25Qxx_ECC_DIR_Program is 0xFF.
+ * 2. A corrected bit is only corrected in RAM, flash keeps the error until the sector is rewritten.
+ *
+ */
+#define W25QXX_ECC_CORRECT                           1		/* 0 : Detect error only   ; 1 : Correct single bit error */
+#define W25QXX_ECC_DATA                              (W25Qxx_PAGESIZE - 4)	/* Data Byte of page */
+
+/**
+ * @brief W25Qxx Page Integrity Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First sector */
+    uint32_t numSector;                              /* Sector number */
+    uint32_t numPage;                                /* Page number */
+    uint32_t sizeData;                               /* Data size (Byte) */
+    uint8_t page[W25Qxx_PAGESIZE];                   /* Page buffer */
+    uint32_t numCorrect;                             /* Corrected single bit error */
+    uint32_t numError;                               /* Uncorrectable error */
+} W25Qxx_ECC_t;
+
+/**
+ * @brief W25Qxx Page Integrity function
+ */
+void W25Qxx_ECC_config(W25Qxx_ECC_t *ecc, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_ECC_Read(W25Qxx_ECC_t *ecc, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err);
+void W25Qxx_ECC_DIR_Program(W25Qxx_ECC_t *ecc, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_ECC_Erase_Sector(W25Qxx_ECC_t *ecc, uint32_t SectorAddr, W25Qxx_ERR *err);
+uint32_t W25Qxx_ECC_Scrub(W25Qxx_ECC_t *ecc, uint32_t SectorAddr, uint32_t NumSector, uint32_t *pBad, uint32_t NumBad, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
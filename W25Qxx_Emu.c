@@ -0,0 +1,839 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Emu.c
+ * @brief   W25Qxx host side chip emulator source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Emu.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Status register bits */
+#define EMU_SR1_BUSY                                 0x01
+#define EMU_SR1_WEL                                  0x02
+#define EMU_SR2_SUS                                  0x80
+#define EMU_SR3_ADS                                  0x01
+#define EMU_SR3_ADP                                  0x02
+#define EMU_SR3_WPS                                  0x04
+#ifndef W25Q_CMD_DIESELECT
+#define W25Q_CMD_DIESELECT                           0xC2
+#endif
+
+/* Virtual clock (ns) */
+uint64_t W25Qxx_EMU_Now = 0;
+
+/* Chip slot of the port callbacks */
+static W25Qxx_EMU_t *EmuSlot[W25QXX_EMU_MAXCHIP];
+
+/* Non-volatile copy of the status register */
+static uint8_t EmuNVSR[W25QXX_EMU_MAXCHIP][3];
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t EMU_Capacity(W25Qxx_CHIP type)										/* Chip size from JEDEC capacity byte (BCD coded) */
+{
+    uint8_t cap = (uint8_t)type;
+    uint8_t n = (cap >> 4) * 10 + (cap & 0x0F);
+
+    return 1UL << (n + 6);
+}
+static W25Qxx_EMU_DIE_t *EMU_Die(W25Qxx_EMU_t *emu, uint32_t ByteAddr)				/* Die of byte address */
+{
+    return &emu->die[ByteAddr / W25QXX_EMU_DIESIZE % emu->numDie];
+}
+static uint8_t EMU_isBusy(W25Qxx_EMU_DIE_t *die)									/* Die is running an operation */
+{
+    return die->op != 0 && die->suspended == 0;
+}
+static void EMU_Update(W25Qxx_EMU_t *emu)											/* Finish the operations whose time is up */
+{
+    uint8_t d = 0;
+    uint16_t i = 0;
+    uint32_t addr = 0;
+    uint32_t size = 0;
+    W25Qxx_EMU_DIE_t *die;
+
+    for (d = 0; d < emu->numDie; d++)
+    {
+        die = &emu->die[d];
+        if (!EMU_isBusy(die) || W25Qxx_EMU_Now < die->busyUntil) continue;
+
+        addr = die->addr;
+        switch (die->op)
+        {
+            case W25Q_CMD_WPAGE:
+            case W25Q_CMD_4BWPAGE:
+                addr &= ~(uint32_t)(W25Qxx_PAGESIZE - 1);
+                for (i = 0; i < W25Qxx_PAGESIZE; i++) emu->mem[addr + i] &= die->data[i];
+                break;
+            case W25Q_CMD_WSECREG:
+                for (i = 0; i < W25Qxx_PAGESIZE; i++) emu->security[((addr >> 12) & 0x03) - 1][i] &= die->data[i];
+                break;
+            case W25Q_CMD_ESECTOR:
+            case W25Q_CMD_4BESECTOR:     size = W25Qxx_SECTORSIZE;      break;
+            case W25Q_CMD_E32KBLOCK:     size = W25Qxx_BLOCKSIZE >> 1;  break;
+            case W25Q_CMD_E64KBLOCK:
+            case W25Q_CMD_4BE64KBLOCK:   size = W25Qxx_BLOCKSIZE;       break;
+            case W25Q_CMD_ECHIP:
+            case 0x60:                   addr = 0; size = emu->sizeChip; break;
+            case W25Q_CMD_ESECREG:
+                memset(emu->security[((addr >> 12) & 0x03) - 1], 0xFF, W25Qxx_PAGESIZE);
+                break;
+            default: break;
+        }
+        if (size != 0)
+        {
+            addr &= ~(size - 1);
+            memset(&emu->mem[addr], 0xFF, size);
+        }
+
+        die->op = 0;
+    }
+}
+static uint8_t EMU_isLocked(W25Qxx_EMU_t *emu, uint32_t ByteAddr, uint32_t size)	/* Individual block lock of an address range */
+{
+    uint32_t addr = 0;
+    uint32_t last = (emu->sizeChip >> W25Qxx_BLOCKPOWER) - 1;
+    uint32_t blk = 0;
+    uint32_t idx = 0;
+
+    if ((emu->StatusRegister3 & EMU_SR3_WPS) == 0) return 0;
+
+    for (addr = ByteAddr; addr < ByteAddr + size; addr += W25Qxx_SECTORSIZE)
+    {
+        blk = addr >> W25Qxx_BLOCKPOWER;
+        if (blk == 0)         idx = (addr >> W25Qxx_SECTORPOWER) & 0x0F;
+        else if (blk == last) idx = 16 + (last - 1) + ((addr >> W25Qxx_SECTORPOWER) & 0x0F);
+        else                  idx = 16 + (blk - 1);
+        if (idx < emu->numLock && emu->lock[idx]) return 1;
+    }
+
+    return 0;
+}
+static void EMU_SetLock(W25Qxx_EMU_t *emu, uint32_t ByteAddr, uint8_t lock)			/* Set individual block lock of an address */
+{
+    uint32_t last = (emu->sizeChip >> W25Qxx_BLOCKPOWER) - 1;
+    uint32_t blk = ByteAddr >> W25Qxx_BLOCKPOWER;
+    uint32_t idx = 0;
+
+    if (blk == 0)         idx = (ByteAddr >> W25Qxx_SECTORPOWER) & 0x0F;
+    else if (blk == last) idx = 16 + (last - 1) + ((ByteAddr >> W25Qxx_SECTORPOWER) & 0x0F);
+    else                  idx = 16 + (blk - 1);
+    if (idx < emu->numLock) emu->lock[idx] = lock;
+}
+static uint32_t EMU_ArrayAddr(W25Qxx_EMU_t *emu)									/* Main array address of the current command */
+{
+    uint32_t addr = emu->addr;
+
+    if (emu->numAddr == 3) addr |= (uint32_t)emu->ExtendedRegister << 24;
+
+    return addr % emu->sizeChip;
+}
+static void EMU_Reset(W25Qxx_EMU_t *emu)											/* Power on / software reset state */
+{
+    uint8_t d = 0;
+
+    emu->StatusRegister1 = EmuNVSR[emu->slot][0];
+    emu->StatusRegister2 = EmuNVSR[emu->slot][1];
+    emu->StatusRegister3 = EmuNVSR[emu->slot][2] & ~EMU_SR3_ADS;
+    if (emu->StatusRegister3 & EMU_SR3_ADP) emu->StatusRegister3 |= EMU_SR3_ADS;
+    emu->ExtendedRegister = 0;
+    emu->volatileWEN = 0;
+    emu->resetEnable = 0;
+    emu->powerDown = 0;
+    emu->activeDie = 0;
+    memset(emu->lock, 0x01, emu->numLock);
+    for (d = 0; d < W25QXX_EMU_MAXDIE; d++) emu->die[d].op = 0;
+}
+static void EMU_PutDW(uint8_t *p, uint32_t dw)										/* Store SFDP DWORD (little endian) */
+{
+    p[0] = (uint8_t)dw;
+    p[1] = (uint8_t)(dw >> 8);
+    p[2] = (uint8_t)(dw >> 16);
+    p[3] = (uint8_t)(dw >> 24);
+}
+static uint32_t EMU_EraseTime(uint32_t us)											/* SFDP erase typical time field (5bit count, 2bit unit) */
+{
+    static const uint32_t unit[4] = { 1000, 16000, 128000, 1000000 };
+    uint8_t u = 0;
+    uint32_t count = 0;
+
+    for (u = 0; u < 3; u++)
+    {
+        if ((us + unit[u] - 1) / unit[u] <= 32) break;
+    }
+    count = (us + unit[u] - 1) / unit[u];
+    if (count == 0) count = 1;
+    if (count > 32) count = 32;
+
+    return ((count - 1) & 0x1F) | ((uint32_t)u << 5);
+}
+static void EMU_BuildSFDP(W25Qxx_EMU_t *emu)										/* JESD216B SFDP header and basic flash parameter table */
+{
+    uint8_t *p = emu->sfdp;
+    uint32_t dw = 0;
+    uint32_t count = 0;
+
+    memset(p, 0xFF, W25Qxx_PAGESIZE);
+
+    /* SFDP header : signature, revision 1.6, 1 parameter header, protocol 0xFF */
+    EMU_PutDW(&p[0x00], 0x50444653);
+    p[0x04] = 0x06; p[0x05] = 0x01; p[0x06] = 0x00; p[0x07] = 0xFF;
+
+    /* parameter header 0 : basic flash parameter table, revision 1.6, 16 DWORDs at 0x80 */
+    p[0x08] = 0x00; p[0x09] = 0x06; p[0x0A] = 0x01; p[0x0B] = 0x10;
+    p[0x0C] = 0x80; p[0x0D] = 0x00; p[0x0E] = 0x00; p[0x0F] = 0xFF;
+
+    /* DWORD1 : 4KB erase (20h), 1-1-2/1-2-2/1-4-4/1-1-4 read, address bytes */
+    dw = 0xFF800000 | 0x00700000 | 0x00010000 | ((uint32_t)W25Q_CMD_ESECTOR << 8) | 0xE5;
+    if (emu->sizeChip > 0x1000000) dw |= 0x00020000;
+    EMU_PutDW(&p[0x80], dw);
+
+    /* DWORD2 : density (bits - 1) */
+    EMU_PutDW(&p[0x84], emu->sizeChip * 8 - 1);
+
+    /* DWORD3/4 : 1-4-4 (EBh), 1-1-4 (6Bh), 1-1-2 (3Bh), 1-2-2 (BBh) */
+    EMU_PutDW(&p[0x88], 0x6B08EB44);
+    EMU_PutDW(&p[0x8C], 0xBB423B08);
+
+    /* DWORD5-7 : 2-2-2 and 4-4-4 not supported */
+    EMU_PutDW(&p[0x90], 0xFFFFFFEE);
+    EMU_PutDW(&p[0x94], 0x0000FFFF);
+    EMU_PutDW(&p[0x98], 0x0000FFFF);
+
+    /* DWORD8/9 : erase type 1 (4KB 20h), type 2 (32KB 52h), type 3 (64KB D8h) */
+    EMU_PutDW(&p[0x9C], ((uint32_t)W25Q_CMD_E32KBLOCK << 24) | (15UL << 16) | ((uint32_t)W25Q_CMD_ESECTOR << 8) | 12);
+    EMU_PutDW(&p[0xA0], ((uint32_t)W25Q_CMD_E64KBLOCK << 8) | 16);
+
+    /* DWORD10 : erase typical time, max = 2 * (4 + 1) * typical */
+    dw = 4;
+    dw |= EMU_EraseTime(emu->timing.tSE) << 4;
+    dw |= EMU_EraseTime(emu->timing.tBE32) << 11;
+    dw |= EMU_EraseTime(emu->timing.tBE64) << 18;
+    EMU_PutDW(&p[0xA4], dw);
+
+    /* DWORD11 : page size 256, page program typical time (64us unit), chip erase typical time (4s unit) */
+    count = (emu->timing.tPP + 63) / 64;
+    if (count == 0) count = 1;
+    if (count > 32) count = 32;
+    dw = 0x02 | (8UL << 4) | ((count - 1) << 8) | (1UL << 13) | (3UL << 14);
+    count = (emu->timing.tCE + 3999) / 4000;
+    if (count == 0) count = 1;
+    if (count > 32) count = 32;
+    dw |= ((count - 1) << 24) | (2UL << 29);
+    EMU_PutDW(&p[0xA8], dw);
+
+    /* DWORD12-14 : suspend/resume (75h/7Ah), deep power-down (B9h/ABh), legacy busy polling */
+    EMU_PutDW(&p[0xAC], 0x7029C210);
+    EMU_PutDW(&p[0xB0], 0x757A757A);
+    EMU_PutDW(&p[0xB4], ((uint32_t)W25Q_CMD_POWERDEN << 23) | ((uint32_t)W25Q_CMD_POWEREN << 15) | 0x00000F04);
+
+    /* DWORD15/16 : enter/exit 4 byte address (B7h/E9h), soft reset (66h/99h) */
+    EMU_PutDW(&p[0xB8], 0xFFFFFFFF);
+    dw = 0x00001000;
+    if (emu->sizeChip > 0x1000000) dw |= 0x01004000;
+    EMU_PutDW(&p[0xBC], dw);
+
+    /* parameter header 1 : 4 byte address instruction table (13h/0Ch/12h/21h/DCh), 2 DWORDs at 0xC0 */
+    if (emu->sizeChip > 0x1000000)
+    {
+        p[0x06] = 0x01;
+        p[0x10] = 0x84; p[0x11] = 0x00; p[0x12] = 0x01; p[0x13] = 0x02;
+        p[0x14] = 0xC0; p[0x15] = 0x00; p[0x16] = 0x00; p[0x17] = 0xFF;
+        EMU_PutDW(&p[0xC0], 0xFFFFF000 | (1UL << 11) | (1UL << 9) | (1UL << 6) | (1UL << 1) | (1UL << 0));
+        EMU_PutDW(&p[0xC4], 0xFFDCFF21);
+    }
+}
+static void EMU_Start(W25Qxx_EMU_t *emu, W25Qxx_EMU_DIE_t *die, uint32_t us)		/* Start a BUSY operation */
+{
+    die->op = emu->cmd;
+    die->suspended = 0;
+    die->busyUntil = W25Qxx_EMU_Now + (uint64_t)us * 1000;
+    emu->StatusRegister1 &= ~EMU_SR1_WEL;
+}
+static void EMU_Execute(W25Qxx_EMU_t *emu)											/* Execute command at CS rising edge */
+{
+    W25Qxx_EMU_DIE_t *die = &emu->die[emu->activeDie];
+    uint32_t addr = 0;
+    uint32_t size = 0;
+    uint32_t us = 0;
+    uint8_t *sr = NULL;
+    uint8_t val = 0;
+    uint16_t i = 0;
+
+    switch (emu->cmd)
+    {
+        case W25Q_CMD_WEN:
+            emu->StatusRegister1 |= EMU_SR1_WEL;
+            return;
+        case W25Q_CMD_WDEN:
+            emu->StatusRegister1 &= ~EMU_SR1_WEL;
+            emu->volatileWEN = 0;
+            return;
+        case W25Q_CMD_VOLATILESREN:
+            emu->volatileWEN = 1;
+            return;
+        case W25Q_CMD_WSREG1:
+        case W25Q_CMD_WSREG2:
+        case W25Q_CMD_WSREG3:
+            if (emu->pos < 2) return;
+            if (!(emu->StatusRegister1 & EMU_SR1_WEL) && !emu->volatileWEN) break;
+            val = emu->data[0];
+            if (emu->cmd == W25Q_CMD_WSREG1)
+            {
+                sr = &emu->StatusRegister1;
+                val = (uint8_t)((*sr & 0x03) | (val & 0xFC));
+            }
+            else if (emu->cmd == W25Q_CMD_WSREG2)
+            {
+                sr = &emu->StatusRegister2;
+                val = (uint8_t)((*sr & 0x80) | (val & 0x43) | ((*sr | val) & 0x38));
+            }
+            else
+            {
+                sr = &emu->StatusRegister3;
+                val = (uint8_t)((*sr & 0x99) | (val & 0x66));
+            }
+            *sr = val;
+            if (emu->volatileWEN)
+            {
+                emu->volatileWEN = 0;
+                return;
+            }
+            EmuNVSR[emu->slot][sr - &emu->StatusRegister1] = val;
+            EMU_Start(emu, die, emu->timing.tW);
+            die->op = 0x01;
+            return;
+        case W25Q_CMD_WEXTREG:
+            if (emu->pos < 2 || !(emu->StatusRegister1 & EMU_SR1_WEL)) break;
+            emu->ExtendedRegister = emu->data[0];
+            emu->StatusRegister1 &= ~EMU_SR1_WEL;
+            return;
+        case W25Q_CMD_WPAGE:
+        case W25Q_CMD_4BWPAGE:
+        case W25Q_CMD_WSECREG:
+            if (emu->pos < 1u + emu->numAddr || !(emu->StatusRegister1 & EMU_SR1_WEL)) break;
+            if (emu->cmd == W25Q_CMD_WSECREG)
+            {
+                addr = emu->addr & 0xFFFF;
+                if ((addr >> 12) < 1 || (addr >> 12) > 3) break;
+            }
+            else
+            {
+                addr = EMU_ArrayAddr(emu);
+                if (EMU_isLocked(emu, addr, 1)) break;
+            }
+            die = (emu->cmd == W25Q_CMD_WSECREG) ? die : EMU_Die(emu, addr);
+            if (EMU_isBusy(die) || die->op != 0) break;
+            memset(die->data, 0xFF, W25Qxx_PAGESIZE);
+            for (i = 0; i < emu->len && i < W25Qxx_PAGESIZE; i++)
+            {
+                die->data[(addr + i) & (W25Qxx_PAGESIZE - 1)] = emu->data[i];
+            }
+            /* page program time : 20% fixed + 80% proportional to the byte number */
+            us = emu->timing.tPP / 5 + (uint32_t)((uint64_t)emu->timing.tPP * 4 * emu->len / (5 * W25Qxx_PAGESIZE));
+            EMU_Start(emu, die, us);
+            die->addr = addr;
+            emu->stat.programs++;
+            return;
+        case W25Q_CMD_ESECTOR:
+        case W25Q_CMD_4BESECTOR:
+        case W25Q_CMD_E32KBLOCK:
+        case W25Q_CMD_E64KBLOCK:
+        case W25Q_CMD_4BE64KBLOCK:
+        case W25Q_CMD_ECHIP:
+        case 0x60:
+        case W25Q_CMD_ESECREG:
+            if (!(emu->StatusRegister1 & EMU_SR1_WEL)) break;
+            switch (emu->cmd)
+            {
+                case W25Q_CMD_ESECTOR:
+                case W25Q_CMD_4BESECTOR:   size = W25Qxx_SECTORSIZE;     us = emu->timing.tSE;   break;
+                case W25Q_CMD_E32KBLOCK:   size = W25Qxx_BLOCKSIZE >> 1; us = emu->timing.tBE32; break;
+                case W25Q_CMD_E64KBLOCK:
+                case W25Q_CMD_4BE64KBLOCK: size = W25Qxx_BLOCKSIZE;      us = emu->timing.tBE64; break;
+                case W25Q_CMD_ESECREG:     size = 0;                     us = emu->timing.tSE;   break;
+                default:                   size = emu->sizeChip;         us = 0;                 break;
+            }
+            if (emu->cmd == W25Q_CMD_ESECREG)
+            {
+                if (emu->pos < 1u + emu->numAddr) break;
+                addr = emu->addr & 0xFFFF;
+                if ((addr >> 12) < 1 || (addr >> 12) > 3) break;
+            }
+            else if (size == emu->sizeChip)
+            {
+                addr = 0;
+                if (emu->die[0].suspended || EMU_isLocked(emu, 0, emu->sizeChip)) break;
+            }
+            else
+            {
+                if (emu->pos < 1u + emu->numAddr) break;
+                addr = EMU_ArrayAddr(emu) & ~(size - 1);
+                if (EMU_isLocked(emu, addr, size)) break;
+                die = EMU_Die(emu, addr);
+            }
+            if (EMU_isBusy(die) || die->op != 0) break;
+            EMU_Start(emu, die, us);
+            die->addr = addr;
+            if (us == 0) die->busyUntil = W25Qxx_EMU_Now + (uint64_t)emu->timing.tCE * 1000000;
+            emu->stat.erases++;
+            return;
+        case W25Q_CMD_WALLBLOCKLOCK:
+        case W25Q_CMD_WALLBLOCKUNLOCK:
+            if (!(emu->StatusRegister1 & EMU_SR1_WEL)) break;
+            memset(emu->lock, emu->cmd == W25Q_CMD_WALLBLOCKLOCK, emu->numLock);
+            emu->StatusRegister1 &= ~EMU_SR1_WEL;
+            return;
+        case W25Q_CMD_WSIGBLOCKLOCK:
+        case W25Q_CMD_WSIGBLOCKUNLOCK:
+            if (emu->pos < 1u + emu->numAddr || !(emu->StatusRegister1 & EMU_SR1_WEL)) break;
+            EMU_SetLock(emu, EMU_ArrayAddr(emu), emu->cmd == W25Q_CMD_WSIGBLOCKLOCK);
+            emu->StatusRegister1 &= ~EMU_SR1_WEL;
+            return;
+        case W25Q_CMD_EWSUSPEND:
+            if (!EMU_isBusy(die) || die->op == 0x01 || die->op == W25Q_CMD_ECHIP || die->op == 0x60) break;
+            die->remain = die->busyUntil - W25Qxx_EMU_Now;
+            die->suspended = 1;
+            return;
+        case W25Q_CMD_EWRESUME:
+            if (die->op == 0 || !die->suspended) break;
+            die->suspended = 0;
+            die->busyUntil = W25Qxx_EMU_Now + die->remain;
+            return;
+        case W25Q_CMD_POWERDEN:
+            emu->powerDown = 1;
+            emu->downAt = W25Qxx_EMU_Now;
+            emu->stat.powerDowns++;
+            return;
+        case W25Q_CMD_POWEREN:
+            if (!emu->powerDown) return;
+            emu->powerDown = 0;
+            emu->wakeUntil = W25Qxx_EMU_Now + (uint64_t)emu->timing.tRES1 * 1000;
+            emu->stat.timePowerDown += W25Qxx_EMU_Now - emu->downAt;
+            return;
+        case W25Q_CMD_4ByteAddrEN:
+            emu->StatusRegister3 |= EMU_SR3_ADS;
+            return;
+        case W25Q_CMD_4ByteAddrDEN:
+            emu->StatusRegister3 &= ~EMU_SR3_ADS;
+            return;
+        case W25Q_CMD_ENRESET:
+            emu->resetEnable = 1;
+            return;
+        case W25Q_CMD_RESETDEV:
+            if (!emu->resetEnable) break;
+            EMU_Reset(emu);
+            W25Qxx_EMU_Now += (uint64_t)emu->timing.tRST * 1000;
+            return;
+        case W25Q_CMD_DIESELECT:
+            if (emu->pos < 2 || emu->data[0] >= emu->numDie) break;
+            emu->activeDie = emu->data[0];
+            return;
+        default:
+            return;
+    }
+
+    emu->stat.ignored++;
+}
+static uint8_t EMU_Output(W25Qxx_EMU_t *emu, uint32_t idx)							/* Data output of read commands (idx : data byte index) */
+{
+    W25Qxx_EMU_DIE_t *die = &emu->die[emu->activeDie];
+    uint8_t sr = 0;
+    uint32_t addr = 0;
+    uint8_t cap = (uint8_t)emu->IDJEDEC;
+    uint8_t n = (cap >> 4) * 10 + (cap & 0x0F);
+
+    switch (emu->cmd)
+    {
+        case W25Q_CMD_RSREG1:
+            emu->stat.statusReads++;
+            sr = emu->StatusRegister1 & ~EMU_SR1_BUSY;
+            if (EMU_isBusy(die)) sr |= EMU_SR1_BUSY;
+            return sr;
+        case W25Q_CMD_RSREG2:
+            emu->stat.statusReads++;
+            sr = emu->StatusRegister2 & ~EMU_SR2_SUS;
+            if (die->op != 0 && die->suspended) sr |= EMU_SR2_SUS;
+            return sr;
+        case W25Q_CMD_RSREG3:
+            emu->stat.statusReads++;
+            return emu->StatusRegister3;
+        case W25Q_CMD_REXTREG:
+            return emu->ExtendedRegister;
+        case W25Q_CMD_JEDECID:
+            return (uint8_t)(emu->IDJEDEC >> (16 - 8 * (idx % 3)));
+        case W25Q_CMD_MANUFACTURER:
+            return (idx & 1) ? (uint8_t)(0x10 + n - 11) : (uint8_t)(emu->IDJEDEC >> 16);
+        case W25Q_CMD_POWEREN:
+            return (uint8_t)(0x10 + n - 11);
+        case W25Q_CMD_UNIQUEID:
+            return (uint8_t)(emu->IDUnique >> (56 - 8 * (idx & 7)));
+        case W25Q_CMD_RSFDP:
+            return emu->sfdp[(emu->addr + idx) & (W25Qxx_PAGESIZE - 1)];
+        case W25Q_CMD_RSECREG:
+            addr = emu->addr & 0xFFFF;
+            if ((addr >> 12) < 1 || (addr >> 12) > 3) return 0xFF;
+            return emu->security[(addr >> 12) - 1][(addr + idx) & (W25Qxx_PAGESIZE - 1)];
+        case W25Q_CMD_RBLOCKLOCK:
+            return EMU_isLocked(emu, EMU_ArrayAddr(emu), 1);
+        case W25Q_CMD_READ:
+        case W25Q_CMD_FASTREAD:
+        case W25Q_CMD_4BREAD:
+        case W25Q_CMD_4BFASTREAD:
+            addr = (EMU_ArrayAddr(emu) + idx) % emu->sizeChip;
+            if (EMU_isBusy(EMU_Die(emu, addr))) return 0xFF;
+            return emu->mem[addr];
+        default:
+            return 0xFF;
+    }
+}
+static void EMU_Decode(W25Qxx_EMU_t *emu)											/* Decode command byte */
+{
+    uint8_t mode4B = (emu->StatusRegister3 & EMU_SR3_ADS) ? 4 : 3;
+
+    emu->numAddr = 0;
+    emu->numDummy = 0;
+    emu->len = 0;
+    switch (emu->cmd)
+    {
+        case W25Q_CMD_READ:
+        case W25Q_CMD_WPAGE:
+        case W25Q_CMD_ESECTOR:
+        case W25Q_CMD_E32KBLOCK:
+        case W25Q_CMD_E64KBLOCK:
+        case W25Q_CMD_RBLOCKLOCK:
+        case W25Q_CMD_WSIGBLOCKLOCK:
+        case W25Q_CMD_WSIGBLOCKUNLOCK:
+        case W25Q_CMD_ESECREG:
+        case W25Q_CMD_WSECREG:
+            emu->numAddr = mode4B;
+            break;
+        case W25Q_CMD_FASTREAD:
+        case W25Q_CMD_RSECREG:
+            emu->numAddr = mode4B;
+            emu->numDummy = 1;
+            break;
+        case W25Q_CMD_4BREAD:
+        case W25Q_CMD_4BWPAGE:
+        case W25Q_CMD_4BESECTOR:
+        case W25Q_CMD_4BE64KBLOCK:
+            emu->numAddr = 4;
+            break;
+        case W25Q_CMD_4BFASTREAD:
+            emu->numAddr = 4;
+            emu->numDummy = 1;
+            break;
+        case W25Q_CMD_MANUFACTURER:
+            emu->numAddr = 3;
+            break;
+        case W25Q_CMD_RSFDP:
+            emu->numAddr = 3;
+            emu->numDummy = 1;
+            break;
+        case W25Q_CMD_UNIQUEID:
+            emu->numDummy = mode4B + 1;
+            break;
+        case W25Q_CMD_POWEREN:
+            emu->numDummy = 3;
+            break;
+        default:
+            break;
+    }
+}
+static uint8_t EMU_isAccepted(W25Qxx_EMU_t *emu)									/* Command is accepted in current state */
+{
+    W25Qxx_EMU_DIE_t *die = &emu->die[emu->activeDie];
+
+    if (emu->powerDown) return emu->cmd == W25Q_CMD_POWEREN;
+    if (W25Qxx_EMU_Now < emu->wakeUntil) return 0;
+
+    if (EMU_isBusy(die))
+    {
+        switch (emu->cmd)
+        {
+            case W25Q_CMD_RSREG1:
+            case W25Q_CMD_RSREG2:
+            case W25Q_CMD_RSREG3:
+            case W25Q_CMD_EWSUSPEND:
+            case W25Q_CMD_ENRESET:
+            case W25Q_CMD_RESETDEV:
+            case W25Q_CMD_DIESELECT:
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    if (die->op != 0 && die->suspended)
+    {
+        switch (emu->cmd)
+        {
+            case W25Q_CMD_WSREG1:
+            case W25Q_CMD_WSREG2:
+            case W25Q_CMD_WSREG3:
+            case W25Q_CMD_ESECTOR:
+            case W25Q_CMD_4BESECTOR:
+            case W25Q_CMD_E32KBLOCK:
+            case W25Q_CMD_E64KBLOCK:
+            case W25Q_CMD_4BE64KBLOCK:
+            case W25Q_CMD_ECHIP:
+            case 0x60:
+            case W25Q_CMD_ESECREG:
+                return 0;
+            case W25Q_CMD_WPAGE:
+            case W25Q_CMD_4BWPAGE:
+            case W25Q_CMD_WSECREG:
+                return die->op != W25Q_CMD_WPAGE && die->op != W25Q_CMD_4BWPAGE && die->op != W25Q_CMD_WSECREG;
+            default:
+                return 1;
+        }
+    }
+
+    return 1;
+}
+/* Port callbacks of the chip slots */
+#define EMU_SLOT(n)                                                                                 \
+static uint8_t EMU_RW##n(uint8_t data) { return W25Qxx_EMU_RW(EmuSlot[n], data); }                  \
+static void EMU_CS_L##n(void)          { W25Qxx_EMU_CS_L(EmuSlot[n]); }                             \
+static void EMU_CS_H##n(void)          { W25Qxx_EMU_CS_H(EmuSlot[n]); }
+EMU_SLOT(0)
+EMU_SLOT(1)
+EMU_SLOT(2)
+EMU_SLOT(3)
+static const W25Qxx_PORT_t EmuPort[W25QXX_EMU_MAXCHIP] = {
+    { W25Qxx_EMU_DelayMS, EMU_CS_H0, EMU_CS_L0, EMU_RW0, W25Qxx_EMU_TimeUS },
+    { W25Qxx_EMU_DelayMS, EMU_CS_H1, EMU_CS_L1, EMU_RW1, W25Qxx_EMU_TimeUS },
+    { W25Qxx_EMU_DelayMS, EMU_CS_H2, EMU_CS_L2, EMU_RW2, W25Qxx_EMU_TimeUS },
+    { W25Qxx_EMU_DelayMS, EMU_CS_H3, EMU_CS_L3, EMU_RW3, W25Qxx_EMU_TimeUS },
+};
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Emulator function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_EMU_Init(W25Qxx_EMU_t *emu, W25Qxx_CHIP type, uint32_t clkHz, W25Qxx_ERR *err)							/* Create an erased chip */
+{
+    uint8_t slot = 0;
+    uint32_t numBlock = 0;
+
+    /* search for a free slot */
+    for (slot = 0; slot < W25QXX_EMU_MAXCHIP; slot++)
+    {
+        if (EmuSlot[slot] == NULL) break;
+    }
+    if (slot == W25QXX_EMU_MAXCHIP || type == UNKNOWN || clkHz == 0)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(emu, 0, sizeof(W25Qxx_EMU_t));
+    emu->type = type;
+    emu->IDJEDEC = (type & 0xFF00FF) | (((type & 0xFF) <= 0x11) ? 0x3000 : 0x4000);
+    emu->IDUnique = 0xD2650000A0B1C2D3ULL + slot;
+    emu->sizeChip = EMU_Capacity(type);
+    emu->numDie = (emu->sizeChip > W25QXX_EMU_DIESIZE) ? (uint8_t)(emu->sizeChip / W25QXX_EMU_DIESIZE) : 1;
+    emu->clkHz = clkHz;
+    emu->slot = slot;
+
+    /* typical timing (W25QxxJV datasheet) */
+    emu->timing.tPP = 400;
+    emu->timing.tSE = 45000;
+    emu->timing.tBE32 = 120000;
+    emu->timing.tBE64 = 150000;
+    emu->timing.tCE = (emu->sizeChip >> 20) * 2500 + 500;
+    emu->timing.tW = 10000;
+    emu->timing.tSUS = 20;
+    emu->timing.tRES1 = 3;
+    emu->timing.tRST = 30;
+
+    /* memory array and individual block lock */
+    numBlock = emu->sizeChip >> W25Qxx_BLOCKPOWER;
+    emu->numLock = (numBlock >= 2) ? numBlock - 2 + 32 : 16;
+    emu->mem = (uint8_t *)malloc(emu->sizeChip);
+    emu->lock = (uint8_t *)malloc(emu->numLock);
+    if (emu->mem == NULL || emu->lock == NULL)
+    {
+        free(emu->mem);
+        free(emu->lock);
+        *err = W25Qxx_ERR_HARDWARE;
+        return;
+    }
+    memset(emu->mem, 0xFF, emu->sizeChip);
+    memset(emu->security, 0xFF, sizeof(emu->security));
+
+    /* factory status register */
+    EmuNVSR[slot][0] = 0x00;
+    EmuNVSR[slot][1] = 0x02;
+    EmuNVSR[slot][2] = 0x60;
+    EMU_Reset(emu);
+    EMU_BuildSFDP(emu);
+
+    EmuSlot[slot] = emu;
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_EMU_DeInit(W25Qxx_EMU_t *emu)																				/* Release chip */
+{
+    if (EmuSlot[emu->slot] == emu) EmuSlot[emu->slot] = NULL;
+    free(emu->mem);
+    free(emu->lock);
+    emu->mem = NULL;
+    emu->lock = NULL;
+}
+void W25Qxx_EMU_Port(W25Qxx_EMU_t *emu, W25Qxx_PORT_t *port)															/* Port callbacks of the chip */
+{
+    *port = EmuPort[emu->slot];
+}
+void W25Qxx_EMU_PowerCycle(W25Qxx_EMU_t *emu)																			/* Power loss : abort the running operation */
+{
+    uint8_t d = 0;
+    W25Qxx_EMU_DIE_t *die;
+
+    /* The interrupted operation leaves the cells half done : an erase may leave any bit
+     * pattern, a program clears a part of the bits. Model it as the first half of the job.
+     */
+    EMU_Update(emu);
+    for (d = 0; d < emu->numDie; d++)
+    {
+        die = &emu->die[d];
+        if (!EMU_isBusy(die)) continue;
+        if (die->op == W25Q_CMD_WPAGE || die->op == W25Q_CMD_4BWPAGE)
+        {
+            uint32_t addr = die->addr & ~(uint32_t)(W25Qxx_PAGESIZE - 1);
+            uint16_t i = 0;
+
+            for (i = 0; i < W25Qxx_PAGESIZE / 2; i++) emu->mem[addr + i] &= die->data[i];
+        }
+        if (die->op == W25Q_CMD_ESECTOR || die->op == W25Q_CMD_4BESECTOR)
+        {
+            uint32_t addr = die->addr & ~(uint32_t)(W25Qxx_SECTORSIZE - 1);
+
+            memset(&emu->mem[addr], 0xFF, W25Qxx_SECTORSIZE / 2);
+        }
+    }
+
+    emu->cs = 0;
+    EMU_Reset(emu);
+}
+void W25Qxx_EMU_Jitter(W25Qxx_EMU_t *emu, uint32_t seed, uint8_t percent)												/* Randomize chip timing by +/- percent */
+{
+    uint32_t *t = &emu->timing.tPP;
+    uint8_t i = 0;
+
+    if (seed == 0) seed = 1;
+    for (i = 0; i < 4; i++)
+    {
+        /* xorshift32 */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        t[i] = (uint32_t)((uint64_t)t[i] * (100 - percent + seed % (2 * percent + 1)) / 100);
+    }
+    EMU_BuildSFDP(emu);
+}
+void W25Qxx_EMU_MaxTiming(W25Qxx_EMU_t *emu, W25Qxx_ERR *err)															/* Worst case chip : BUSY time from W25QInfoList max time */
+{
+    W25Qxx_t dev;
+
+    memset(&dev, 0, sizeof(W25Qxx_t));
+    dev.IDJEDEC = emu->IDJEDEC;
+    *err = W25Qxx_ERR_NONE;
+    W25Qxx_QueryChip(&dev, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    emu->timing.tPP = dev.info.ProgrMaxTimePage * 1000;
+    emu->timing.tSE = dev.info.EraseMaxTimeSector * 1000;
+    emu->timing.tBE32 = dev.info.EraseMaxTimeBlock32 * 1000;
+    emu->timing.tBE64 = dev.info.EraseMaxTimeBlock64 * 1000;
+    emu->timing.tCE = dev.info.EraseMaxTimeChip;
+    EMU_BuildSFDP(emu);
+}
+uint8_t W25Qxx_EMU_RW(W25Qxx_EMU_t *emu, uint8_t data)																	/* SPI byte exchange */
+{
+    uint8_t ret = 0xFF;
+    uint32_t idx = 0;
+
+    W25Qxx_EMU_Now += 8000000000ULL / emu->clkHz;
+    emu->stat.bytes++;
+    EMU_Update(emu);
+
+    if (!emu->cs) return 0xFF;
+
+    if (emu->pos == 0)
+    {
+        emu->cmd = data;
+        emu->pos = 1;
+        if (!EMU_isAccepted(emu))
+        {
+            emu->cmd = 0x00;
+            emu->stat.ignored++;
+            return 0xFF;
+        }
+        if (emu->cmd != W25Q_CMD_ENRESET && emu->cmd != W25Q_CMD_RESETDEV) emu->resetEnable = 0;
+        EMU_Decode(emu);
+        return 0xFF;
+    }
+
+    if (emu->cmd == 0x00) return 0xFF;
+
+    if (emu->pos <= emu->numAddr)
+    {
+        emu->addr = (emu->addr << 8) | data;
+    }
+    else if (emu->pos <= (uint32_t)emu->numAddr + emu->numDummy)
+    {
+        /* dummy */
+    }
+    else
+    {
+        idx = emu->pos - 1 - emu->numAddr - emu->numDummy;
+        ret = EMU_Output(emu, idx);
+        if (emu->len < W25Qxx_PAGESIZE) emu->data[emu->len++] = data;
+    }
+    emu->pos++;
+
+    return ret;
+}
+void W25Qxx_EMU_CS_L(W25Qxx_EMU_t *emu)																				/* CS falling edge */
+{
+    emu->cs = 1;
+    emu->pos = 0;
+    emu->addr = 0;
+    emu->cmd = 0x00;
+    emu->stat.commands++;
+}
+void W25Qxx_EMU_CS_H(W25Qxx_EMU_t *emu)																				/* CS rising edge */
+{
+    if (!emu->cs) return;
+    emu->cs = 0;
+    EMU_Update(emu);
+    if (emu->cmd != 0x00) EMU_Execute(emu);
+}
+void W25Qxx_EMU_DelayMS(uint32_t ms)																					/* spi_delayms : advance virtual clock */
+{
+    W25Qxx_EMU_Now += (uint64_t)ms * 1000000;
+}
+uint32_t W25Qxx_EMU_TimeUS(void)																						/* spi_timeus : virtual clock (us), a counter read costs 100ns */
+{
+    W25Qxx_EMU_Now += 100;
+    return (uint32_t)(W25Qxx_EMU_Now / 1000);
+}
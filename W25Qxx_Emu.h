@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Emu.h
+ * @brief   W25Qxx host side chip emulator header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_EMU_H
+#define __W25QXX_EMU_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Emulator
+ *
+ * 				Host side model of one W25Q chip behind the W25Qxx_PORT_t callbacks.
+ *
+ * 				Memory array    : NOR semantics, program only clears bits, erase sets 0xFF
+ * 				Status register : BUSY/WEL/SUS/ADS/WPS, volatile and non-volatile write
+ * 				Timing          : BUSY time per operation, SPI clock time per byte
+ * 				Other           : suspend/resume, security register, SFDP, individual block lock,
+ * 				                  extended address register, deep power-down, software die select
+ * Note:
+ * 1. All emulated chips share one virtual clock (W25Qxx_EMU_Now), so several chips on the
+ *    same emulated bus see the same time line. spi_delayms only advances the virtual clock.
+ * 2. The port callbacks have no context pointer, each chip takes one of the
+ *    W25QXX_EMU_MAXCHIP static slots.
+ * 3. BP/TB/CMP array protection is not modelled, only the individual block lock (WPS = 1).
+ * 4. W25Qxx_EMU_Init uses the datasheet typical time, W25Qxx_EMU_MaxTiming switches to the
+ *    max time of W25QInfoList to exercise the timeout path, W25Qxx_EMU_Jitter spreads the time.
+ *
+ */
+#define W25QXX_EMU_MAXCHIP                           4		/* Number of chips that can be emulated at the same time */
+#define W25QXX_EMU_MAXDIE                            4		/* Number of die of a stacked chip */
+#define W25QXX_EMU_DIESIZE                           0x4000000	/* Stacked die size (64MB) */
+
+/**
+ * @brief W25Qxx Emulator operation timing (typical value)
+ */
+typedef struct
+{
+    uint32_t tPP;                                    /* Page program time   (us) */
+    uint32_t tSE;                                    /* Sector erase time   (us) */
+    uint32_t tBE32;                                  /* Block32 erase time  (us) */
+    uint32_t tBE64;                                  /* Block64 erase time  (us) */
+    uint32_t tCE;                                    /* Chip erase time     (ms) */
+    uint32_t tW;                                     /* Status write time   (us) */
+    uint32_t tSUS;                                   /* Suspend latency     (us) */
+    uint32_t tRES1;                                  /* Release power-down  (us) */
+    uint32_t tRST;                                   /* Reset time          (us) */
+} W25Qxx_EMU_TIMING_t;
+
+/**
+ * @brief W25Qxx Emulator die state
+ */
+typedef struct
+{
+    uint8_t op;                                      /* Pending operation (command) */
+    uint32_t addr;                                   /* Pending operation address */
+    uint16_t len;                                    /* Pending page program length */
+    uint8_t data[W25Qxx_PAGESIZE];                   /* Pending page program data */
+    uint8_t suspended;                               /* Operation is suspended */
+    uint64_t busyUntil;                              /* Virtual time the operation ends (ns) */
+    uint64_t remain;                                 /* Remaining time when suspended (ns) */
+} W25Qxx_EMU_DIE_t;
+
+/**
+ * @brief W25Qxx Emulator statistic
+ */
+typedef struct
+{
+    uint64_t bytes;                                  /* SPI bytes on the wire */
+    uint32_t commands;                               /* CS asserted transactions */
+    uint32_t ignored;                                /* Commands ignored (busy/locked/no WEL) */
+    uint32_t programs;                               /* Page programs */
+    uint32_t erases;                                 /* Sector/Block/Chip erases */
+    uint32_t statusReads;                            /* Status register reads */
+    uint32_t powerDowns;                             /* Deep power-down entries */
+    uint64_t timePowerDown;                          /* Time in deep power-down until the last release (ns) */
+} W25Qxx_EMU_STAT_t;
+
+/**
+ * @brief W25Qxx Emulator chip
+ */
+typedef struct
+{
+    W25Qxx_CHIP type;                                /* Chip type */
+    uint32_t IDJEDEC;                                /* JEDEC  ID */
+    uint64_t IDUnique;                               /* Unique ID */
+    uint32_t sizeChip;                               /* Chip size (Byte) */
+    uint8_t numDie;                                  /* Die number */
+    uint8_t activeDie;                               /* Selected die */
+    uint8_t *mem;                                    /* Memory array */
+    uint8_t *lock;                                   /* Individual block lock bits */
+    uint32_t numLock;                                /* Individual block lock number */
+    uint8_t security[3][W25Qxx_PAGESIZE];            /* Security register #1 - #3 */
+    uint8_t sfdp[W25Qxx_PAGESIZE];                   /* SFDP table */
+    uint8_t StatusRegister1;                         /* StatusRegister 1 */
+    uint8_t StatusRegister2;                         /* StatusRegister 2 */
+    uint8_t StatusRegister3;                         /* StatusRegister 3 */
+    uint8_t ExtendedRegister;                        /* ExtendedRegister */
+    uint8_t volatileWEN;                             /* Volatile SR write enable (50h) */
+    uint8_t resetEnable;                             /* Reset enable (66h) */
+    uint8_t powerDown;                               /* Deep power-down */
+    uint64_t downAt;                                 /* Virtual time of deep power-down entry (ns) */
+    uint64_t wakeUntil;                              /* Commands are ignored until tRES1 is over (ns) */
+    uint32_t clkHz;                                  /* SPI clock (Hz) */
+    W25Qxx_EMU_TIMING_t timing;                      /* Operation timing */
+    W25Qxx_EMU_DIE_t die[W25QXX_EMU_MAXDIE];         /* Die state */
+    W25Qxx_EMU_STAT_t stat;                          /* Statistic */
+    /* command decoder */
+    uint8_t cs;                                      /* CS is asserted */
+    uint8_t cmd;                                     /* Current command */
+    uint32_t pos;                                    /* Byte position in transaction */
+    uint32_t addr;                                   /* Address of current command */
+    uint8_t numAddr;                                 /* Address bytes of current command */
+    uint8_t numDummy;                                /* Dummy bytes of current command */
+    uint16_t len;                                    /* Data bytes of current command */
+    uint8_t data[W25Qxx_PAGESIZE];                   /* Data of current command */
+    uint8_t slot;                                    /* Port slot */
+} W25Qxx_EMU_t;
+
+/**
+ * @brief W25Qxx Emulator virtual clock (ns)
+ */
+extern uint64_t W25Qxx_EMU_Now;
+
+/**
+ * @brief W25Qxx Emulator function
+ */
+void W25Qxx_EMU_Init(W25Qxx_EMU_t *emu, W25Qxx_CHIP type, uint32_t clkHz, W25Qxx_ERR *err);
+void W25Qxx_EMU_DeInit(W25Qxx_EMU_t *emu);
+void W25Qxx_EMU_Port(W25Qxx_EMU_t *emu, W25Qxx_PORT_t *port);
+void W25Qxx_EMU_PowerCycle(W25Qxx_EMU_t *emu);
+void W25Qxx_EMU_Jitter(W25Qxx_EMU_t *emu, uint32_t seed, uint8_t percent);
+void W25Qxx_EMU_MaxTiming(W25Qxx_EMU_t *emu, W25Qxx_ERR *err);
+uint8_t W25Qxx_EMU_RW(W25Qxx_EMU_t *emu, uint8_t data);
+void W25Qxx_EMU_CS_L(W25Qxx_EMU_t *emu);
+void W25Qxx_EMU_CS_H(W25Qxx_EMU_t *emu);
+void W25Qxx_EMU_DelayMS(uint32_t ms);
+uint32_t W25Qxx_EMU_TimeUS(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
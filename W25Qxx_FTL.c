@@ -0,0 +1,332 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_FTL.c
+ * @brief   W25Qxx wear leveling flash translation layer
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_FTL.h"
+#include "W25Qxx_CRC.h"
+#include <string.h>
+
+/* Header field offset */
+#define FTL_OFS_MAGIC        0
+#define FTL_OFS_LSN          8
+#define FTL_OFS_SEQ          12
+#define FTL_NONE             0xFFFF
+#define FTL_ERASED           0xFFFFFFFFu
+
+/* FTL Cache */
+static uint8_t W25QXX_FTL_BUF[W25Qxx_PAGESIZE];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_FTL_Addr(W25Qxx_FTL_t *ftl, uint32_t psn)													/* Byte address of physical sector */
+{
+    return (ftl->startSector + psn) * ftl->dev->sizeSector;
+}
+static void W25Qxx_FTL_ReadHead(W25Qxx_FTL_t *ftl, uint32_t psn, W25Qxx_FTL_HEAD_t *head, W25Qxx_ERR *err)			/* Read physical sector header */
+{
+    uint8_t buf[W25QXX_FTL_HEADSIZE];
+
+    W25Qxx_Read(ftl->dev, buf, W25Qxx_FTL_Addr(ftl, psn), W25QXX_FTL_HEADSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    head->magic      = W25Qxx_Get32(&buf[0]);
+    head->eraseCount = W25Qxx_Get32(&buf[4]);
+    head->lsn        = W25Qxx_Get32(&buf[8]);
+    head->seq        = W25Qxx_Get32(&buf[12]);
+}
+static void W25Qxx_FTL_WriteField(W25Qxx_FTL_t *ftl, uint32_t psn, uint8_t ofs, uint32_t val, W25Qxx_ERR *err)		/* Program header field */
+{
+    uint8_t buf[4];
+
+    W25Qxx_Put32(buf, val);
+    W25Qxx_DIR_Program(ftl->dev, buf, W25Qxx_FTL_Addr(ftl, psn) + ofs, 4, err);
+}
+static void W25Qxx_FTL_Erase(W25Qxx_FTL_t *ftl, uint32_t psn, W25Qxx_ERR *err)										/* Erase physical sector and write erase count */
+{
+    uint8_t buf[8];
+
+    W25Qxx_Erase_Sector(ftl->dev, ftl->startSector + psn, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    ftl->eraseCount[psn]++;
+    ftl->numErase++;
+
+    /* magic + erase count */
+    W25Qxx_Put32(&buf[0], W25QXX_FTL_MAGIC);
+    W25Qxx_Put32(&buf[4], ftl->eraseCount[psn]);
+    W25Qxx_DIR_Program(ftl->dev, buf, W25Qxx_FTL_Addr(ftl, psn) + FTL_OFS_MAGIC, 8, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    ftl->state[psn] = W25Qxx_FTL_FREE;
+    ftl->numFree++;
+}
+static uint32_t W25Qxx_FTL_Find(W25Qxx_FTL_t *ftl, W25Qxx_FTL_STATE state, uint8_t max)								/* Physical sector of state with min/max erase count */
+{
+    uint32_t psn = FTL_NONE;
+    uint32_t i = 0;
+
+    for (i = 0; i < ftl->numSector; i++)
+    {
+        if (ftl->state[i] != state) continue;
+        if (psn == FTL_NONE
+            || ( max && ftl->eraseCount[i] > ftl->eraseCount[psn])
+            || (!max && ftl->eraseCount[i] < ftl->eraseCount[psn]))
+        {
+            psn = i;
+        }
+    }
+
+    return psn;
+}
+static void W25Qxx_FTL_Commit(W25Qxx_FTL_t *ftl, uint32_t psn, uint32_t lsn, uint8_t *pBuffer, uint32_t src, W25Qxx_ERR *err)	/* Write logical sector to free physical sector (data from pBuffer or physical sector src) */
+{
+    uint32_t addr = W25Qxx_FTL_Addr(ftl, psn);
+    uint32_t ofs = W25QXX_FTL_HEADSIZE;
+    uint32_t num = 0;
+
+    /* allocate */
+    ftl->state[psn] = W25Qxx_FTL_GARBAGE;
+    ftl->numFree--;
+    W25Qxx_FTL_WriteField(ftl, psn, FTL_OFS_LSN, lsn, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* data */
+    if (pBuffer != NULL)
+    {
+        W25Qxx_DIR_Program(ftl->dev, pBuffer, addr + ofs, ftl->sizeData, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    else
+    {
+        for (; ofs < ftl->dev->sizeSector; ofs += num)
+        {
+            num = ftl->dev->sizePage - (ofs % ftl->dev->sizePage);
+            W25Qxx_Read(ftl->dev, W25QXX_FTL_BUF, W25Qxx_FTL_Addr(ftl, src) + ofs, (uint16_t)num, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+
+            /* blank data need not be programmed */
+            if (W25Qxx_isBlank(W25QXX_FTL_BUF, num)) continue;
+
+            W25Qxx_DIR_Program(ftl->dev, W25QXX_FTL_BUF, addr + ofs, num, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+    }
+
+    /* commit */
+    W25Qxx_FTL_WriteField(ftl, psn, FTL_OFS_SEQ, ftl->seq++, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* remap, the old physical sector is garbage */
+    if (ftl->map[lsn] != FTL_NONE)
+    {
+        ftl->state[ftl->map[lsn]] = W25Qxx_FTL_GARBAGE;
+    }
+    ftl->map[lsn] = (uint16_t)psn;
+    ftl->state[psn] = W25Qxx_FTL_VALID;
+    ftl->numProgram++;
+}
+static void W25Qxx_FTL_Static(W25Qxx_FTL_t *ftl, W25Qxx_ERR *err)													/* Static wear leveling */
+{
+    W25Qxx_FTL_HEAD_t head;
+    uint32_t cold = W25Qxx_FTL_Find(ftl, W25Qxx_FTL_VALID, 0);
+    uint32_t worn = W25Qxx_FTL_Find(ftl, W25Qxx_FTL_FREE, 1);
+
+    *err = W25Qxx_ERR_NONE;
+    if (cold == FTL_NONE || worn == FTL_NONE) return;
+    if (ftl->eraseCount[worn] <= ftl->eraseCount[cold] + W25QXX_FTL_WLDELTA) return;
+
+    /* move cold data to the most worn free sector, the least worn sector is released */
+    W25Qxx_FTL_ReadHead(ftl, cold, &head, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_FTL_Commit(ftl, worn, head.lsn, NULL, cold, err);
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               FTL function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_FTL_Mount(W25Qxx_FTL_t *ftl, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    W25Qxx_FTL_HEAD_t head;
+    W25Qxx_FTL_HEAD_t other;
+    uint32_t maxCount = 0;
+    uint32_t maxSeq = 0;
+    uint32_t psn = 0;
+
+    /* Determine if the sector range is valid */
+    if (NumSector <= W25QXX_FTL_SPARE || NumSector > W25QXX_FTL_SECTOR || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(ftl, 0, sizeof(W25Qxx_FTL_t));
+    memset(ftl->map, 0xFF, sizeof(ftl->map));
+    ftl->dev         = dev;
+    ftl->startSector = StartSector;
+    ftl->numSector   = NumSector;
+    ftl->numLogical  = NumSector - W25QXX_FTL_SPARE;
+    ftl->sizeData    = dev->sizeSector - W25QXX_FTL_HEADSIZE;
+
+    /* scan header */
+    for (psn = 0; psn < NumSector; psn++)
+    {
+        W25Qxx_FTL_ReadHead(ftl, psn, &head, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* no header (blank or torn erase), erase count is unknown */
+        if (head.magic != W25QXX_FTL_MAGIC)
+        {
+            ftl->state[psn] = W25Qxx_FTL_GARBAGE;
+            ftl->eraseCount[psn] = FTL_ERASED;
+            continue;
+        }
+        ftl->eraseCount[psn] = head.eraseCount;
+        if (head.eraseCount > maxCount) maxCount = head.eraseCount;
+
+        /* free */
+        if (head.lsn == FTL_ERASED && head.seq == FTL_ERASED)
+        {
+            ftl->state[psn] = W25Qxx_FTL_FREE;
+            ftl->numFree++;
+            continue;
+        }
+
+        /* uncommitted */
+        ftl->state[psn] = W25Qxx_FTL_GARBAGE;
+        if (head.seq == FTL_ERASED || head.lsn >= ftl->numLogical) continue;
+        if (head.seq > maxSeq) maxSeq = head.seq;
+
+        /* the highest sequence wins */
+        if (ftl->map[head.lsn] != FTL_NONE)
+        {
+            W25Qxx_FTL_ReadHead(ftl, ftl->map[head.lsn], &other, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+            if (other.seq > head.seq) continue;
+            ftl->state[ftl->map[head.lsn]] = W25Qxx_FTL_GARBAGE;
+        }
+        ftl->map[head.lsn] = (uint16_t)psn;
+        ftl->state[psn] = W25Qxx_FTL_VALID;
+    }
+
+    /* unknown erase count : the highest erase count */
+    for (psn = 0; psn < NumSector; psn++)
+    {
+        if (ftl->eraseCount[psn] == FTL_ERASED) ftl->eraseCount[psn] = maxCount;
+    }
+    ftl->seq = maxSeq + 1;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_FTL_Read(W25Qxx_FTL_t *ftl, uint32_t LogicalSector, uint8_t *pBuffer, W25Qxx_ERR *err)
+{
+    uint32_t addr = 0;
+    uint32_t ofs = 0;
+    uint32_t num = 0;
+
+    /* Determine if the logical sector is valid */
+    if (LogicalSector >= ftl->numLogical)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    /* not mapped */
+    if (ftl->map[LogicalSector] == FTL_NONE)
+    {
+        memset(pBuffer, 0xFF, ftl->sizeData);
+        *err = W25Qxx_ERR_NONE;
+        return;
+    }
+
+    addr = W25Qxx_FTL_Addr(ftl, ftl->map[LogicalSector]) + W25QXX_FTL_HEADSIZE;
+    for (ofs = 0; ofs < ftl->sizeData; ofs += num)
+    {
+        num = ftl->sizeData - ofs;
+        if (num > 0xFFFF) num = 0xFFFF;
+        W25Qxx_Read(ftl->dev, pBuffer + ofs, addr + ofs, (uint16_t)num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+void W25Qxx_FTL_Write(W25Qxx_FTL_t *ftl, uint32_t LogicalSector, uint8_t *pBuffer, W25Qxx_ERR *err)
+{
+    uint32_t psn = 0;
+
+    /* Determine if the logical sector is valid */
+    if (LogicalSector >= ftl->numLogical)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    /* garbage collection */
+    W25Qxx_FTL_GC(ftl, W25QXX_FTL_GCFREE, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* dynamic wear leveling : the least worn free sector */
+    psn = W25Qxx_FTL_Find(ftl, W25Qxx_FTL_FREE, 0);
+    if (psn == FTL_NONE)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    W25Qxx_FTL_Commit(ftl, psn, LogicalSector, pBuffer, 0, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    ftl->numWrite++;
+
+    /* static wear leveling */
+    if (ftl->numWrite % W25QXX_FTL_WLPERIOD == 0)
+    {
+        W25Qxx_FTL_GC(ftl, W25QXX_FTL_GCFREE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        W25Qxx_FTL_Static(ftl, err);
+    }
+}
+void W25Qxx_FTL_GC(W25Qxx_FTL_t *ftl, uint32_t NumFree, W25Qxx_ERR *err)
+{
+    uint32_t psn = 0;
+
+    *err = W25Qxx_ERR_NONE;
+
+    /* erase the least worn garbage first */
+    while (ftl->numFree < NumFree)
+    {
+        psn = W25Qxx_FTL_Find(ftl, W25Qxx_FTL_GARBAGE, 0);
+        if (psn == FTL_NONE) return;
+
+        W25Qxx_FTL_Erase(ftl, psn, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+void W25Qxx_FTL_EraseCount(W25Qxx_FTL_t *ftl, uint32_t *min, uint32_t *max)
+{
+    uint32_t i = 0;
+
+    *min = 0xFFFFFFFF;
+    *max = 0;
+    for (i = 0; i < ftl->numSector; i++)
+    {
+        if (ftl->eraseCount[i] < *min) *min = ftl->eraseCount[i];
+        if (ftl->eraseCount[i] > *max) *max = ftl->eraseCount[i];
+    }
+}
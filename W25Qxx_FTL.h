@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_FTL.h
+ * @brief   W25Qxx wear leveling flash translation layer header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_FTL_H
+#define __W25QXX_FTL_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Flash Translation Layer
+ *
+ * 				Logical sectors are mapped to physical sectors of a sector range, a write goes
+ * 				to a new physical sector and the old one is erased later (garbage collection).
+ *
+ * 				Header  : first 16 bytes of every physical sector, programmed in this order
+ * 				          1. magic + erase count   right after erase
+ * 				          2. logical sector        at allocation
+ * 				          3. data
+ * 				          4. sequence              commit, the sector is valid from now on
+ * 				Mount   : the mapping table is rebuilt from the headers, the highest sequence of a
+ * 				          logical sector wins, an uncommitted or old sector is garbage.
+ * 				Wear    : dynamic, a write takes the free sector with the lowest erase count.
+ * 				          static, every W25QXX_FTL_WLPERIOD writes the coldest valid sector is moved
+ * 				          to the most worn free sector if the erase count differs more than
+ * 				          W25QXX_FTL_WLDELTA.
+ * 				GC      : garbage sectors are erased when less than W25QXX_FTL_GCFREE sectors are
+ * 				          free, the garbage sector with the lowest erase count first.
+ * Note:
+ * 1. The data size of a logical sector is sizeSector - W25QXX_FTL_HEADSIZE (4080 Byte).
+ * 2. Logical sector number = physical sector number - W25QXX_FTL_SPARE.
+ * 3. A blank header at mount may be a torn erase, the sector is treated as garbage and erased
+ *    again before use.
+ *
+ */
+#define W25QXX_FTL_SECTOR                            4096	/* Max physical sectors (RAM : 7 Byte per sector) */
+#define W25QXX_FTL_SPARE                             8		/* Physical sectors not mapped (GC and static wear leveling) */
+#define W25QXX_FTL_GCFREE                            2		/* Erase garbage when free sectors < GCFREE */
+#define W25QXX_FTL_WLPERIOD                          64		/* Static wear leveling check period (writes) */
+#define W25QXX_FTL_WLDELTA                           32		/* Static wear leveling erase count difference */
+#define W25QXX_FTL_HEADSIZE                          16		/* Physical sector header size (Byte) */
+#define W25QXX_FTL_MAGIC                             0x4C54463Cu	/* "<FTL" */
+
+/**
+ * @brief W25Qxx FTL physical sector state
+ */
+typedef enum
+{
+    W25Qxx_FTL_FREE     = 0x00,                      /* Erased, erase count written */
+    W25Qxx_FTL_VALID    = 0x01,                      /* Mapped logical sector */
+    W25Qxx_FTL_GARBAGE  = 0x02,                      /* Old/uncommitted data, must be erased */
+} W25Qxx_FTL_STATE;
+
+/**
+ * @brief W25Qxx FTL physical sector header
+ */
+typedef struct
+{
+    uint32_t magic;                                  /* W25QXX_FTL_MAGIC */
+    uint32_t eraseCount;                             /* Erase count */
+    uint32_t lsn;                                    /* Logical sector */
+    uint32_t seq;                                    /* Sequence (commit) */
+} W25Qxx_FTL_HEAD_t;
+
+/**
+ * @brief W25Qxx FTL Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First physical sector */
+    uint32_t numSector;                              /* Physical sector number */
+    uint32_t numLogical;                             /* Logical sector number */
+    uint32_t sizeData;                               /* Data size of logical sector (Byte) */
+    uint32_t seq;                                    /* Next sequence */
+    uint32_t numFree;                                /* Free physical sectors */
+    uint16_t map[W25QXX_FTL_SECTOR];                 /* Logical -> physical (0xFFFF : not mapped) */
+    uint8_t state[W25QXX_FTL_SECTOR];                /* Physical sector state */
+    uint32_t eraseCount[W25QXX_FTL_SECTOR];          /* Physical sector erase count */
+    uint32_t numWrite;                               /* Logical sector writes */
+    uint32_t numProgram;                             /* Physical sector programs (include static wear leveling) */
+    uint32_t numErase;                               /* Physical sector erases */
+} W25Qxx_FTL_t;
+
+/**
+ * @brief W25Qxx FTL function
+ */
+void W25Qxx_FTL_Mount(W25Qxx_FTL_t *ftl, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_FTL_Read(W25Qxx_FTL_t *ftl, uint32_t LogicalSector, uint8_t *pBuffer, W25Qxx_ERR *err);
+void W25Qxx_FTL_Write(W25Qxx_FTL_t *ftl, uint32_t LogicalSector, uint8_t *pBuffer, W25Qxx_ERR *err);
+void W25Qxx_FTL_GC(W25Qxx_FTL_t *ftl, uint32_t NumFree, W25Qxx_ERR *err);
+void W25Qxx_FTL_EraseCount(W25Qxx_FTL_t *ftl, uint32_t *min, uint32_t *max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
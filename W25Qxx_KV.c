@@ -0,0 +1,518 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_KV.c
+ * @brief   W25Qxx log structured key-value store
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_KV.h"
+#include "W25Qxx_CRC.h"
+#include <string.h>
+
+/* Layout */
+#define KV_HEADSIZE          8				/* Sector header {magic, seq} */
+#define KV_RECSIZE           8				/* Record header {crc32c, keyLen, type, valLen} */
+#define KV_TYPE_VALUE        0x01
+#define KV_TYPE_DELETE       0x00
+#define KV_NONE              0xFFFFFFFFu
+
+/* KV Cache */
+static uint8_t W25QXX_KV_BUF[W25Qxx_PAGESIZE];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_KV_Addr(W25Qxx_KV_t *kv, uint32_t sector)													/* Byte address of sector */
+{
+    return (kv->startSector + sector) * kv->dev->sizeSector;
+}
+static uint32_t W25Qxx_KV_Hash(const uint8_t *key, uint8_t keyLen)													/* FNV-1a */
+{
+    uint32_t hash = 0x811C9DC5;
+    uint8_t i = 0;
+
+    for (i = 0; i < keyLen; i++)
+    {
+        hash = (hash ^ key[i]) * 0x01000193;
+    }
+
+    return hash;
+}
+static uint32_t W25Qxx_KV_Next(W25Qxx_KV_t *kv, uint32_t addr, uint32_t end, uint8_t *rec, uint8_t *closed, W25Qxx_ERR *err)	/* Read record header and key, return record size (0 : end of sector) */
+{
+    uint32_t size = 0;
+    uint32_t crc = 0;
+
+    *closed = 0;
+    if (end - addr < KV_RECSIZE) return 0;
+
+    W25Qxx_Read(kv->dev, rec, addr, KV_RECSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    /* blank : end of records */
+    if (W25Qxx_isBlank(rec, KV_RECSIZE)) return 0;
+
+    /* torn or corrupt record, the sector is closed */
+    *closed = 1;
+    size = KV_RECSIZE + rec[4] + (rec[6] | ((uint32_t)rec[7] << 8));
+    if (rec[4] == 0 || rec[4] > W25QXX_KV_KEYSIZE || rec[5] > KV_TYPE_VALUE || size > end - addr) return 0;
+
+    W25Qxx_Read(kv->dev, rec + KV_RECSIZE, addr + KV_RECSIZE, rec[4], err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+    crc = W25Qxx_CRC32C_Flash(kv->dev, 0, addr + 4, size - 4, err);
+    if (*err != W25Qxx_ERR_NONE || crc != W25Qxx_Get32(rec)) return 0;
+
+    *closed = 0;
+    return size;
+}
+static uint32_t W25Qxx_KV_Find(W25Qxx_KV_t *kv, const uint8_t *key, uint8_t keyLen, uint32_t hash, uint8_t *found, W25Qxx_ERR *err)	/* Index slot of key (or empty slot) */
+{
+    uint8_t rec[KV_RECSIZE + W25QXX_KV_KEYSIZE];
+    uint32_t mask = W25QXX_KV_INDEX - 1;
+    uint32_t i = hash & mask;
+
+    *found = 0;
+    *err = W25Qxx_ERR_NONE;
+    while (kv->index[i].addr != KV_NONE)
+    {
+        /* compare key on flash */
+        if (kv->index[i].hash == hash)
+        {
+            W25Qxx_Read(kv->dev, rec, kv->index[i].addr, KV_RECSIZE + keyLen, err);
+            if (*err != W25Qxx_ERR_NONE) return i;
+            if (rec[4] == keyLen && W25Qxx_isEqual(&rec[KV_RECSIZE], key, keyLen))
+            {
+                *found = 1;
+                return i;
+            }
+        }
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+static void W25Qxx_KV_IndexSet(W25Qxx_KV_t *kv, const uint8_t *key, uint8_t keyLen, uint32_t addr, W25Qxx_ERR *err)	/* Insert/update key */
+{
+    uint32_t hash = W25Qxx_KV_Hash(key, keyLen);
+    uint8_t found = 0;
+    uint32_t i = W25Qxx_KV_Find(kv, key, keyLen, hash, &found, err);
+
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (!found)
+    {
+        if (kv->numKey >= W25QXX_KV_INDEX - 1)
+        {
+            *err = W25Qxx_ERR_FULL;
+            return;
+        }
+        kv->numKey++;
+    }
+    kv->index[i].hash = hash;
+    kv->index[i].addr = addr;
+}
+static void W25Qxx_KV_IndexDel(W25Qxx_KV_t *kv, const uint8_t *key, uint8_t keyLen, W25Qxx_ERR *err)				/* Remove key (backward shift) */
+{
+    uint32_t mask = W25QXX_KV_INDEX - 1;
+    uint8_t found = 0;
+    uint32_t i = W25Qxx_KV_Find(kv, key, keyLen, W25Qxx_KV_Hash(key, keyLen), &found, err);
+    uint32_t j = i;
+    uint32_t k = 0;
+
+    if (*err != W25Qxx_ERR_NONE || !found) return;
+
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (kv->index[j].addr == KV_NONE) break;
+
+        /* move the entry if its home slot is not in (i, j] */
+        k = kv->index[j].hash & mask;
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j)))
+        {
+            kv->index[i] = kv->index[j];
+            i = j;
+        }
+    }
+    kv->index[i].addr = KV_NONE;
+    kv->numKey--;
+}
+static void W25Qxx_KV_Open(W25Qxx_KV_t *kv, W25Qxx_ERR *err)														/* Erase a free sector as new head */
+{
+    uint8_t buf[KV_HEADSIZE];
+    uint32_t s = 0;
+    uint32_t i = 0;
+
+    if (kv->numFree == 0)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    /* next free sector of the ring */
+    for (i = 1; i <= kv->numSector; i++)
+    {
+        s = (kv->head + i) % kv->numSector;
+        if (kv->seq[s] == KV_NONE) break;
+    }
+
+    W25Qxx_Erase_Sector(kv->dev, kv->startSector + s, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    kv->numErase++;
+
+    W25Qxx_Put32(&buf[0], W25QXX_KV_MAGIC);
+    W25Qxx_Put32(&buf[4], kv->nextSeq);
+    W25Qxx_DIR_Program(kv->dev, buf, W25Qxx_KV_Addr(kv, s), KV_HEADSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    kv->seq[s] = kv->nextSeq++;
+    kv->numFree--;
+    kv->head = s;
+    kv->pos  = KV_HEADSIZE;
+}
+static void W25Qxx_KV_Retire(W25Qxx_KV_t *kv, uint32_t sector, W25Qxx_ERR *err)									/* Free sector (clear magic, erased when reused) */
+{
+    uint8_t buf[4] = { 0x00, 0x00, 0x00, 0x00 };
+
+    W25Qxx_DIR_Program(kv->dev, buf, W25Qxx_KV_Addr(kv, sector), 4, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    kv->seq[sector] = KV_NONE;
+    kv->numFree++;
+}
+static uint32_t W25Qxx_KV_Copy(W25Qxx_KV_t *kv, uint32_t addr, uint32_t size, W25Qxx_ERR *err)					/* Copy record to head */
+{
+    uint32_t dst = 0;
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    if (kv->pos + size > kv->dev->sizeSector)
+    {
+        W25Qxx_KV_Open(kv, err);
+        if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+    }
+    dst = W25Qxx_KV_Addr(kv, kv->head) + kv->pos;
+
+    for (i = 0; i < size; i += num)
+    {
+        num = size - i;
+        if (num > W25Qxx_PAGESIZE) num = W25Qxx_PAGESIZE;
+        W25Qxx_Read(kv->dev, W25QXX_KV_BUF, addr + i, (uint16_t)num, err);
+        if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+        W25Qxx_DIR_Program(kv->dev, W25QXX_KV_BUF, dst + i, num, err);
+        if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+    }
+    kv->pos += size;
+
+    return dst;
+}
+static void W25Qxx_KV_Compact(W25Qxx_KV_t *kv, W25Qxx_ERR *err)													/* Move live records of the oldest sector to head */
+{
+    uint8_t rec[KV_RECSIZE + W25QXX_KV_KEYSIZE];
+    uint32_t old = KV_NONE;
+    uint32_t addr = 0;
+    uint32_t end = 0;
+    uint32_t size = 0;
+    uint32_t dst = 0;
+    uint32_t slot = 0;
+    uint8_t closed = 0;
+    uint8_t found = 0;
+    uint32_t s = 0;
+
+    /* oldest sector */
+    for (s = 0; s < kv->numSector; s++)
+    {
+        if (kv->seq[s] == KV_NONE || s == kv->head) continue;
+        if (old == KV_NONE || kv->seq[s] < kv->seq[old]) old = s;
+    }
+    if (old == KV_NONE)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    /* live record : the index points to it, tombstones of the oldest sector are dropped */
+    addr = W25Qxx_KV_Addr(kv, old) + KV_HEADSIZE;
+    end  = W25Qxx_KV_Addr(kv, old) + kv->dev->sizeSector;
+    while ((size = W25Qxx_KV_Next(kv, addr, end, rec, &closed, err)) != 0)
+    {
+        if (rec[5] == KV_TYPE_VALUE)
+        {
+            slot = W25Qxx_KV_Find(kv, &rec[KV_RECSIZE], rec[4], W25Qxx_KV_Hash(&rec[KV_RECSIZE], rec[4]), &found, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+            if (found && kv->index[slot].addr == addr)
+            {
+                dst = W25Qxx_KV_Copy(kv, addr, size, err);
+                if (*err != W25Qxx_ERR_NONE) return;
+                kv->index[slot].addr = dst;
+            }
+        }
+        addr += size;
+    }
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_KV_Retire(kv, old, err);
+    kv->numCompact++;
+}
+static uint32_t W25Qxx_KV_Append(W25Qxx_KV_t *kv, const uint8_t *key, uint8_t keyLen, uint8_t type, uint8_t *pValue, uint16_t NumByte, W25Qxx_ERR *err)	/* Append record, return record address */
+{
+    uint8_t rec[KV_RECSIZE + W25QXX_KV_KEYSIZE];
+    uint32_t size = KV_RECSIZE + keyLen + NumByte;
+    uint32_t addr = 0;
+    uint32_t crc = 0;
+    uint32_t i = 0;
+
+    /* Determine if the record fits in a sector */
+    if (size > kv->dev->sizeSector - KV_HEADSIZE)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return KV_NONE;
+    }
+
+    /* new head sector, compact first to keep the reserve */
+    if (kv->pos + size > kv->dev->sizeSector)
+    {
+        for (i = 0; kv->numFree < W25QXX_KV_RESERVE; i++)
+        {
+            if (i >= kv->numSector)
+            {
+                *err = W25Qxx_ERR_FULL;
+                return KV_NONE;
+            }
+            W25Qxx_KV_Compact(kv, err);
+            if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+        }
+        if (kv->pos + size > kv->dev->sizeSector)
+        {
+            W25Qxx_KV_Open(kv, err);
+            if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+        }
+    }
+
+    /* record header */
+    rec[4] = keyLen;
+    rec[5] = type;
+    rec[6] = (uint8_t)NumByte;
+    rec[7] = (uint8_t)(NumByte >> 8);
+    memcpy(&rec[KV_RECSIZE], key, keyLen);
+    crc = W25Qxx_CRC32C(0, &rec[4], KV_RECSIZE - 4 + keyLen);
+    crc = W25Qxx_CRC32C(crc, pValue, NumByte);
+    W25Qxx_Put32(rec, crc);
+
+    /* program */
+    addr = W25Qxx_KV_Addr(kv, kv->head) + kv->pos;
+    W25Qxx_DIR_Program(kv->dev, rec, addr, KV_RECSIZE + keyLen, err);
+    if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+    if (NumByte)
+    {
+        W25Qxx_DIR_Program(kv->dev, pValue, addr + KV_RECSIZE + keyLen, NumByte, err);
+        if (*err != W25Qxx_ERR_NONE) return KV_NONE;
+    }
+    kv->pos += size;
+
+    return addr;
+}
+static uint8_t W25Qxx_KV_Key(const char *key, W25Qxx_ERR *err)													/* Key length */
+{
+    size_t len = strlen(key);
+
+    if (len == 0 || len > W25QXX_KV_KEYSIZE)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return 0;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+    return (uint8_t)len;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               KV function                                                           */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_KV_Mount(W25Qxx_KV_t *kv, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    uint8_t rec[KV_RECSIZE + W25QXX_KV_KEYSIZE];
+    uint32_t last = 0;
+    uint32_t addr = 0;
+    uint32_t end = 0;
+    uint32_t size = 0;
+    uint32_t s = 0;
+    uint32_t i = 0;
+    uint8_t closed = 0;
+    uint8_t first = 1;
+
+    /* Determine if the sector range is valid */
+    if (NumSector <= W25QXX_KV_RESERVE || NumSector > W25QXX_KV_SECTOR || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(kv, 0, sizeof(W25Qxx_KV_t));
+    memset(kv->index, 0xFF, sizeof(kv->index));
+    kv->dev         = dev;
+    kv->startSector = StartSector;
+    kv->numSector   = NumSector;
+    kv->head        = NumSector - 1;
+    kv->pos         = dev->sizeSector;
+
+    /* sector header */
+    for (s = 0; s < NumSector; s++)
+    {
+        W25Qxx_Read(dev, rec, W25Qxx_KV_Addr(kv, s), KV_HEADSIZE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        kv->seq[s] = KV_NONE;
+        if (W25Qxx_Get32(&rec[0]) == W25QXX_KV_MAGIC && W25Qxx_Get32(&rec[4]) != KV_NONE)
+        {
+            kv->seq[s] = W25Qxx_Get32(&rec[4]);
+            if (kv->seq[s] >= kv->nextSeq) kv->nextSeq = kv->seq[s] + 1;
+        }
+        else
+        {
+            kv->numFree++;
+        }
+    }
+
+    /* replay sectors in seq order */
+    for (i = 0; i < NumSector - kv->numFree; i++)
+    {
+        /* next seq */
+        s = KV_NONE;
+        for (size = 0; size < NumSector; size++)
+        {
+            if (kv->seq[size] == KV_NONE || (!first && kv->seq[size] <= last)) continue;
+            if (s == KV_NONE || kv->seq[size] < kv->seq[s]) s = size;
+        }
+        last  = kv->seq[s];
+        first = 0;
+
+        addr = W25Qxx_KV_Addr(kv, s) + KV_HEADSIZE;
+        end  = W25Qxx_KV_Addr(kv, s) + dev->sizeSector;
+        while ((size = W25Qxx_KV_Next(kv, addr, end, rec, &closed, err)) != 0)
+        {
+            if (rec[5] == KV_TYPE_VALUE)
+            {
+                W25Qxx_KV_IndexSet(kv, &rec[KV_RECSIZE], rec[4], addr, err);
+            }
+            else
+            {
+                W25Qxx_KV_IndexDel(kv, &rec[KV_RECSIZE], rec[4], err);
+            }
+            if (*err != W25Qxx_ERR_NONE) return;
+            addr += size;
+        }
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* head : the last sector, a closed sector takes no more record */
+        kv->head = s;
+        kv->pos  = closed ? dev->sizeSector : addr - W25Qxx_KV_Addr(kv, s);
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_KV_Format(W25Qxx_KV_t *kv, W25Qxx_ERR *err)
+{
+    uint32_t s = 0;
+
+    for (s = 0; s < kv->numSector; s++)
+    {
+        if (kv->seq[s] == KV_NONE) continue;
+        W25Qxx_KV_Retire(kv, s, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    W25Qxx_KV_Mount(kv, kv->dev, kv->startSector, kv->numSector, err);
+}
+void W25Qxx_KV_Put(W25Qxx_KV_t *kv, const char *key, uint8_t *pValue, uint16_t NumByte, W25Qxx_ERR *err)
+{
+    uint8_t keyLen = W25Qxx_KV_Key(key, err);
+    uint8_t found = 0;
+    uint32_t addr = 0;
+
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* Determine if a new key fits in the index before the record is persisted (mount replays it) */
+    if (kv->numKey >= W25QXX_KV_INDEX - 1)
+    {
+        W25Qxx_KV_Find(kv, (const uint8_t *)key, keyLen, W25Qxx_KV_Hash((const uint8_t *)key, keyLen), &found, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        if (!found)
+        {
+            *err = W25Qxx_ERR_FULL;
+            return;
+        }
+    }
+
+    addr = W25Qxx_KV_Append(kv, (const uint8_t *)key, keyLen, KV_TYPE_VALUE, pValue, NumByte, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_KV_IndexSet(kv, (const uint8_t *)key, keyLen, addr, err);
+}
+uint16_t W25Qxx_KV_Get(W25Qxx_KV_t *kv, const char *key, uint8_t *pValue, uint16_t NumByte, W25Qxx_ERR *err)
+{
+    uint8_t rec[KV_RECSIZE];
+    uint8_t keyLen = W25Qxx_KV_Key(key, err);
+    uint8_t found = 0;
+    uint32_t slot = 0;
+    uint16_t valLen = 0;
+
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    slot = W25Qxx_KV_Find(kv, (const uint8_t *)key, keyLen, W25Qxx_KV_Hash((const uint8_t *)key, keyLen), &found, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+    if (!found)
+    {
+        *err = W25Qxx_ERR_NOTFOUND;
+        return 0;
+    }
+
+    /* value */
+    W25Qxx_Read(kv->dev, rec, kv->index[slot].addr, KV_RECSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+    valLen = rec[6] | ((uint16_t)rec[7] << 8);
+    if (NumByte > valLen) NumByte = valLen;
+    if (NumByte)
+    {
+        W25Qxx_Read(kv->dev, pValue, kv->index[slot].addr + KV_RECSIZE + keyLen, NumByte, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+    }
+
+    return valLen;
+}
+void W25Qxx_KV_Delete(W25Qxx_KV_t *kv, const char *key, W25Qxx_ERR *err)
+{
+    uint8_t keyLen = W25Qxx_KV_Key(key, err);
+    uint8_t found = 0;
+
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_KV_Find(kv, (const uint8_t *)key, keyLen, W25Qxx_KV_Hash((const uint8_t *)key, keyLen), &found, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (!found)
+    {
+        *err = W25Qxx_ERR_NOTFOUND;
+        return;
+    }
+
+    /* tombstone */
+    W25Qxx_KV_Append(kv, (const uint8_t *)key, keyLen, KV_TYPE_DELETE, NULL, 0, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_KV_IndexDel(kv, (const uint8_t *)key, keyLen, err);
+}
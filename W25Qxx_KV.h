@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_KV.h
+ * @brief   W25Qxx log structured key-value store header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_KV_H
+#define __W25QXX_KV_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Key-Value Store
+ *
+ * 				Records are appended to the sectors of a sector range by W25Qxx_DIR_Program,
+ * 				an update is a new record and a delete is a tombstone record, so a put costs a
+ * 				page program and no sector erase.
+ *
+ * 				Sector  : header {magic, seq}, the sectors are used as a ring in seq order.
+ * 				Record  : {crc32c, keyLen, type, valLen, key, value}, crc32c covers the record
+ * 				          from keyLen, a torn record fails the crc.
+ * 				Index   : RAM hash table (FNV-1a) of key -> record address, rebuilt at mount by
+ * 				          replaying the sectors in seq order. The key is compared on flash.
+ * 				Compact : when less than W25QXX_KV_RESERVE sectors are free, the live records of
+ * 				          the oldest sector are copied to the head and the oldest sector is freed.
+ * Note:
+ * 1. A free sector is erased when it becomes the head, a torn erase does not survive.
+ * 2. A record does not cross sectors, max value size = sizeSector - sector header - record header - key.
+ * 3. A sector with a torn record is closed, the next record starts in a new sector.
+ *
+ */
+#define W25QXX_KV_SECTOR                             64		/* Max sectors */
+#define W25QXX_KV_INDEX                              256	/* Index entries (power of 2, max keys = INDEX - 1) */
+#define W25QXX_KV_KEYSIZE                            32		/* Max key length */
+#define W25QXX_KV_RESERVE                            2		/* Free sectors kept for compaction */
+#define W25QXX_KV_MAGIC                              0x31564B3Cu	/* "<KV1" */
+
+/**
+ * @brief W25Qxx KV Index entry
+ */
+typedef struct
+{
+    uint32_t hash;                                   /* FNV-1a hash of key */
+    uint32_t addr;                                   /* Record address (0xFFFFFFFF : empty) */
+} W25Qxx_KV_ENTRY_t;
+
+/**
+ * @brief W25Qxx KV Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First sector */
+    uint32_t numSector;                              /* Sector number */
+    uint32_t seq[W25QXX_KV_SECTOR];                  /* Sector seq (0xFFFFFFFF : free) */
+    uint32_t nextSeq;                                /* Seq of next head sector */
+    uint32_t head;                                   /* Head sector */
+    uint32_t pos;                                    /* Write offset in head sector */
+    uint32_t numFree;                                /* Free sectors */
+    uint32_t numKey;                                 /* Keys in index */
+    W25Qxx_KV_ENTRY_t index[W25QXX_KV_INDEX];        /* Hash index */
+    uint32_t numErase;                               /* Sector erases */
+    uint32_t numCompact;                             /* Compacted sectors */
+} W25Qxx_KV_t;
+
+/**
+ * @brief W25Qxx KV function
+ */
+void W25Qxx_KV_Mount(W25Qxx_KV_t *kv, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_KV_Format(W25Qxx_KV_t *kv, W25Qxx_ERR *err);
+void W25Qxx_KV_Put(W25Qxx_KV_t *kv, const char *key, uint8_t *pValue, uint16_t NumByte, W25Qxx_ERR *err);
+uint16_t W25Qxx_KV_Get(W25Qxx_KV_t *kv, const char *key, uint8_t *pValue, uint16_t NumByte, W25Qxx_ERR *err);
+void W25Qxx_KV_Delete(W25Qxx_KV_t *kv, const char *key, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_LFS.c
+ * @brief   W25Qxx littlefs block device
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_LFS.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_LFS_Addr(const struct lfs_config *c, lfs_block_t block, lfs_off_t off)						/* Byte address of block offset */
+{
+    W25Qxx_LFS_t *bd = (W25Qxx_LFS_t *)c->context;
+
+    return (bd->startSector + block) * bd->dev->sizeSector + off;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               littlefs function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_LFS_config(W25Qxx_LFS_t *bd, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    uint32_t lookahead = 0;
+
+    /* Determine if the sector range is valid */
+    if (NumSector < 2 || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(bd, 0, sizeof(W25Qxx_LFS_t));
+    bd->dev = dev;
+    bd->startSector = StartSector;
+
+    /* one bit per block, multiple of 8 Byte */
+    lookahead = ((NumSector + 63) / 64) * 8;
+    if (lookahead > W25QXX_LFS_LOOKAHEAD) lookahead = W25QXX_LFS_LOOKAHEAD;
+
+    bd->cfg.context          = bd;
+    bd->cfg.read             = W25Qxx_LFS_Read;
+    bd->cfg.prog             = W25Qxx_LFS_Prog;
+    bd->cfg.erase            = W25Qxx_LFS_Erase;
+    bd->cfg.sync             = W25Qxx_LFS_Sync;
+    bd->cfg.read_size        = 1;
+    bd->cfg.prog_size        = 1;
+    bd->cfg.block_size       = dev->sizeSector;
+    bd->cfg.block_count      = NumSector;
+    bd->cfg.block_cycles     = W25QXX_LFS_CYCLES;
+    bd->cfg.cache_size       = dev->sizePage;
+    bd->cfg.lookahead_size   = lookahead;
+    bd->cfg.read_buffer      = bd->readBuffer;
+    bd->cfg.prog_buffer      = bd->progBuffer;
+    bd->cfg.lookahead_buffer = bd->lookaheadBuffer;
+
+    *err = W25Qxx_ERR_NONE;
+}
+int W25Qxx_LFS_Read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
+{
+    W25Qxx_LFS_t *bd = (W25Qxx_LFS_t *)c->context;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+
+    W25Qxx_Read_Start(bd->dev, W25Qxx_LFS_Addr(c, block, off), &err);
+    if (err != W25Qxx_ERR_NONE) return LFS_ERR_IO;
+
+    W25Qxx_Read_Stream(bd->dev, (uint8_t *)buffer, size);
+    W25Qxx_Read_Stop(bd->dev);
+
+    return LFS_ERR_OK;
+}
+int W25Qxx_LFS_Prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size)
+{
+    W25Qxx_LFS_t *bd = (W25Qxx_LFS_t *)c->context;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+
+    W25Qxx_DIR_Program(bd->dev, (uint8_t *)buffer, W25Qxx_LFS_Addr(c, block, off), size, &err);
+
+    return (err == W25Qxx_ERR_NONE) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+int W25Qxx_LFS_Erase(const struct lfs_config *c, lfs_block_t block)
+{
+    W25Qxx_LFS_t *bd = (W25Qxx_LFS_t *)c->context;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+
+    W25Qxx_Erase_Sector(bd->dev, bd->startSector + block, &err);
+
+    return (err == W25Qxx_ERR_NONE) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+int W25Qxx_LFS_Sync(const struct lfs_config *c)
+{
+    (void)c;
+
+    return LFS_ERR_OK;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_LFS.h
+ * @brief   W25Qxx littlefs block device header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_LFS_H
+#define __W25QXX_LFS_H
+
+#include "W25Qxx.h"
+#include "lfs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx littlefs Block Device
+ *
+ * 				The littlefs block device callbacks of a sector range.
+ *
+ * 				read  : W25Qxx_Read_Start/Stream/Stop, one CS enabled transfer of any size
+ * 				prog  : W25Qxx_DIR_Program, littlefs only programs erased blocks
+ * 				erase : W25Qxx_Erase_Sector
+ * 				sync  : program/erase waits for the end, nothing to do
+ *
+ * 				Geometry     : block = sector, read/prog size = 1 (NOR is byte addressable)
+ * 				Cache        : page size, a cache flush is one page program
+ * 				Lookahead    : one bit per block, rounded up to 8 Byte and limited to W25QXX_LFS_LOOKAHEAD
+ * Note:
+ * 1. The W25Qxx_LFS_t holds the struct lfs_config and the buffers, it must stay valid while mounted.
+ * 2. lfs_mount(&lfs, &W25Qxx_LFS_t.cfg)
+ *
+ */
+#define W25QXX_LFS_LOOKAHEAD                         128	/* Max lookahead buffer (Byte, multiple of 8) */
+#define W25QXX_LFS_CYCLES                            500	/* Erase cycles before metadata is moved (wear leveling) */
+
+/**
+ * @brief W25Qxx littlefs Block Device Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First sector */
+    struct lfs_config cfg;                           /* littlefs config */
+    uint8_t readBuffer[W25Qxx_PAGESIZE];             /* Read cache */
+    uint8_t progBuffer[W25Qxx_PAGESIZE];             /* Program cache */
+    uint8_t lookaheadBuffer[W25QXX_LFS_LOOKAHEAD];   /* Lookahead buffer */
+} W25Qxx_LFS_t;
+
+/**
+ * @brief W25Qxx littlefs Block Device function
+ */
+void W25Qxx_LFS_config(W25Qxx_LFS_t *bd, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+int W25Qxx_LFS_Read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size);
+int W25Qxx_LFS_Prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size);
+int W25Qxx_LFS_Erase(const struct lfs_config *c, lfs_block_t block);
+int W25Qxx_LFS_Sync(const struct lfs_config *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
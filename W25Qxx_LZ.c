@@ -0,0 +1,449 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_LZ.c
+ * @brief   W25Qxx compressed (LZ4 block) volume
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_LZ.h"
+#include <string.h>
+
+/* Index entry
+ * | rawEnd (4) | dataStart (4) | dataLen (4, bit31 : raw) | crc32c (4) |
+**/
+#define W25QXX_LZ_RAW      0x80000000
+#define W25QXX_LZ_NONE     0xFFFFFFFF
+
+/* Index entry state */
+#define W25QXX_LZ_BLANK    0
+#define W25QXX_LZ_VALID    1
+#define W25QXX_LZ_TORN     2
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_LZ_DataAddr(W25Qxx_LZ_t *lz, uint32_t Offset)												/* Byte address of data area offset */
+{
+    return (lz->startSector + lz->numIndex) * lz->dev->sizeSector + Offset;
+}
+static uint32_t W25Qxx_LZ_MaxEntry(W25Qxx_LZ_t *lz)																/* Index entry number */
+{
+    return lz->numIndex * lz->dev->sizeSector / W25QXX_LZ_ENTRY;
+}
+static uint8_t W25Qxx_LZ_Entry(W25Qxx_LZ_t *lz, uint32_t Entry, uint32_t *pRawEnd, uint32_t *pDataStart, uint32_t *pDataLen, W25Qxx_ERR *err)	/* Read index entry */
+{
+    uint8_t entry[W25QXX_LZ_ENTRY];
+
+    W25Qxx_Read(lz->dev, entry, lz->startSector * lz->dev->sizeSector + Entry * W25QXX_LZ_ENTRY, W25QXX_LZ_ENTRY, err);
+    if (*err != W25Qxx_ERR_NONE) return W25QXX_LZ_TORN;
+
+    if (W25Qxx_isBlank(entry, W25QXX_LZ_ENTRY)) return W25QXX_LZ_BLANK;
+    if (W25Qxx_Get32(entry + 12) != W25Qxx_CRC32C(0, entry, 12)) return W25QXX_LZ_TORN;
+
+    *pRawEnd = W25Qxx_Get32(entry);
+    *pDataStart = W25Qxx_Get32(entry + 4);
+    *pDataLen = W25Qxx_Get32(entry + 8);
+
+    return W25QXX_LZ_VALID;
+}
+static uint32_t W25Qxx_LZ_Sequence(uint8_t *pDst, uint32_t op, const uint8_t *pLiteral, uint32_t NumLiteral, uint32_t Offset, uint32_t NumMatch)	/* Emit LZ4 sequence (NumMatch = 0 : last literals) */
+{
+    uint32_t token = op++;
+    uint32_t len = 0;
+
+    pDst[token] = (uint8_t)(((NumLiteral >= 15) ? 15 : NumLiteral) << 4);
+    if (NumLiteral >= 15)
+    {
+        for (len = NumLiteral - 15; len >= 255; len -= 255) pDst[op++] = 255;
+        pDst[op++] = (uint8_t)len;
+    }
+    memcpy(pDst + op, pLiteral, NumLiteral);
+    op += NumLiteral;
+    if (NumMatch == 0) return op;
+
+    pDst[op++] = (uint8_t)Offset;
+    pDst[op++] = (uint8_t)(Offset >> 8);
+    NumMatch -= 4;
+    pDst[token] |= (uint8_t)((NumMatch >= 15) ? 15 : NumMatch);
+    if (NumMatch >= 15)
+    {
+        for (len = NumMatch - 15; len >= 255; len -= 255) pDst[op++] = 255;
+        pDst[op++] = (uint8_t)len;
+    }
+
+    return op;
+}
+static uint32_t W25Qxx_LZ_Compress(W25Qxx_LZ_t *lz, uint32_t NumByte)											/* LZ4 block compress of append block */
+{
+    const uint8_t *src = lz->block;
+    uint32_t anchor = 0;
+    uint32_t ip = 0;
+    uint32_t op = 0;
+    uint32_t ref = 0;
+    uint32_t num = 0;
+    uint32_t h = 0;
+
+    memset(lz->hash, 0, sizeof(lz->hash));
+
+    /* a match starts 12 Byte and ends 5 Byte before the end (LZ4 rule) */
+    while (NumByte > 12 && ip < NumByte - 12)
+    {
+        h = ((W25Qxx_Get32(src + ip) * 2654435761u) >> 16) & (W25QXX_LZ_HASH - 1);
+        ref = lz->hash[h];
+        lz->hash[h] = (uint16_t)(ip + 1);
+        if (ref == 0 || W25Qxx_Get32(src + ref - 1) != W25Qxx_Get32(src + ip))
+        {
+            ip++;
+            continue;
+        }
+        ref--;
+
+        for (num = 4; ip + num < NumByte - 5 && src[ref + num] == src[ip + num]; num++);
+        op = W25Qxx_LZ_Sequence(lz->comp, op, src + anchor, ip - anchor, ip - ref, num);
+        ip += num;
+        anchor = ip;
+    }
+
+    return W25Qxx_LZ_Sequence(lz->comp, op, src + anchor, NumByte - anchor, 0, 0);
+}
+static uint32_t W25Qxx_LZ_Length(W25Qxx_LZ_t *lz, uint32_t len, uint32_t *pIn, uint32_t DataLen)				/* LZ4 length extension Byte from stream */
+{
+    uint8_t data = 0;
+
+    if (len != 15) return len;
+    do
+    {
+        if (*pIn >= DataLen) return 0xFFFFFFFF;
+        W25Qxx_Read_Stream(lz->dev, &data, 1);
+        (*pIn)++;
+        len += data;
+    } while (data == 255);
+
+    return len;
+}
+static void W25Qxx_LZ_Decode(W25Qxx_LZ_t *lz, uint32_t DataStart, uint32_t DataLen, uint32_t RawLen, W25Qxx_ERR *err)	/* Decode block to cache (compressed data streamed from flash) */
+{
+    uint32_t in = 0;
+    uint32_t out = 0;
+    uint32_t len = 0;
+    uint32_t off = 0;
+    uint8_t data[2];
+    uint8_t token = 0;
+
+    W25Qxx_Read_Start(lz->dev, W25Qxx_LZ_DataAddr(lz, DataStart), err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* raw block */
+    if (DataLen & W25QXX_LZ_RAW)
+    {
+        W25Qxx_Read_Stream(lz->dev, lz->cache, RawLen);
+        W25Qxx_Read_Stop(lz->dev);
+        return;
+    }
+
+    while (in < DataLen)
+    {
+        W25Qxx_Read_Stream(lz->dev, &token, 1);
+        in++;
+
+        /* literals */
+        len = W25Qxx_LZ_Length(lz, token >> 4, &in, DataLen);
+        if (len > RawLen - out || len > DataLen - in) break;
+        W25Qxx_Read_Stream(lz->dev, lz->cache + out, len);
+        out += len;
+        in += len;
+        if (in == DataLen) break;
+
+        /* match */
+        if (DataLen - in < 2) break;
+        W25Qxx_Read_Stream(lz->dev, data, 2);
+        in += 2;
+        off = data[0] | ((uint32_t)data[1] << 8);
+        len = W25Qxx_LZ_Length(lz, token & 0x0F, &in, DataLen);
+        if (len == 0xFFFFFFFF || off == 0 || off > out || len + 4 > RawLen - out) break;
+        for (len += 4; len; len--, out++) lz->cache[out] = lz->cache[out - off];
+    }
+
+    W25Qxx_Read_Stop(lz->dev);
+
+    if (in != DataLen || out != RawLen) *err = W25Qxx_ERR_CHECKSUM;
+}
+static void W25Qxx_LZ_Commit(W25Qxx_LZ_t *lz, W25Qxx_ERR *err)													/* Write append block to flash */
+{
+    uint8_t entry[W25QXX_LZ_ENTRY];
+    uint32_t len = 0;
+    uint8_t *src = lz->block;
+
+    *err = W25Qxx_ERR_NONE;
+    if (lz->numBlock == 0) return;
+
+    /* a block that does not get smaller is stored raw */
+    len = W25Qxx_LZ_Compress(lz, lz->numBlock);
+    if (len < lz->numBlock) src = lz->comp;
+    else len = lz->numBlock;
+
+    if (lz->numEntry >= W25Qxx_LZ_MaxEntry(lz) || lz->dataEnd + len > lz->numData * lz->dev->sizeSector)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    /* data first, the entry commits the block */
+    W25Qxx_DIR_Program(lz->dev, src, W25Qxx_LZ_DataAddr(lz, lz->dataEnd), len, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    memset(entry, 0xFF, W25QXX_LZ_ENTRY);
+    W25Qxx_Put32(entry, lz->rawEnd + lz->numBlock);
+    W25Qxx_Put32(entry + 4, lz->dataEnd);
+    W25Qxx_Put32(entry + 8, len | ((src == lz->block) ? W25QXX_LZ_RAW : 0));
+    W25Qxx_Put32(entry + 12, W25Qxx_CRC32C(0, entry, 12));
+    W25Qxx_DIR_Program(lz->dev, entry, lz->startSector * lz->dev->sizeSector + lz->numEntry * W25QXX_LZ_ENTRY, W25QXX_LZ_ENTRY, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    lz->numEntry++;
+    lz->rawEnd += lz->numBlock;
+    lz->dataEnd += len;
+    lz->numBlock = 0;
+}
+static void W25Qxx_LZ_Load(W25Qxx_LZ_t *lz, uint32_t ByteAddr, W25Qxx_ERR *err)									/* Decode the block of a logical address to cache */
+{
+    uint32_t rawEnd = 0;
+    uint32_t dataStart = 0;
+    uint32_t dataLen = 0;
+    uint32_t rawStart = 0;
+    uint32_t entry = W25QXX_LZ_NONE;
+    uint32_t lo = 0;
+    uint32_t hi = lz->numEntry;
+    uint32_t mid = 0;
+    uint32_t i = 0;
+
+    /* sequential read, the next valid entry follows the cached block */
+    if (lz->cacheEntry != W25QXX_LZ_NONE && ByteAddr == lz->cacheStart + lz->cacheLen)
+    {
+        for (i = lz->cacheEntry + 1; i < lz->numEntry; i++)
+        {
+            if (W25Qxx_LZ_Entry(lz, i, &rawEnd, &dataStart, &dataLen, err) == W25QXX_LZ_VALID)
+            {
+                entry = i;
+                rawStart = ByteAddr;
+                break;
+            }
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+    }
+
+    if (entry == W25QXX_LZ_NONE)
+    {
+        /* first valid entry with rawEnd > ByteAddr, torn entries are skipped */
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            for (i = mid; i < lz->numEntry; i++)
+            {
+                if (W25Qxx_LZ_Entry(lz, i, &rawEnd, &dataStart, &dataLen, err) == W25QXX_LZ_VALID) break;
+                if (*err != W25Qxx_ERR_NONE) return;
+            }
+            if (i == lz->numEntry || rawEnd > ByteAddr) hi = mid;
+            else lo = i + 1;
+        }
+        for (i = lo; i < lz->numEntry; i++)
+        {
+            if (W25Qxx_LZ_Entry(lz, i, &rawEnd, &dataStart, &dataLen, err) == W25QXX_LZ_VALID) break;
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+        if (i == lz->numEntry)
+        {
+            *err = W25Qxx_ERR_BYTEADDRBOUND;
+            return;
+        }
+        entry = i;
+
+        /* block start is the end of the previous valid entry */
+        while (i-- > 0)
+        {
+            if (W25Qxx_LZ_Entry(lz, i, &rawStart, &mid, &hi, err) == W25QXX_LZ_VALID) break;
+            if (*err != W25Qxx_ERR_NONE) return;
+            rawStart = 0;
+        }
+    }
+
+    if (rawEnd - rawStart > W25QXX_LZ_BLOCK)
+    {
+        *err = W25Qxx_ERR_CHECKSUM;
+        return;
+    }
+
+    lz->cacheEntry = W25QXX_LZ_NONE;
+    W25Qxx_LZ_Decode(lz, dataStart, dataLen, rawEnd - rawStart, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    lz->cacheEntry = entry;
+    lz->cacheStart = rawStart;
+    lz->cacheLen = rawEnd - rawStart;
+    lz->numDecode++;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               LZ function                                                           */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_LZ_Mount(W25Qxx_LZ_t *lz, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    uint8_t data[W25Qxx_PAGESIZE];
+    uint32_t rawEnd = 0;
+    uint32_t dataStart = 0;
+    uint32_t dataLen = 0;
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    uint32_t mid = 0;
+    uint32_t off = 0;
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    /* Determine if the sector range is valid */
+    if (NumSector < 2 || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(lz, 0, sizeof(W25Qxx_LZ_t));
+    lz->dev = dev;
+    lz->startSector = StartSector;
+    lz->numIndex = (NumSector + 15) / 16;
+    lz->numData = NumSector - lz->numIndex;
+    lz->sizeBlock = W25QXX_LZ_BLOCK;
+    lz->cacheEntry = W25QXX_LZ_NONE;
+
+    /* entries are appended, the first blank entry is the end */
+    hi = W25Qxx_LZ_MaxEntry(lz);
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (W25Qxx_LZ_Entry(lz, mid, &rawEnd, &dataStart, &dataLen, err) == W25QXX_LZ_BLANK) hi = mid;
+        else lo = mid + 1;
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    lz->numEntry = lo;
+
+    /* the last valid entry */
+    for (i = lz->numEntry; i > 0; i--)
+    {
+        if (W25Qxx_LZ_Entry(lz, i - 1, &rawEnd, &dataStart, &dataLen, err) == W25QXX_LZ_VALID)
+        {
+            lz->rawEnd = rawEnd;
+            lz->dataEnd = dataStart + (dataLen & ~W25QXX_LZ_RAW);
+            break;
+        }
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    /* data of a block without entry (power loss) is skipped */
+    for (off = lz->dataEnd, hi = lz->dataEnd; off < lz->dataEnd + W25QXX_LZ_BOUND && off < lz->numData * dev->sizeSector; off += num)
+    {
+        num = sizeof(data);
+        if (num > lz->numData * dev->sizeSector - off) num = lz->numData * dev->sizeSector - off;
+        W25Qxx_Read(dev, data, W25Qxx_LZ_DataAddr(lz, off), num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        for (i = 0; i < num; i++)
+        {
+            if (data[i] != 0xFF) hi = off + i + 1;
+        }
+    }
+    lz->dataEnd = hi;
+}
+void W25Qxx_LZ_Format(W25Qxx_LZ_t *lz, W25Qxx_ERR *err)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < lz->numIndex + lz->numData; i++)
+    {
+        W25Qxx_Erase_Sector(lz->dev, lz->startSector + i, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    lz->numEntry = 0;
+    lz->rawEnd = 0;
+    lz->dataEnd = 0;
+    lz->numBlock = 0;
+    lz->cacheEntry = W25QXX_LZ_NONE;
+}
+void W25Qxx_LZ_Append(W25Qxx_LZ_t *lz, uint8_t *pBuffer, uint32_t NumByte, W25Qxx_ERR *err)
+{
+    uint32_t num = 0;
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByte; NumByte -= num, pBuffer += num)
+    {
+        num = (lz->numBlock < lz->sizeBlock) ? lz->sizeBlock - lz->numBlock : 0;
+        if (num > NumByte) num = NumByte;
+
+        memcpy(lz->block + lz->numBlock, pBuffer, num);
+        lz->numBlock += num;
+        if (lz->numBlock >= lz->sizeBlock)
+        {
+            W25Qxx_LZ_Commit(lz, err);
+            if (*err != W25Qxx_ERR_NONE)
+            {
+                lz->numBlock -= num;
+                return;
+            }
+        }
+    }
+}
+void W25Qxx_LZ_Sync(W25Qxx_LZ_t *lz, W25Qxx_ERR *err)
+{
+    W25Qxx_LZ_Commit(lz, err);
+}
+void W25Qxx_LZ_Read(W25Qxx_LZ_t *lz, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err)
+{
+    uint32_t num = 0;
+
+    /* Determine if the address > volume size */
+    if (ByteAddr > W25Qxx_LZ_Size(lz) || NumByteToRead > W25Qxx_LZ_Size(lz) - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByteToRead; NumByteToRead -= num, pBuffer += num, ByteAddr += num)
+    {
+        /* not synced part of append block */
+        if (ByteAddr >= lz->rawEnd)
+        {
+            memcpy(pBuffer, lz->block + (ByteAddr - lz->rawEnd), NumByteToRead);
+            return;
+        }
+
+        if (lz->cacheEntry == W25QXX_LZ_NONE || ByteAddr < lz->cacheStart || ByteAddr >= lz->cacheStart + lz->cacheLen)
+        {
+            W25Qxx_LZ_Load(lz, ByteAddr, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+
+        num = lz->cacheStart + lz->cacheLen - ByteAddr;
+        if (num > NumByteToRead) num = NumByteToRead;
+        memcpy(pBuffer, lz->cache + (ByteAddr - lz->cacheStart), num);
+    }
+}
+uint32_t W25Qxx_LZ_Size(W25Qxx_LZ_t *lz)
+{
+    return lz->rawEnd + lz->numBlock;
+}
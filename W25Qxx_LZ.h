@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_LZ.h
+ * @brief   W25Qxx compressed (LZ4 block) volume header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_LZ_H
+#define __W25QXX_LZ_H
+
+#include "W25Qxx.h"
+#include "W25Qxx_CRC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Compressed Volume
+ *
+ * 				Appended data is cut into blocks of W25QXX_LZ_BLOCK Byte, a block is compressed to the
+ * 				LZ4 block format (stored raw when it does not get smaller) and programmed by W25Qxx_DIR_Program.
+ *
+ * 				Layout : | index sectors (NumSector / 16) | data sectors |
+ * 				Index  : entry {rawEnd, dataStart, dataLen (bit31 : raw), crc32c} per block, appended.
+ * 				         A read finds the block by binary search of rawEnd, a torn entry is skipped.
+ * 				Read   : only the touched blocks are decoded, the compressed data is streamed from flash
+ * 				         by one continuous read, the last decoded block is cached.
+ * Note:
+ * 1. The volume is append only, the space is given back by W25Qxx_LZ_Format.
+ * 2. W25Qxx_LZ_Sync writes the collected part of a block as a short block, data not synced is
+ *    lost on power loss but readable before.
+ * 3. RAM : 3 x W25QXX_LZ_BLOCK + 2 x W25QXX_LZ_HASH Byte (+ 1/255 of block).
+ * 4. lz->sizeBlock (default W25QXX_LZ_BLOCK) may be lowered after the mount for smaller blocks
+ *    (faster random read, lower ratio), a volume of any block size up to W25QXX_LZ_BLOCK is readable.
+ *
+ */
+#define W25QXX_LZ_BLOCK                              1024	/* Block size (Byte, max 65535) */
+#define W25QXX_LZ_HASH                               1024	/* Compressor hash table entries (power of 2) */
+#define W25QXX_LZ_ENTRY                              16		/* Index entry size (Byte) */
+#define W25QXX_LZ_BOUND                              (W25QXX_LZ_BLOCK + W25QXX_LZ_BLOCK / 255 + 16)	/* Max compressed block size */
+
+/**
+ * @brief W25Qxx Compressed Volume Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First sector */
+    uint32_t numIndex;                               /* Index sector number */
+    uint32_t numData;                                /* Data sector number */
+    uint32_t numEntry;                               /* Index entry used (with torn entry) */
+    uint32_t rawEnd;                                 /* Logical size written to flash */
+    uint32_t dataEnd;                                /* Next data Byte (data area offset) */
+    uint32_t sizeBlock;                              /* Append block size (Byte, max W25QXX_LZ_BLOCK) */
+    uint32_t numBlock;                               /* Collected Byte of append block */
+    uint32_t cacheEntry;                             /* Entry of cached block (0xFFFFFFFF : none) */
+    uint32_t cacheStart;                             /* Logical address of cached block */
+    uint32_t cacheLen;                               /* Length of cached block */
+    uint8_t block[W25QXX_LZ_BLOCK];                  /* Append block */
+    uint8_t cache[W25QXX_LZ_BLOCK];                  /* Decoded block */
+    uint8_t comp[W25QXX_LZ_BOUND];                   /* Compressed block */
+    uint16_t hash[W25QXX_LZ_HASH];                   /* Compressor hash table */
+    uint32_t numDecode;                              /* Decoded block */
+} W25Qxx_LZ_t;
+
+/**
+ * @brief W25Qxx Compressed Volume function
+ */
+void W25Qxx_LZ_Mount(W25Qxx_LZ_t *lz, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_LZ_Format(W25Qxx_LZ_t *lz, W25Qxx_ERR *err);
+void W25Qxx_LZ_Append(W25Qxx_LZ_t *lz, uint8_t *pBuffer, uint32_t NumByte, W25Qxx_ERR *err);
+void W25Qxx_LZ_Sync(W25Qxx_LZ_t *lz, W25Qxx_ERR *err);
+void W25Qxx_LZ_Read(W25Qxx_LZ_t *lz, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err);
+uint32_t W25Qxx_LZ_Size(W25Qxx_LZ_t *lz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Log.c
+ * @brief   W25Qxx append only ring log
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Log.h"
+#include "W25Qxx_CRC.h"
+#include <string.h>
+
+/* Layout */
+#define LOG_HEADSIZE         8				/* Sector header {magic, seq} */
+#define LOG_RECSIZE          3				/* Record overhead {len, commit} */
+#define LOG_COMMIT           0x00
+#define LOG_NONE             0xFFFFFFFFu
+
+/* Buffer */
+static uint8_t W25QXX_LOG_BUF[W25Qxx_PAGESIZE];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_Log_Addr(W25Qxx_LOG_t *log, uint32_t sector)												/* Byte address of sector */
+{
+    return (log->startSector + sector) * log->dev->sizeSector;
+}
+static uint32_t W25Qxx_Log_Seq(W25Qxx_LOG_t *log, uint32_t sector, W25Qxx_ERR *err)								/* Seq of sector (0xFFFFFFFF : no header) */
+{
+    uint8_t buf[LOG_HEADSIZE];
+
+    W25Qxx_Read(log->dev, buf, W25Qxx_Log_Addr(log, sector), LOG_HEADSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return LOG_NONE;
+
+    if (W25Qxx_Get32(buf) != W25QXX_LOG_MAGIC) return LOG_NONE;
+
+    return W25Qxx_Get32(buf + 4);
+}
+static void W25Qxx_Log_Idle(W25Qxx_LOG_t *log, W25Qxx_ERR *err)													/* Wait for end of program/erase ahead */
+{
+    uint32_t i = 0;
+
+    /* a short program ends within some polls, the 1ms wait is for the erase ahead */
+    for (i = 0; i < W25QXX_LOG_POLL; i++)
+    {
+        if (W25Qxx_ReadStatus(log->dev) & (W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND))
+        {
+            *err = W25Qxx_ERR_NONE;
+            return;
+        }
+    }
+
+    W25Qxx_isStatus(log->dev, W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, log->dev->info.EraseMaxTimeSector, err);
+}
+static void W25Qxx_Log_Program(W25Qxx_LOG_t *log, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Program (no wait for end of the last page) */
+{
+    uint32_t num = 0;
+
+    for (; NumByte; NumByte -= num)
+    {
+        /* no beyond page address */
+        num = log->dev->sizePage - (ByteAddr % log->dev->sizePage);
+        if (num > NumByte) num = NumByte;
+
+        W25Qxx_Log_Idle(log, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        W25Qxx_DIR_Program_Page_Start(log->dev, pBuffer, ByteAddr, (uint16_t)num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        pBuffer  += num;
+        ByteAddr += num;
+    }
+}
+static void W25Qxx_Log_Record(W25Qxx_LOG_t *log, uint8_t *pBuffer, uint16_t NumByte, uint32_t ByteAddr, W25Qxx_ERR *err)	/* Program {len, data} of a record (one program per page) */
+{
+    uint32_t total = 2 + (uint32_t)NumByte;
+    uint32_t pos = 0;
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    for (; pos < total; pos += num)
+    {
+        num = log->dev->sizePage - ((ByteAddr + pos) % log->dev->sizePage);
+        if (num > total - pos) num = total - pos;
+
+        /* data only */
+        if (pos >= 2)
+        {
+            W25Qxx_Log_Program(log, pBuffer + pos - 2, ByteAddr + pos, num, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+            continue;
+        }
+
+        /* the page with the length */
+        for (i = 0; i < num; i++)
+        {
+            W25QXX_LOG_BUF[i] = (pos + i < 2) ? (uint8_t)(NumByte >> ((pos + i) * 8)) : pBuffer[pos + i - 2];
+        }
+        W25Qxx_Log_Program(log, W25QXX_LOG_BUF, ByteAddr + pos, num, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+}
+static uint32_t W25Qxx_Log_Walk(W25Qxx_LOG_t *log, uint32_t sector, W25Qxx_ERR *err)								/* Write offset of sector (one continuous read) */
+{
+    uint8_t buf[2];
+    uint32_t pos = LOG_HEADSIZE;
+    uint16_t len = 0;
+
+    W25Qxx_Read_Start(log->dev, W25Qxx_Log_Addr(log, sector) + LOG_HEADSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return pos;
+
+    while (pos + LOG_RECSIZE <= log->dev->sizeSector)
+    {
+        /* length, blank : end of records */
+        W25Qxx_Read_Stream(log->dev, buf, 2);
+        len = buf[0] | ((uint16_t)buf[1] << 8);
+        if (len == 0xFFFF) break;
+
+        /* torn record, the sector is closed */
+        if (pos + LOG_RECSIZE + len > log->dev->sizeSector)
+        {
+            pos = log->dev->sizeSector;
+            break;
+        }
+        W25Qxx_Read_Stream(log->dev, NULL, len);
+        W25Qxx_Read_Stream(log->dev, buf, 1);
+        if (buf[0] != LOG_COMMIT)
+        {
+            pos = log->dev->sizeSector;
+            break;
+        }
+        pos += LOG_RECSIZE + len;
+    }
+
+    W25Qxx_Read_Stop(log->dev);
+
+    return pos;
+}
+static void W25Qxx_Log_Open(W25Qxx_LOG_t *log, W25Qxx_ERR *err)													/* New head sector and erase ahead */
+{
+    uint8_t buf[LOG_HEADSIZE];
+    uint32_t next = log->empty ? 0 : (log->head + 1) % log->numSector;
+    uint32_t seq = log->empty ? 1 : log->seqHead + 1;
+
+    W25Qxx_Log_Idle(log, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* not erased ahead (first sector or after mount) */
+    if (next != log->ahead)
+    {
+        W25Qxx_Erase_Sector(log->dev, log->startSector + next, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        log->numErase++;
+    }
+    log->ahead = LOG_NONE;
+
+    /* the tail is overwritten (ring of 2 sectors) */
+    if (!log->empty && next == log->tail)
+    {
+        log->tail = (log->tail + 1) % log->numSector;
+        log->seqTail++;
+    }
+
+    /* header */
+    W25Qxx_Put32(buf, W25QXX_LOG_MAGIC);
+    W25Qxx_Put32(buf + 4, seq);
+    W25Qxx_Log_Program(log, buf, W25Qxx_Log_Addr(log, next), LOG_HEADSIZE, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    if (log->empty)
+    {
+        log->tail    = next;
+        log->seqTail = seq;
+        log->empty   = 0;
+    }
+    log->head    = next;
+    log->seqHead = seq;
+    log->pos     = LOG_HEADSIZE;
+
+    /* erase ahead, the oldest sector is dropped */
+    W25Qxx_Log_Idle(log, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    next = (next + 1) % log->numSector;
+    if (next == log->tail && next != log->head)
+    {
+        log->tail = (log->tail + 1) % log->numSector;
+        log->seqTail++;
+    }
+    W25Qxx_Erase_Sector_Start(log->dev, log->startSector + next, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    log->ahead = next;
+    log->numErase++;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Log function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Log_Mount(W25Qxx_LOG_t *log, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    uint32_t base = 0;
+    uint32_t seqBase = 0;
+    uint32_t seq = 0;
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    uint32_t mid = 0;
+    uint32_t s = 0;
+
+    /* Determine if the sector range is valid */
+    if (NumSector < 2 || StartSector + NumSector > dev->numSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(log, 0, sizeof(W25Qxx_LOG_t));
+    log->dev         = dev;
+    log->startSector = StartSector;
+    log->numSector   = NumSector;
+    log->ahead       = LOG_NONE;
+    log->empty       = 1;
+
+    /* an erase/program started before (e.g. a remount) is not read through */
+    W25Qxx_Log_Idle(log, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* base : sector 0, or sector 1 if sector 0 is erased ahead of the head (n - 1) */
+    seqBase = W25Qxx_Log_Seq(log, 0, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (seqBase == LOG_NONE)
+    {
+        base = 1;
+        seqBase = W25Qxx_Log_Seq(log, 1, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        if (seqBase == LOG_NONE) return;
+    }
+
+    /* head : the last sector from base with seq >= seq of base */
+    lo = base;
+    hi = NumSector;
+    while (hi - lo > 1)
+    {
+        mid = lo + (hi - lo) / 2;
+        seq = W25Qxx_Log_Seq(log, mid, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        if (seq != LOG_NONE && seq >= seqBase) lo = mid;
+        else                                   hi = mid;
+    }
+    log->head    = lo;
+    log->seqHead = seqBase + (lo - base);
+    log->empty   = 0;
+
+    /* tail : the oldest sector after the head, or base if the ring is not wrapped */
+    log->tail    = base;
+    log->seqTail = seqBase;
+    for (mid = 1; mid <= 2 && mid < NumSector; mid++)
+    {
+        s = (lo + mid) % NumSector;
+        seq = W25Qxx_Log_Seq(log, s, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        if (seq != LOG_NONE && seq < log->seqHead)
+        {
+            log->tail    = s;
+            log->seqTail = seq;
+            break;
+        }
+    }
+
+    /* write offset of the head */
+    log->seqHead = W25Qxx_Log_Seq(log, lo, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    log->pos = W25Qxx_Log_Walk(log, lo, err);
+}
+void W25Qxx_Log_Append(W25Qxx_LOG_t *log, uint8_t *pBuffer, uint16_t NumByte, W25Qxx_ERR *err)
+{
+    uint8_t buf[1];
+    uint32_t addr = 0;
+
+    /* Determine if the record fits in a sector */
+    if (NumByte == 0xFFFF || LOG_HEADSIZE + LOG_RECSIZE + (uint32_t)NumByte > log->dev->sizeSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* new head sector */
+    if (log->empty || log->pos + LOG_RECSIZE + NumByte > log->dev->sizeSector)
+    {
+        W25Qxx_Log_Open(log, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    /* length and data together, commit */
+    addr = W25Qxx_Log_Addr(log, log->head) + log->pos;
+    W25Qxx_Log_Record(log, pBuffer, NumByte, addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    buf[0] = LOG_COMMIT;
+    W25Qxx_Log_Program(log, buf, addr + 2 + NumByte, 1, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    log->pos += LOG_RECSIZE + NumByte;
+    log->numAppend++;
+}
+void W25Qxx_Log_Rewind(W25Qxx_LOG_t *log, W25Qxx_LOG_CURSOR_t *cur)
+{
+    cur->sector = log->tail;
+    cur->pos    = LOG_HEADSIZE;
+    cur->seq    = log->seqTail;
+}
+uint16_t W25Qxx_Log_Next(W25Qxx_LOG_t *log, W25Qxx_LOG_CURSOR_t *cur, uint8_t *pBuffer, uint16_t NumByte, W25Qxx_ERR *err)
+{
+    uint8_t buf[2];
+    uint32_t addr = 0;
+    uint16_t len = 0;
+
+    W25Qxx_Log_Idle(log, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    while (!log->empty)
+    {
+        /* overwritten by the ring */
+        if (cur->seq < log->seqTail)
+        {
+            W25Qxx_Log_Rewind(log, cur);
+        }
+
+        /* end of log */
+        if (cur->seq == log->seqHead && cur->pos >= log->pos) break;
+
+        /* record in sector */
+        addr = W25Qxx_Log_Addr(log, cur->sector) + cur->pos;
+        if (cur->pos + LOG_RECSIZE <= log->dev->sizeSector)
+        {
+            W25Qxx_Read(log->dev, buf, addr, 2, err);
+            if (*err != W25Qxx_ERR_NONE) return 0;
+            len = buf[0] | ((uint16_t)buf[1] << 8);
+
+            if (len != 0xFFFF && cur->pos + LOG_RECSIZE + len <= log->dev->sizeSector)
+            {
+                W25Qxx_Read(log->dev, buf, addr + 2 + len, 1, err);
+                if (*err != W25Qxx_ERR_NONE) return 0;
+
+                if (buf[0] == LOG_COMMIT)
+                {
+                    if (NumByte > len) NumByte = len;
+                    if (NumByte)
+                    {
+                        W25Qxx_Read(log->dev, pBuffer, addr + 2, NumByte, err);
+                        if (*err != W25Qxx_ERR_NONE) return 0;
+                    }
+                    cur->pos += LOG_RECSIZE + len;
+                    return len;
+                }
+            }
+        }
+
+        /* end of sector (or torn record), next sector */
+        if (cur->seq == log->seqHead) break;
+        cur->sector = (cur->sector + 1) % log->numSector;
+        cur->seq++;
+        cur->pos = LOG_HEADSIZE;
+    }
+
+    *err = W25Qxx_ERR_NOTFOUND;
+    return 0;
+}
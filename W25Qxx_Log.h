@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Log.h
+ * @brief   W25Qxx append only ring log header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_LOG_H
+#define __W25QXX_LOG_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Ring Log
+ *
+ * 				Records are appended to the sectors of a sector range used as a ring.
+ *
+ * 				Sector : header {magic, seq}, seq + 1 for every new head sector.
+ * 				Record : {len, data, 0x00}, len and data in one program per page, the commit byte
+ * 				         0x00 is programmed last.
+ * 				Mount  : the sectors from the first one up to the head hold increasing seq, the head
+ * 				         is found by binary search of the sector headers (log2(n) reads of 8 Byte),
+ * 				         the write offset by one continuous read of the head sector.
+ * 				Erase  : the sector after the head is erased ahead (oldest data is dropped).
+ * 				Wait   : erase/program is started only, the next access waits for its end by polling
+ * 				         BUSY W25QXX_LOG_POLL times before the 1ms wait of W25Qxx_isStatus.
+ * Note:
+ * 1. A record does not cross sectors, max record size = sizeSector - 8 - 3.
+ * 2. A head sector with a torn record is closed, the next record starts in a new sector.
+ * 3. A reader cursor that is overwritten by the ring goes on from the tail.
+ *
+ */
+#define W25QXX_LOG_POLL                              1024	/* BUSY polls before 1ms wait */
+#define W25QXX_LOG_MAGIC                             0x474F4C3Cu	/* "<LOG" */
+
+/**
+ * @brief W25Qxx Log reader cursor
+ */
+typedef struct
+{
+    uint32_t sector;                                 /* Sector */
+    uint32_t pos;                                    /* Offset in sector */
+    uint32_t seq;                                    /* Seq of sector */
+} W25Qxx_LOG_CURSOR_t;
+
+/**
+ * @brief W25Qxx Log Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t startSector;                            /* First sector */
+    uint32_t numSector;                              /* Sector number */
+    uint32_t head;                                   /* Head sector */
+    uint32_t seqHead;                                /* Seq of head sector */
+    uint32_t pos;                                    /* Write offset in head sector */
+    uint32_t tail;                                   /* Tail (oldest) sector */
+    uint32_t seqTail;                                /* Seq of tail sector */
+    uint32_t ahead;                                  /* Sector erased ahead (0xFFFFFFFF : none) */
+    uint8_t empty;                                   /* No sector is written */
+    uint32_t numAppend;                              /* Appended records */
+    uint32_t numErase;                               /* Sector erases */
+} W25Qxx_LOG_t;
+
+/**
+ * @brief W25Qxx Log function
+ */
+void W25Qxx_Log_Mount(W25Qxx_LOG_t *log, W25Qxx_t *dev, uint32_t StartSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_Log_Append(W25Qxx_LOG_t *log, uint8_t *pBuffer, uint16_t NumByte, W25Qxx_ERR *err);
+void W25Qxx_Log_Rewind(W25Qxx_LOG_t *log, W25Qxx_LOG_CURSOR_t *cur);
+uint16_t W25Qxx_Log_Next(W25Qxx_LOG_t *log, W25Qxx_LOG_CURSOR_t *cur, uint8_t *pBuffer, uint16_t NumByte, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
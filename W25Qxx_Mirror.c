@@ -0,0 +1,471 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Mirror.c
+ * @brief   W25Qxx mirrored (RAID-1) volume source file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Mirror.h"
+#include <string.h>
+
+/* Mirror Cache */
+static uint8_t W25QXX_MIRROR_CACHE[W25Qxx_SECTORSIZE];
+static uint8_t W25QXX_MIRROR_CMP[W25Qxx_PAGESIZE];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static void W25Qxx_Mirror_Wait(W25Qxx_MIRROR_t *mir, uint8_t first, uint32_t timeout, W25Qxx_ERR *err)				/* Wait for members from first end of erase/program */
+{
+    uint8_t i = 0;
+
+    /* The members run in parallel, the first wait covers most of the time of the others */
+    for (i = first; i < W25QXX_MIRROR_MEMBER; i++)
+    {
+        W25Qxx_isStatus(mir->member[i], W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, timeout, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+static uint8_t W25Qxx_Mirror_Select(W25Qxx_MIRROR_t *mir, W25Qxx_ERR *err)											/* Select the next member that is not BUSY */
+{
+    uint32_t time = mir->member[0]->info.EraseMaxTimeBlock64;
+    uint8_t i = 0;
+    uint8_t k = 0;
+
+    do
+    {
+        /* round robin from the next member */
+        for (k = 0; k < W25QXX_MIRROR_MEMBER; k++)
+        {
+            i = (mir->next + k) % W25QXX_MIRROR_MEMBER;
+            if (W25Qxx_ReadStatus(mir->member[i]) & (W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND))
+            {
+                *err = W25Qxx_ERR_NONE;
+                return i;
+            }
+        }
+
+        if (time-- == 0) break;
+
+        mir->member[0]->port.spi_delayms(1);
+
+    } while (time);
+
+    *err = W25Qxx_ERR_STATUS;
+    return 0;
+}
+static void W25Qxx_Mirror_Start(W25Qxx_t *dev, W25Qxx_OP op, uint8_t *pBuffer, uint32_t Addr, uint16_t NumByte, W25Qxx_ERR *err)	/* Start erase/page program on one member */
+{
+    switch (op)
+    {
+        case W25Qxx_OP_PROGRAM_PAGE  : W25Qxx_DIR_Program_Page_Start(dev, pBuffer, Addr, NumByte, err); break;
+        case W25Qxx_OP_ERASE_SECTOR  : W25Qxx_Erase_Sector_Start(dev, Addr, err);  break;
+        case W25Qxx_OP_ERASE_BLOCK32 : W25Qxx_Erase_Block32_Start(dev, Addr, err); break;
+        case W25Qxx_OP_ERASE_BLOCK64 : W25Qxx_Erase_Block64_Start(dev, Addr, err); break;
+        default                      : *err = W25Qxx_ERR_INVALID; break;
+    }
+}
+static void W25Qxx_Mirror_Run(W25Qxx_MIRROR_t *mir, W25Qxx_OP op, uint8_t *pBuffer, uint32_t Addr, uint16_t NumByte, uint8_t last, uint32_t timeout, W25Qxx_ERR *err)	/* Erase/page program on every member */
+{
+    uint8_t i = 0;
+
+    /* the master copy first, the other members may still end their previous operation */
+    W25Qxx_Mirror_Start(mir->member[0], op, pBuffer, Addr, NumByte, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+#if W25QXX_MIRROR_STAGGER
+    /* the last operation of a call ends on the master copy only */
+    if (last)
+    {
+        W25Qxx_isStatus(mir->member[0], W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND, timeout, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+#else
+    (void)last;
+#endif
+
+    /* the previous operation may be a block erase */
+    W25Qxx_Mirror_Wait(mir, 1, mir->member[0]->info.EraseMaxTimeBlock64, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    for (i = 1; i < W25QXX_MIRROR_MEMBER; i++)
+    {
+        W25Qxx_Mirror_Start(mir->member[i], op, pBuffer, Addr, NumByte, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+#if W25QXX_MIRROR_STAGGER
+    /* the other members trail, no wait */
+    if (last)
+    {
+        *err = W25Qxx_ERR_NONE;
+        return;
+    }
+#endif
+
+    /* members in parallel */
+    W25Qxx_Mirror_Wait(mir, 0, timeout, err);
+}
+static void W25Qxx_Mirror_Parallel_Program(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, uint8_t last, W25Qxx_ERR *err)	/* Program every member page by page */
+{
+    uint16_t remPage = 0;
+
+    /* First page remain bytes */
+    remPage = W25Qxx_PAGESIZE - (ByteAddr & (W25Qxx_PAGESIZE - 1));
+    if (NumByteToWrite <= remPage) remPage = NumByteToWrite;
+
+    while (1)
+    {
+        W25Qxx_Mirror_Run(mir, W25Qxx_OP_PROGRAM_PAGE, pBuffer, ByteAddr, remPage, last && NumByteToWrite == remPage, mir->member[0]->info.ProgrMaxTimePage, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* Determine if writing is completed */
+        if (NumByteToWrite == remPage) break;
+        else
+        {
+            pBuffer += remPage;
+            ByteAddr += remPage;
+            NumByteToWrite -= remPage;
+            remPage = (NumByteToWrite > W25Qxx_PAGESIZE) ? W25Qxx_PAGESIZE : NumByteToWrite;
+        }
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+#if W25QXX_MIRROR_VERIFY
+static void W25Qxx_Mirror_Queue(W25Qxx_MIRROR_t *mir, uint32_t SectorAddr)											/* Queue a sector for W25Qxx_Mirror_Repair_Queued */
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < mir->numQueued; i++)
+    {
+        if (mir->repair[i] == SectorAddr) return;
+    }
+    if (mir->numQueued == W25QXX_MIRROR_QUEUE)
+    {
+        mir->numOverflow++;
+        return;
+    }
+    mir->repair[mir->numQueued++] = SectorAddr;
+}
+#endif
+static uint8_t W25Qxx_Mirror_isBlank(W25Qxx_t *dev, uint32_t ByteAddr, uint16_t NumByte, W25Qxx_ERR *err)			/* Check member address range is 0xFF */
+{
+    uint8_t buff[64];
+    uint16_t num = 0;
+
+    while (NumByte)
+    {
+        num = (NumByte > sizeof(buff)) ? sizeof(buff) : NumByte;
+        W25Qxx_Read(dev, buff, ByteAddr, num, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+
+        if (!W25Qxx_isBlank(buff, num)) return 0;
+
+        ByteAddr += num;
+        NumByte -= num;
+    }
+
+    return 1;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                                Mirror function                                                      */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Mirror_config(W25Qxx_MIRROR_t *mir, W25Qxx_t *primary, W25Qxx_t *secondary, W25Qxx_ERR *err)				/* Config mirror volume */
+{
+    /* Determine if the members are configured */
+    if (primary == NULL || secondary == NULL || primary == secondary
+        || primary->sizeChip == 0 || secondary->sizeChip == 0)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(mir, 0, sizeof(W25Qxx_MIRROR_t));
+    mir->member[0] = primary;
+    mir->member[1] = secondary;
+
+    /* volume size is the smaller member */
+    mir->numSector = (primary->numSector < secondary->numSector) ? primary->numSector : secondary->numSector;
+    mir->sizeChip = mir->numSector * W25Qxx_SECTORSIZE;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Mirror_Read(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err)	/* Read from the member that is not BUSY */
+{
+    uint8_t sel = 0;
+#if W25QXX_MIRROR_VERIFY
+    uint8_t i = 0;
+    uint16_t off = 0;
+    uint16_t num = 0;
+#endif
+
+    /* Determine if the address > mir->sizeChip */
+    if (ByteAddr + NumByteToRead > mir->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    /* select member */
+    sel = W25Qxx_Mirror_Select(mir, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    W25Qxx_Read(mir->member[sel], pBuffer, ByteAddr, NumByteToRead, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    mir->numRead[sel]++;
+    mir->next = (sel + 1) % W25QXX_MIRROR_MEMBER;
+
+#if W25QXX_MIRROR_VERIFY
+    /* compare with the other members that are not BUSY, the master copy wins */
+    for (i = 0; i < W25QXX_MIRROR_MEMBER; i++)
+    {
+        if (i == sel) continue;
+        if (!(W25Qxx_ReadStatus(mir->member[i]) & (W25Qxx_STATUS_IDLE | W25Qxx_STATUS_SUSPEND))) continue;
+
+        for (off = 0; off < NumByteToRead; off += num)
+        {
+            num = NumByteToRead - off;
+            if (num > W25Qxx_PAGESIZE) num = W25Qxx_PAGESIZE;
+
+            W25Qxx_Read(mir->member[i], W25QXX_MIRROR_CMP, ByteAddr + off, num, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+
+            if (W25Qxx_isEqual(W25QXX_MIRROR_CMP, pBuffer + off, num)) continue;
+
+            /* the master copy is returned, the stale member is rewritten by W25Qxx_Mirror_Repair_Queued */
+            if (i == 0) memcpy(pBuffer + off, W25QXX_MIRROR_CMP, num);
+            mir->numMismatch++;
+            W25Qxx_Mirror_Queue(mir, (ByteAddr + off) >> W25Qxx_SECTORPOWER);
+            if (((ByteAddr + off) >> W25Qxx_SECTORPOWER) != ((ByteAddr + off + num - 1) >> W25Qxx_SECTORPOWER))
+            {
+                W25Qxx_Mirror_Queue(mir, (ByteAddr + off + num - 1) >> W25Qxx_SECTORPOWER);
+            }
+        }
+    }
+#endif
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Mirror_DIR_Program(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)	/* No check Direct program all members */
+{
+    /* Determine if the number is 0 */
+    if (NumByteToWrite == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > mir->sizeChip */
+    if (ByteAddr + NumByteToWrite > mir->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Mirror_Parallel_Program(mir, pBuffer, ByteAddr, NumByteToWrite, 1, err);
+}
+void W25Qxx_Mirror_Program(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)	/* Check program all members */
+{
+    /* Check program
+     * Built in data erasure operation !!!
+     * The sector content of the master copy (member 0) is written to every member
+     * when the sector has to be erased.
+    **/
+    uint32_t numSec = 0;
+    uint16_t offSec = 0;
+    uint16_t remSec = 0;
+    uint8_t blank = 0;
+    uint8_t k = 0;
+
+    /* Determine if the number is 0 */
+    if (NumByteToWrite == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > mir->sizeChip */
+    if (ByteAddr + NumByteToWrite > mir->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    /* First Sector remain bytes */
+    numSec = ByteAddr >> W25Qxx_SECTORPOWER;
+    offSec = ByteAddr & (W25Qxx_SECTORSIZE - 1);
+    remSec = W25Qxx_SECTORSIZE - offSec;
+    if (NumByteToWrite <= remSec) remSec = NumByteToWrite;
+
+    while (1)
+    {
+        /*---------------------------------- Check Data Area ------------------------------------*/
+
+        /* Determine if all members are idle (the blank check reads every member) */
+        W25Qxx_Mirror_Wait(mir, 0, mir->member[0]->info.EraseMaxTimeBlock64, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* read current sector of the master copy to buffer area */
+        W25Qxx_Read(mir->member[0], W25QXX_MIRROR_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        /* Check whether the current sector data is 0xFF */
+        blank = W25Qxx_isBlank(&W25QXX_MIRROR_CACHE[offSec], remSec);
+
+        /* Check the other members too, a member may be out of date */
+        for (k = 1; k < W25QXX_MIRROR_MEMBER && blank; k++)
+        {
+            blank = W25Qxx_Mirror_isBlank(mir->member[k], ByteAddr, remSec, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+
+        /*------------------------------------ Write data ---------------------------------------*/
+
+        if (!blank)						/* need to be erased */
+        {
+            /* erase current sector of every member */
+            W25Qxx_Mirror_Run(mir, W25Qxx_OP_ERASE_SECTOR, NULL, numSec, 0, 0, mir->member[0]->info.EraseMaxTimeSector, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+
+            /* copy data to buffer area */
+            memcpy(&W25QXX_MIRROR_CACHE[offSec], pBuffer, remSec);
+
+            /* Write the entire sector */
+            W25Qxx_Mirror_Parallel_Program(mir, W25QXX_MIRROR_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, NumByteToWrite == remSec, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+        else							/* no need to be erased */
+        {
+            /* Directly write the remaining section of the sector */
+            W25Qxx_Mirror_Parallel_Program(mir, pBuffer, ByteAddr, remSec, NumByteToWrite == remSec, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+
+        numSec++;						/* updata sector address */
+        offSec = 0;						/* reset  sector offset  */
+
+        /*------------------------------- Update next parameters --------------------------------*/
+
+        /* Determine if writing is completed */
+        if (NumByteToWrite == remSec) break;
+        else
+        {
+            pBuffer += remSec;
+            ByteAddr += remSec;
+            NumByteToWrite -= remSec;
+            remSec = (NumByteToWrite > W25Qxx_SECTORSIZE) ? W25Qxx_SECTORSIZE : NumByteToWrite;
+        }
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Mirror_Erase_Sector(W25Qxx_MIRROR_t *mir, uint32_t SectorAddr, W25Qxx_ERR *err)							/* Erase sector of 4k on all members */
+{
+    /* Determine if Sector Addrress Bound */
+    if (SectorAddr >= mir->numSector)
+    {
+        *err = W25Qxx_ERR_SECTORADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Mirror_Run(mir, W25Qxx_OP_ERASE_SECTOR, NULL, SectorAddr, 0, 1, mir->member[0]->info.EraseMaxTimeSector, err);
+}
+void W25Qxx_Mirror_Erase_Block64(W25Qxx_MIRROR_t *mir, uint32_t Block64Addr, W25Qxx_ERR *err)						/* Erase block of 64k on all members */
+{
+    /* Determine if Block 64 Addrress Bound */
+    if (Block64Addr >= (mir->numSector >> 4))
+    {
+        *err = W25Qxx_ERR_BLOCK64ADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Mirror_Run(mir, W25Qxx_OP_ERASE_BLOCK64, NULL, Block64Addr, 0, 1, mir->member[0]->info.EraseMaxTimeBlock64, err);
+}
+void W25Qxx_Mirror_Sync(W25Qxx_MIRROR_t *mir, W25Qxx_ERR *err)														/* Wait for the trailing members */
+{
+    W25Qxx_Mirror_Wait(mir, 0, mir->member[0]->info.EraseMaxTimeBlock64, err);
+}
+void W25Qxx_Mirror_Repair(W25Qxx_MIRROR_t *mir, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)				/* Rewrite member sectors that differ from the master copy */
+{
+    uint32_t numSec = 0;
+    uint32_t endSec = 0;
+    uint32_t off = 0;
+    uint8_t k = 0;
+
+    /* Determine if the number is 0 */
+    if (NumByte == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > mir->sizeChip */
+    if (ByteAddr + NumByte > mir->sizeChip)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Mirror_Sync(mir, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    /* every sector of the range */
+    endSec = (ByteAddr + NumByte - 1) >> W25Qxx_SECTORPOWER;
+    for (numSec = ByteAddr >> W25Qxx_SECTORPOWER; numSec <= endSec; numSec++)
+    {
+        /* master copy */
+        W25Qxx_Read(mir->member[0], W25QXX_MIRROR_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        for (k = 1; k < W25QXX_MIRROR_MEMBER; k++)
+        {
+            /* compare page by page */
+            for (off = 0; off < W25Qxx_SECTORSIZE; off += W25Qxx_PAGESIZE)
+            {
+                W25Qxx_Read(mir->member[k], W25QXX_MIRROR_CMP, numSec * W25Qxx_SECTORSIZE + off, W25Qxx_PAGESIZE, err);
+                if (*err != W25Qxx_ERR_NONE) return;
+                if (!W25Qxx_isEqual(W25QXX_MIRROR_CMP, &W25QXX_MIRROR_CACHE[off], W25Qxx_PAGESIZE)) break;
+            }
+            if (off == W25Qxx_SECTORSIZE) continue;
+
+            /* program or erase + program as needed */
+            W25Qxx_Program(mir->member[k], W25QXX_MIRROR_CACHE, numSec * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+
+            mir->numRepair++;
+        }
+    }
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Mirror_Repair_Queued(W25Qxx_MIRROR_t *mir, W25Qxx_ERR *err)											/* Repair the sectors queued by the reads */
+{
+    *err = W25Qxx_ERR_NONE;
+    while (mir->numQueued)
+    {
+        W25Qxx_Mirror_Repair(mir, mir->repair[mir->numQueued - 1] * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+
+        mir->numQueued--;
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Mirror.h
+ * @brief   W25Qxx mirrored (RAID-1) volume header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_MIRROR_H
+#define __W25QXX_MIRROR_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Mirror Volume
+ *
+ * 				Members hold identical content, member 0 is the master copy.
+ *
+ * 				Write : erase/program is started on every member before waiting, so the members
+ * 				        work in parallel. W25QXX_MIRROR_STAGGER = 1 (opt-in) : the last erase/page
+ * 				        program of a call ends on the master copy first, then it is started on the
+ * 				        other members and the call returns, the other members trail by this
+ * 				        operation and end it while the master copy runs the next one.
+ * 				Read  : served by the next member that is not BUSY (round robin), so a read
+ * 				        does not wait behind an erase running on the other member.
+ * 				Verify: W25QXX_MIRROR_VERIFY = 1 : a read is compared with the other members that are
+ * 				        not BUSY, the master copy wins, the sector of a mismatch is queued (repair[]).
+ * 				Repair: W25Qxx_Mirror_Repair compares the sectors of a range with the master copy
+ * 				        and rewrites a member sector that differs, W25Qxx_Mirror_Repair_Queued does
+ * 				        this for the sectors queued by the reads (e.g. in idle time).
+ * Note:
+ * 1. All members must be configured by W25Qxx_config before W25Qxx_Mirror_config.
+ * 2. A trailing member holds the data of every started write as soon as it is not BUSY,
+ *    W25Qxx_Mirror_Sync waits for it (e.g. before the members are used directly). A write
+ *    right after a longer one waits for the trailing member, e.g. a page program after a
+ *    sector erase costs the erase time once more if there is no time between the calls.
+ * 3. Nothing is written in the read. When the queue is full a mismatch is only counted
+ *    (numOverflow), then W25Qxx_Mirror_Repair of the whole volume finds the sector.
+ *
+ */
+#define W25QXX_MIRROR_MEMBER                         2		/* Number of members */
+#define W25QXX_MIRROR_STAGGER                        0		/* 0 : Wait for all members; 1 : Return when the master copy ends */
+#define W25QXX_MIRROR_VERIFY                         1		/* 0 : Read one member     ; 1 : Compare members on read (queue repair) */
+#define W25QXX_MIRROR_QUEUE                          8		/* Sectors queued for repair by the reads */
+
+/**
+ * @brief W25Qxx Mirror Volume Information
+ */
+typedef struct
+{
+    W25Qxx_t *member[W25QXX_MIRROR_MEMBER];          /* Member device (member 0 is master copy) */
+    uint32_t numSector;                              /* Sector number */
+    uint32_t sizeChip;                               /* Volume size (Byte) */
+    uint8_t next;                                    /* Next member of load balanced read */
+    uint32_t numRead[W25QXX_MIRROR_MEMBER];          /* Reads served by member */
+    uint32_t numMismatch;                            /* Mismatch found by read (W25QXX_MIRROR_VERIFY = 1) */
+    uint32_t repair[W25QXX_MIRROR_QUEUE];            /* Sector queued for repair */
+    uint8_t numQueued;                               /* Sector number in repair[] */
+    uint32_t numOverflow;                            /* Mismatch not queued (queue full) */
+    uint32_t numRepair;                              /* Sector repaired by W25Qxx_Mirror_Repair */
+} W25Qxx_MIRROR_t;
+
+/**
+ * @brief W25Qxx Mirror Volume function
+ */
+void W25Qxx_Mirror_config(W25Qxx_MIRROR_t *mir, W25Qxx_t *primary, W25Qxx_t *secondary, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Read(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint16_t NumByteToRead, W25Qxx_ERR *err);
+void W25Qxx_Mirror_DIR_Program(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Program(W25Qxx_MIRROR_t *mir, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Erase_Sector(W25Qxx_MIRROR_t *mir, uint32_t SectorAddr, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Erase_Block64(W25Qxx_MIRROR_t *mir, uint32_t Block64Addr, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Sync(W25Qxx_MIRROR_t *mir, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Repair(W25Qxx_MIRROR_t *mir, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err);
+void W25Qxx_Mirror_Repair_Queued(W25Qxx_MIRROR_t *mir, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
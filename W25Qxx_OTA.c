@@ -0,0 +1,376 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_OTA.c
+ * @brief   W25Qxx dual bank firmware update
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_OTA.h"
+#include <string.h>
+
+/* Patch parser state */
+#define W25QXX_OTA_IDLE      0
+#define W25QXX_OTA_OP        1
+#define W25QXX_OTA_FIELD     2
+#define W25QXX_OTA_DATA      3
+#define W25QXX_OTA_DONE      4
+
+/* Meta record
+ * | magic (4) | active (4) | size (4) | crc32c (4) | seq (4) | check (4) | reserved (8) |
+ * check : crc32c of magic ~ seq
+**/
+#define W25QXX_OTA_CHECK     20
+
+/* OTA Cache */
+static uint8_t W25QXX_OTA_BUF[W25Qxx_SECTORSIZE];
+static uint8_t W25QXX_OTA_OLD[W25QXX_OTA_CHUNK];
+static uint8_t W25QXX_OTA_CMP[W25QXX_OTA_CHUNK];
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint32_t W25Qxx_OTA_Addr(W25Qxx_OTA_t *ota, uint8_t Slot, uint32_t Offset)									/* Byte address of slot offset */
+{
+    return ota->slotSector[Slot] * ota->dev->sizeSector + Offset;
+}
+static void W25Qxx_OTA_Flush(W25Qxx_OTA_t *ota, uint32_t Length, W25Qxx_ERR *err)									/* Write the collected sector to the inactive slot */
+{
+    uint32_t addr = W25Qxx_OTA_Addr(ota, ota->active ^ 1, (ota->newPos - 1) / ota->dev->sizeSector * ota->dev->sizeSector);
+    uint8_t erase = 0;
+    uint8_t equal = 1;
+    uint32_t off = 0;
+
+    /* the rest of the last sector is erased */
+    memset(W25QXX_OTA_BUF + Length, 0xFF, ota->dev->sizeSector - Length);
+
+    /* compare with the inactive slot */
+    W25Qxx_Read_Start(ota->dev, addr, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    for (off = 0; off < ota->dev->sizeSector && erase == 0; off += W25QXX_OTA_CHUNK)
+    {
+        W25Qxx_Read_Stream(ota->dev, W25QXX_OTA_CMP, W25QXX_OTA_CHUNK);
+        if (equal && W25Qxx_isEqual(W25QXX_OTA_CMP, W25QXX_OTA_BUF + off, W25QXX_OTA_CHUNK)) continue;
+        equal = 0;
+        if (!W25Qxx_isProgrammable(W25QXX_OTA_CMP, W25QXX_OTA_BUF + off, W25QXX_OTA_CHUNK)) erase = 1;
+    }
+    W25Qxx_Read_Stop(ota->dev);
+
+    if (equal)
+    {
+        ota->numSkip++;
+        return;
+    }
+    if (erase)
+    {
+        W25Qxx_Erase_Sector(ota->dev, addr / ota->dev->sizeSector, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        ota->numErase++;
+    }
+
+    /* erased pages are not programmed */
+    for (off = 0; off < ota->dev->sizeSector; off += ota->dev->sizePage)
+    {
+        if (W25Qxx_isBlank(W25QXX_OTA_BUF + off, ota->dev->sizePage)) continue;
+
+        W25Qxx_DIR_Program_Page(ota->dev, W25QXX_OTA_BUF + off, addr + off, ota->dev->sizePage, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        ota->numProgram += ota->dev->sizePage;
+    }
+}
+static void W25Qxx_OTA_Emit(W25Qxx_OTA_t *ota, uint8_t *pData, uint32_t NumByte, W25Qxx_ERR *err)					/* Append Byte to the new image */
+{
+    uint32_t off = 0;
+    uint32_t num = 0;
+
+    *err = W25Qxx_ERR_NONE;
+    if (ota->newPos + NumByte > ota->numSector * ota->dev->sizeSector)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    ota->newCrc = W25Qxx_CRC32C(ota->newCrc, pData, NumByte);
+    for (; NumByte; NumByte -= num, pData += num)
+    {
+        off = ota->newPos % ota->dev->sizeSector;
+        num = ota->dev->sizeSector - off;
+        if (num > NumByte) num = NumByte;
+
+        memcpy(W25QXX_OTA_BUF + off, pData, num);
+        ota->newPos += num;
+        if (off + num == ota->dev->sizeSector)
+        {
+            W25Qxx_OTA_Flush(ota, ota->dev->sizeSector, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+        }
+    }
+}
+static void W25Qxx_OTA_Command(W25Qxx_OTA_t *ota, W25Qxx_ERR *err)													/* Command argument is complete */
+{
+    *err = W25Qxx_ERR_NONE;
+    switch (ota->op)
+    {
+        case 'D' :
+        case 'I' :
+            ota->remain = W25Qxx_Get32(ota->field);
+            ota->state = ota->remain ? W25QXX_OTA_DATA : W25QXX_OTA_OP;
+            break;
+        case 'S' :
+            ota->oldPos += W25Qxx_Get32(ota->field);
+            ota->state = W25QXX_OTA_OP;
+            break;
+        case 'E' :
+            ota->endSize = W25Qxx_Get32(ota->field);
+            ota->endCrc = W25Qxx_Get32(ota->field + 4);
+            /* the last sector */
+            if (ota->newPos % ota->dev->sizeSector) W25Qxx_OTA_Flush(ota, ota->newPos % ota->dev->sizeSector, err);
+            ota->state = W25QXX_OTA_DONE;
+            break;
+        default :
+            *err = W25Qxx_ERR_INVALID;
+            break;
+    }
+}
+static void W25Qxx_OTA_Meta(W25Qxx_OTA_t *ota, W25Qxx_ERR *err)													/* Append meta record of the active slot */
+{
+    uint32_t full = 0;
+    uint32_t slot = ota->metaSlot;
+    uint8_t cur = ota->metaCur;
+
+    /* current meta sector is full : the record goes to the other sector */
+    full = (slot == ota->dev->sizeSector / W25QXX_OTA_RECORD);
+    if (full)
+    {
+        /* the other sector only holds older records, the current one keeps the last valid record */
+        if (ota->metaDirty)
+        {
+            W25Qxx_Erase_Sector(ota->dev, ota->metaSector + (cur ^ 1), err);
+            if (*err != W25Qxx_ERR_NONE) return;
+            ota->metaDirty = 0;
+        }
+        cur ^= 1;
+        slot = 0;
+    }
+
+    memset(W25QXX_OTA_OLD, 0xFF, W25QXX_OTA_RECORD);
+    W25Qxx_Put32(W25QXX_OTA_OLD, W25QXX_OTA_MAGIC);
+    W25Qxx_Put32(W25QXX_OTA_OLD + 4, ota->active);
+    W25Qxx_Put32(W25QXX_OTA_OLD + 8, ota->size);
+    W25Qxx_Put32(W25QXX_OTA_OLD + 12, ota->crc);
+    W25Qxx_Put32(W25QXX_OTA_OLD + 16, ota->seq);
+    W25Qxx_Put32(W25QXX_OTA_OLD + W25QXX_OTA_CHECK, W25Qxx_CRC32C(0, W25QXX_OTA_OLD, W25QXX_OTA_CHECK));
+    W25Qxx_DIR_Program_Page(ota->dev, W25QXX_OTA_OLD, (ota->metaSector + cur) * ota->dev->sizeSector + slot * W25QXX_OTA_RECORD, W25QXX_OTA_RECORD, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    ota->metaCur = cur;
+    ota->metaSlot = slot + 1;
+    ota->seq++;
+
+    /* the new record is on flash, the full sector is erased for the next switch */
+    if (full)
+    {
+        ota->metaDirty = 1;
+        W25Qxx_Erase_Sector(ota->dev, ota->metaSector + (cur ^ 1), err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        ota->metaDirty = 0;
+    }
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               OTA function                                                          */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_OTA_Mount(W25Qxx_OTA_t *ota, W25Qxx_t *dev, uint32_t SlotA, uint32_t SlotB, uint32_t NumSector, uint32_t MetaSector, W25Qxx_ERR *err)
+{
+    uint32_t numSlot = dev->sizeSector / W25QXX_OTA_RECORD;
+    uint32_t used[2] = { 0, 0 };
+    uint32_t slot = 0;
+    uint32_t seq = 0;
+    uint8_t torn[2] = { 0, 0 };
+    uint8_t valid = 0;
+    uint8_t m = 0;
+
+    /* Determine if the slots are valid (MetaSector and MetaSector + 1 are the meta sectors) */
+    if (NumSector == 0 || dev->sizeSector != W25Qxx_SECTORSIZE ||
+        SlotA + NumSector > dev->numSector || SlotB + NumSector > dev->numSector || MetaSector + 2 > dev->numSector ||
+        (SlotA < SlotB + NumSector && SlotB < SlotA + NumSector) ||
+        (MetaSector + 1 >= SlotA && MetaSector < SlotA + NumSector) || (MetaSector + 1 >= SlotB && MetaSector < SlotB + NumSector))
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(ota, 0, sizeof(W25Qxx_OTA_t));
+    ota->dev = dev;
+    ota->slotSector[0] = SlotA;
+    ota->slotSector[1] = SlotB;
+    ota->numSector = NumSector;
+    ota->metaSector = MetaSector;
+
+    /* the valid meta record of the highest seq is the active slot */
+    for (m = 0; m < 2; m++)
+    {
+        for (slot = 0; slot < numSlot; slot++)
+        {
+            W25Qxx_Read(dev, W25QXX_OTA_OLD, (MetaSector + m) * dev->sizeSector + slot * W25QXX_OTA_RECORD, W25QXX_OTA_RECORD, err);
+            if (*err != W25Qxx_ERR_NONE) return;
+
+            if (W25Qxx_isBlank(W25QXX_OTA_OLD, W25QXX_OTA_RECORD)) continue;
+            used[m] = slot + 1;
+
+            /* the meta sector with a torn record takes no more record */
+            if (W25Qxx_Get32(W25QXX_OTA_OLD) != W25QXX_OTA_MAGIC ||
+                W25Qxx_Get32(W25QXX_OTA_OLD + W25QXX_OTA_CHECK) != W25Qxx_CRC32C(0, W25QXX_OTA_OLD, W25QXX_OTA_CHECK))
+            {
+                torn[m] = 1;
+                continue;
+            }
+
+            seq = W25Qxx_Get32(W25QXX_OTA_OLD + 16);
+            if (valid && seq < ota->seq) continue;
+            valid = 1;
+            ota->metaCur = m;
+            ota->active = W25Qxx_Get32(W25QXX_OTA_OLD + 4) & 0x01;
+            ota->size = W25Qxx_Get32(W25QXX_OTA_OLD + 8);
+            ota->crc = W25Qxx_Get32(W25QXX_OTA_OLD + 12);
+            ota->seq = seq + 1;
+        }
+    }
+
+    /* records follow the last used slot of the current sector */
+    m = ota->metaCur;
+    ota->metaSlot = torn[m] ? numSlot : used[m];
+    ota->metaDirty = (used[m ^ 1] != 0);
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_OTA_Begin(W25Qxx_OTA_t *ota, W25Qxx_ERR *err)
+{
+    ota->state = W25QXX_OTA_OP;
+    ota->oldPos = 0;
+    ota->newPos = 0;
+    ota->newCrc = 0;
+    ota->numSkip = 0;
+    ota->numErase = 0;
+    ota->numProgram = 0;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_OTA_Patch(W25Qxx_OTA_t *ota, uint8_t *pData, uint32_t NumByte, W25Qxx_ERR *err)
+{
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    *err = W25Qxx_ERR_NONE;
+    while (NumByte)
+    {
+        switch (ota->state)
+        {
+            case W25QXX_OTA_OP :
+                ota->op = *pData++;
+                NumByte--;
+                ota->numField = 0;
+                ota->state = W25QXX_OTA_FIELD;
+                break;
+            case W25QXX_OTA_FIELD :
+                ota->field[ota->numField++] = *pData++;
+                NumByte--;
+                if (ota->numField == ((ota->op == 'E') ? 8 : 4)) W25Qxx_OTA_Command(ota, err);
+                break;
+            case W25QXX_OTA_DATA :
+                num = (NumByte < ota->remain) ? NumByte : ota->remain;
+                if (num > W25QXX_OTA_CHUNK) num = W25QXX_OTA_CHUNK;
+                if (ota->op == 'D')
+                {
+                    /* Byte add to the old image */
+                    if (ota->oldPos > ota->size || num > ota->size - ota->oldPos)
+                    {
+                        *err = W25Qxx_ERR_INVALID;
+                        break;
+                    }
+                    W25Qxx_Read(ota->dev, W25QXX_OTA_OLD, W25Qxx_OTA_Addr(ota, ota->active, ota->oldPos), num, err);
+                    if (*err != W25Qxx_ERR_NONE) break;
+                    for (i = 0; i < num; i++) W25QXX_OTA_OLD[i] += pData[i];
+                    ota->oldPos += num;
+                    W25Qxx_OTA_Emit(ota, W25QXX_OTA_OLD, num, err);
+                }
+                else
+                {
+                    W25Qxx_OTA_Emit(ota, pData, num, err);
+                }
+                pData += num;
+                NumByte -= num;
+                ota->remain -= num;
+                if (ota->remain == 0) ota->state = W25QXX_OTA_OP;
+                break;
+            default :
+                *err = W25Qxx_ERR_INVALID;
+                break;
+        }
+        if (*err != W25Qxx_ERR_NONE)
+        {
+            ota->state = W25QXX_OTA_IDLE;
+            return;
+        }
+    }
+}
+void W25Qxx_OTA_End(W25Qxx_OTA_t *ota, W25Qxx_ERR *err)
+{
+    uint32_t size = 0;
+    uint32_t crc = 0;
+
+    /* Determine if the patch is complete */
+    if (ota->state != W25QXX_OTA_DONE)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+    ota->state = W25QXX_OTA_IDLE;
+    if (ota->newPos != ota->endSize || ota->newCrc != ota->endCrc)
+    {
+        *err = W25Qxx_ERR_CHECKSUM;
+        return;
+    }
+
+    /* verify the written slot */
+    if (W25Qxx_CRC32C_Flash(ota->dev, 0, W25Qxx_OTA_Addr(ota, ota->active ^ 1, 0), ota->endSize, err) != ota->endCrc)
+    {
+        if (*err == W25Qxx_ERR_NONE) *err = W25Qxx_ERR_CHECKSUM;
+        return;
+    }
+
+    /* switch the active slot */
+    size = ota->size;
+    crc = ota->crc;
+    ota->active ^= 1;
+    ota->size = ota->endSize;
+    ota->crc = ota->endCrc;
+    W25Qxx_OTA_Meta(ota, err);
+    if (*err != W25Qxx_ERR_NONE)
+    {
+        ota->active ^= 1;
+        ota->size = size;
+        ota->crc = crc;
+    }
+}
+uint8_t W25Qxx_OTA_Verify(W25Qxx_OTA_t *ota, W25Qxx_ERR *err)														/* Active image is good (1 : good) */
+{
+    uint32_t crc = W25Qxx_CRC32C_Flash(ota->dev, 0, W25Qxx_OTA_Addr(ota, ota->active, 0), ota->size, err);
+
+    return (*err == W25Qxx_ERR_NONE && crc == ota->crc);
+}
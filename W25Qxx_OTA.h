@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_OTA.h
+ * @brief   W25Qxx dual bank firmware update header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_OTA_H
+#define __W25QXX_OTA_H
+
+#include "W25Qxx.h"
+#include "W25Qxx_CRC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Firmware Update
+ *
+ * 				Two image slots (A/B) and a meta sector, the new image is built in the inactive slot
+ * 				from the active image and a delta patch, the active slot is switched after the verify.
+ *
+ * 				Patch : stream of commands (little endian), old position starts at 0
+ * 				        'D' len(4) data(len) : new = old[pos] + data (Byte add), pos += len
+ * 				        'I' len(4) data(len) : new = data
+ * 				        'S' delta(4)         : pos += delta (signed)
+ * 				        'E' size(4) crc(4)   : end, size and crc32c of the new image
+ * 				Write : the new image is collected per sector, a sector equal to the inactive slot is
+ * 				        skipped, a sector that only clears bits is programmed, else it is erased.
+ * 				Meta  : record {magic, active, size, crc32c, seq, check} appended to the current of two
+ * 				        meta sectors, the valid record of the highest seq is the active slot. When the
+ * 				        current sector is full the record is written to the other (erased) sector first,
+ * 				        then the full sector is erased, a valid record is always on flash.
+ * Note:
+ * 1. W25Qxx_OTA_Patch takes the patch in pieces of any size (e.g. from a radio link).
+ * 2. W25Qxx_OTA_End verifies the slot by one continuous read before the meta record is written,
+ *    an update broken by power loss leaves the old slot active.
+ * 3. Without meta record slot A is active and empty, the first patch is a full image of 'I' commands.
+ *
+ */
+#define W25QXX_OTA_CHUNK                             64		/* Old image read size of 'D' command (Byte) */
+#define W25QXX_OTA_RECORD                            32		/* Meta record size (Byte) */
+#define W25QXX_OTA_MAGIC                             0x41544F3Cu	/* "<OTA" */
+
+/**
+ * @brief W25Qxx Firmware Update Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t slotSector[2];                          /* First sector of slot A/B */
+    uint32_t numSector;                              /* Slot size (sector) */
+    uint32_t metaSector;                             /* First of the two meta sectors */
+    uint8_t metaCur;                                 /* Current meta sector (0/1) */
+    uint8_t metaDirty;                               /* Other meta sector is not erased (power loss before its erase) */
+    uint32_t metaSlot;                               /* Next meta record slot of the current sector */
+    uint32_t seq;                                    /* Next meta record seq */
+    uint8_t active;                                  /* Active slot */
+    uint32_t size;                                   /* Active image size (Byte) */
+    uint32_t crc;                                    /* Active image crc32c */
+    /* update */
+    uint8_t state;                                   /* Patch parser state */
+    uint8_t op;                                      /* Current command */
+    uint8_t field[8];                                /* Command argument */
+    uint8_t numField;                                /* Command argument Byte received */
+    uint32_t remain;                                 /* Data Byte remain of command */
+    uint32_t oldPos;                                 /* Old image position */
+    uint32_t newPos;                                 /* New image position */
+    uint32_t newCrc;                                 /* crc32c of new image */
+    uint32_t endSize;                                /* Size of 'E' command */
+    uint32_t endCrc;                                 /* crc32c of 'E' command */
+    uint32_t numSkip;                                /* Sector skipped (unchanged) */
+    uint32_t numErase;                               /* Sector erased */
+    uint32_t numProgram;                             /* Byte programmed */
+} W25Qxx_OTA_t;
+
+/**
+ * @brief W25Qxx Firmware Update function
+ */
+void W25Qxx_OTA_Mount(W25Qxx_OTA_t *ota, W25Qxx_t *dev, uint32_t SlotA, uint32_t SlotB, uint32_t NumSector, uint32_t MetaSector, W25Qxx_ERR *err);
+void W25Qxx_OTA_Begin(W25Qxx_OTA_t *ota, W25Qxx_ERR *err);
+void W25Qxx_OTA_Patch(W25Qxx_OTA_t *ota, uint8_t *pData, uint32_t NumByte, W25Qxx_ERR *err);
+void W25Qxx_OTA_End(W25Qxx_OTA_t *ota, W25Qxx_ERR *err);
+uint8_t W25Qxx_OTA_Verify(W25Qxx_OTA_t *ota, W25Qxx_ERR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Queue.c
+ * @brief   W25Qxx request queue
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Queue.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static void W25Qxx_Queue_Add(W25Qxx_QUEUE_t *q, W25Qxx_REQ type, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByte, W25Qxx_ERR *err)	/* Add request */
+{
+    W25Qxx_REQ_t *req;
+
+    /* Flush a full queue */
+    if (q->num >= W25QXX_QUEUE_DEPTH)
+    {
+        W25Qxx_Queue_Flush(q);
+    }
+
+    req = &q->req[q->num++];
+    req->type     = type;
+    req->pBuffer  = pBuffer;
+    req->ByteAddr = ByteAddr;
+    req->NumByte  = NumByte;
+    req->err      = err;
+
+    *err = W25Qxx_ERR_NONE;
+}
+static void W25Qxx_Queue_Transfer(W25Qxx_QUEUE_t *q, uint8_t *idx, uint8_t num)										/* One read transfer for sorted and merged requests */
+{
+    W25Qxx_REQ_t *req;
+    W25Qxx_REQ_t *cover;
+    W25Qxx_ERR err = W25Qxx_ERR_NONE;
+    uint32_t start = q->req[idx[0]].ByteAddr;
+    uint32_t pos = start;
+    uint32_t end = 0;
+    uint8_t i = 0;
+
+    /* send read instruction and address */
+    W25Qxx_Read_Start(q->dev, start, &err);
+    if (err != W25Qxx_ERR_NONE)
+    {
+        for (i = 0; i < num; i++)
+        {
+            *q->req[idx[i]].err = err;
+        }
+        return;
+    }
+
+    /* scatter data (the requests are in ascending address order) */
+    cover = &q->req[idx[0]];
+    for (i = 0; i < num; i++)
+    {
+        req = &q->req[idx[i]];
+        end = req->ByteAddr + req->NumByte;
+
+        /* discard the gap */
+        if (req->ByteAddr > pos)
+        {
+            W25Qxx_Read_Stream(q->dev, NULL, req->ByteAddr - pos);
+            pos = req->ByteAddr;
+        }
+
+        /* overlap with the data already read, [ByteAddr, pos) is inside the request that read up to pos */
+        if (req->ByteAddr < pos)
+        {
+            memcpy(req->pBuffer, cover->pBuffer + (req->ByteAddr - cover->ByteAddr), (end < pos ? end : pos) - req->ByteAddr);
+        }
+
+        /* read the rest */
+        if (end > pos)
+        {
+            W25Qxx_Read_Stream(q->dev, req->pBuffer + (pos - req->ByteAddr), end - pos);
+            pos = end;
+            cover = req;
+        }
+
+        *req->err = W25Qxx_ERR_NONE;
+    }
+
+    /* CS disable */
+    W25Qxx_Read_Stop(q->dev);
+
+    /* statistic */
+    q->head = pos;
+    q->numRequest += num;
+    q->numTransfer++;
+    q->numByte += pos - start;
+}
+static void W25Qxx_Queue_Dispatch_Read(W25Qxx_QUEUE_t *q, uint8_t first, uint8_t last)								/* Dispatch the reads between two writes */
+{
+    uint8_t idx[W25QXX_QUEUE_DEPTH];
+    W25Qxx_REQ_t *req;
+    uint32_t start = 0;
+    uint32_t end = 0;
+    uint32_t reqend = 0;
+    uint8_t num = last - first;
+    uint8_t run = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+    uint8_t k = 0;
+
+    /* Elevator order : ascending distance from the head, wrap around at the end of chip */
+    for (i = 0; i < num; i++)
+    {
+        k = first + i;
+        for (j = i; j > 0 && (uint32_t)(q->req[idx[j - 1]].ByteAddr - q->head) > (uint32_t)(q->req[k].ByteAddr - q->head); j--)
+        {
+            idx[j] = idx[j - 1];
+        }
+        idx[j] = k;
+    }
+
+    /* Merge the adjacent reads */
+    for (i = 0; i < num; i += run)
+    {
+        start = q->req[idx[i]].ByteAddr;
+        end   = start + q->req[idx[i]].NumByte;
+
+        for (run = 1; i + run < num; run++)
+        {
+            req = &q->req[idx[i + run]];
+            reqend = req->ByteAddr + req->NumByte;
+            if (reqend < end) reqend = end;
+
+            /* wrap around of the elevator */
+            if (req->ByteAddr < start) break;
+
+            /* gap too large */
+            if (req->ByteAddr > end + W25QXX_QUEUE_GAP) break;
+
+            /* transfer too large */
+            if (reqend - start > W25QXX_QUEUE_MAXMERGE) break;
+
+#if W25QXX_4BADDR == 0
+            /* cross the extended address register boundary (16MB) */
+            if ((start >> 24) != ((reqend - 1) >> 24)) break;
+#endif
+            end = reqend;
+        }
+
+        W25Qxx_Queue_Transfer(q, &idx[i], run);
+    }
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Queue function                                                        */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Queue_Init(W25Qxx_QUEUE_t *q, W25Qxx_t *dev)
+{
+    memset(q, 0, sizeof(W25Qxx_QUEUE_t));
+    q->dev = dev;
+}
+void W25Qxx_Queue_Read(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err)
+{
+    /* Determine if the number is 0 */
+    if (NumByteToRead == 0x00)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* Determine if the address > dev->sizeChip */
+    if (ByteAddr >= q->dev->sizeChip || NumByteToRead > q->dev->sizeChip - ByteAddr)
+    {
+        *err = W25Qxx_ERR_BYTEADDRBOUND;
+        return;
+    }
+
+    W25Qxx_Queue_Add(q, W25Qxx_REQ_READ, pBuffer, ByteAddr, NumByteToRead, err);
+}
+void W25Qxx_Queue_Program(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    W25Qxx_Queue_Add(q, W25Qxx_REQ_PROGRAM, pBuffer, ByteAddr, NumByteToWrite, err);
+}
+void W25Qxx_Queue_DIR_Program(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err)
+{
+    W25Qxx_Queue_Add(q, W25Qxx_REQ_DIR_PROGRAM, pBuffer, ByteAddr, NumByteToWrite, err);
+}
+void W25Qxx_Queue_Erase_Sector(W25Qxx_QUEUE_t *q, uint32_t SectorAddr, W25Qxx_ERR *err)
+{
+    W25Qxx_Queue_Add(q, W25Qxx_REQ_ERASE_SECTOR, NULL, SectorAddr, 0, err);
+}
+void W25Qxx_Queue_Flush(W25Qxx_QUEUE_t *q)
+{
+    W25Qxx_REQ_t *req;
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    while (i < q->num)
+    {
+        req = &q->req[i];
+
+        /* reads up to the next write */
+        if (req->type == W25Qxx_REQ_READ)
+        {
+            for (j = i + 1; j < q->num && q->req[j].type == W25Qxx_REQ_READ; j++);
+            W25Qxx_Queue_Dispatch_Read(q, i, j);
+            i = j;
+            continue;
+        }
+
+        /* write in submission order */
+        switch (req->type)
+        {
+            case W25Qxx_REQ_PROGRAM      : W25Qxx_Program(q->dev, req->pBuffer, req->ByteAddr, req->NumByte, req->err);     break;
+            case W25Qxx_REQ_DIR_PROGRAM  : W25Qxx_DIR_Program(q->dev, req->pBuffer, req->ByteAddr, req->NumByte, req->err); break;
+            case W25Qxx_REQ_ERASE_SECTOR : W25Qxx_Erase_Sector(q->dev, req->ByteAddr, req->err);                              break;
+            default                      : *req->err = W25Qxx_ERR_INVALID;                                                     break;
+        }
+        i++;
+    }
+
+    q->num = 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Queue.h
+ * @brief   W25Qxx request queue header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_QUEUE_H
+#define __W25QXX_QUEUE_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx Request Queue
+ *
+ * 				Requests are queued and dispatched by W25Qxx_Queue_Flush.
+ *
+ * 				Read  : the reads between two writes are sorted by address (elevator, from the
+ * 				        address of the last transfer upwards and then wrap around), reads that are
+ * 				        contiguous or closer than W25QXX_QUEUE_GAP are merged into one CS enabled
+ * 				        transfer and the data is scattered back to the buffers of the requests.
+ * 				Write : program/erase are dispatched in submission order and act as a barrier,
+ * 				        a read is never moved across a write.
+ * Note:
+ * 1. The buffer and err of a request must stay valid until W25Qxx_Queue_Flush returns, the
+ *    err of a request is written when the request is dispatched.
+ * 2. A full queue is flushed before the new request is added.
+ * 3. In the 3-address mode a merged transfer does not cross the 16MB boundary.
+ *
+ */
+#define W25QXX_QUEUE_DEPTH                           16		/* Number of requests */
+#define W25QXX_QUEUE_GAP                             32		/* Max gap (Byte) between merged reads, the gap is clocked out and discarded */
+#define W25QXX_QUEUE_MAXMERGE                        4096	/* Max size (Byte) of one merged transfer */
+
+/**
+ * @brief W25Qxx Request type
+ */
+typedef enum
+{
+    W25Qxx_REQ_READ          = 0x00,                 /* W25Qxx_Read */
+    W25Qxx_REQ_PROGRAM       = 0x01,                 /* W25Qxx_Program */
+    W25Qxx_REQ_DIR_PROGRAM   = 0x02,                 /* W25Qxx_DIR_Program */
+    W25Qxx_REQ_ERASE_SECTOR  = 0x03,                 /* W25Qxx_Erase_Sector */
+} W25Qxx_REQ;
+
+/**
+ * @brief W25Qxx Request
+ */
+typedef struct
+{
+    W25Qxx_REQ type;                                 /* Request type */
+    uint8_t *pBuffer;                                /* Data buffer */
+    uint32_t ByteAddr;                               /* Byte address (Sector address of erase) */
+    uint32_t NumByte;                                /* Byte number */
+    W25Qxx_ERR *err;                                 /* Request result */
+} W25Qxx_REQ_t;
+
+/**
+ * @brief W25Qxx Request Queue Information
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    W25Qxx_REQ_t req[W25QXX_QUEUE_DEPTH];            /* Pending request (submission order) */
+    uint8_t num;                                     /* Pending request number */
+    uint32_t head;                                   /* Elevator position (end address of the last read transfer) */
+    uint32_t numRequest;                             /* Dispatched read requests */
+    uint32_t numTransfer;                            /* Issued read transfers */
+    uint32_t numByte;                                /* Bytes clocked out by read transfers (include gap) */
+} W25Qxx_QUEUE_t;
+
+/**
+ * @brief W25Qxx Request Queue function
+ */
+void W25Qxx_Queue_Init(W25Qxx_QUEUE_t *q, W25Qxx_t *dev);
+void W25Qxx_Queue_Read(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToRead, W25Qxx_ERR *err);
+void W25Qxx_Queue_Program(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Queue_DIR_Program(W25Qxx_QUEUE_t *q, uint8_t *pBuffer, uint32_t ByteAddr, uint32_t NumByteToWrite, W25Qxx_ERR *err);
+void W25Qxx_Queue_Erase_Sector(W25Qxx_QUEUE_t *q, uint32_t SectorAddr, W25Qxx_ERR *err);
+void W25Qxx_Queue_Flush(W25Qxx_QUEUE_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Trace.c
+ * @brief   W25Qxx SPI transaction trace
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Trace.h"
+#include <string.h>
+
+/* Recorder of the port slots */
+static W25Qxx_TRACE_t *TraceSlot[W25QXX_TRACE_MAXPORT];
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static uint8_t W25Qxx_Trace_Varint(uint8_t *p, uint32_t val)											/* Write varint, return size */
+{
+    uint8_t n = 0;
+
+    while (val >= 0x80)
+    {
+        p[n++] = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    p[n++] = (uint8_t)val;
+
+    return n;
+}
+static uint8_t W25Qxx_Trace_GetVarint(const uint8_t *p, uint8_t max, uint32_t *val)					/* Read varint, return size (0 : invalid) */
+{
+    uint8_t n = 0;
+
+    *val = 0;
+    while (n < max && n < 5)
+    {
+        *val |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+        if ((p[n++] & 0x80) == 0) return n;
+    }
+
+    return 0;
+}
+static void W25Qxx_Trace_Put(W25Qxx_TRACE_t *trace, const uint8_t *rec, uint8_t n)					/* Append record, drop the oldest ones */
+{
+    uint8_t i = 0;
+
+    while (trace->used + n > trace->size)
+    {
+        i = trace->buf[trace->tail];
+        trace->tail = (trace->tail + i) % trace->size;
+        trace->used -= i;
+        trace->numRecord--;
+        trace->numDrop++;
+    }
+    for (i = 0; i < n; i++)
+    {
+        trace->buf[trace->head] = rec[i];
+        if (++trace->head == trace->size) trace->head = 0;
+    }
+    trace->used += n;
+    trace->numRecord++;
+}
+static uint8_t W25Qxx_Trace_RW(W25Qxx_TRACE_t *trace, uint8_t data)									/* Byte transfer */
+{
+    if (trace->len < W25QXX_TRACE_HEAD) trace->data[trace->len] = data;
+    trace->len++;
+    trace->miso = trace->port.spi_rw(data);
+
+    return trace->miso;
+}
+static void W25Qxx_Trace_CS_L(W25Qxx_TRACE_t *trace)													/* CS falling edge : start transaction */
+{
+    trace->len = 0;
+    if (trace->port.spi_timeus != NULL) trace->timeL = trace->port.spi_timeus();
+    trace->port.spi_cs_L();
+}
+static void W25Qxx_Trace_CS_H(W25Qxx_TRACE_t *trace)													/* CS rising edge : write record */
+{
+    uint8_t rec[W25QXX_TRACE_MAXREC];
+    uint32_t now = 0;
+    uint8_t n = 1;
+
+    trace->port.spi_cs_H();
+    if (trace->port.spi_timeus != NULL) now = trace->port.spi_timeus();
+
+    n += W25Qxx_Trace_Varint(&rec[n], trace->timeL - trace->timeH);
+    n += W25Qxx_Trace_Varint(&rec[n], now - trace->timeL);
+    n += W25Qxx_Trace_Varint(&rec[n], trace->len);
+    rec[n++] = trace->miso;
+    memcpy(&rec[n], trace->data, (trace->len < W25QXX_TRACE_HEAD) ? trace->len : W25QXX_TRACE_HEAD);
+    n += (trace->len < W25QXX_TRACE_HEAD) ? trace->len : W25QXX_TRACE_HEAD;
+    rec[0] = n;
+    W25Qxx_Trace_Put(trace, rec, n);
+
+    trace->timeH = now;
+}
+static void W25Qxx_Trace_DelayMS(W25Qxx_TRACE_t *trace, uint32_t ms)									/* Delay is not recorded (gap) */
+{
+    trace->port.spi_delayms(ms);
+}
+static uint32_t W25Qxx_Trace_TimeUS(W25Qxx_TRACE_t *trace)											/* Microsecond counter */
+{
+    return trace->port.spi_timeus();
+}
+/* Port callbacks of the recorder slots */
+#define TRACE_SLOT(n)                                                                               \
+static uint8_t TRACE_RW##n(uint8_t data)      { return W25Qxx_Trace_RW(TraceSlot[n], data); }       \
+static void TRACE_CS_L##n(void)               { W25Qxx_Trace_CS_L(TraceSlot[n]); }                  \
+static void TRACE_CS_H##n(void)               { W25Qxx_Trace_CS_H(TraceSlot[n]); }                  \
+static void TRACE_DelayMS##n(uint32_t ms)     { W25Qxx_Trace_DelayMS(TraceSlot[n], ms); }           \
+static uint32_t TRACE_TimeUS##n(void)         { return W25Qxx_Trace_TimeUS(TraceSlot[n]); }
+TRACE_SLOT(0)
+TRACE_SLOT(1)
+static const W25Qxx_PORT_t TracePort[W25QXX_TRACE_MAXPORT] = {
+    { TRACE_DelayMS0, TRACE_CS_H0, TRACE_CS_L0, TRACE_RW0, TRACE_TimeUS0 },
+    { TRACE_DelayMS1, TRACE_CS_H1, TRACE_CS_L1, TRACE_RW1, TRACE_TimeUS1 },
+};
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Trace function                                                        */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Trace_Attach(W25Qxx_TRACE_t *trace, W25Qxx_t *dev, uint8_t *buf, uint32_t size, W25Qxx_ERR *err)
+{
+    uint8_t slot = 0;
+
+    /* search for a free slot */
+    for (slot = 0; slot < W25QXX_TRACE_MAXPORT; slot++)
+    {
+        if (TraceSlot[slot] == NULL) break;
+    }
+    if (slot == W25QXX_TRACE_MAXPORT || buf == NULL || size < W25QXX_TRACE_MAXREC)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(trace, 0, sizeof(W25Qxx_TRACE_t));
+    trace->port = dev->port;
+    trace->buf = buf;
+    trace->size = size;
+    trace->slot = slot;
+    if (trace->port.spi_timeus != NULL) trace->timeH = trace->port.spi_timeus();
+
+    /* the device runs on the recorder callbacks */
+    TraceSlot[slot] = trace;
+    dev->port = TracePort[slot];
+    if (trace->port.spi_timeus == NULL) dev->port.spi_timeus = NULL;
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Trace_Detach(W25Qxx_TRACE_t *trace, W25Qxx_t *dev)
+{
+    if (TraceSlot[trace->slot] != trace) return;
+
+    dev->port = trace->port;
+    TraceSlot[trace->slot] = NULL;
+}
+void W25Qxx_Trace_Clear(W25Qxx_TRACE_t *trace)
+{
+    trace->head = 0;
+    trace->tail = 0;
+    trace->used = 0;
+    trace->numRecord = 0;
+    trace->numDrop = 0;
+}
+uint32_t W25Qxx_Trace_Export(W25Qxx_TRACE_t *trace, uint8_t *pBuffer, uint32_t size)
+{
+    uint32_t n = W25QXX_TRACE_HDRSIZE + trace->used;
+    uint32_t first = 0;
+
+    /* Determine if the buffer is large enough (NULL : return the export size) */
+    if (pBuffer == NULL) return n;
+    if (size < n) return 0;
+
+    pBuffer[0]  = (uint8_t)(W25QXX_TRACE_MAGIC);
+    pBuffer[1]  = (uint8_t)(W25QXX_TRACE_MAGIC >> 8);
+    pBuffer[2]  = (uint8_t)(W25QXX_TRACE_MAGIC >> 16);
+    pBuffer[3]  = (uint8_t)(W25QXX_TRACE_MAGIC >> 24);
+    pBuffer[4]  = W25QXX_TRACE_VERSION;
+    pBuffer[5]  = W25QXX_TRACE_HEAD;
+    pBuffer[6]  = 0;
+    pBuffer[7]  = 0;
+    pBuffer[8]  = (uint8_t)(trace->numRecord);
+    pBuffer[9]  = (uint8_t)(trace->numRecord >> 8);
+    pBuffer[10] = (uint8_t)(trace->numRecord >> 16);
+    pBuffer[11] = (uint8_t)(trace->numRecord >> 24);
+    pBuffer[12] = (uint8_t)(trace->numDrop);
+    pBuffer[13] = (uint8_t)(trace->numDrop >> 8);
+    pBuffer[14] = (uint8_t)(trace->numDrop >> 16);
+    pBuffer[15] = (uint8_t)(trace->numDrop >> 24);
+
+    /* records, oldest first */
+    first = trace->size - trace->tail;
+    if (first > trace->used) first = trace->used;
+    memcpy(&pBuffer[W25QXX_TRACE_HDRSIZE], &trace->buf[trace->tail], first);
+    memcpy(&pBuffer[W25QXX_TRACE_HDRSIZE + first], trace->buf, trace->used - first);
+
+    return n;
+}
+uint8_t W25Qxx_Trace_Decode(const uint8_t *pBuffer, uint32_t size, W25Qxx_TRACE_REC_t *rec)
+{
+    uint8_t n = 1;
+    uint8_t k = 0;
+
+    /* Determine if the record is complete */
+    if (size == 0 || pBuffer[0] < 5 || pBuffer[0] > W25QXX_TRACE_MAXREC || pBuffer[0] > size) return 0;
+
+    k = W25Qxx_Trace_GetVarint(&pBuffer[n], pBuffer[0] - n, &rec->gap);
+    if (k == 0) return 0;
+    n += k;
+    k = W25Qxx_Trace_GetVarint(&pBuffer[n], pBuffer[0] - n, &rec->time);
+    if (k == 0) return 0;
+    n += k;
+    k = W25Qxx_Trace_GetVarint(&pBuffer[n], pBuffer[0] - n, &rec->len);
+    if (k == 0 || n + k >= pBuffer[0]) return 0;
+    n += k;
+    rec->miso = pBuffer[n++];
+    rec->numHead = (rec->len < W25QXX_TRACE_HEAD) ? (uint8_t)rec->len : W25QXX_TRACE_HEAD;
+    if (n + rec->numHead != pBuffer[0]) return 0;
+    memcpy(rec->head, &pBuffer[n], rec->numHead);
+
+    return pBuffer[0];
+}
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Trace.h
+ * @brief   W25Qxx SPI transaction trace header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_TRACE_H
+#define __W25QXX_TRACE_H
+
+#include "W25Qxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief W25Qxx SPI Transaction Trace
+ *
+ * 				W25Qxx_Trace_Attach puts a recorder between the device and its W25Qxx_PORT_t, the
+ * 				driver is not changed. One record is written into a ring buffer per CS transaction
+ * 				(CS falling edge to CS rising edge), the oldest records are dropped when it is full.
+ *
+ * 				Record : [size] [gap] [time] [len] [miso] [head ...]
+ * 				         size : record size (byte)
+ * 				         gap  : us from the previous CS rising edge to the CS falling edge (varint)
+ * 				         time : us from the CS falling edge to the CS rising edge (varint)
+ * 				         len  : bytes of the transaction (varint)
+ * 				         miso : last byte read
+ * 				         head : first min(len, W25QXX_TRACE_HEAD) bytes written (command, address, dummy)
+ * 				Export : W25QXX_TRACE_HDRSIZE byte header (little endian) then the records, oldest first
+ * 				         magic (4) version (1) head (1) reserved (2) record number (4) dropped number (4)
+ * Note:
+ * 1. The data bytes are not recorded, a page program costs about 10 bytes of ring buffer and
+ *    the trace holds no user data. The host tool (trace_tool.c) decodes the commands and
+ *    replays them on the emulator with filler data.
+ * 2. Per byte the recorder costs one call and one compare, spi_timeus is only read at the
+ *    CS edges. Without spi_timeus gap and time are 0.
+ * 3. The port callbacks have no context pointer, each traced device takes one of the
+ *    W25QXX_TRACE_MAXPORT static slots.
+ * 4. Records are written in the CS rising edge callback, W25Qxx_Trace_Export must not run
+ *    at the same time as a transaction on the traced device.
+ *
+ */
+#define W25QXX_TRACE_MAXPORT                         2			/* Number of devices that can be traced at the same time */
+#define W25QXX_TRACE_HEAD                            6			/* Recorded bytes at the start of a transaction */
+#define W25QXX_TRACE_MAXREC                          (1 + 5 + 5 + 5 + 1 + W25QXX_TRACE_HEAD)	/* Max record size */
+#define W25QXX_TRACE_HDRSIZE                         16			/* Export header size */
+#define W25QXX_TRACE_MAGIC                           0x54513257	/* "W2QT" */
+#define W25QXX_TRACE_VERSION                         1
+
+/**
+ * @brief W25Qxx Trace record (decoded)
+ */
+typedef struct
+{
+    uint32_t gap;                                    /* us from the previous CS rising edge */
+    uint32_t time;                                   /* us of the transaction */
+    uint32_t len;                                    /* Transaction bytes */
+    uint8_t miso;                                    /* Last byte read */
+    uint8_t numHead;                                 /* Recorded head bytes */
+    uint8_t head[W25QXX_TRACE_HEAD];                 /* First bytes written */
+} W25Qxx_TRACE_REC_t;
+
+/**
+ * @brief W25Qxx Trace recorder
+ */
+typedef struct
+{
+    W25Qxx_PORT_t port;                              /* Traced port */
+    uint8_t *buf;                                    /* Ring buffer */
+    uint32_t size;                                   /* Ring buffer size */
+    uint32_t head;                                   /* Write position */
+    uint32_t tail;                                   /* Oldest record */
+    uint32_t used;                                   /* Bytes in ring buffer */
+    uint32_t numRecord;                              /* Records in ring buffer */
+    uint32_t numDrop;                                /* Records dropped when the ring buffer was full */
+    uint32_t timeL;                                  /* Time of CS falling edge (us) */
+    uint32_t timeH;                                  /* Time of last CS rising edge (us) */
+    uint32_t len;                                    /* Bytes of current transaction */
+    uint8_t miso;                                    /* Last byte read */
+    uint8_t data[W25QXX_TRACE_HEAD];                 /* Head of current transaction */
+    uint8_t slot;                                    /* Port slot */
+} W25Qxx_TRACE_t;
+
+/**
+ * @brief W25Qxx Trace function
+ */
+void W25Qxx_Trace_Attach(W25Qxx_TRACE_t *trace, W25Qxx_t *dev, uint8_t *buf, uint32_t size, W25Qxx_ERR *err);
+void W25Qxx_Trace_Detach(W25Qxx_TRACE_t *trace, W25Qxx_t *dev);
+void W25Qxx_Trace_Clear(W25Qxx_TRACE_t *trace);
+uint32_t W25Qxx_Trace_Export(W25Qxx_TRACE_t *trace, uint8_t *pBuffer, uint32_t size);
+uint8_t W25Qxx_Trace_Decode(const uint8_t *pBuffer, uint32_t size, W25Qxx_TRACE_REC_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
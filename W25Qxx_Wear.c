@@ -0,0 +1,412 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Wear.c
+ * @brief   W25Qxx wear accounting
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#include "W25Qxx_Wear.h"
+#include <string.h>
+
+#if W25QXX_WEAR
+
+/* Record header
+ * | magic (4) | seq (4) | numSector (4) | size (4) | crc32c (4) | check (4) |
+ * crc32c : crc32c of the tokens
+ * check  : crc32c of magic ~ crc32c
+**/
+#define W25QXX_WEAR_CHECK     20
+#define W25QXX_WEAR_NOADDR    0xFFFFFFFF
+
+/* Token coder, area->buf holds the Byte not yet programmed / not yet decoded */
+typedef struct
+{
+    W25Qxx_WEAR_AREA_t *area;
+    uint32_t ByteAddr;                               /* Token address (W25QXX_WEAR_NOADDR : size only) */
+    uint32_t size;                                   /* Coded Byte */
+    uint32_t crc;                                    /* crc32c of coded Byte */
+    uint16_t len;                                    /* Byte in area->buf */
+    uint16_t pos;                                    /* Decode position in area->buf */
+} W25Qxx_WEAR_CODER_t;
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Internal function                                                     */
+/*---------------------------------------------------------------------------------------------------------------------*/
+static void W25Qxx_Wear_Flush(W25Qxx_WEAR_CODER_t *c, W25Qxx_ERR *err)											/* Program the coded Byte of area->buf */
+{
+    c->crc = W25Qxx_CRC32C(c->crc, c->area->buf, c->len);
+    if (c->ByteAddr != W25QXX_WEAR_NOADDR && c->len)
+    {
+        W25Qxx_DIR_Program(c->area->dev, c->area->buf, c->ByteAddr + c->size, c->len, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    c->size += c->len;
+    c->len = 0;
+    *err = W25Qxx_ERR_NONE;
+}
+static void W25Qxx_Wear_PutToken(W25Qxx_WEAR_CODER_t *c, uint64_t val, W25Qxx_ERR *err)							/* Code one varint token */
+{
+    if (c->len > W25Qxx_PAGESIZE - 10)
+    {
+        W25Qxx_Wear_Flush(c, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    while (val >= 0x80)
+    {
+        c->area->buf[c->len++] = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    c->area->buf[c->len++] = (uint8_t)val;
+    *err = W25Qxx_ERR_NONE;
+}
+static uint32_t W25Qxx_Wear_Encode(W25Qxx_WEAR_AREA_t *area, uint32_t ByteAddr, uint32_t *crc, W25Qxx_ERR *err)	/* Code the counts, program them to ByteAddr, return size */
+{
+    W25Qxx_WEAR_CODER_t c;
+    W25Qxx_WEAR_t *wear = &area->dev->wear;
+    uint32_t base = 0xFFFFFFFF;
+    uint32_t prev = 0;
+    uint32_t run = 0;
+    uint32_t val = 0;
+    uint32_t i = 0;
+
+    memset(&c, 0, sizeof(c));
+    c.area = area;
+    c.ByteAddr = ByteAddr;
+
+    for (i = 0; i < wear->numSector; i++)
+    {
+        if (wear->count[i] < base) base = wear->count[i];
+    }
+    W25Qxx_Wear_PutToken(&c, base, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    for (i = 0; i < wear->numSector; i++)
+    {
+        val = wear->count[i] - base;
+        if (val == prev && i != 0)
+        {
+            run++;
+            continue;
+        }
+        if (run) W25Qxx_Wear_PutToken(&c, (uint64_t)run << 1, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+        W25Qxx_Wear_PutToken(&c, ((uint64_t)val << 1) | 1, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+        prev = val;
+        run = 0;
+    }
+    if (run) W25Qxx_Wear_PutToken(&c, (uint64_t)run << 1, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+    W25Qxx_Wear_Flush(&c, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    *crc = c.crc;
+    return c.size;
+}
+static uint8_t W25Qxx_Wear_GetToken(W25Qxx_WEAR_CODER_t *c, uint64_t *val, W25Qxx_ERR *err)					/* Decode one varint token, return 0 at the end of the record */
+{
+    uint8_t shift = 0;
+    uint8_t b = 0;
+
+    *val = 0;
+    *err = W25Qxx_ERR_NONE;
+    do
+    {
+        if (shift >= 64) return 0;
+        if (c->pos == c->len)
+        {
+            if (c->size == 0) return 0;
+            c->len = (c->size > W25Qxx_PAGESIZE) ? W25Qxx_PAGESIZE : (uint16_t)c->size;
+            W25Qxx_Read(c->area->dev, c->area->buf, c->ByteAddr, c->len, err);
+            if (*err != W25Qxx_ERR_NONE) return 0;
+            c->crc = W25Qxx_CRC32C(c->crc, c->area->buf, c->len);
+            c->ByteAddr += c->len;
+            c->size -= c->len;
+            c->pos = 0;
+        }
+        b = c->area->buf[c->pos++];
+        *val |= (uint64_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    return 1;
+}
+static uint8_t W25Qxx_Wear_Decode(W25Qxx_WEAR_AREA_t *area, uint32_t ByteAddr, uint32_t size, uint32_t crc, W25Qxx_ERR *err)	/* Load the counts of a record, return 1 if it is valid */
+{
+    W25Qxx_WEAR_CODER_t c;
+    W25Qxx_WEAR_t *wear = &area->dev->wear;
+    uint64_t token = 0;
+    uint32_t base = 0;
+    uint32_t prev = 0;
+    uint32_t i = 0;
+
+    memset(&c, 0, sizeof(c));
+    c.area = area;
+    c.ByteAddr = ByteAddr;
+    c.size = size;
+
+    if (!W25Qxx_Wear_GetToken(&c, &token, err)) return 0;
+    base = (uint32_t)token;
+    while (W25Qxx_Wear_GetToken(&c, &token, err))
+    {
+        if (token & 1)
+        {
+            if (i == wear->numSector) return 0;
+            prev = (uint32_t)(token >> 1);
+            wear->count[i++] = base + prev;
+        }
+        else
+        {
+            if (i == 0 || (token >> 1) > wear->numSector - i) return 0;
+            for (token >>= 1; token; token--) wear->count[i++] = base + prev;
+        }
+    }
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    return i == wear->numSector && c.size == 0 && c.pos == c.len && c.crc == crc;
+}
+static uint8_t W25Qxx_Wear_Header(W25Qxx_WEAR_AREA_t *area, uint32_t offset, W25Qxx_ERR *err)					/* Read and check the record header at offset */
+{
+    W25Qxx_t *dev = area->dev;
+
+    W25Qxx_Read(dev, area->buf, area->firstSector * dev->sizeSector + offset, W25QXX_WEAR_HEADER, err);
+    if (*err != W25Qxx_ERR_NONE) return 0;
+
+    return W25Qxx_Get32(area->buf) == W25QXX_WEAR_MAGIC &&
+           W25Qxx_Get32(area->buf + W25QXX_WEAR_CHECK) == W25Qxx_CRC32C(0, area->buf, W25QXX_WEAR_CHECK) &&
+           W25Qxx_Get32(area->buf + 8) == dev->numSector &&
+           W25Qxx_Get32(area->buf + 12) <= area->numSector * dev->sizeSector - offset - W25QXX_WEAR_HEADER;
+}
+static uint8_t W25Qxx_Wear_isBlank(W25Qxx_WEAR_AREA_t *area, uint32_t offset, uint32_t NumByte, W25Qxx_ERR *err)	/* Area range is erased */
+{
+    W25Qxx_t *dev = area->dev;
+    uint32_t num = 0;
+
+    *err = W25Qxx_ERR_NONE;
+    for (; NumByte; NumByte -= num, offset += num)
+    {
+        num = (NumByte > W25Qxx_PAGESIZE) ? W25Qxx_PAGESIZE : NumByte;
+        W25Qxx_Read(dev, area->buf, area->firstSector * dev->sizeSector + offset, (uint16_t)num, err);
+        if (*err != W25Qxx_ERR_NONE) return 0;
+        if (!W25Qxx_isBlank(area->buf, num)) return 0;
+    }
+
+    return 1;
+}
+/*---------------------------------------------------------------------------------------------------------------------*/
+/*                                               Wear function                                                         */
+/*---------------------------------------------------------------------------------------------------------------------*/
+void W25Qxx_Wear_Mount(W25Qxx_WEAR_AREA_t *area, W25Qxx_t *dev, uint32_t *count, uint32_t FirstSector, uint32_t NumSector, W25Qxx_ERR *err)
+{
+    uint32_t offset = 0;
+    uint32_t limit = 0xFFFFFFFF;
+    uint32_t best = 0;
+    uint32_t bestSeq = 0;
+    uint32_t seq = 0;
+    uint32_t size = 0;
+    uint32_t crc = 0;
+    uint8_t found = 0;
+
+    /* Determine if the area is in the chip */
+    if (count == NULL || NumSector < 2 || FirstSector >= dev->numSector || NumSector > dev->numSector - FirstSector)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    memset(area, 0, sizeof(W25Qxx_WEAR_AREA_t));
+    area->dev = dev;
+    area->firstSector = FirstSector;
+    area->numSector = NumSector;
+    area->seq = 1;
+    dev->wear.count = count;
+    dev->wear.numSector = dev->numSector;
+    dev->wear.numChange = 0;
+
+    /* newest record with a valid crc32c, the newest header gives the next record offset and seq */
+    while (1)
+    {
+        found = 0;
+        for (offset = 0; offset < NumSector * dev->sizeSector; offset += dev->sizePage)
+        {
+            if (!W25Qxx_Wear_Header(area, offset, err))
+            {
+                if (*err != W25Qxx_ERR_NONE) return;
+                continue;
+            }
+            seq = W25Qxx_Get32(area->buf + 4);
+            if (seq >= limit || (found && seq <= bestSeq)) continue;
+
+            found = 1;
+            best = offset;
+            bestSeq = seq;
+            size = W25Qxx_Get32(area->buf + 12);
+            crc = W25Qxx_Get32(area->buf + 16);
+        }
+        if (!found) break;
+        if (limit == 0xFFFFFFFF)
+        {
+            area->next = (best + W25QXX_WEAR_HEADER + size + dev->sizePage - 1) / dev->sizePage * dev->sizePage;
+            area->seq = bestSeq + 1;
+        }
+        limit = bestSeq;
+
+        if (W25Qxx_Wear_Decode(area, FirstSector * dev->sizeSector + best + W25QXX_WEAR_HEADER, size, crc, err))
+        {
+            area->seqLoad = bestSeq;
+            area->size = W25QXX_WEAR_HEADER + size;
+            break;
+        }
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+
+    /* no valid record : all sectors start at 0 */
+    if (area->seqLoad == 0) memset(count, 0, dev->numSector * sizeof(uint32_t));
+
+    *err = W25Qxx_ERR_NONE;
+}
+void W25Qxx_Wear_Checkpoint(W25Qxx_WEAR_AREA_t *area, W25Qxx_ERR *err)
+{
+    W25Qxx_t *dev = area->dev;
+    uint32_t areaSize = area->numSector * dev->sizeSector;
+    uint32_t offset = area->next;
+    uint32_t total = 0;
+    uint32_t size = 0;
+    uint32_t crc = 0;
+    uint32_t sector = 0;
+    uint8_t head[W25QXX_WEAR_HEADER];
+
+    /* Determine if the accounting is mounted */
+    if (dev->wear.count == NULL)
+    {
+        *err = W25Qxx_ERR_INVALID;
+        return;
+    }
+
+    /* record size, the area keeps the previous record while the next one is written */
+    total = W25QXX_WEAR_HEADER + W25Qxx_Wear_Encode(area, W25QXX_WEAR_NOADDR, &crc, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    if (2 * total + dev->sizeSector > areaSize)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    /* the rest of a started sector is used when it is blank (a torn record is skipped) */
+    if (offset + total > areaSize) offset = 0;
+    if (offset % dev->sizeSector)
+    {
+        size = dev->sizeSector - offset % dev->sizeSector;
+        if (!W25Qxx_Wear_isBlank(area, offset, (total < size) ? total : size, err))
+        {
+            if (*err != W25Qxx_ERR_NONE) return;
+            offset += size;
+            if (offset + total > areaSize) offset = 0;
+        }
+    }
+
+    /* erase the sectors the record enters, the erase is counted and may make the record longer */
+    for (sector = (offset + dev->sizeSector - 1) / dev->sizeSector; sector * dev->sizeSector < offset + total; sector++)
+    {
+        W25Qxx_Erase_Sector(dev, area->firstSector + sector, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+        total = W25QXX_WEAR_HEADER + W25Qxx_Wear_Encode(area, W25QXX_WEAR_NOADDR, &crc, err);
+        if (*err != W25Qxx_ERR_NONE) return;
+    }
+    if (offset + total > areaSize)
+    {
+        *err = W25Qxx_ERR_FULL;
+        return;
+    }
+
+    /* tokens, then the header makes the record valid */
+    size = W25Qxx_Wear_Encode(area, area->firstSector * dev->sizeSector + offset + W25QXX_WEAR_HEADER, &crc, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+    W25Qxx_Put32(head, W25QXX_WEAR_MAGIC);
+    W25Qxx_Put32(head + 4, area->seq);
+    W25Qxx_Put32(head + 8, dev->numSector);
+    W25Qxx_Put32(head + 12, size);
+    W25Qxx_Put32(head + 16, crc);
+    W25Qxx_Put32(head + W25QXX_WEAR_CHECK, W25Qxx_CRC32C(0, head, W25QXX_WEAR_CHECK));
+    W25Qxx_DIR_Program(dev, head, area->firstSector * dev->sizeSector + offset, W25QXX_WEAR_HEADER, err);
+    if (*err != W25Qxx_ERR_NONE) return;
+
+    area->next = (offset + W25QXX_WEAR_HEADER + size + dev->sizePage - 1) / dev->sizePage * dev->sizePage;
+    area->size = W25QXX_WEAR_HEADER + size;
+    area->seq++;
+    area->numCheckpoint++;
+    dev->wear.numChange = 0;
+
+    *err = W25Qxx_ERR_NONE;
+}
+uint32_t W25Qxx_Wear_Block(W25Qxx_t *dev, uint32_t Block64Addr)													/* Highest erase count of the sectors of a block */
+{
+    uint32_t sector = Block64Addr * (dev->sizeBlock / dev->sizeSector);
+    uint32_t end = sector + dev->sizeBlock / dev->sizeSector;
+    uint32_t max = 0;
+
+    if (dev->wear.count == NULL) return 0;
+    if (end > dev->wear.numSector) end = dev->wear.numSector;
+    for (; sector < end; sector++)
+    {
+        if (dev->wear.count[sector] > max) max = dev->wear.count[sector];
+    }
+
+    return max;
+}
+void W25Qxx_Wear_Histogram(W25Qxx_t *dev, uint32_t *hist, uint32_t NumBin, uint32_t BinWidth)					/* Sector number per erase count range, the last bin takes the rest */
+{
+    uint32_t bin = 0;
+    uint32_t i = 0;
+
+    if (NumBin == 0) return;
+    memset(hist, 0, NumBin * sizeof(uint32_t));
+    if (dev->wear.count == NULL || BinWidth == 0) return;
+
+    for (i = 0; i < dev->wear.numSector; i++)
+    {
+        bin = dev->wear.count[i] / BinWidth;
+        hist[(bin < NumBin) ? bin : NumBin - 1]++;
+    }
+}
+uint32_t W25Qxx_Wear_Hottest(W25Qxx_t *dev, W25Qxx_WEAR_HOT_t *hot, uint32_t Num)								/* Num most erased sectors, highest first, return number */
+{
+    uint32_t n = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    if (dev->wear.count == NULL) return 0;
+
+    for (i = 0; i < dev->wear.numSector; i++)
+    {
+        if (n == Num && (Num == 0 || dev->wear.count[i] <= hot[n - 1].count)) continue;
+
+        /* insert in order, the lowest one falls out of a full list */
+        j = (n < Num) ? n++ : n - 1;
+        for (; j > 0 && hot[j - 1].count < dev->wear.count[i]; j--) hot[j] = hot[j - 1];
+        hot[j].sector = i;
+        hot[j].count = dev->wear.count[i];
+    }
+
+    return n;
+}
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2022 iammingge
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file    W25Qxx_Wear.h
+ * @brief   W25Qxx wear accounting header file
+ * @author  iammingge
+ *
+ *      DATE             NAME                      DESCRIPTION
+ *
+ *   10-18-2026        iammingge                Initial Version 1.0
+ *
+**/
+
+#ifndef __W25QXX_WEAR_H
+#define __W25QXX_WEAR_H
+
+#include "W25Qxx.h"
+#include "W25Qxx_CRC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if W25QXX_WEAR
+/**
+ * @brief W25Qxx Wear Accounting
+ *
+ * 				The erase count per sector (dev->wear, W25QXX_WEAR = 1) is kept in RAM, W25Qxx_Wear_Checkpoint
+ * 				appends it as one compact record to a reserved sector area.
+ *
+ * 				Record : header | magic (4) | seq (4) | numSector (4) | size (4) | crc32c (4) | check (4) |
+ * 				         and size Byte of varint tokens, the count minus the smallest count (base) :
+ * 				         base first, then 2n : previous value n more times, 2v + 1 : value v
+ * 				Area   : a record starts on a page after the previous one, at the end of the area the
+ * 				         next record starts at the first sector again. A sector is only erased when a
+ * 				         record enters it, a checkpoint costs page programs and one sector erase every
+ * 				         sizeSector / record size checkpoints. The header is programmed after the tokens.
+ * 				Mount  : the record with the highest seq and a valid crc32c is loaded.
+ * Note:
+ * 1. The erases of the checkpoint area are counted as well.
+ * 2. The area must hold two records and one sector, W25Qxx_Wear_Checkpoint returns W25Qxx_ERR_FULL
+ *    otherwise (a flat wear of 2048 sectors is a record of about 30 Byte, a random one 2 - 3KB).
+ * 3. The erases after the last checkpoint are lost at power loss, checkpoint after a number of
+ *    erases (dev->wear.numChange) and before power off.
+ * 4. The area is reserved, the application must not program or erase it.
+ *
+ */
+#define W25QXX_WEAR_MAGIC                            0x52414557u	/* "WEAR" */
+#define W25QXX_WEAR_HEADER                           24				/* Record header size (Byte) */
+
+/**
+ * @brief W25Qxx Wear checkpoint area
+ */
+typedef struct
+{
+    W25Qxx_t *dev;                                   /* Device */
+    uint32_t firstSector;                            /* First sector of the area */
+    uint32_t numSector;                              /* Sector number of the area */
+    uint32_t next;                                   /* Next record offset in the area (Byte) */
+    uint32_t seq;                                    /* Next record seq */
+    uint32_t seqLoad;                                /* Seq of the record loaded by mount (0 : none, counts start at 0) */
+    uint32_t size;                                   /* Size of the last record (Byte) */
+    uint32_t numCheckpoint;                          /* Records written since mount */
+    uint8_t buf[W25Qxx_PAGESIZE];                    /* Record coding buffer */
+} W25Qxx_WEAR_AREA_t;
+
+/**
+ * @brief W25Qxx Wear hottest sector
+ */
+typedef struct
+{
+    uint32_t sector;                                 /* Sector address */
+    uint32_t count;                                  /* Erase count */
+} W25Qxx_WEAR_HOT_t;
+
+/**
+ * @brief W25Qxx Wear function
+ */
+void W25Qxx_Wear_Mount(W25Qxx_WEAR_AREA_t *area, W25Qxx_t *dev, uint32_t *count, uint32_t FirstSector, uint32_t NumSector, W25Qxx_ERR *err);
+void W25Qxx_Wear_Checkpoint(W25Qxx_WEAR_AREA_t *area, W25Qxx_ERR *err);
+uint32_t W25Qxx_Wear_Block(W25Qxx_t *dev, uint32_t Block64Addr);
+void W25Qxx_Wear_Histogram(W25Qxx_t *dev, uint32_t *hist, uint32_t NumBin, uint32_t BinWidth);
+uint32_t W25Qxx_Wear_Hottest(W25Qxx_t *dev, W25Qxx_WEAR_HOT_t *hot, uint32_t Num);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
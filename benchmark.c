@@ -0,0 +1,2477 @@
+/**
+  * @file  : benchmark.c
+  * @brief : W25Qxx throughput and latency benchmark on the emulated chip (host)
+  *
+  * Build : cc -O2 -o benchmark benchmark.c W25Qxx.c W25Qxx_Emu.c W25Qxx_Trace.c W25Qxx_Wear.c W25Qxx_CRC.c W25Qxx_Mirror.c W25Qxx_FTL.c W25Qxx_KV.c W25Qxx_Log.c W25Qxx_Queue.c W25Qxx_Bus.c W25Qxx_Die.c W25Qxx_ECC.c W25Qxx_LZ.c
+  *         make benchmark_fs : the same with -DBENCH_LFS=1 -DBENCH_FATFS=1, W25Qxx_LFS.c, W25Qxx_Disk.c,
+  *                               littlefs and FatFs (lfs and fatfs sections)
+  * Usage : benchmark [csv|json] [quick] [cal] [all] [W25Q16|W25Q32|W25Q64|W25Q128|W25Q256|W25Q512|W25Q01|W25Q02] [section ...]
+  *
+  *         csv   : one row per point (default)
+  *         json  : array of the same records
+  *         quick : fewer repetitions, for a smoke run
+  *         cal   : W25Qxx_Calibrate before the run (BUSY polled by the calibrated schedule)
+  *         chip  : run only the given chip models (default W25Q16, W25Q64, W25Q256)
+  *         all   : every section below after the default run
+  *         section : run only the named sections (and the named chips)
+  *                 power  : W25QXX_AUTO_POWER = 1, access traces replayed with idle time off/1/10/100/1000ms
+  *                          (size), latency of all accesses and of the accesses that release the
+  *                          chip (first_access), energy of the trace by the BENCH_I* currents
+  *                 mirror : read latency right after an erase and sector erase latency, one chip against
+  *                          the mirror volume
+  *                 jitter : W25Qxx_Calibrate on chips of W25Qxx_EMU_Jitter +/- 0/10/25/50% (size),
+  *                          "error_pct" rows : p50/p99 calibration error (%) of the chips, then page
+  *                          program and sector erase polled uncalibrated, calibrated and by the
+  *                          calibration of a typical chip (stale), spi_bytes : polling traffic
+  *                 startup : W25Qxx_config after power-up (cold) against W25Qxx_config_Warm after an
+  *                          MCU reset (warm) and after power-up (warm_power_up : the chip powers up in
+  *                          the saved state, cold_fallback : it does not, e.g. the 4 Byte address mode),
+  *                          p50/p99 : wall time, spi_bytes : bus time = spi_bytes * 8 / BENCH_CLKHZ
+  *                 ftl    : W25Qxx_FTL over the 4096 sectors of W25Q128, uniform and hot_cold (90% of
+  *                          the writes to 5% of the logical sectors) after every logical sector is
+  *                          written once, "EraseCount" rows : p50/p99 = min/max erase count of the
+  *                          physical sectors, erases/programs = physical sector erases/programs per
+  *                          logical write (write amplification), "Mount" : time to rebuild the map
+  *                 kv     : W25Qxx_KV of 64 keys in 16 sectors, put and get of random keys (size :
+  *                          value Byte, ops/s = bytes_per_s / size, erases x 10000 = erases per 10k
+  *                          updates), mount after the updates
+  *                 log    : W25Qxx_Log append of 16/128/1024 Byte records (size), mount of a ring of
+  *                          16/256/2048 sectors (size) written 1.5 times
+  *                 queue  : batches of W25QXX_QUEUE_DEPTH requests (size) of a table scan, scattered
+  *                          reads, a table scan with programs and the reads of 4 clients recorded by
+  *                          W25Qxx_Trace (Trace_Clients), dispatched one by one (direct) and by
+  *                          W25Qxx_Queue_Flush (queued), latency, SPI bytes and CS transactions per
+  *                          batch (Byte per transaction = spi_bytes / transactions)
+  *                 bus    : two emulated W25Q64 on one bus, 256KB program and erase on both chips one
+  *                          after the other (serial) and as W25Qxx_Bus jobs (bus), page read of one
+  *                          chip while the other erases a sector (size : Byte of both chips)
+  *                 die    : W25Q01 page reads of die 0 or die 1 (chip) arriving every 1ms with a die 0
+  *                          sector erase every 50ms, W25Qxx_Erase_Sector (blocking) against W25Qxx_Die
+  *                          (die), latency from the arrival of the read
+  *                 ecc    : W25Qxx_ECC_Read of 1/16/128 pages of data against W25Qxx_Read of the same
+  *                          pages (plain), without and with a bit error in every page, "ecc:W25Q64"
+  *                          rows in emulator time, "ecc:host" rows by the host clock (CRC CPU time
+  *                          on top of the emulator)
+  *                 lz     : W25Qxx_LZ of 256/512/1024/4096 Byte blocks (size, up to W25QXX_LZ_BLOCK, size 0 :
+  *                          W25Qxx_DIR_Program / W25Qxx_Read of the raw data) on log lines, JSON records,
+  *                          a lookup table and random data (state), 4KB appends, 4KB sequential and 64 Byte
+  *                          random reads, bytes_per_s of raw data, "Footprint" rows : spi_bytes = flash
+  *                          Byte per 4KB raw data, ram_bytes = W25Qxx_LZ_t at W25QXX_LZ_BLOCK = size
+  *                 checksum : CRC32/CRC32C/SHA256 of the 16MB W25Q128 (size, 1MB quick) by W25Qxx_Checksum
+  *                          (stream) against W25Qxx_Read into RAM then the hash (two_pass) and the hash of
+  *                          RAM alone (kernel), "checksum:W25Q128" rows in emulator time, "checksum:host"
+  *                          rows by the host clock, ram_bytes = RAM buffer Byte
+  *                 lfs    : BENCH_LFS = 1 (make benchmark_fs), littlefs through W25Qxx_LFS_config on 1MB
+  *                          of W25Q64 : format, mount, create of 64 files of 64 Byte (open, write,
+  *                          close), 256KB file written and read back by 4KB calls, 64 Byte appends
+  *                          with lfs_file_sync, then mount of the used volume, latency per call
+  *                 fatfs  : BENCH_FATFS = 1 (make benchmark_fs), FatFs through W25Qxx_Disk on 1MB of
+  *                          W25Q64 (FAT12, cluster = 4KB erase unit) : format, mount, 256KB file
+  *                          written by 4KB calls, then copied by 4KB read + write calls to space never
+  *                          written (erased), to the clusters of a deleted copy (dirty) and to the
+  *                          same after W25Qxx_Disk_Idle erased the trimmed units (Idle row : time of
+  *                          the background erase), read back of the copy
+  *
+  * Time is the emulator virtual time (SPI clock + BUSY time), except for the buffer check
+  * kernels (chip "host") and the driver CPU time (chip "driver", zero latency port, to compare
+  * builds such as W25QXX_STATS = 0/1, "driver+trace" through W25Qxx_Trace_Attach) which are
+  * timed by the host clock. With W25QXX_WEAR = 1 the chip "wear" rows give the host time per
+  * erase with the accounting not mounted / counted, the "wear:<chip>" rows the emulator time of
+  * W25Qxx_Wear_Checkpoint and W25Qxx_Wear_Mount (size : record Byte). With W25QXX_LATENCY = 1
+  * the "latency:W25Q64" rows are the W25Qxx_Latency_Dump of a random read/program/erase mix
+  * (reps : operations, p50/p99 : upper bound of the histogram bucket).
+  */
+#define _POSIX_C_SOURCE     199309L						/* clock_gettime with -std=c99 */
+#ifndef BENCH_LFS
+#define BENCH_LFS           0							/* 1 : lfs section, needs littlefs (make benchmark_fs) */
+#endif
+#ifndef BENCH_FATFS
+#define BENCH_FATFS         0							/* 1 : fatfs section, needs FatFs (make benchmark_fs) */
+#endif
+
+#include "W25Qxx.h"
+#include "W25Qxx_Emu.h"
+#include "W25Qxx_Trace.h"
+#include "W25Qxx_Wear.h"
+#include "W25Qxx_Mirror.h"
+#include "W25Qxx_FTL.h"
+#include "W25Qxx_KV.h"
+#include "W25Qxx_Log.h"
+#include "W25Qxx_Queue.h"
+#include "W25Qxx_Bus.h"
+#include "W25Qxx_Die.h"
+#include "W25Qxx_ECC.h"
+#include "W25Qxx_LZ.h"
+#if BENCH_LFS
+#include "W25Qxx_LFS.h"
+#endif
+#if BENCH_FATFS
+#include "W25Qxx_Disk.h"
+#if !FF_USE_MKFS || !FF_USE_TRIM
+#error "fatfs section : FF_USE_MKFS = 1 and FF_USE_TRIM = 1 in ffconf.h"
+#endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CLKHZ         50000000					/* Emulated SPI clock */
+#define BENCH_MAXSIZE       0x100000					/* Largest transfer (1MB) */
+#define BENCH_READCHUNK     0x8000						/* W25Qxx_Read length is 16 bit, larger reads are split */
+#define BENCH_UNALIGNED     0x83						/* Unaligned offset : crosses page and sector boundary */
+#define BENCH_MAXREP        32
+#define BENCH_KERNELSIZE    0x40000						/* Buffer check kernel buffer (256KB) */
+#define BENCH_VCC           3.3							/* Energy model (W25Q128JV typical) : supply (V) */
+#define BENCH_ISB           10e-6						/* Standby current (A) */
+#define BENCH_IPD           1e-6						/* Deep power-down current (A) */
+#define BENCH_IREAD         7e-3						/* Read current at 50MHz (A) */
+#define BENCH_IPROG         20e-3						/* Program/erase current (A) */
+#define BENCH_LZRAW         0x40000						/* Raw data of the lz section (256KB) */
+#define BENCH_LZPIECE       4096						/* lz Append / sequential read length */
+#define BENCH_LZRAND        256							/* lz random reads (BENCH_LZPIECE / 64 Byte) */
+#define BENCH_LZSECTOR      256							/* lz volume sectors (plain data in the upper half) */
+#define BENCH_FSSECTOR      256							/* File system volume sectors (1MB) */
+#define BENCH_FSFILE        0x40000						/* File_Write / File_Read file length (256KB) */
+#define BENCH_FSPIECE       4096						/* File_Write / File_Read call length */
+#define BENCH_FSFILES       64							/* File_Create files */
+#define BENCH_FSRECORD      64							/* File_Create file / File_Append record length */
+#define BENCH_FSREP         256							/* File_Append records */
+
+typedef enum
+{
+	BENCH_READ = 0,
+	BENCH_PROGRAM,
+	BENCH_DIR_PROGRAM,
+	BENCH_ERASE_SECTOR,
+	BENCH_ERASE_BLOCK32,
+	BENCH_ERASE_BLOCK64,
+} BENCH_OP;
+
+typedef struct
+{
+	const char *chip;
+	const char *op;
+	uint32_t size;
+	const char *align;
+	const char *state;
+	uint32_t reps;
+	double bps;									/* Bytes per second */
+	double p50;									/* Latency p50 (us) */
+	double p99;									/* Latency p99 (us) */
+	double spiBytes;							/* SPI bytes on the wire per operation */
+	double erases;								/* Erases per operation */
+	double programs;							/* Page programs per operation */
+	double energy;								/* Estimated energy (mJ, power rows) */
+	double transactions;						/* CS transactions per operation (0 : not counted, empty) */
+	double ram;									/* RAM Byte of the measured code (0 : not measured, empty) */
+} BENCH_RESULT_t;
+
+static const struct { const char *name; W25Qxx_CHIP type; } BenchChip[] = {
+	{ "W25Q16", W25Q16 }, { "W25Q32", W25Q32 }, { "W25Q64", W25Q64 }, { "W25Q128", W25Q128 },
+	{ "W25Q256", W25Q256 }, { "W25Q512", W25Q512 }, { "W25Q01", W25Q01 }, { "W25Q02", W25Q02 },
+};
+static const char *OpName[] = { "Read", "Program", "DIR_Program", "Erase_Sector", "Erase_Block32", "Erase_Block64" };
+
+static W25Qxx_EMU_t emu;
+static W25Qxx_t dev;
+static W25Qxx_ERR err;
+static uint8_t *src;
+static uint8_t *dst;
+static uint32_t seed = 0x2545F491;
+static uint8_t json = 0;
+static uint32_t rows = 0;
+
+static uint32_t Bench_Rand(void)																	/* xorshift32 */
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+static void Bench_Fill(uint8_t *p, uint32_t n)														/* Random data */
+{
+	uint32_t i;
+
+	for (i = 0; i < n; i++) p[i] = (uint8_t)Bench_Rand();
+}
+static int Bench_Cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+static double Bench_Percentile(uint64_t *t, uint32_t n, uint32_t pct)								/* Nearest rank percentile of sorted sample (ns -> us) */
+{
+	uint32_t rank = (n * pct + 99) / 100;
+
+	if (rank == 0) rank = 1;
+	return t[rank - 1] / 1000.0;
+}
+static void Bench_Print(BENCH_RESULT_t *r)															/* Output one record */
+{
+	if (json)
+	{
+		printf("%s\n  {\"chip\":\"%s\",\"op\":\"%s\",\"size\":%u,\"align\":\"%s\",\"state\":\"%s\",\"reps\":%u,"
+		       "\"bytes_per_s\":%.0f,\"p50_us\":%.2f,\"p99_us\":%.2f,\"spi_bytes\":%.0f,\"erases\":%.2f,\"programs\":%.2f,\"energy_mj\":%.3f,",
+		       rows ? "," : "[", r->chip, r->op, r->size, r->align, r->state, r->reps,
+		       r->bps, r->p50, r->p99, r->spiBytes, r->erases, r->programs, r->energy);
+		if (r->transactions) printf("\"transactions\":%.2f,", r->transactions);
+		else                 printf("\"transactions\":null,");
+		if (r->ram) printf("\"ram_bytes\":%.0f}", r->ram);
+		else        printf("\"ram_bytes\":null}");
+	}
+	else
+	{
+		if (rows == 0) printf("chip,op,size,align,state,reps,bytes_per_s,p50_us,p99_us,spi_bytes,erases,programs,energy_mj,transactions,ram_bytes\n");
+		printf("%s,%s,%u,%s,%s,%u,%.0f,%.2f,%.2f,%.0f,%.2f,%.2f,%.3f,",
+		       r->chip, r->op, r->size, r->align, r->state, r->reps,
+		       r->bps, r->p50, r->p99, r->spiBytes, r->erases, r->programs, r->energy);
+		if (r->transactions) printf("%.2f,", r->transactions);
+		else                 printf(",");
+		if (r->ram) printf("%.0f\n", r->ram);
+		else        printf("\n");
+	}
+	rows++;
+}
+static void Bench_Fail(const char *what)															/* Report the failed step and the driver error, then exit */
+{
+	fprintf(stderr, "%s : err %d\n", what, err);
+	exit(1);
+}
+static void Bench_Open(W25Qxx_EMU_t *e, W25Qxx_t *d, W25Qxx_CHIP type)								/* Fresh emulated chip behind a device, exit with the chip and error code on failure */
+{
+	const char *name = "?";
+	uint8_t i;
+
+	for (i = 0; i < sizeof(BenchChip) / sizeof(BenchChip[0]); i++)
+		if (BenchChip[i].type == type) name = BenchChip[i].name;
+	memset(d, 0, sizeof(W25Qxx_t));
+	W25Qxx_EMU_Init(e, type, BENCH_CLKHZ, &err);
+	if (err != W25Qxx_ERR_NONE)
+	{
+		fprintf(stderr, "%s : emulator init err %d\n", name, err);
+		exit(1);
+	}
+	W25Qxx_EMU_Port(e, &d->port);
+	W25Qxx_config(d, &err);
+	if (err != W25Qxx_ERR_NONE)
+	{
+		fprintf(stderr, "%s : config err %d\n", name, err);
+		exit(1);
+	}
+}
+static void Bench_Prepare(uint32_t addr, uint32_t size, uint8_t dirty)								/* Set the sectors of a range fresh (erased) or dirty (random data) */
+{
+	uint32_t start = addr & ~(uint32_t)(W25Qxx_SECTORSIZE - 1);
+	uint32_t end = (addr + size + W25Qxx_SECTORSIZE - 1) & ~(uint32_t)(W25Qxx_SECTORSIZE - 1);
+
+	/* written straight into the emulated array, so the preparation does not count */
+	if (dirty) Bench_Fill(&emu.mem[start], end - start);
+	else       memset(&emu.mem[start], 0xFF, end - start);
+}
+static void Bench_Run(const char *chip, BENCH_OP op, uint32_t size, uint32_t offset, uint8_t dirty, uint32_t reps)	/* Measure one point */
+{
+	static uint64_t lat[BENCH_MAXREP];
+	BENCH_RESULT_t r;
+	uint64_t t0 = 0;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint32_t addr = 0;
+	uint32_t done = 0;
+	uint32_t n = 0;
+	uint32_t i = 0;
+
+	memset(&r, 0, sizeof(r));
+	for (i = 0; i < reps; i++)
+	{
+		/* a different block64 each repetition, the range must not leave the chip */
+		addr = ((i * W25Qxx_BLOCKSIZE * 17) % (emu.sizeChip - BENCH_MAXSIZE - W25Qxx_BLOCKSIZE)) & ~(uint32_t)(W25Qxx_BLOCKSIZE - 1);
+		addr += offset;
+		Bench_Prepare(addr, size, dirty);
+		Bench_Fill(src, size);
+
+		bytes = emu.stat.bytes;
+		erases = emu.stat.erases;
+		programs = emu.stat.programs;
+		t0 = W25Qxx_EMU_Now;
+		switch (op)
+		{
+			case BENCH_READ:
+				for (done = 0; done < size; done += n)
+				{
+					n = (size - done > BENCH_READCHUNK) ? BENCH_READCHUNK : size - done;
+					W25Qxx_Read(&dev, dst + done, addr + done, (uint16_t)n, &err);
+					if (err != W25Qxx_ERR_NONE) break;
+				}
+				break;
+			case BENCH_PROGRAM:       W25Qxx_Program(&dev, src, addr, size, &err);       break;
+			case BENCH_DIR_PROGRAM:   W25Qxx_DIR_Program(&dev, src, addr, size, &err);   break;
+			case BENCH_ERASE_SECTOR:  W25Qxx_Erase_Sector(&dev, W25Qxx_SECTORADDR(addr), &err);   break;
+			case BENCH_ERASE_BLOCK32: W25Qxx_Erase_Block32(&dev, W25Qxx_BLOCK32ADDR(addr), &err); break;
+			case BENCH_ERASE_BLOCK64: W25Qxx_Erase_Block64(&dev, W25Qxx_BLOCK64ADDR(addr), &err); break;
+		}
+		lat[i] = W25Qxx_EMU_Now - t0;
+		if (err != W25Qxx_ERR_NONE)
+		{
+			fprintf(stderr, "%s %s size %u addr 0x%08X : err %d\n", chip, OpName[op], size, addr, err);
+			exit(1);
+		}
+
+		/* the programmed data must read back */
+		if ((op == BENCH_PROGRAM || op == BENCH_DIR_PROGRAM) && memcmp(&emu.mem[addr], src, size) != 0)
+		{
+			fprintf(stderr, "%s %s size %u addr 0x%08X : data mismatch\n", chip, OpName[op], size, addr);
+			exit(1);
+		}
+
+		total += lat[i];
+		r.spiBytes += (double)(emu.stat.bytes - bytes);
+		r.erases += emu.stat.erases - erases;
+		r.programs += emu.stat.programs - programs;
+	}
+	qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+	r.chip = chip;
+	r.op = OpName[op];
+	r.size = size;
+	r.align = offset ? "unaligned" : "aligned";
+	r.state = (op == BENCH_READ) ? "any" : (dirty ? "dirty" : "fresh");
+	r.reps = reps;
+	r.bps = total ? (double)size * reps * 1e9 / total : 0;
+	r.p50 = Bench_Percentile(lat, reps, 50);
+	r.p99 = Bench_Percentile(lat, reps, 99);
+	r.spiBytes /= reps;
+	r.erases /= reps;
+	r.programs /= reps;
+	Bench_Print(&r);
+}
+static void Bench_Chip(const char *chip, W25Qxx_CHIP type, uint8_t quick, uint8_t cal)				/* Sweep of one chip model */
+{
+	static const BENCH_OP erase[] = { BENCH_ERASE_SECTOR, BENCH_ERASE_BLOCK32, BENCH_ERASE_BLOCK64 };
+	static const uint32_t erasesize[] = { W25Qxx_SECTORSIZE, W25Qxx_BLOCKSIZE >> 1, W25Qxx_BLOCKSIZE };
+	uint32_t size = 0;
+	uint32_t reps = 0;
+	uint8_t a = 0;
+	uint8_t d = 0;
+	uint8_t i = 0;
+
+	Bench_Open(&emu, &dev, type);
+	if (cal) W25Qxx_Calibrate(&dev, dev.numBlock - 1, &err);
+	if (err != W25Qxx_ERR_NONE)
+	{
+		fprintf(stderr, "%s : calibrate err %d\n", chip, err);
+		exit(1);
+	}
+
+	/* 1B - 1MB by factor 4, aligned/unaligned, fresh/dirty (Read does not depend on the content) */
+	for (size = 1; size <= BENCH_MAXSIZE; size <<= 2)
+	{
+		reps = (size <= W25Qxx_SECTORSIZE) ? BENCH_MAXREP : (size <= W25Qxx_BLOCKSIZE) ? 8 : 3;
+		if (quick) reps = (reps > 3) ? 3 : reps;
+		for (a = 0; a < 2; a++)
+		{
+			Bench_Run(chip, BENCH_READ, size, a ? BENCH_UNALIGNED : 0, 1, reps);
+			for (d = 0; d < 2; d++) Bench_Run(chip, BENCH_PROGRAM, size, a ? BENCH_UNALIGNED : 0, d, reps);
+			Bench_Run(chip, BENCH_DIR_PROGRAM, size, a ? BENCH_UNALIGNED : 0, 0, reps);
+		}
+	}
+
+	/* erase of a fresh (already erased) and a dirty unit */
+	for (i = 0; i < 3; i++)
+	{
+		for (d = 0; d < 2; d++) Bench_Run(chip, erase[i], erasesize[i], 0, d, quick ? 3 : 8);
+	}
+
+	W25Qxx_EMU_DeInit(&emu);
+}
+static double Bench_Clock(void)																		/* Host clock (s) */
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+static uint8_t Bench_isBlank_Byte(const uint8_t *p, uint32_t n)										/* Byte loop reference */
+{
+	while (n--) if (*p++ != 0xFF) return 0;
+	return 1;
+}
+static uint8_t Bench_isProgrammable_Byte(const uint8_t *o, const uint8_t *p, uint32_t n)
+{
+	while (n--) if (*p++ & ~*o++) return 0;
+	return 1;
+}
+static uint8_t Bench_isEqual_Byte(const uint8_t *a, const uint8_t *b, uint32_t n)
+{
+	while (n--) if (*a++ != *b++) return 0;
+	return 1;
+}
+static void Bench_Kernel(uint8_t quick)																/* Buffer check kernels against the byte loop (host clock) */
+{
+	static uint64_t lat[BENCH_MAXREP];
+	BENCH_RESULT_t r;
+	volatile uint32_t sink = 0;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint32_t k = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	double t0 = 0;
+	double total = 0;
+
+	/* worst case : blank and equal buffers are scanned to the end */
+	memset(src, 0xFF, BENCH_KERNELSIZE);
+	memset(dst, 0xFF, BENCH_KERNELSIZE);
+	memset(&r, 0, sizeof(r));
+	for (k = 0; k < 6; k++)
+	{
+		total = 0;
+		for (i = 0; i < reps; i++)
+		{
+			t0 = Bench_Clock();
+			for (j = 0; j < 16; j++)
+			{
+				switch (k)
+				{
+					case 0: sink += W25Qxx_isBlank(src, BENCH_KERNELSIZE);                  break;
+					case 1: sink += Bench_isBlank_Byte(src, BENCH_KERNELSIZE);              break;
+					case 2: sink += W25Qxx_isProgrammable(src, dst, BENCH_KERNELSIZE);      break;
+					case 3: sink += Bench_isProgrammable_Byte(src, dst, BENCH_KERNELSIZE);  break;
+					case 4: sink += W25Qxx_isEqual(src, dst, BENCH_KERNELSIZE);             break;
+					case 5: sink += Bench_isEqual_Byte(src, dst, BENCH_KERNELSIZE);         break;
+				}
+			}
+			lat[i] = (uint64_t)((Bench_Clock() - t0) * 1e9 / 16);
+			total += lat[i];
+		}
+		qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = "host";
+		r.op = (k < 2) ? "isBlank" : (k < 4) ? "isProgrammable" : "isEqual";
+		r.size = BENCH_KERNELSIZE;
+		r.align = "aligned";
+		r.state = (k & 1) ? "byteloop" : "kernel";
+		r.reps = reps;
+		r.bps = total ? (double)BENCH_KERNELSIZE * reps * 1e9 / total : 0;
+		r.p50 = Bench_Percentile(lat, reps, 50);
+		r.p99 = Bench_Percentile(lat, reps, 99);
+		Bench_Print(&r);
+	}
+}
+static uint8_t Bench_Null_RW(uint8_t data)															/* Zero latency port : IDLE status, 0x00 data */
+{
+	(void)data;
+	return 0x00;
+}
+static void Bench_Null_CS(void)
+{
+}
+static void Bench_Null_DelayMS(uint32_t ms)
+{
+	(void)ms;
+}
+static void Bench_Driver(uint8_t quick, uint8_t traced)												/* Driver CPU time of 4KB Read/DIR_Program/Program (host clock) */
+{
+	static uint64_t lat[BENCH_MAXREP];
+	static uint8_t ring[W25Qxx_SECTORSIZE];
+	W25Qxx_TRACE_t trace;
+	static const BENCH_OP op[] = { BENCH_READ, BENCH_DIR_PROGRAM, BENCH_PROGRAM };
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint32_t k = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	double t0 = 0;
+	double total = 0;
+
+	/* geometry from the emulated chip, then the port is replaced */
+	Bench_Open(&emu, &dev, W25Q64);
+	dev.port.spi_rw = Bench_Null_RW;
+	dev.port.spi_cs_H = Bench_Null_CS;
+	dev.port.spi_cs_L = Bench_Null_CS;
+	dev.port.spi_delayms = Bench_Null_DelayMS;
+	dev.port.spi_timeus = NULL;
+	if (traced)
+	{
+		W25Qxx_Trace_Attach(&trace, &dev, ring, sizeof(ring), &err);
+		if (err != W25Qxx_ERR_NONE) exit(1);
+	}
+
+	/* Program : the sector reads 0x00, random data needs the erase */
+	Bench_Fill(src, W25Qxx_SECTORSIZE);
+	memset(&r, 0, sizeof(r));
+	for (k = 0; k < 3; k++)
+	{
+		total = 0;
+		for (i = 0; i < reps; i++)
+		{
+			t0 = Bench_Clock();
+			for (j = 0; j < 64; j++)
+			{
+				switch (op[k])
+				{
+					case BENCH_READ:        W25Qxx_Read(&dev, dst, 0x1000, W25Qxx_SECTORSIZE, &err);        break;
+					case BENCH_DIR_PROGRAM: W25Qxx_DIR_Program(&dev, src, 0x1000, W25Qxx_SECTORSIZE, &err); break;
+					default:                W25Qxx_Program(&dev, src, 0x1000, W25Qxx_SECTORSIZE, &err);     break;
+				}
+			}
+			lat[i] = (uint64_t)((Bench_Clock() - t0) * 1e9 / 64);
+			total += lat[i];
+		}
+		qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = traced ? "driver+trace" : "driver";
+		r.op = OpName[op[k]];
+		r.size = W25Qxx_SECTORSIZE;
+		r.align = "aligned";
+		r.state = "-";
+		r.reps = reps;
+		r.bps = total ? (double)W25Qxx_SECTORSIZE * reps * 1e9 / total : 0;
+		r.p50 = Bench_Percentile(lat, reps, 50);
+		r.p99 = Bench_Percentile(lat, reps, 99);
+		Bench_Print(&r);
+	}
+
+	if (traced) W25Qxx_Trace_Detach(&trace, &dev);
+	W25Qxx_EMU_DeInit(&emu);
+}
+#if W25QXX_WEAR
+static void Bench_Wear(uint8_t quick)																/* Wear accounting : host time per erase, checkpoint and mount on the emulated chip */
+{
+	static uint64_t lat[BENCH_MAXREP];
+	static uint32_t count[W25Qxx_SECTORADDR(0x2000000)];
+	static const BENCH_OP op[] = { BENCH_ERASE_SECTOR, BENCH_ERASE_BLOCK64 };
+	static const struct { const char *name; W25Qxx_CHIP type; } chip[] = { { "wear:W25Q64", W25Q64 }, { "wear:W25Q256", W25Q256 } };
+	W25Qxx_WEAR_AREA_t area;
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint32_t numArea = 16;
+	uint64_t bytes = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint64_t t = 0;
+	double t0 = 0;
+	double total = 0;
+	uint32_t c = 0;
+	uint32_t k = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint8_t on = 0;
+	uint8_t skewed = 0;
+
+	/* host time per erase instruction (zero latency port), accounting not mounted / mounted */
+	Bench_Open(&emu, &dev, W25Q256);
+	W25Qxx_EMU_DeInit(&emu);
+	dev.port.spi_rw = Bench_Null_RW;
+	dev.port.spi_cs_H = Bench_Null_CS;
+	dev.port.spi_cs_L = Bench_Null_CS;
+	dev.port.spi_delayms = Bench_Null_DelayMS;
+	dev.port.spi_timeus = NULL;
+	for (on = 0; on < 2; on++)
+	{
+		if (on) dev.wear.count = count;
+		if (on) dev.wear.numSector = dev.numSector;
+		for (k = 0; k < 2; k++)
+		{
+			memset(&r, 0, sizeof(r));
+			total = 0;
+			for (i = 0; i < reps; i++)
+			{
+				t0 = Bench_Clock();
+				for (j = 0; j < 256; j++)
+				{
+					if (op[k] == BENCH_ERASE_SECTOR) W25Qxx_Erase_Sector(&dev, j * 31 % dev.numSector, &err);
+					else                             W25Qxx_Erase_Block64(&dev, j * 31 % dev.numBlock, &err);
+				}
+				lat[i] = (uint64_t)((Bench_Clock() - t0) * 1e9 / 256);
+				total += lat[i];
+			}
+			qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = "wear";
+			r.op = OpName[op[k]];
+			r.size = (op[k] == BENCH_ERASE_SECTOR) ? W25Qxx_SECTORSIZE : W25Qxx_BLOCKSIZE;
+			r.align = "aligned";
+			r.state = on ? "counted" : "not_mounted";
+			r.reps = reps;
+			r.p50 = Bench_Percentile(lat, reps, 50);
+			r.p99 = Bench_Percentile(lat, reps, 99);
+			Bench_Print(&r);
+		}
+	}
+
+	/* checkpoint (emulator time) of a flat wear and of a few hot sectors */
+	for (c = 0; c < sizeof(chip) / sizeof(chip[0]); c++)
+	{
+		for (skewed = 0; skewed < 2; skewed++)
+		{
+			Bench_Open(&emu, &dev, chip[c].type);
+			W25Qxx_Wear_Mount(&area, &dev, count, dev.numSector - numArea, numArea, &err);
+			if (err != W25Qxx_ERR_NONE) Bench_Fail("wear mount");
+			for (i = 0; i < dev.numSector; i++)
+			{
+				count[i] = 1000;
+				if (skewed && i < 64) count[i] += Bench_Rand() % 5000;
+				else if (skewed && Bench_Rand() % 8 == 0) count[i] += Bench_Rand() % 4;
+			}
+
+			memset(&r, 0, sizeof(r));
+			for (i = 0; i < reps; i++)
+			{
+				count[Bench_Rand() % 64]++;
+				bytes = emu.stat.bytes;
+				erases = emu.stat.erases;
+				programs = emu.stat.programs;
+				t = W25Qxx_EMU_Now;
+				W25Qxx_Wear_Checkpoint(&area, &err);
+				lat[i] = W25Qxx_EMU_Now - t;
+				if (err != W25Qxx_ERR_NONE)
+				{
+					fprintf(stderr, "%s Checkpoint : err %d\n", chip[c].name, err);
+					exit(1);
+				}
+				r.spiBytes += (double)(emu.stat.bytes - bytes);
+				r.erases += emu.stat.erases - erases;
+				r.programs += emu.stat.programs - programs;
+			}
+			qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = chip[c].name;
+			r.op = "Checkpoint";
+			r.size = area.size;
+			r.align = "-";
+			r.state = skewed ? "skewed" : "flat";
+			r.reps = reps;
+			r.p50 = Bench_Percentile(lat, reps, 50);
+			r.p99 = Bench_Percentile(lat, reps, 99);
+			r.spiBytes /= reps;
+			r.erases /= reps;
+			r.programs /= reps;
+			Bench_Print(&r);
+
+			/* mount loads the last checkpoint */
+			memset(&r, 0, sizeof(r));
+			bytes = emu.stat.bytes;
+			t = W25Qxx_EMU_Now;
+			W25Qxx_Wear_Mount(&area, &dev, count, dev.numSector - numArea, numArea, &err);
+			lat[0] = W25Qxx_EMU_Now - t;
+			if (err != W25Qxx_ERR_NONE || area.seqLoad != reps) exit(1);
+			r.chip = chip[c].name;
+			r.op = "Mount";
+			r.size = area.size;
+			r.align = "-";
+			r.state = skewed ? "skewed" : "flat";
+			r.reps = 1;
+			r.p50 = Bench_Percentile(lat, 1, 50);
+			r.p99 = r.p50;
+			r.spiBytes = (double)(emu.stat.bytes - bytes);
+			Bench_Print(&r);
+
+			W25Qxx_EMU_DeInit(&emu);
+		}
+	}
+}
+#endif
+#if W25QXX_LATENCY
+static void Bench_Latency(uint8_t quick)															/* Latency histogram of a mixed workload on the emulated chip (W25Qxx_Latency_Dump) */
+{
+	static const char *LatName[W25Qxx_LAT_NUM] = { "Read", "Program", "Program_Erase", "Erase_Sector", "Erase_Block32", "Erase_Block64", "Erase_Chip", "Status_Poll", "DIR_Program" };
+	static uint8_t buf[W25Qxx_SECTORSIZE];
+	W25Qxx_LATENCY_PCT_t pct[W25Qxx_LAT_NUM];
+	BENCH_RESULT_t r;
+	uint32_t num = quick ? 64 : 1024;
+	uint32_t addr = 0;
+	uint32_t size = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_Latency_Reset(&dev);
+
+	/* random reads and programs in the first 1MB, a program erases when the data sets bits */
+	for (i = 0; i < num; i++)
+	{
+		addr = Bench_Rand() % (BENCH_MAXSIZE - W25Qxx_SECTORSIZE);
+		size = 1 + Bench_Rand() % W25Qxx_SECTORSIZE;
+		switch (Bench_Rand() % 4)
+		{
+			case 0 :
+				W25Qxx_Read(&dev, buf, addr, (uint16_t)size, &err);
+				break;
+			case 1 :
+				for (j = 0; j < size; j++) buf[j] = (uint8_t)Bench_Rand();
+				W25Qxx_Program(&dev, buf, addr, size, &err);
+				break;
+			case 2 :
+				W25Qxx_Read(&dev, buf, addr, (uint16_t)size, &err);
+				for (j = 0; j < size; j++) buf[j] &= (uint8_t)Bench_Rand();
+				W25Qxx_Program(&dev, buf, addr, size, &err);
+				break;
+			default :
+				W25Qxx_Erase_Sector(&dev, addr / W25Qxx_SECTORSIZE, &err);
+				break;
+		}
+		if (err != W25Qxx_ERR_NONE) exit(1);
+	}
+	W25Qxx_Erase_Block32(&dev, 0, &err);
+	W25Qxx_Erase_Block64(&dev, 1, &err);
+	if (err != W25Qxx_ERR_NONE) exit(1);
+
+	W25Qxx_Latency_Dump(&dev, pct);
+	for (i = 0; i < W25Qxx_LAT_NUM; i++)
+	{
+		if (pct[i].num == 0) continue;
+
+		memset(&r, 0, sizeof(r));
+		r.chip = "latency:W25Q64";
+		r.op = LatName[i];
+		r.size = 0;
+		r.align = "-";
+		r.state = "histogram";
+		r.reps = pct[i].num;
+		r.p50 = pct[i].p50;
+		r.p99 = pct[i].p99;
+		Bench_Print(&r);
+	}
+
+	W25Qxx_EMU_DeInit(&emu);
+}
+#endif
+#if W25QXX_AUTO_POWER
+static void Bench_Power(uint8_t quick)																/* Auto power-down on access traces : first access latency and energy (emulator time) */
+{
+	/* access trace : gap before every access (ms), page read or page program, access number */
+	static const struct { const char *name; uint32_t gap; uint32_t burst; uint32_t burstGap; uint8_t program; uint32_t num; } trace[] = {
+		{ "Trace_Logger", 1000, 1, 0, 1, 600 },		/* one page program per second */
+		{ "Trace_Burst",  5000, 50, 2, 0, 3000 },		/* 50 reads 2ms apart every 5s */
+		{ "Trace_Poll",   5, 1, 0, 0, 4000 },			/* one read every 5ms */
+	};
+	static const uint32_t idle[] = { 0, 1, 10, 100, 1000 };
+	static uint64_t lat[4000];
+	static uint64_t first[4000];
+	static uint8_t buf[W25Qxx_PAGESIZE];
+	BENCH_RESULT_t r;
+	uint64_t bytes = 0;
+	uint64_t busy = 0;
+	uint32_t numFirst = 0;
+	uint32_t num = 0;
+	uint32_t gap = 0;
+	uint32_t t = 0;
+	uint32_t k = 0;
+	uint32_t i = 0;
+	uint32_t m = 0;
+	uint64_t s = 0;
+	uint8_t down = 0;
+	double tStandby = 0;
+	double tDown = 0;
+	double tBus = 0;
+	double tBusy = 0;
+
+	for (t = 0; t < sizeof(trace) / sizeof(trace[0]); t++)
+	{
+		for (k = 0; k < sizeof(idle) / sizeof(idle[0]); k++)
+		{
+			Bench_Open(&emu, &dev, W25Q128);
+			W25Qxx_Power_Auto(&dev, idle[k], &err);
+			if (err != W25Qxx_ERR_NONE) Bench_Fail("power auto");
+
+			/* replay the trace, W25Qxx_Power_Poll every ms of the gap */
+			num = quick ? trace[t].num / 10 : trace[t].num;
+			numFirst = 0;
+			busy = 0;
+			bytes = emu.stat.bytes;
+			for (i = 0; i < num; i++)
+			{
+				gap = (i % trace[t].burst) ? trace[t].burstGap : trace[t].gap;
+				for (m = 0; m < gap; m++)
+				{
+					W25Qxx_EMU_DelayMS(1);
+					W25Qxx_Power_Poll(&dev);
+				}
+
+				down = (dev.power.state == W25Qxx_POWER_DOWN);
+				s = W25Qxx_EMU_Now;
+				if (trace[t].program)
+				{
+					/* the sector is erased before its first page */
+					memset(buf, (uint8_t)i, sizeof(buf));
+					if ((i & 15) == 0) W25Qxx_Erase_Sector(&dev, (i % 768) >> 4, &err);
+					if (err == W25Qxx_ERR_NONE) W25Qxx_DIR_Program_Page(&dev, buf, (i % 768) * W25Qxx_PAGESIZE, W25Qxx_PAGESIZE, &err);
+					busy += ((i & 15) ? 0 : emu.timing.tSE) + emu.timing.tPP;
+				}
+				else
+				{
+					W25Qxx_Read(&dev, buf, (i % 768) * W25Qxx_PAGESIZE, W25Qxx_PAGESIZE, &err);
+				}
+				if (err != W25Qxx_ERR_NONE) exit(1);
+				lat[i] = W25Qxx_EMU_Now - s;
+				if (down) first[numFirst++] = lat[i];
+			}
+			W25Qxx_Power_Poll(&dev);
+			qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+			qsort(first, numFirst, sizeof(first[0]), Bench_Cmp);
+
+			/* energy : powered idle, deep power-down, bus transfer, program/erase */
+			tStandby = dev.power.timeStandby / 1e6;
+			tDown = dev.power.timeDown / 1e6;
+			tBus = (emu.stat.bytes - bytes) * 8.0 / BENCH_CLKHZ;
+			tBusy = busy / 1e9;
+
+			memset(&r, 0, sizeof(r));
+			r.chip = "power:W25Q128";
+			r.op = trace[t].name;
+			r.size = idle[k];
+			r.align = "-";
+			r.state = idle[k] ? "auto" : "off";
+			r.reps = num;
+			r.p50 = Bench_Percentile(lat, num, 50);
+			r.p99 = Bench_Percentile(lat, num, 99);
+			r.spiBytes = (double)(emu.stat.bytes - bytes) / num;
+			r.energy = BENCH_VCC * (BENCH_ISB * (tStandby - tBus - tBusy) + BENCH_IPD * tDown + BENCH_IREAD * tBus + BENCH_IPROG * tBusy) * 1e3;
+			Bench_Print(&r);
+
+			/* the accesses that released the chip */
+			if (numFirst)
+			{
+				r.state = "first_access";
+				r.reps = numFirst;
+				r.p50 = Bench_Percentile(first, numFirst, 50);
+				r.p99 = Bench_Percentile(first, numFirst, 99);
+				r.spiBytes = 0;
+				r.energy = 0;
+				Bench_Print(&r);
+			}
+
+			W25Qxx_EMU_DeInit(&emu);
+		}
+	}
+}
+#endif
+static void Bench_Mirror(uint8_t quick)															/* Read latency right after an erase : one chip / mirror volume (emulator time) */
+{
+	static uint64_t lat[BENCH_MAXREP];
+	static uint8_t buf[W25Qxx_PAGESIZE];
+	W25Qxx_EMU_t emu2;
+	W25Qxx_t dev2;
+	W25Qxx_MIRROR_t mir;
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint64_t total = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint8_t k = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	Bench_Open(&emu2, &dev2, W25Q64);
+	W25Qxx_Mirror_config(&mir, &dev, &dev2, &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("mirror config");
+
+	/* 0 : read of an idle volume, 1 : first read after the erase call returns (one chip : waits for the erase) */
+	for (k = 0; k < 4; k++)
+	{
+		memset(&r, 0, sizeof(r));
+		total = 0;
+		for (i = 0; i < reps; i++)
+		{
+			if (k & 1)
+			{
+				if (k & 2) W25Qxx_Mirror_Erase_Sector(&mir, 16 + i, &err);
+				else       W25Qxx_Erase_Sector_Start(&dev, 16 + i, &err);
+				if (err != W25Qxx_ERR_NONE) exit(1);
+			}
+			t = W25Qxx_EMU_Now;
+			if (k & 2)
+			{
+				W25Qxx_Mirror_Read(&mir, buf, i * W25Qxx_SECTORSIZE, sizeof(buf), &err);
+			}
+			else
+			{
+				W25Qxx_isStatus(&dev, W25Qxx_STATUS_IDLE, dev.info.EraseMaxTimeSector, &err);
+				if (err == W25Qxx_ERR_NONE) W25Qxx_Read(&dev, buf, i * W25Qxx_SECTORSIZE, sizeof(buf), &err);
+			}
+			lat[i] = W25Qxx_EMU_Now - t;
+			if (err != W25Qxx_ERR_NONE) exit(1);
+			total += lat[i];
+
+			/* the next repetition starts idle */
+			W25Qxx_Mirror_Sync(&mir, &err);
+			if (err != W25Qxx_ERR_NONE) exit(1);
+		}
+		qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = (k & 2) ? "mirror:W25Q64" : "W25Q64";
+		r.op = (k & 1) ? "Read_after_Erase" : "Read";
+		r.size = sizeof(buf);
+		r.align = "aligned";
+		r.state = (k & 2) ? (W25QXX_MIRROR_VERIFY ? "verify" : "one_member") : "-";
+		r.reps = reps;
+		r.bps = total ? (double)sizeof(buf) * reps * 1e9 / total : 0;
+		r.p50 = Bench_Percentile(lat, reps, 50);
+		r.p99 = Bench_Percentile(lat, reps, 99);
+		Bench_Print(&r);
+	}
+
+	/* sector erase of one chip against the volume (parallel : both members end before the call returns) */
+	for (k = 0; k < 2; k++)
+	{
+		memset(&r, 0, sizeof(r));
+		total = 0;
+		for (i = 0; i < reps; i++)
+		{
+			t = W25Qxx_EMU_Now;
+			if (k) W25Qxx_Mirror_Erase_Sector(&mir, 16 + i, &err);
+			else   W25Qxx_Erase_Sector(&dev, 16 + i, &err);
+			lat[i] = W25Qxx_EMU_Now - t;
+			if (err != W25Qxx_ERR_NONE) exit(1);
+			total += lat[i];
+			W25Qxx_Mirror_Sync(&mir, &err);
+			if (err != W25Qxx_ERR_NONE) exit(1);
+		}
+		qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = k ? "mirror:W25Q64" : "W25Q64";
+		r.op = "Erase_Sector";
+		r.size = W25Qxx_SECTORSIZE;
+		r.align = "aligned";
+		r.state = k ? (W25QXX_MIRROR_STAGGER ? "stagger" : "parallel") : "-";
+		r.reps = reps;
+		r.bps = total ? (double)W25Qxx_SECTORSIZE * reps * 1e9 / total : 0;
+		r.p50 = Bench_Percentile(lat, reps, 50);
+		r.p99 = Bench_Percentile(lat, reps, 99);
+		Bench_Print(&r);
+	}
+
+	W25Qxx_EMU_DeInit(&emu2);
+	W25Qxx_EMU_DeInit(&emu);
+}
+static void Bench_Jitter(uint8_t quick)															/* W25Qxx_Calibrate on chips of randomized timing (W25Qxx_EMU_Jitter) : error and BUSY wait (emulator time) */
+{
+	static const uint8_t percent[] = { 0, 10, 25, 50 };
+	static const char *CalName[] = { "Calibrate_Program", "Calibrate_Sector", "Calibrate_Block32", "Calibrate_Block64" };
+	static const char *StateName[] = { "uncalibrated", "calibrated", "stale" };
+	static uint64_t error[4][32];
+	static uint64_t lat[2][3][32 * BENCH_MAXREP];
+	static uint8_t buf[W25Qxx_PAGESIZE];
+	W25Qxx_TIMING_t nominal;
+	W25Qxx_TIMING_t timing;
+	BENCH_RESULT_t r;
+	uint32_t chips = quick ? 4 : 32;
+	uint32_t reps = quick ? 3 : 8;
+	uint64_t bytes[2][3] = { { 0 } };
+	uint32_t real = 0;
+	uint32_t cal = 0;
+	uint32_t n = 0;
+	uint32_t p = 0;
+	uint32_t c = 0;
+	uint32_t i = 0;
+	uint8_t k = 0;
+	uint8_t o = 0;
+	uint64_t t = 0;
+	uint64_t b = 0;
+
+	/* the calibration of a chip of typical time, used as a stale calibration on the others */
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_Calibrate(&dev, dev.numBlock - 1, &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("calibrate");
+	nominal = dev.timing;
+	W25Qxx_EMU_DeInit(&emu);
+
+	for (p = 0; p < sizeof(percent) / sizeof(percent[0]); p++)
+	{
+		memset(bytes, 0, sizeof(bytes));
+		n = 0;
+		for (c = 0; c < chips; c++)
+		{
+			/* a chip of its own time : +/- percent of the typical time per operation */
+			Bench_Open(&emu, &dev, W25Q64);
+			W25Qxx_EMU_Jitter(&emu, 0x9E3779B9 * (c + 1), percent[p]);
+			W25Qxx_Calibrate(&dev, dev.numBlock - 1, &err);
+			if (err != W25Qxx_ERR_NONE)
+			{
+				fprintf(stderr, "jitter %u%% chip %u : calibrate err %d\n", percent[p], c, err);
+				exit(1);
+			}
+
+			/* calibration error against the emulated time (0.001% : the percentile prints %) */
+			for (k = 0; k < 4; k++)
+			{
+				real = (&emu.timing.tPP)[k];
+				cal = (&dev.timing.ProgrTimePage)[k];
+				error[k][c] = (uint64_t)((cal > real ? cal - real : real - cal) * 100000.0 / real);
+			}
+
+			/* page program and sector erase of dirty sectors, polled by each schedule */
+			timing = dev.timing;
+			for (k = 0; k < 3; k++)
+			{
+				if (k == 0) memset(&dev.timing, 0, sizeof(dev.timing));
+				else        dev.timing = (k == 1) ? timing : nominal;
+				for (i = 0; i < reps; i++)
+				{
+					Bench_Prepare((16 + i) * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, 1);
+					Bench_Prepare((48 + i) * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, 0);
+					Bench_Fill(buf, sizeof(buf));
+					for (o = 0; o < 2; o++)
+					{
+						b = emu.stat.bytes;
+						t = W25Qxx_EMU_Now;
+						if (o) W25Qxx_Erase_Sector(&dev, 16 + i, &err);
+						else   W25Qxx_DIR_Program_Page(&dev, buf, (48 + i) * W25Qxx_SECTORSIZE, sizeof(buf), &err);
+						lat[o][k][n + i] = W25Qxx_EMU_Now - t;
+						bytes[o][k] += emu.stat.bytes - b;
+						if (err != W25Qxx_ERR_NONE)
+						{
+							fprintf(stderr, "jitter %u%% chip %u %s : err %d\n", percent[p], c, StateName[k], err);
+							exit(1);
+						}
+					}
+				}
+			}
+			n += reps;
+			W25Qxx_EMU_DeInit(&emu);
+		}
+
+		for (k = 0; k < 4; k++)
+		{
+			qsort(error[k], chips, sizeof(error[k][0]), Bench_Cmp);
+
+			memset(&r, 0, sizeof(r));
+			r.chip = "jitter:W25Q64";
+			r.op = CalName[k];
+			r.size = percent[p];
+			r.align = "-";
+			r.state = "error_pct";
+			r.reps = chips;
+			r.p50 = Bench_Percentile(error[k], chips, 50);
+			r.p99 = Bench_Percentile(error[k], chips, 99);
+			Bench_Print(&r);
+		}
+		for (o = 0; o < 2; o++)
+		{
+			for (k = 0; k < 3; k++)
+			{
+				qsort(lat[o][k], n, sizeof(lat[o][k][0]), Bench_Cmp);
+
+				memset(&r, 0, sizeof(r));
+				r.chip = "jitter:W25Q64";
+				r.op = o ? OpName[BENCH_ERASE_SECTOR] : OpName[BENCH_DIR_PROGRAM];
+				r.size = percent[p];
+				r.align = "-";
+				r.state = StateName[k];
+				r.reps = n;
+				r.p50 = Bench_Percentile(lat[o][k], n, 50);
+				r.p99 = Bench_Percentile(lat[o][k], n, 99);
+				r.spiBytes = (double)bytes[o][k] / n;
+				Bench_Print(&r);
+			}
+		}
+	}
+}
+static void Bench_Startup(uint8_t quick)															/* W25Qxx_config (cold) against W25Qxx_config_Warm (emulator time) */
+{
+	static const struct { const char *name; W25Qxx_CHIP type; } chip[] = {
+		{ "startup:W25Q64", W25Q64 }, { "startup:W25Q256", W25Q256 }, { "startup:W25Q01", W25Q01 },
+	};
+	static const char *StateName[] = { "cold", "warm", "warm_power_up", "cold_fallback" };
+	static uint64_t lat[BENCH_MAXREP];
+	W25Qxx_WARM_t warm;
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t c = 0;
+	uint32_t i = 0;
+	uint8_t k = 0;
+	uint8_t ret = 0;
+
+	for (c = 0; c < sizeof(chip) / sizeof(chip[0]); c++)
+	{
+		Bench_Open(&emu, &dev, chip[c].type);
+		W25Qxx_config_Save(&dev, &warm);
+
+		/* 0 : power-up, 1 : MCU reset (the chip kept power), 2 : power-up with a valid descriptor
+		   (warm when the power-up state is the saved one, else the cold start of the fallback) */
+		for (k = 0; k < 3; k++)
+		{
+			memset(&r, 0, sizeof(r));
+			for (i = 0; i < reps; i++)
+			{
+				if (k != 1) W25Qxx_EMU_PowerCycle(&emu);
+				bytes = emu.stat.bytes;
+				t = W25Qxx_EMU_Now;
+				if (k == 0)
+				{
+					W25Qxx_config(&dev, &err);
+					ret = 0;
+				}
+				else
+				{
+					ret = W25Qxx_config_Warm(&dev, &warm, &err);
+				}
+				lat[i] = W25Qxx_EMU_Now - t;
+				if (err != W25Qxx_ERR_NONE || (k == 1 && ret != 1))
+				{
+					fprintf(stderr, "%s %s : err %d warm %u\n", chip[c].name, StateName[k], err, ret);
+					exit(1);
+				}
+				r.spiBytes += (double)(emu.stat.bytes - bytes);
+			}
+			qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = chip[c].name;
+			r.op = "config";
+			r.size = 0;
+			r.align = "-";
+			r.state = StateName[(k == 2 && ret == 0) ? 3 : k];
+			r.reps = reps;
+			r.p50 = Bench_Percentile(lat, reps, 50);
+			r.p99 = Bench_Percentile(lat, reps, 99);
+			r.spiBytes /= reps;
+			Bench_Print(&r);
+		}
+
+		W25Qxx_EMU_DeInit(&emu);
+	}
+}
+static void Bench_FTL(uint8_t quick)																/* Wear leveling FTL over a 16MB chip : write latency, erase count spread, write amplification, mount (emulator time) */
+{
+	static const char *LoadName[] = { "uniform", "hot_cold" };
+	static W25Qxx_FTL_t ftl;
+	static uint64_t lat[40000];
+	static uint8_t buf[W25Qxx_SECTORSIZE];
+	BENCH_RESULT_t r;
+	uint32_t num = quick ? 4000 : 40000;
+	uint64_t bytes = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint32_t min = 0;
+	uint32_t max = 0;
+	uint32_t lsn = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint8_t k = 0;
+
+	for (k = 0; k < 2; k++)
+	{
+		Bench_Open(&emu, &dev, W25Q128);
+		W25Qxx_FTL_Mount(&ftl, &dev, 0, dev.numSector, &err);
+		if (err != W25Qxx_ERR_NONE) Bench_Fail("ftl mount");
+
+		/* every logical sector written once, then the measured writes */
+		for (lsn = 0; lsn < ftl.numLogical && err == W25Qxx_ERR_NONE; lsn++)
+		{
+			Bench_Fill(buf, ftl.sizeData);
+			W25Qxx_FTL_Write(&ftl, lsn, buf, &err);
+		}
+		if (err != W25Qxx_ERR_NONE) exit(1);
+
+		/* uniform : any logical sector, hot_cold : 90% of the writes to 5% of the logical sectors */
+		memset(&r, 0, sizeof(r));
+		bytes = emu.stat.bytes;
+		erases = emu.stat.erases;
+		programs = emu.stat.programs;
+		for (i = 0; i < num; i++)
+		{
+			if (k == 0 || Bench_Rand() % 10 == 0) lsn = Bench_Rand() % ftl.numLogical;
+			else                                   lsn = Bench_Rand() % (ftl.numLogical / 20);
+			Bench_Fill(buf, 16);
+			t = W25Qxx_EMU_Now;
+			W25Qxx_FTL_Write(&ftl, lsn, buf, &err);
+			lat[i] = W25Qxx_EMU_Now - t;
+			if (err != W25Qxx_ERR_NONE)
+			{
+				fprintf(stderr, "ftl %s write %u : err %d\n", LoadName[k], i, err);
+				exit(1);
+			}
+		}
+		qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = "ftl:W25Q128";
+		r.op = "Write";
+		r.size = ftl.sizeData;
+		r.align = "-";
+		r.state = LoadName[k];
+		r.reps = num;
+		r.p50 = Bench_Percentile(lat, num, 50);
+		r.p99 = Bench_Percentile(lat, num, 99);
+		r.spiBytes = (double)(emu.stat.bytes - bytes) / num;
+		r.erases = (double)(emu.stat.erases - erases) / num;
+		r.programs = (double)(emu.stat.programs - programs) / num;
+		Bench_Print(&r);
+
+		/* erase count of the physical sectors after the fill and the writes */
+		W25Qxx_FTL_EraseCount(&ftl, &min, &max);
+		memset(&r, 0, sizeof(r));
+		r.chip = "ftl:W25Q128";
+		r.op = "EraseCount";
+		r.size = ftl.numSector;
+		r.align = "-";
+		r.state = LoadName[k];
+		r.reps = ftl.numWrite;
+		r.p50 = min;
+		r.p99 = max;
+		r.erases = (double)ftl.numErase / ftl.numWrite;
+		r.programs = (double)ftl.numProgram / ftl.numWrite;
+		Bench_Print(&r);
+
+		/* mount rebuilds the map from the 4096 headers */
+		memset(&r, 0, sizeof(r));
+		bytes = emu.stat.bytes;
+		t = W25Qxx_EMU_Now;
+		W25Qxx_FTL_Mount(&ftl, &dev, 0, dev.numSector, &err);
+		lat[0] = W25Qxx_EMU_Now - t;
+		if (err != W25Qxx_ERR_NONE) exit(1);
+		r.chip = "ftl:W25Q128";
+		r.op = "Mount";
+		r.size = ftl.numSector;
+		r.align = "-";
+		r.state = LoadName[k];
+		r.reps = 1;
+		r.p50 = Bench_Percentile(lat, 1, 50);
+		r.p99 = r.p50;
+		r.spiBytes = (double)(emu.stat.bytes - bytes);
+		Bench_Print(&r);
+
+		W25Qxx_EMU_DeInit(&emu);
+	}
+}
+static void Bench_KV(uint8_t quick)																/* Key-value store : put/get latency, erases per update, mount (emulator time) */
+{
+	static const uint16_t valSize[] = { 16, 200 };
+	static W25Qxx_KV_t kv;
+	static uint64_t lat[10000];
+	static uint8_t buf[256];
+	BENCH_RESULT_t r;
+	char key[16];
+	uint32_t num = quick ? 1000 : 10000;
+	uint32_t numKey = 64;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint8_t v = 0;
+	uint8_t k = 0;
+
+	for (v = 0; v < sizeof(valSize) / sizeof(valSize[0]); v++)
+	{
+		Bench_Open(&emu, &dev, W25Q64);
+		W25Qxx_KV_Mount(&kv, &dev, 16, 16, &err);
+		if (err != W25Qxx_ERR_NONE) Bench_Fail("kv mount");
+
+		/* 0 : updates of random keys (64 keys in 16 sectors), 1 : gets of random keys */
+		for (k = 0; k < 2; k++)
+		{
+			memset(&r, 0, sizeof(r));
+			total = 0;
+			bytes = emu.stat.bytes;
+			erases = emu.stat.erases;
+			programs = emu.stat.programs;
+			for (i = 0; i < num; i++)
+			{
+				sprintf(key, "key%02u", (unsigned)(Bench_Rand() % numKey));
+				Bench_Fill(buf, valSize[v]);
+				t = W25Qxx_EMU_Now;
+				if (k == 0) W25Qxx_KV_Put(&kv, key, buf, valSize[v], &err);
+				else        W25Qxx_KV_Get(&kv, key, buf, valSize[v], &err);
+				lat[i] = W25Qxx_EMU_Now - t;
+				total += lat[i];
+
+				/* a get before the first put of the key is not found */
+				if (err != W25Qxx_ERR_NONE && !(k == 1 && err == W25Qxx_ERR_NOTFOUND))
+				{
+					fprintf(stderr, "kv %s %s : err %d\n", k ? "Get" : "Put", key, err);
+					exit(1);
+				}
+			}
+			qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = "kv:W25Q64";
+			r.op = k ? "Get" : "Put";
+			r.size = valSize[v];
+			r.align = "-";
+			r.state = "random_key";
+			r.reps = num;
+			r.bps = total ? (double)valSize[v] * num * 1e9 / total : 0;
+			r.p50 = Bench_Percentile(lat, num, 50);
+			r.p99 = Bench_Percentile(lat, num, 99);
+			r.spiBytes = (double)(emu.stat.bytes - bytes) / num;
+			r.erases = (double)(emu.stat.erases - erases) / num;
+			r.programs = (double)(emu.stat.programs - programs) / num;
+			Bench_Print(&r);
+		}
+
+		/* mount replays the 16 sectors */
+		memset(&r, 0, sizeof(r));
+		bytes = emu.stat.bytes;
+		t = W25Qxx_EMU_Now;
+		W25Qxx_KV_Mount(&kv, &dev, 16, 16, &err);
+		lat[0] = W25Qxx_EMU_Now - t;
+		if (err != W25Qxx_ERR_NONE || kv.numKey != numKey) exit(1);
+		r.chip = "kv:W25Q64";
+		r.op = "Mount";
+		r.size = valSize[v];
+		r.align = "-";
+		r.state = "random_key";
+		r.reps = 1;
+		r.p50 = Bench_Percentile(lat, 1, 50);
+		r.p99 = r.p50;
+		r.spiBytes = (double)(emu.stat.bytes - bytes);
+		Bench_Print(&r);
+
+		W25Qxx_EMU_DeInit(&emu);
+	}
+}
+static void Bench_Log(uint8_t quick)																/* Ring log : append throughput, mount time by region size (emulator time) */
+{
+	static const uint16_t recSize[] = { 16, 128, 1024 };
+	static const uint32_t region[] = { 16, 256, 2048 };
+	static W25Qxx_LOG_t log;
+	static uint64_t lat[BENCH_MAXREP * 64];
+	static uint8_t buf[1024];
+	BENCH_RESULT_t r;
+	uint32_t num = quick ? 256 : BENCH_MAXREP * 64;
+	uint32_t fill = 0;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint8_t k = 0;
+
+	/* append of 16/128/1024 Byte records to 256 sectors, the wait of the last program included */
+	for (k = 0; k < sizeof(recSize) / sizeof(recSize[0]); k++)
+	{
+		Bench_Open(&emu, &dev, W25Q64);
+		W25Qxx_Log_Mount(&log, &dev, 0, 256, &err);
+		if (err != W25Qxx_ERR_NONE) Bench_Fail("log mount");
+
+		memset(&r, 0, sizeof(r));
+		total = 0;
+		bytes = emu.stat.bytes;
+		erases = emu.stat.erases;
+		programs = emu.stat.programs;
+		for (i = 0; i < num; i++)
+		{
+			Bench_Fill(buf, recSize[k]);
+			t = W25Qxx_EMU_Now;
+			W25Qxx_Log_Append(&log, buf, recSize[k], &err);
+			lat[i] = W25Qxx_EMU_Now - t;
+			total += lat[i];
+			if (err != W25Qxx_ERR_NONE)
+			{
+				fprintf(stderr, "log append %u : err %d\n", i, err);
+				exit(1);
+			}
+		}
+		qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+
+		r.chip = "log:W25Q64";
+		r.op = "Append";
+		r.size = recSize[k];
+		r.align = "-";
+		r.state = "256_sectors";
+		r.reps = num;
+		r.bps = total ? (double)recSize[k] * num * 1e9 / total : 0;
+		r.p50 = Bench_Percentile(lat, num, 50);
+		r.p99 = Bench_Percentile(lat, num, 99);
+		r.spiBytes = (double)(emu.stat.bytes - bytes) / num;
+		r.erases = (double)(emu.stat.erases - erases) / num;
+		r.programs = (double)(emu.stat.programs - programs) / num;
+		Bench_Print(&r);
+
+		W25Qxx_EMU_DeInit(&emu);
+	}
+
+	/* mount of a ring written 1.5 times (head in the middle of the region) */
+	for (k = 0; k < sizeof(region) / sizeof(region[0]) - (quick ? 1 : 0); k++)
+	{
+		Bench_Open(&emu, &dev, W25Q64);
+		W25Qxx_Log_Mount(&log, &dev, 0, region[k], &err);
+		if (err != W25Qxx_ERR_NONE) Bench_Fail("log mount");
+
+		fill = region[k] * 3 / 2 * (W25Qxx_SECTORSIZE / (1024 + 3)) + 1;
+		for (i = 0; i < fill && err == W25Qxx_ERR_NONE; i++)
+		{
+			Bench_Fill(buf, 1024);
+			W25Qxx_Log_Append(&log, buf, 1024, &err);
+		}
+		if (err != W25Qxx_ERR_NONE) exit(1);
+
+		memset(&r, 0, sizeof(r));
+		bytes = emu.stat.bytes;
+		t = W25Qxx_EMU_Now;
+		W25Qxx_Log_Mount(&log, &dev, 0, region[k], &err);
+		lat[0] = W25Qxx_EMU_Now - t;
+		if (err != W25Qxx_ERR_NONE) exit(1);
+		r.chip = "log:W25Q64";
+		r.op = "Mount";
+		r.size = region[k];
+		r.align = "-";
+		r.state = "wrapped";
+		r.reps = 1;
+		r.p50 = Bench_Percentile(lat, 1, 50);
+		r.p99 = r.p50;
+		r.spiBytes = (double)(emu.stat.bytes - bytes);
+		Bench_Print(&r);
+
+		W25Qxx_EMU_DeInit(&emu);
+	}
+}
+static uint32_t Bench_Queue_Record(uint32_t *addr, uint32_t *size, uint32_t num)					/* Reads of 4 clients captured by W25Qxx_Trace, decoded back into requests */
+{
+	static uint8_t ring[0x20000];
+	static uint8_t out[W25QXX_TRACE_HDRSIZE + 0x20000];
+	static uint8_t buf[128];
+	W25Qxx_TRACE_t trace;
+	W25Qxx_TRACE_REC_t rec;
+	uint32_t next[4] = { 0x00000, 0x40000, 0x80000, 0xC0000 };
+	uint32_t n = 0;
+	uint32_t pos = 0;
+	uint32_t i = 0;
+	uint32_t a = 0;
+	uint8_t c = 0;
+	uint8_t k = 0;
+
+	/* log viewer    : 64 Byte records one after the other
+	   text renderer : 32 Byte glyphs of a 96 glyph font, the letters of a word
+	   sensor export : 128 Byte blocks one after the other
+	   settings      : 16 Byte entries of a 4KB table, scanned in order
+	   the client of each read is random, as the tasks of an RTOS are scheduled */
+	W25Qxx_Trace_Attach(&trace, &dev, ring, sizeof(ring), &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("trace attach");
+	for (i = 0; i < num; i++)
+	{
+		c = (uint8_t)(Bench_Rand() % 4);
+		switch (c)
+		{
+			case 0 :  a = next[0]; next[0] += 64;  n = 64;  break;
+			case 1 :  a = next[1] + (33 + Bench_Rand() % 26) * 32; n = 32; break;
+			case 2 :  a = next[2]; next[2] += 128; n = 128; break;
+			default : a = next[3]; next[3] = 0xC0000 + (next[3] + 16 - 0xC0000) % W25Qxx_SECTORSIZE; n = 16; break;
+		}
+		W25Qxx_Read(&dev, buf, a, (uint16_t)n, &err);
+		if (err != W25Qxx_ERR_NONE) Bench_Fail("trace read");
+	}
+	W25Qxx_Trace_Detach(&trace, &dev);
+	n = W25Qxx_Trace_Export(&trace, out, sizeof(out));
+
+	/* the read instructions of the trace (3 Byte address), status polls and others are skipped */
+	i = 0;
+	for (pos = W25QXX_TRACE_HDRSIZE; pos < n && i < num; pos += k)
+	{
+		k = W25Qxx_Trace_Decode(&out[pos], n - pos, &rec);
+		if (k == 0) Bench_Fail("trace decode");
+		if (rec.numHead < 4 || (rec.head[0] != W25Q_CMD_READ && rec.head[0] != W25Q_CMD_FASTREAD)) continue;
+		addr[i] = (uint32_t)rec.head[1] << 16 | (uint32_t)rec.head[2] << 8 | rec.head[3];
+		size[i] = rec.len - ((rec.head[0] == W25Q_CMD_READ) ? 4 : 5);
+		i++;
+	}
+
+	return i;
+}
+static void Bench_Queue(uint8_t quick)															/* Request queue : access traces dispatched one by one and by W25Qxx_Queue_Flush (emulator time) */
+{
+	static const char *TraceName[] = { "Trace_Table", "Trace_Scatter", "Trace_Mixed", "Trace_Clients" };
+	static uint64_t lat[BENCH_MAXREP * 8];
+	static uint32_t recAddr[BENCH_MAXREP * 8 * W25QXX_QUEUE_DEPTH];
+	static uint32_t recSize[BENCH_MAXREP * 8 * W25QXX_QUEUE_DEPTH];
+	static uint8_t buf[W25QXX_QUEUE_DEPTH][128];
+	static uint8_t wbuf[64];
+	static W25Qxx_ERR rerr[W25QXX_QUEUE_DEPTH];
+	W25Qxx_QUEUE_t q;
+	BENCH_RESULT_t r;
+	uint32_t addr[W25QXX_QUEUE_DEPTH];
+	uint32_t size[W25QXX_QUEUE_DEPTH];
+	uint32_t num = quick ? 16 : BENCH_MAXREP * 8;
+	uint32_t base = 0;
+	uint32_t need = 0;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint32_t commands = 0;
+	uint32_t numRec = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint8_t k = 0;
+	uint8_t queued = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_Queue_Init(&q, &dev);
+	Bench_Fill(emu.mem, BENCH_MAXSIZE);
+	numRec = Bench_Queue_Record(recAddr, recSize, num * W25QXX_QUEUE_DEPTH);
+
+	/* a batch of W25QXX_QUEUE_DEPTH requests :
+	   Table   : 16 - 64 Byte records of one 4KB table in random order
+	   Scatter : 32 Byte reads anywhere in the first 1MB
+	   Mixed   : Table with a 64 Byte DIR_Program to erased space every 8 requests
+	   Clients : the reads of 4 clients recorded by W25Qxx_Trace (Bench_Queue_Record), replayed in order */
+	for (k = 0; k < 4; k++)
+	{
+		for (queued = 0; queued < 2; queued++)
+		{
+			memset(&r, 0, sizeof(r));
+			total = 0;
+			need = 0;
+			bytes = emu.stat.bytes;
+			commands = emu.stat.commands;
+			if (k == 3) num = numRec / W25QXX_QUEUE_DEPTH;
+			for (i = 0; i < num; i++)
+			{
+				base = (Bench_Rand() % (BENCH_MAXSIZE / W25Qxx_SECTORSIZE)) * W25Qxx_SECTORSIZE;
+				for (j = 0; j < W25QXX_QUEUE_DEPTH; j++)
+				{
+					size[j] = (k == 1) ? 32 : (k == 3) ? recSize[i * W25QXX_QUEUE_DEPTH + j] : 16 + Bench_Rand() % 49;
+					addr[j] = (k == 1) ? Bench_Rand() % (BENCH_MAXSIZE - 64) : (k == 3) ? recAddr[i * W25QXX_QUEUE_DEPTH + j] : base + (Bench_Rand() % 64) * 64;
+					need += size[j];
+				}
+
+				t = W25Qxx_EMU_Now;
+				for (j = 0; j < W25QXX_QUEUE_DEPTH; j++)
+				{
+					if (k == 2 && (j & 7) == 7)
+					{
+						/* the program goes to the erased space after 1MB */
+						memset(&emu.mem[BENCH_MAXSIZE + (i * 2 + j / 8) * 64], 0xFF, 64);
+						Bench_Fill(wbuf, 64);
+						if (queued) W25Qxx_Queue_DIR_Program(&q, wbuf, BENCH_MAXSIZE + (i * 2 + j / 8) * 64, 64, &rerr[j]);
+						else        W25Qxx_DIR_Program(&dev, wbuf, BENCH_MAXSIZE + (i * 2 + j / 8) * 64, 64, &rerr[j]);
+						size[j] = 0;
+					}
+					else if (queued)
+					{
+						W25Qxx_Queue_Read(&q, buf[j], addr[j], size[j], &rerr[j]);
+					}
+					else
+					{
+						W25Qxx_Read(&dev, buf[j], addr[j], (uint16_t)size[j], &rerr[j]);
+					}
+				}
+				if (queued) W25Qxx_Queue_Flush(&q);
+				lat[i] = W25Qxx_EMU_Now - t;
+				total += lat[i];
+
+				/* every read returns the data of its own address */
+				for (j = 0; j < W25QXX_QUEUE_DEPTH; j++)
+				{
+					if (rerr[j] != W25Qxx_ERR_NONE || memcmp(buf[j], &emu.mem[addr[j]], size[j]) != 0)
+					{
+						fprintf(stderr, "queue %s batch %u request %u : err %d or data mismatch\n", TraceName[k], i, j, rerr[j]);
+						exit(1);
+					}
+				}
+			}
+			qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = "queue:W25Q64";
+			r.op = TraceName[k];
+			r.size = W25QXX_QUEUE_DEPTH;
+			r.align = "-";
+			r.state = queued ? "queued" : "direct";
+			r.reps = num;
+			r.bps = total ? (double)need * 1e9 / total : 0;
+			r.p50 = Bench_Percentile(lat, num, 50);
+			r.p99 = Bench_Percentile(lat, num, 99);
+			r.spiBytes = (double)(emu.stat.bytes - bytes) / num;
+			r.transactions = (double)(emu.stat.commands - commands) / num;
+			Bench_Print(&r);
+		}
+	}
+
+	W25Qxx_EMU_DeInit(&emu);
+}
+static void Bench_Bus(uint8_t quick)																/* Two chips on one SPI bus : one chip after the other against W25Qxx_Bus background jobs (emulator time) */
+{
+	static const char *OpBusName[] = { "DIR_Program", "Erase", "Read_during_Erase" };
+	static uint64_t lat[BENCH_MAXREP];
+	static uint8_t buf[W25Qxx_PAGESIZE];
+	W25Qxx_EMU_t emu2;
+	W25Qxx_t dev2;
+	W25Qxx_t *chip[2] = { &dev, &dev2 };
+	W25Qxx_BUS_t bus;
+	W25Qxx_ERR jerr[2] = { W25Qxx_ERR_NONE, W25Qxx_ERR_NONE };
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : 8;
+	uint32_t size = W25Qxx_BLOCKSIZE * 4;			/* per chip, 16 sectors + 3 block64 erase */
+	uint32_t addr = 0;
+	uint32_t sec = 0;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+	uint8_t useBus = 0;
+	uint8_t c = 0;
+	uint8_t k = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	Bench_Open(&emu2, &dev2, W25Q64);
+	W25Qxx_Bus_Init(&bus);
+	W25Qxx_Bus_Attach(&bus, &dev, &err);
+	if (err == W25Qxx_ERR_NONE) W25Qxx_Bus_Attach(&bus, &dev2, &err);
+	if (err != W25Qxx_ERR_NONE) exit(1);
+
+	/* 0 : program of 256KB to each chip, 1 : erase of 256KB + 4KB (unaligned) on each chip,
+	   2 : page read of chip 1 while chip 0 erases a sector */
+	for (k = 0; k < 3; k++)
+	{
+		for (useBus = 0; useBus < 2; useBus++)
+		{
+			memset(&r, 0, sizeof(r));
+			total = 0;
+			bytes = emu.stat.bytes + emu2.stat.bytes;
+			for (i = 0; i < reps; i++)
+			{
+				addr = (i % 8) * 0x100000;
+				Bench_Fill(src, size);
+				if (k == 0)
+				{
+					memset(&emu.mem[addr], 0xFF, size);
+					memset(&emu2.mem[addr], 0xFF, size);
+				}
+				else
+				{
+					Bench_Fill(&emu.mem[addr], size + W25Qxx_SECTORSIZE);
+					Bench_Fill(&emu2.mem[addr], size + W25Qxx_SECTORSIZE);
+				}
+
+				t = W25Qxx_EMU_Now;
+				if (k == 2)
+				{
+					if (useBus)
+					{
+						W25Qxx_Bus_Erase(&bus, 0, addr / W25Qxx_SECTORSIZE, 1, &jerr[0]);
+						W25Qxx_Bus_Poll(&bus);
+						t = W25Qxx_EMU_Now;
+						W25Qxx_Bus_Read(&bus, 1, buf, addr, sizeof(buf), &err);
+					}
+					else
+					{
+						W25Qxx_Erase_Sector(&dev, addr / W25Qxx_SECTORSIZE, &err);
+						if (err == W25Qxx_ERR_NONE) W25Qxx_Read(&dev2, buf, addr, sizeof(buf), &err);
+					}
+					lat[i] = W25Qxx_EMU_Now - t;
+					if (useBus) W25Qxx_Bus_Wait(&bus, W25QXX_BUS_ALL, &err);
+				}
+				else if (useBus)
+				{
+					for (c = 0; c < 2; c++)
+					{
+						if (k == 0) W25Qxx_Bus_DIR_Program(&bus, c, src, addr, size, &jerr[c]);
+						else        W25Qxx_Bus_Erase(&bus, c, addr / W25Qxx_SECTORSIZE + 1, size / W25Qxx_SECTORSIZE, &jerr[c]);
+					}
+					W25Qxx_Bus_Wait(&bus, W25QXX_BUS_ALL, &err);
+					lat[i] = W25Qxx_EMU_Now - t;
+				}
+				else
+				{
+					for (c = 0; c < 2 && err == W25Qxx_ERR_NONE; c++)
+					{
+						if (k == 0)
+						{
+							W25Qxx_DIR_Program(chip[c], src, addr, size, &err);
+							continue;
+						}
+
+						/* the sector range as W25Qxx_Bus_Erase : aligned 64KB blocks, sectors around */
+						for (sec = addr / W25Qxx_SECTORSIZE + 1; sec <= (addr + size) / W25Qxx_SECTORSIZE && err == W25Qxx_ERR_NONE; )
+						{
+							if ((sec & 15) == 0 && sec + 16 <= (addr + size) / W25Qxx_SECTORSIZE + 1)
+							{
+								W25Qxx_Erase_Block64(chip[c], sec / 16, &err);
+								sec += 16;
+							}
+							else
+							{
+								W25Qxx_Erase_Sector(chip[c], sec++, &err);
+							}
+						}
+					}
+					lat[i] = W25Qxx_EMU_Now - t;
+				}
+				if (err != W25Qxx_ERR_NONE || jerr[0] != W25Qxx_ERR_NONE || jerr[1] != W25Qxx_ERR_NONE)
+				{
+					fprintf(stderr, "bus %s %s : err %d %d %d\n", OpBusName[k], useBus ? "bus" : "serial", err, jerr[0], jerr[1]);
+					exit(1);
+				}
+				if (k == 0 && (memcmp(&emu.mem[addr], src, size) != 0 || memcmp(&emu2.mem[addr], src, size) != 0))
+				{
+					fprintf(stderr, "bus %s : data mismatch\n", OpBusName[k]);
+					exit(1);
+				}
+				if (k == 2 && memcmp(buf, &emu2.mem[addr], sizeof(buf)) != 0) exit(1);
+				total += lat[i];
+			}
+			qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+			r.chip = "bus:2xW25Q64";
+			r.op = OpBusName[k];
+			r.size = (k == 2) ? sizeof(buf) : 2 * size;
+			r.align = (k == 1) ? "unaligned" : "aligned";
+			r.state = useBus ? "bus" : "serial";
+			r.reps = reps;
+			r.bps = total ? (double)r.size * reps * 1e9 / total : 0;
+			r.p50 = Bench_Percentile(lat, reps, 50);
+			r.p99 = Bench_Percentile(lat, reps, 99);
+			r.spiBytes = (double)(emu.stat.bytes + emu2.stat.bytes - bytes) / reps;
+			Bench_Print(&r);
+		}
+	}
+
+	W25Qxx_EMU_DeInit(&emu2);
+	W25Qxx_EMU_DeInit(&emu);
+}
+static void Bench_Die(uint8_t quick)																/* Stacked die : latency of reads arriving every 1ms while sector erases run (emulator time) */
+{
+	static const char *ModeName[] = { "no_erase", "blocking", "die" };
+	static uint64_t lat[2000];
+	static uint8_t buf[W25Qxx_PAGESIZE];
+	W25Qxx_DIE_t die;
+	BENCH_RESULT_t r;
+	uint32_t num = quick ? 200 : 2000;
+	uint32_t erases = 0;
+	uint64_t arrival = 0;
+	uint64_t start = 0;
+	uint32_t addr = 0;
+	uint32_t i = 0;
+	uint8_t m = 0;
+	uint8_t d = 0;
+
+	/* page reads of one die of W25Q01 every 1ms, an erase of a die 0 sector every 50ms */
+	for (d = 0; d < 2; d++)
+	{
+		for (m = 0; m < 3; m++)
+		{
+			Bench_Open(&emu, &dev, W25Q01);
+			W25Qxx_Die_Init(&die, &dev);
+
+			erases = emu.stat.erases;
+			start = W25Qxx_EMU_Now;
+			for (i = 0; i < num; i++)
+			{
+				/* the read arrives on time (idle until then), or late behind a blocking erase */
+				arrival = start + (uint64_t)i * 1000000;
+				if (W25Qxx_EMU_Now < arrival) W25Qxx_EMU_Now = arrival;
+
+				if (m && i % 50 == 0)
+				{
+					Bench_Fill(&emu.mem[(i / 50) * W25Qxx_SECTORSIZE], W25Qxx_SECTORSIZE);
+					if (m == 1) W25Qxx_Erase_Sector(&dev, i / 50, &err);
+					else        W25Qxx_Die_Erase_Sector_Start(&die, i / 50, &err);
+					if (err != W25Qxx_ERR_NONE) exit(1);
+				}
+
+				addr = d * W25Qxx_DIESIZE + (Bench_Rand() % (W25Qxx_DIESIZE / W25Qxx_PAGESIZE)) * W25Qxx_PAGESIZE;
+				if (m == 2) W25Qxx_Die_Read(&die, buf, addr, sizeof(buf), &err);
+				else        W25Qxx_Read(&dev, buf, addr, sizeof(buf), &err);
+				if (err != W25Qxx_ERR_NONE || memcmp(buf, &emu.mem[addr], sizeof(buf)) != 0)
+				{
+					fprintf(stderr, "die %s read 0x%08X : err %d or data mismatch\n", ModeName[m], addr, err);
+					exit(1);
+				}
+				lat[i] = W25Qxx_EMU_Now - arrival;
+			}
+			if (m == 2) W25Qxx_Die_Wait(&die, W25QXX_DIE_ALL, &err);
+			if (err != W25Qxx_ERR_NONE) exit(1);
+			qsort(lat, num, sizeof(lat[0]), Bench_Cmp);
+
+			memset(&r, 0, sizeof(r));
+			r.chip = d ? "die:W25Q01:die1" : "die:W25Q01:die0";
+			r.op = "Read_during_Erase";
+			r.size = sizeof(buf);
+			r.align = "aligned";
+			r.state = ModeName[m];
+			r.reps = num;
+			r.p50 = Bench_Percentile(lat, num, 50);
+			r.p99 = Bench_Percentile(lat, num, 99);
+			r.erases = (double)(emu.stat.erases - erases) / num;
+			Bench_Print(&r);
+
+			W25Qxx_EMU_DeInit(&emu);
+		}
+	}
+}
+static void Bench_ECC(uint8_t quick)																/* Page CRC32C : read throughput against W25Qxx_Read (emulator time and host clock) */
+{
+	static const uint32_t size[] = { W25QXX_ECC_DATA, 4032, 32256 };
+	static const char *StateName[] = { "plain", "crc", "crc_1bit" };
+	static W25Qxx_ECC_t ecc;
+	static uint64_t lat[BENCH_MAXREP];
+	BENCH_RESULT_t r;
+	uint32_t reps = quick ? 3 : BENCH_MAXREP;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t addr = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint8_t host = 0;
+	uint8_t z = 0;
+	uint8_t k = 0;
+	double t0 = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_ECC_config(&ecc, &dev, 0, 64, &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("ecc config");
+	Bench_Fill(src, ecc.sizeData);
+	W25Qxx_ECC_DIR_Program(&ecc, src, 0, ecc.sizeData, &err);
+	if (err != W25Qxx_ERR_NONE) exit(1);
+
+	/* plain : W25Qxx_Read of the same flash length, crc : W25Qxx_ECC_Read, crc_1bit : one bit error in every page */
+	for (k = 0; k < 3; k++)
+	{
+		if (k == 2)
+		{
+			for (j = 0; j < ecc.numPage; j++) emu.mem[j * W25Qxx_PAGESIZE + Bench_Rand() % W25Qxx_PAGESIZE] ^= (uint8_t)(1 << (Bench_Rand() % 8));
+		}
+		for (z = 0; z < sizeof(size) / sizeof(size[0]); z++)
+		{
+			for (host = 0; host < 2; host++)
+			{
+				memset(&r, 0, sizeof(r));
+				total = 0;
+				bytes = emu.stat.bytes;
+				for (i = 0; i < reps; i++)
+				{
+					addr = (i * size[z]) % (ecc.sizeData - size[z]);
+					addr -= addr % W25QXX_ECC_DATA;
+					t = W25Qxx_EMU_Now;
+					t0 = Bench_Clock();
+					if (k == 0) W25Qxx_Read(&dev, dst, addr / W25QXX_ECC_DATA * W25Qxx_PAGESIZE, (uint16_t)(size[z] / W25QXX_ECC_DATA * W25Qxx_PAGESIZE), &err);
+					else        W25Qxx_ECC_Read(&ecc, dst, addr, size[z], &err);
+					lat[i] = host ? (uint64_t)((Bench_Clock() - t0) * 1e9) : W25Qxx_EMU_Now - t;
+					total += lat[i];
+					if (err != W25Qxx_ERR_NONE || (k && memcmp(dst, src + addr, size[z]) != 0))
+					{
+						fprintf(stderr, "ecc %s size %u : err %d or data mismatch\n", StateName[k], size[z], err);
+						exit(1);
+					}
+				}
+				qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+				r.chip = host ? "ecc:host" : "ecc:W25Q64";
+				r.op = "Read";
+				r.size = size[z];
+				r.align = "aligned";
+				r.state = StateName[k];
+				r.reps = reps;
+				r.bps = total ? (double)size[z] * reps * 1e9 / total : 0;
+				r.p50 = Bench_Percentile(lat, reps, 50);
+				r.p99 = Bench_Percentile(lat, reps, 99);
+				r.spiBytes = (double)(emu.stat.bytes - bytes) / reps;
+				Bench_Print(&r);
+			}
+		}
+	}
+
+	W25Qxx_EMU_DeInit(&emu);
+}
+static void Bench_LZ_Data(uint8_t kind, uint8_t *p, uint32_t n)									/* Log lines, JSON records, lookup table, random */
+{
+	char line[128];
+	uint32_t off = 0;
+	uint32_t len = 0;
+	uint32_t i = 0;
+
+	if (kind == 3)
+	{
+		Bench_Fill(p, n);
+		return;
+	}
+	for (i = 0; off < n; i++, off += len)
+	{
+		if (kind == 0)
+		{
+			len = (uint32_t)snprintf(line, sizeof(line), "%08u I sensor%u temp=%u.%u hum=%u\n",
+			                         i * 125, Bench_Rand() % 4, 20 + Bench_Rand() % 8, Bench_Rand() % 10, 35 + Bench_Rand() % 20);
+		}
+		else if (kind == 1)
+		{
+			len = (uint32_t)snprintf(line, sizeof(line), "{\"id\":%u,\"name\":\"node%u\",\"enabled\":%s,\"rate\":%u,\"mode\":\"auto\"},\n",
+			                         i, i % 64, (Bench_Rand() & 1) ? "true" : "false", 100 * (1 + Bench_Rand() % 10));
+		}
+		else
+		{
+			/* 16 bit little endian steps of a slowly rising curve */
+			len = 2;
+			line[0] = (char)((1000 + i / 8) & 0xFF);
+			line[1] = (char)((1000 + i / 8) >> 8);
+		}
+		memcpy(p + off, line, (len < n - off) ? len : n - off);
+	}
+}
+static void Bench_LZ(uint8_t quick)																	/* W25Qxx_LZ : throughput, flash and RAM of block sizes against plain program/read */
+{
+	static const uint32_t block[] = { 256, 512, 1024, 4096 };
+	static const char *DataName[] = { "log", "json", "table", "random" };
+	static const char *LzOp[] = { "Append", "Read_seq", "Read_rand" };
+	static W25Qxx_LZ_t lz;
+	static uint64_t lat[BENCH_LZRAND];
+	BENCH_RESULT_t r;
+	uint32_t raw = quick ? BENCH_LZRAW / 4 : BENCH_LZRAW;
+	uint32_t piece = 0;
+	uint32_t reps = 0;
+	uint64_t total = 0;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint32_t addr = 0;
+	uint32_t i = 0;
+	uint8_t kind = 0;
+	uint8_t op = 0;
+	uint8_t z = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+
+	/* size 0 : W25Qxx_DIR_Program / W25Qxx_Read of the raw data (plain), then the volume of each block size */
+	for (kind = 0; kind < sizeof(DataName) / sizeof(DataName[0]); kind++)
+	{
+		Bench_LZ_Data(kind, src, raw);
+		for (z = 0; z <= sizeof(block) / sizeof(block[0]); z++)
+		{
+			if (z && block[z - 1] > W25QXX_LZ_BLOCK) continue;
+			Bench_Prepare(0, BENCH_LZSECTOR * W25Qxx_SECTORSIZE, 0);
+			if (z)
+			{
+				W25Qxx_LZ_Mount(&lz, &dev, 0, BENCH_LZSECTOR, &err);
+				if (err != W25Qxx_ERR_NONE) exit(1);
+				lz.sizeBlock = block[z - 1];
+			}
+
+			for (op = 0; op < 3; op++)
+			{
+				memset(&r, 0, sizeof(r));
+				piece = (op == 2) ? BENCH_LZPIECE / 64 : BENCH_LZPIECE;
+				reps = (op == 2) ? BENCH_LZRAND : raw / piece;
+				total = 0;
+				bytes = emu.stat.bytes;
+				erases = emu.stat.erases;
+				programs = emu.stat.programs;
+				for (i = 0; i < reps; i++)
+				{
+					addr = (op == 2) ? Bench_Rand() % (raw - piece) : i * piece;
+					t = W25Qxx_EMU_Now;
+					if (op == 0 && z)       W25Qxx_LZ_Append(&lz, src + addr, piece, &err);
+					else if (op == 0)       W25Qxx_DIR_Program(&dev, src + addr, addr + W25Qxx_SECTORSIZE * BENCH_LZSECTOR / 2, piece, &err);
+					else if (z)             W25Qxx_LZ_Read(&lz, dst, addr, piece, &err);
+					else                    W25Qxx_Read(&dev, dst, addr + W25Qxx_SECTORSIZE * BENCH_LZSECTOR / 2, (uint16_t)piece, &err);
+					if (err == W25Qxx_ERR_NONE && op == 0 && z && i == reps - 1) W25Qxx_LZ_Sync(&lz, &err);
+					lat[i] = W25Qxx_EMU_Now - t;
+					total += lat[i];
+					if (err != W25Qxx_ERR_NONE || (op && memcmp(dst, src + addr, piece) != 0))
+					{
+						fprintf(stderr, "lz %s %s block %u : err %d or data mismatch\n", DataName[kind], LzOp[op], z ? block[z - 1] : 0, err);
+						exit(1);
+					}
+				}
+				qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+				r.chip = "lz:W25Q64";
+				r.op = LzOp[op];
+				r.size = z ? block[z - 1] : 0;
+				r.align = "aligned";
+				r.state = DataName[kind];
+				r.reps = reps;
+				r.bps = total ? (double)piece * reps * 1e9 / total : 0;
+				r.p50 = Bench_Percentile(lat, reps, 50);
+				r.p99 = Bench_Percentile(lat, reps, 99);
+				r.spiBytes = (double)(emu.stat.bytes - bytes) / reps;
+				r.erases = (double)(emu.stat.erases - erases) / reps;
+				r.programs = (double)(emu.stat.programs - programs) / reps;
+				Bench_Print(&r);
+			}
+
+			/* Footprint : spi_bytes = flash Byte (index + data) per BENCH_LZPIECE raw Byte, ram = W25Qxx_LZ_t at W25QXX_LZ_BLOCK = size */
+			memset(&r, 0, sizeof(r));
+			r.chip = "lz:W25Q64";
+			r.op = "Footprint";
+			r.size = z ? block[z - 1] : 0;
+			r.align = "aligned";
+			r.state = DataName[kind];
+			r.reps = 1;
+			r.spiBytes = z ? (double)(lz.numEntry * W25QXX_LZ_ENTRY + lz.dataEnd) * BENCH_LZPIECE / raw : BENCH_LZPIECE;
+			r.ram = z ? (double)(sizeof(W25Qxx_LZ_t) - 2 * W25QXX_LZ_BLOCK - W25QXX_LZ_BOUND + 3 * block[z - 1] + block[z - 1] / 255 + 16) : 0;
+			Bench_Print(&r);
+		}
+	}
+
+	W25Qxx_EMU_DeInit(&emu);
+}
+static void Bench_Checksum(uint8_t quick)															/* W25Qxx_Checksum (one streamed read) against W25Qxx_Read into a buffer, then hash */
+{
+	static const char *AlgoName[] = { "CRC32", "CRC32C", "SHA256" };
+	static const char *StateName[] = { "stream", "two_pass", "kernel" };
+	W25Qxx_SHA256_t sha;
+	BENCH_RESULT_t r;
+	uint32_t size = quick ? 0x100000 : 0;
+	uint8_t digest[2][W25QXX_SHA256_SIZE];
+	uint8_t *image = NULL;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t crc = 0;
+	uint32_t off = 0;
+	uint32_t num = 0;
+	uint8_t host = 0;
+	uint8_t k = 0;
+	uint8_t a = 0;
+	double t0 = 0;
+
+	Bench_Open(&emu, &dev, W25Q128);
+	if (size == 0) size = dev.sizeChip;
+	image = (uint8_t *)malloc(size);
+	if (image == NULL) exit(1);
+	Bench_Fill(emu.mem, size);
+
+	/* stream : W25Qxx_Checksum, two_pass : W25Qxx_Read of the range into RAM then the hash, kernel : the hash alone */
+	for (a = 0; a < 3; a++)
+	{
+		for (k = 0; k < 3; k++)
+		{
+			memset(&r, 0, sizeof(r));
+			bytes = emu.stat.bytes;
+			t = W25Qxx_EMU_Now;
+			t0 = Bench_Clock();
+			if (k == 0)
+			{
+				W25Qxx_Checksum(&dev, 0, size, (W25Qxx_HASH)a, 0, digest[0], &err);
+			}
+			else
+			{
+				for (off = 0; k == 1 && off < size && err == W25Qxx_ERR_NONE; off += num)
+				{
+					num = (size - off > BENCH_READCHUNK) ? BENCH_READCHUNK : size - off;
+					W25Qxx_Read(&dev, image + off, off, (uint16_t)num, &err);
+				}
+				if (a == 2)
+				{
+					W25Qxx_SHA256_Init(&sha);
+					W25Qxx_SHA256_Update(&sha, image, size);
+					W25Qxx_SHA256_Final(&sha, digest[1]);
+				}
+				else
+				{
+					crc = (a == 0) ? W25Qxx_CRC32(0, image, size) : W25Qxx_CRC32C(0, image, size);
+					digest[1][0] = (uint8_t)(crc >> 24);
+					digest[1][1] = (uint8_t)(crc >> 16);
+					digest[1][2] = (uint8_t)(crc >> 8);
+					digest[1][3] = (uint8_t)crc;
+				}
+			}
+			t0 = Bench_Clock() - t0;
+			t = W25Qxx_EMU_Now - t;
+			if (err != W25Qxx_ERR_NONE || (k && memcmp(digest[0], digest[1], (a == 2) ? W25QXX_SHA256_SIZE : 4) != 0))
+			{
+				fprintf(stderr, "checksum %s %s : err %d or digest mismatch\n", AlgoName[a], StateName[k], err);
+				exit(1);
+			}
+
+			for (host = 0; host < 2; host++)
+			{
+				if (k == 2 && host == 0) continue;
+				r.chip = host ? "checksum:host" : "checksum:W25Q128";
+				r.op = AlgoName[a];
+				r.size = size;
+				r.align = "aligned";
+				r.state = StateName[k];
+				r.reps = 1;
+				r.p50 = host ? t0 * 1e6 : t / 1000.0;
+				r.p99 = r.p50;
+				r.bps = r.p50 > 0 ? size * 1e6 / r.p50 : 0;
+				r.spiBytes = (double)(emu.stat.bytes - bytes);
+				r.ram = (k == 0) ? W25QXX_CRC_CHUNK : size;
+				Bench_Print(&r);
+			}
+		}
+	}
+
+	free(image);
+	W25Qxx_EMU_DeInit(&emu);
+}
+#if BENCH_LFS || BENCH_FATFS
+static void Bench_FS_Print(const char *chip, const char *op, uint32_t size, const char *state, uint64_t *lat, uint32_t reps, uint64_t bytes, uint32_t erases, uint32_t programs)	/* Row of a file workload (lat : ns per operation) */
+{
+	BENCH_RESULT_t r;
+	uint64_t total = 0;
+	uint32_t i = 0;
+
+	for (i = 0; i < reps; i++) total += lat[i];
+	qsort(lat, reps, sizeof(lat[0]), Bench_Cmp);
+
+	memset(&r, 0, sizeof(r));
+	r.chip = chip;
+	r.op = op;
+	r.size = size;
+	r.align = "aligned";
+	r.state = state;
+	r.reps = reps;
+	r.bps = total ? (double)size * reps * 1e9 / total : 0;
+	r.p50 = Bench_Percentile(lat, reps, 50);
+	r.p99 = Bench_Percentile(lat, reps, 99);
+	r.spiBytes = (double)(emu.stat.bytes - bytes) / reps;
+	r.erases = (double)(emu.stat.erases - erases) / reps;
+	r.programs = (double)(emu.stat.programs - programs) / reps;
+	Bench_Print(&r);
+}
+#endif
+#if BENCH_LFS
+static void Bench_LFS(uint8_t quick)																/* littlefs through W25Qxx_LFS : format, mount, file create/write/read/append (emulator time) */
+{
+	static const char *LfsOp[] = { "Format", "Mount", "File_Create", "File_Write", "File_Read", "File_Append", "Mount" };
+	static W25Qxx_LFS_t bd;
+	static uint64_t lat[BENCH_FSREP];
+	lfs_t lfs;
+	lfs_file_t file;
+	char name[16];
+	uint32_t size = quick ? BENCH_FSFILE / 4 : BENCH_FSFILE;
+	uint32_t piece = 0;
+	uint32_t reps = 0;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint32_t i = 0;
+	uint8_t op = 0;
+	int ret = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_LFS_config(&bd, &dev, 0, BENCH_FSSECTOR, &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("lfs config");
+	Bench_Fill(src, size);
+
+	/* the volume starts erased, every operation is timed from the call to the return */
+	for (op = 0; op < sizeof(LfsOp) / sizeof(LfsOp[0]); op++)
+	{
+		piece = (op == 2 || op == 5) ? BENCH_FSRECORD : (op == 3 || op == 4) ? BENCH_FSPIECE : 0;
+		reps = (op == 2) ? BENCH_FSFILES : (op == 3 || op == 4) ? size / BENCH_FSPIECE : (op == 5) ? (quick ? BENCH_FSREP / 4 : BENCH_FSREP) : 1;
+		bytes = emu.stat.bytes;
+		erases = emu.stat.erases;
+		programs = emu.stat.programs;
+		if (op == 3) ret = lfs_file_open(&lfs, &file, "data.bin", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+		if (op == 4) ret = lfs_file_open(&lfs, &file, "data.bin", LFS_O_RDONLY);
+		if (op == 5) ret = lfs_file_open(&lfs, &file, "log.txt", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+		for (i = 0; i < reps && ret >= 0; i++)
+		{
+			t = W25Qxx_EMU_Now;
+			switch (op)
+			{
+				case 0 :
+					ret = lfs_format(&lfs, &bd.cfg);
+					break;
+				case 1 :
+				case 6 :
+					ret = lfs_mount(&lfs, &bd.cfg);
+					break;
+				case 2 :
+					/* small file : open, write, close */
+					snprintf(name, sizeof(name), "cfg%03u.txt", i);
+					ret = lfs_file_open(&lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+					if (ret >= 0) ret = lfs_file_write(&lfs, &file, src + i * piece, piece);
+					if (ret >= 0) ret = lfs_file_close(&lfs, &file);
+					break;
+				case 3 :
+					ret = lfs_file_write(&lfs, &file, src + i * piece, piece);
+					if (ret >= 0 && i == reps - 1) ret = lfs_file_close(&lfs, &file);
+					break;
+				case 4 :
+					ret = lfs_file_read(&lfs, &file, dst, piece);
+					if (ret >= 0 && memcmp(dst, src + i * piece, piece) != 0) ret = LFS_ERR_CORRUPT;
+					if (ret >= 0 && i == reps - 1) ret = lfs_file_close(&lfs, &file);
+					break;
+				default :
+					/* log record, synced one by one */
+					ret = lfs_file_write(&lfs, &file, src + (i * piece) % size, piece);
+					if (ret >= 0) ret = lfs_file_sync(&lfs, &file);
+					if (ret >= 0 && i == reps - 1) ret = lfs_file_close(&lfs, &file);
+					break;
+			}
+			lat[i] = W25Qxx_EMU_Now - t;
+		}
+		if (ret < 0)
+		{
+			fprintf(stderr, "lfs %s : error %d\n", LfsOp[op], ret);
+			exit(1);
+		}
+		Bench_FS_Print("lfs:W25Q64", LfsOp[op], piece, "-", lat, reps, bytes, erases, programs);
+
+		/* the second mount is after the workload */
+		if (op == 5) lfs_unmount(&lfs);
+	}
+
+	lfs_unmount(&lfs);
+	W25Qxx_EMU_DeInit(&emu);
+}
+#endif
+#if BENCH_FATFS
+#if !FF_FS_NORTC
+DWORD get_fattime(void)																				/* FatFs time stamp : fixed 2026-10-18 */
+{
+	return ((DWORD)(2026 - 1980) << 25) | ((DWORD)10 << 21) | ((DWORD)18 << 16);
+}
+#endif
+static FATFS fs;
+static FRESULT Bench_FatFs_Write(const char *to, const uint8_t *data, uint32_t size, uint64_t *lat)	/* Write a file by BENCH_FSPIECE calls (lat : ns per call) */
+{
+	FIL out;
+	FRESULT ret = FR_OK;
+	UINT n = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+
+	ret = f_open(&out, to, FA_WRITE | FA_CREATE_ALWAYS);
+	for (i = 0; i < size / BENCH_FSPIECE && ret == FR_OK; i++)
+	{
+		t = W25Qxx_EMU_Now;
+		ret = f_write(&out, data + i * BENCH_FSPIECE, BENCH_FSPIECE, &n);
+		if (ret == FR_OK && i == size / BENCH_FSPIECE - 1) ret = f_close(&out);
+		lat[i] = W25Qxx_EMU_Now - t;
+	}
+	return ret;
+}
+static FRESULT Bench_FatFs_Copy(const char *from, const char *to, uint32_t size, uint64_t *lat)		/* Copy a file by BENCH_FSPIECE calls (lat : ns per call) */
+{
+	static BYTE buf[BENCH_FSPIECE];
+	FIL in;
+	FIL out;
+	FRESULT ret = FR_OK;
+	UINT n = 0;
+	uint64_t t = 0;
+	uint32_t i = 0;
+
+	/* a new mount allocates from the start of the volume (the clusters of the deleted copy) */
+	ret = f_mount(&fs, "", 1);
+	if (ret == FR_OK) ret = f_open(&in, from, FA_READ);
+	if (ret == FR_OK) ret = f_open(&out, to, FA_WRITE | FA_CREATE_ALWAYS);
+	for (i = 0; i < size / BENCH_FSPIECE && ret == FR_OK; i++)
+	{
+		t = W25Qxx_EMU_Now;
+		ret = f_read(&in, buf, BENCH_FSPIECE, &n);
+		if (ret == FR_OK) ret = f_write(&out, buf, n, &n);
+		if (ret == FR_OK && n != BENCH_FSPIECE) ret = FR_DENIED;
+		if (ret == FR_OK && i == size / BENCH_FSPIECE - 1) ret = f_close(&out);
+		lat[i] = W25Qxx_EMU_Now - t;
+	}
+	f_close(&in);
+	return ret;
+}
+static void Bench_FatFs(uint8_t quick)																/* FatFs through W25Qxx_Disk : format, mount, file write, copy, read (emulator time) */
+{
+	static const char *FatOp[] = { "Format", "Mount", "File_Write", "File_Copy", "File_Copy", "Idle", "File_Copy", "File_Read" };
+	static const char *FatState[] = { "-", "-", "erased", "erased", "dirty", "trim", "trimmed", "-" };
+	static W25Qxx_DISK_t disk;
+	static BYTE work[W25QXX_DISK_UNIT];
+	static uint64_t lat[BENCH_FSREP];
+	MKFS_PARM opt = { FM_FAT | FM_SFD, 1, 0, 0, W25QXX_DISK_UNIT };
+	FIL file;
+	FRESULT ret = FR_OK;
+	UINT n = 0;
+	uint32_t size = quick ? BENCH_FSFILE / 4 : BENCH_FSFILE;
+	uint32_t piece = 0;
+	uint32_t reps = 0;
+	uint32_t trim = 0;
+	uint64_t bytes = 0;
+	uint64_t t = 0;
+	uint32_t erases = 0;
+	uint32_t programs = 0;
+	uint32_t i = 0;
+	uint8_t op = 0;
+
+	Bench_Open(&emu, &dev, W25Q64);
+	W25Qxx_Disk_Attach(0, &disk, &dev, 0, BENCH_FSSECTOR, &err);
+	if (err != W25Qxx_ERR_NONE) Bench_Fail("disk attach");
+	Bench_Fill(src, size * 2);
+
+	/* cluster = erase unit, the data area is aligned to the unit (GET_BLOCK_SIZE) */
+	for (op = 0; op < sizeof(FatOp) / sizeof(FatOp[0]); op++)
+	{
+		piece = (op >= 2 && op != 5) ? BENCH_FSPIECE : 0;
+		reps = piece ? size / BENCH_FSPIECE : 1;
+		bytes = emu.stat.bytes;
+		erases = emu.stat.erases;
+		programs = emu.stat.programs;
+		switch (op)
+		{
+			case 0 :
+				t = W25Qxx_EMU_Now;
+				ret = f_mkfs("", &opt, work, sizeof(work));
+				lat[0] = W25Qxx_EMU_Now - t;
+				break;
+			case 1 :
+				t = W25Qxx_EMU_Now;
+				ret = f_mount(&fs, "", 1);
+				lat[0] = W25Qxx_EMU_Now - t;
+				break;
+			case 2 :
+				ret = Bench_FatFs_Write("src.bin", src, size, lat);
+				break;
+			case 3 :
+				/* to space never written, new.bin (other data) is written first so the copy lands behind it */
+				ret = Bench_FatFs_Write("new.bin", src + size, size, lat);
+				bytes = emu.stat.bytes;
+				erases = emu.stat.erases;
+				programs = emu.stat.programs;
+				if (ret == FR_OK) ret = Bench_FatFs_Copy("src.bin", "dst.bin", size, lat);
+				break;
+			case 4 :
+				/* new.bin to the clusters of the deleted copy, still programmed with other data */
+				ret = f_unlink("dst.bin");
+				bytes = emu.stat.bytes;
+				erases = emu.stat.erases;
+				programs = emu.stat.programs;
+				if (ret == FR_OK) ret = Bench_FatFs_Copy("new.bin", "dst.bin", size, lat);
+				break;
+			case 6 :
+				/* to the same clusters after the idle erase */
+				ret = Bench_FatFs_Copy("src.bin", "dst.bin", size, lat);
+				break;
+			case 5 :
+				/* erase of the units trimmed by the deletion, W25Qxx_Disk_Idle until none is left */
+				ret = f_unlink("dst.bin");
+				bytes = emu.stat.bytes;
+				erases = emu.stat.erases;
+				programs = emu.stat.programs;
+				t = W25Qxx_EMU_Now;
+				do
+				{
+					trim = disk.numTrim;
+					W25Qxx_Disk_Idle(&disk, &err);
+				} while (err == W25Qxx_ERR_NONE && (disk.busy || disk.numTrim != trim));
+				if (err != W25Qxx_ERR_NONE) ret = FR_DISK_ERR;
+				lat[0] = W25Qxx_EMU_Now - t;
+				break;
+			default :
+				ret = f_open(&file, "dst.bin", FA_READ);
+				for (i = 0; i < reps && ret == FR_OK; i++)
+				{
+					t = W25Qxx_EMU_Now;
+					ret = f_read(&file, dst, piece, &n);
+					lat[i] = W25Qxx_EMU_Now - t;
+					if (ret == FR_OK && (n != piece || memcmp(dst, src + i * piece, piece) != 0)) ret = FR_INT_ERR;
+				}
+				f_close(&file);
+				break;
+		}
+		if (ret != FR_OK)
+		{
+			fprintf(stderr, "fatfs %s %s : error %d\n", FatOp[op], FatState[op], ret);
+			exit(1);
+		}
+		Bench_FS_Print("fatfs:W25Q64", FatOp[op], piece, FatState[op], lat, reps, bytes, erases, programs);
+	}
+
+	f_mount(NULL, "", 0);
+	W25Qxx_EMU_DeInit(&emu);
+}
+#endif
+/* Section run only when named (or "all") */
+static const struct { const char *name; void (*run)(uint8_t quick); } BenchSection[] = {
+#if W25QXX_AUTO_POWER
+	{ "power", Bench_Power },
+#endif
+	{ "mirror", Bench_Mirror },
+	{ "jitter", Bench_Jitter },
+	{ "startup", Bench_Startup },
+	{ "ftl", Bench_FTL },
+	{ "kv", Bench_KV },
+	{ "log", Bench_Log },
+	{ "queue", Bench_Queue },
+	{ "bus", Bench_Bus },
+	{ "die", Bench_Die },
+	{ "ecc", Bench_ECC },
+	{ "lz", Bench_LZ },
+	{ "checksum", Bench_Checksum },
+#if BENCH_LFS
+	{ "lfs", Bench_LFS },
+#endif
+#if BENCH_FATFS
+	{ "fatfs", Bench_FatFs },
+#endif
+};
+/* Main */
+int main(int argc, char *argv[])
+{
+	uint8_t quick = 0;
+	uint8_t cal = 0;
+	uint8_t select[sizeof(BenchChip) / sizeof(BenchChip[0])] = { 0 };
+	uint8_t section[sizeof(BenchSection) / sizeof(BenchSection[0])] = { 0 };
+	uint8_t any = 0;
+	uint8_t base = 1;
+	int i = 0;
+	uint8_t c = 0;
+
+	for (i = 1; i < argc; i++)
+	{
+		if      (strcmp(argv[i], "json") == 0)  json = 1;
+		else if (strcmp(argv[i], "csv") == 0)   json = 0;
+		else if (strcmp(argv[i], "quick") == 0) quick = 1;
+		else if (strcmp(argv[i], "cal") == 0)   cal = 1;
+		else if (strcmp(argv[i], "all") == 0)   memset(section, 1, sizeof(section));
+		else
+		{
+			for (c = 0; c < sizeof(BenchSection) / sizeof(BenchSection[0]); c++)
+			{
+				if (strcmp(argv[i], BenchSection[c].name) == 0) break;
+			}
+			if (c < sizeof(BenchSection) / sizeof(BenchSection[0]))
+			{
+				section[c] = 1;
+				base = 0;
+				continue;
+			}
+
+			for (c = 0; c < sizeof(BenchChip) / sizeof(BenchChip[0]); c++)
+			{
+				if (strcmp(argv[i], BenchChip[c].name) == 0) break;
+			}
+			if (c == sizeof(BenchChip) / sizeof(BenchChip[0]))
+			{
+				fprintf(stderr, "usage : %s [csv|json] [quick] [cal] [all] [chip ...] [section ...]\n", argv[0]);
+				return 2;
+			}
+			select[c] = 1;
+			any = 1;
+			base = 1;
+		}
+	}
+	if (!any && base)
+	{
+		select[0] = 1;		/* W25Q16  */
+		select[2] = 1;		/* W25Q64  */
+		select[4] = 1;		/* W25Q256 */
+	}
+
+	src = (uint8_t *)malloc(BENCH_MAXSIZE);
+	dst = (uint8_t *)malloc(BENCH_MAXSIZE);
+	if (src == NULL || dst == NULL) return 1;
+
+	for (c = 0; c < sizeof(BenchChip) / sizeof(BenchChip[0]); c++)
+	{
+		if (select[c]) Bench_Chip(BenchChip[c].name, BenchChip[c].type, quick, cal);
+	}
+	if (base)
+	{
+		Bench_Kernel(quick);
+		Bench_Driver(quick, 0);
+		Bench_Driver(quick, 1);
+#if W25QXX_WEAR
+		Bench_Wear(quick);
+#endif
+#if W25QXX_LATENCY
+		Bench_Latency(quick);
+#endif
+	}
+	for (c = 0; c < sizeof(BenchSection) / sizeof(BenchSection[0]); c++)
+	{
+		if (section[c]) BenchSection[c].run(quick);
+	}
+
+	if (json) printf("\n]\n");
+	free(src);
+	free(dst);
+
+	return 0;
+}
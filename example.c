@@ -50,6 +50,7 @@ int main(void)
 	testdev.port.spi_rw = SPI5_RW;
 	testdev.port.spi_cs_H = SPI5_CS_H;
 	testdev.port.spi_cs_L = SPI5_CS_L;
+	testdev.port.spi_timeus = NULL;								/* optional : microsecond counter of W25Qxx_Calibrate */
 	W25Qxx_config(&testdev, &err);
 	if (err != W25Qxx_ERR_NONE) while (1);
 
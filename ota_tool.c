@@ -0,0 +1,394 @@
+/**
+  * @file  : ota_tool.c
+  * @brief : W25Qxx_OTA patch generator and update benchmark on the emulated chip (host)
+  *
+  * Build : cc -O2 -o ota_tool ota_tool.c W25Qxx.c W25Qxx_Emu.c W25Qxx_OTA.c W25Qxx_CRC.c
+  * Usage : ota_tool diff <old.bin> <new.bin> <patch.bin>
+  *         ota_tool apply <old.bin> <patch.bin> [new.bin]
+  *         ota_tool bench [quick]
+  *
+  *         diff  : patch of 'D'/'I'/'S'/'E' commands (W25Qxx_OTA.h) that builds new.bin from
+  *                 old.bin, an empty old.bin (0 Byte) gives a full image of 'I' commands
+  *         apply : install old.bin in both slots of the emulated W25Q64, apply the patch by W25Qxx_OTA_Patch
+  *                 in pieces of OTA_PIECE Byte, print the update cost and save the new image
+  *         bench : the same on synthetic images : first install (full), no change (same), a few
+  *                 bytes changed (bytes), 512 Byte inserted at 1/4 (insert), address constants
+  *                 moved by 0x100 in the upper half (relink)
+  *
+  * Generator : a match continues at the old position of the last match (no 'S') or is found by a
+  * hash of 8 Byte of the old image, a match is extended while at least half of the Byte are
+  * equal ('D' data is then mostly 0x00 for the compressor of the transport), the rest is 'I'.
+  * Cost : patch Byte, emulator time of Begin/Patch/End, Byte programmed, sectors erased and
+  * skipped (unchanged) in the inactive slot.
+  */
+#include "W25Qxx.h"
+#include "W25Qxx_Emu.h"
+#include "W25Qxx_OTA.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OTA_CLKHZ           50000000					/* Emulated SPI clock */
+#define OTA_MINMATCH        16							/* Shortest 'D' command (Byte) */
+#define OTA_HASHBITS        16							/* Hash table of old image positions */
+#define OTA_PIECE           256							/* W25Qxx_OTA_Patch piece (Byte) */
+#define OTA_SLOTSECTOR      1023						/* Slot size (sector), W25Q64 : A, B, 2 meta sectors */
+#define OTA_BENCHSIZE       0x40000						/* Bench image size (256KB) */
+
+typedef struct
+{
+	uint8_t *data;
+	uint32_t size;
+	uint32_t cap;
+	uint32_t numLiteral;								/* 'I' data Byte */
+	uint32_t numDelta;									/* 'D' data Byte */
+	uint32_t numNonZero;								/* 'D' data Byte that are not 0x00 */
+} OTA_PATCH_t;
+
+static W25Qxx_EMU_t emu;
+static W25Qxx_t dev;
+static W25Qxx_OTA_t ota;
+static uint32_t seed = 1;
+
+static uint32_t Ota_Rand(void)																		/* xorshift32 */
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+static void Ota_Put(OTA_PATCH_t *p, const uint8_t *data, uint32_t n)								/* Append to the patch */
+{
+	if (p->size + n > p->cap)
+	{
+		p->cap = (p->size + n) * 2;
+		p->data = (uint8_t *)realloc(p->data, p->cap);
+		if (p->data == NULL) exit(1);
+	}
+	memcpy(p->data + p->size, data, n);
+	p->size += n;
+}
+static void Ota_Cmd(OTA_PATCH_t *p, uint8_t op, uint32_t a, uint32_t b)								/* Command and argument (little endian) */
+{
+	uint8_t cmd[9];
+
+	cmd[0] = op;
+	W25Qxx_Put32(&cmd[1], a);
+	W25Qxx_Put32(&cmd[5], b);
+	Ota_Put(p, cmd, (op == 'E') ? 9 : 5);
+}
+static void Ota_Literal(OTA_PATCH_t *p, const uint8_t *data, uint32_t n)							/* 'I' command */
+{
+	if (n == 0) return;
+	Ota_Cmd(p, 'I', n, 0);
+	Ota_Put(p, data, n);
+	p->numLiteral += n;
+}
+static uint32_t Ota_Hash(const uint8_t *p)															/* Hash of 8 Byte */
+{
+	uint32_t a = W25Qxx_Get32(p);
+	uint32_t b = W25Qxx_Get32(p + 4);
+
+	return ((a * 0x9E3779B1u) ^ (b * 0x85EBCA77u)) >> (32 - OTA_HASHBITS);
+}
+static uint32_t Ota_Extend(const uint8_t *old, uint32_t oldSize, uint32_t o, const uint8_t *neu, uint32_t newSize, uint32_t n)	/* Match length, half of the Byte equal */
+{
+	int32_t score = 0;
+	int32_t best = 0;
+	uint32_t len = 0;
+	uint32_t i = 0;
+
+	for (i = 0; o + i < oldSize && n + i < newSize; i++)
+	{
+		score += (old[o + i] == neu[n + i]) ? 1 : -1;
+		if (score > best)
+		{
+			best = score;
+			len = i + 1;
+		}
+		else if (score < best - 64)
+		{
+			break;
+		}
+	}
+	return len;
+}
+static void Ota_Diff(const uint8_t *old, uint32_t oldSize, const uint8_t *neu, uint32_t newSize, OTA_PATCH_t *p)	/* Patch of new from old */
+{
+	static uint32_t table[1 << OTA_HASHBITS];
+	static uint8_t delta[W25Qxx_SECTORSIZE];
+	uint32_t oldPos = 0;
+	uint32_t lit = 0;
+	uint32_t len = 0;
+	uint32_t far = 0;
+	uint32_t o = 0;
+	uint32_t n = 0;
+	uint32_t i = 0;
+	uint32_t k = 0;
+
+	memset(p, 0, sizeof(OTA_PATCH_t));
+
+	/* old positions by hash (0xFFFFFFFF : none), the first position of a hash is kept */
+	memset(table, 0xFF, sizeof(table));
+	for (i = oldSize >= 8 ? oldSize - 8 + 1 : 0; i > 0; i--) table[Ota_Hash(old + i - 1)] = i - 1;
+
+	for (n = 0; n < newSize; )
+	{
+		/* continue at the old position, or move to an old position of the same 8 Byte */
+		len = (oldPos < oldSize) ? Ota_Extend(old, oldSize, oldPos, neu, newSize, n) : 0;
+		o = oldPos;
+		if (len < OTA_MINMATCH && n + 8 <= newSize)
+		{
+			far = table[Ota_Hash(neu + n)];
+			if (far != 0xFFFFFFFF && memcmp(old + far, neu + n, 8) == 0)
+			{
+				len = Ota_Extend(old, oldSize, far, neu, newSize, n);
+				o = far;
+			}
+		}
+		if (len < OTA_MINMATCH)
+		{
+			n++;
+			continue;
+		}
+
+		/* the new Byte before the match, then the match */
+		Ota_Literal(p, neu + lit, n - lit);
+		if (o != oldPos) Ota_Cmd(p, 'S', o - oldPos, 0);
+		Ota_Cmd(p, 'D', len, 0);
+		for (i = 0; i < len; i += k)
+		{
+			k = (len - i > sizeof(delta)) ? sizeof(delta) : len - i;
+			for (far = 0; far < k; far++)
+			{
+				delta[far] = (uint8_t)(neu[n + i + far] - old[o + i + far]);
+				if (delta[far]) p->numNonZero++;
+			}
+			Ota_Put(p, delta, k);
+		}
+		n += len;
+		lit = n;
+		p->numDelta += len;
+		oldPos = o + len;
+	}
+	Ota_Literal(p, neu + lit, newSize - lit);
+	Ota_Cmd(p, 'E', newSize, W25Qxx_CRC32C(0, neu, newSize));
+}
+static uint8_t *Ota_Load(const char *path, uint32_t *size)											/* Whole file (NULL : error) */
+{
+	FILE *f = fopen(path, "rb");
+	uint8_t *data = NULL;
+	long len = 0;
+
+	if (f == NULL) return NULL;
+	if (fseek(f, 0, SEEK_END) == 0) len = ftell(f);
+	if (len >= 0 && fseek(f, 0, SEEK_SET) == 0) data = (uint8_t *)malloc(len ? (size_t)len : 1);
+	if (data != NULL && fread(data, 1, (size_t)len, f) != (size_t)len)
+	{
+		free(data);
+		data = NULL;
+	}
+	fclose(f);
+	*size = (uint32_t)len;
+	return data;
+}
+static int Ota_Save(const char *path, const uint8_t *data, uint32_t size)							/* Write file (0 : ok) */
+{
+	FILE *f = fopen(path, "wb");
+	int ret = 1;
+
+	if (f == NULL) return 1;
+	if (fwrite(data, 1, size, f) == size) ret = 0;
+	if (fclose(f) != 0) ret = 1;
+	return ret;
+}
+static void Ota_Chip(W25Qxx_ERR *err)																/* Empty W25Q64, slot A, B and meta sectors */
+{
+	W25Qxx_EMU_Init(&emu, W25Q64, OTA_CLKHZ, err);
+	if (*err != W25Qxx_ERR_NONE) return;
+	W25Qxx_EMU_Port(&emu, &dev.port);
+	W25Qxx_config(&dev, err);
+	if (*err != W25Qxx_ERR_NONE) return;
+	W25Qxx_OTA_Mount(&ota, &dev, 0, OTA_SLOTSECTOR, OTA_SLOTSECTOR, 2 * OTA_SLOTSECTOR, err);
+}
+static void Ota_Update(const OTA_PATCH_t *p, uint64_t *ns, W25Qxx_ERR *err)							/* Patch in pieces of OTA_PIECE Byte, emulator time of the update */
+{
+	uint64_t t0 = W25Qxx_EMU_Now;
+	uint32_t num = 0;
+	uint32_t i = 0;
+
+	W25Qxx_OTA_Begin(&ota, err);
+	for (i = 0; i < p->size && *err == W25Qxx_ERR_NONE; i += num)
+	{
+		num = (p->size - i > OTA_PIECE) ? OTA_PIECE : p->size - i;
+		W25Qxx_OTA_Patch(&ota, p->data + i, num, err);
+	}
+	if (*err == W25Qxx_ERR_NONE) W25Qxx_OTA_End(&ota, err);
+	*ns = W25Qxx_EMU_Now - t0;
+}
+static void Ota_Install(const uint8_t *old, uint32_t size, W25Qxx_ERR *err)						/* old image in both slots (the update writes over the previous image) */
+{
+	OTA_PATCH_t full;
+	uint64_t ns = 0;
+	uint32_t i = 0;
+
+	Ota_Diff(NULL, 0, old, size, &full);
+	for (i = 0; i < 2 && *err == W25Qxx_ERR_NONE; i++) Ota_Update(&full, &ns, err);
+	free(full.data);
+}
+static void Ota_Active(uint8_t *buf, W25Qxx_ERR *err)												/* Read the active image */
+{
+	W25Qxx_Read_Start(&dev, ota.slotSector[ota.active] * W25Qxx_SECTORSIZE, err);
+	if (*err != W25Qxx_ERR_NONE) return;
+	W25Qxx_Read_Stream(&dev, buf, ota.size);
+	W25Qxx_Read_Stop(&dev);
+}
+static uint8_t Ota_Check(const uint8_t *neu, uint32_t size, uint8_t *buf, W25Qxx_ERR *err)		/* Active slot is the new image (1 : equal) */
+{
+	if (ota.size != size || !W25Qxx_OTA_Verify(&ota, err)) return 0;
+	Ota_Active(buf, err);
+	return (*err == W25Qxx_ERR_NONE && memcmp(buf, neu, size) == 0);
+}
+static void Ota_Image(uint8_t *img, uint32_t size)													/* Synthetic firmware : code and 32 bit address constants every 64 Byte */
+{
+	uint32_t i = 0;
+
+	for (i = 0; i < size; i++) img[i] = (uint8_t)Ota_Rand();
+	for (i = 0; i + 4 <= size; i += 64) W25Qxx_Put32(img + i, 0x08000000u + (Ota_Rand() % size & ~3u));
+}
+static int Ota_Bench(uint8_t quick)																	/* Update cost of the scenarios */
+{
+	static const char *name[] = { "full", "same", "bytes", "insert", "relink" };
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	OTA_PATCH_t p;
+	uint32_t size = quick ? OTA_BENCHSIZE / 4 : OTA_BENCHSIZE;
+	uint32_t newSize = 0;
+	uint8_t *old = (uint8_t *)malloc(size);
+	uint8_t *neu = (uint8_t *)malloc(size + 512);
+	uint8_t *buf = (uint8_t *)malloc(size + 512);
+	uint64_t ns = 0;
+	uint32_t s = 0;
+	uint32_t i = 0;
+	int ret = 0;
+
+	if (old == NULL || neu == NULL || buf == NULL) return 1;
+	Ota_Image(old, size);
+
+	printf("scenario,image,patch,literal,delta_nonzero,update_ms,programmed,erased,skipped\n");
+	for (s = 0; s < sizeof(name) / sizeof(name[0]); s++)
+	{
+		/* the new image */
+		memcpy(neu, old, size);
+		newSize = size;
+		if (s == 2)
+		{
+			for (i = 0; i < 16; i++) neu[Ota_Rand() % size] ^= (uint8_t)(1 + Ota_Rand() % 255);
+		}
+		else if (s == 3)
+		{
+			memmove(neu + size / 4 + 512, neu + size / 4, size - size / 4);
+			for (i = 0; i < 512; i++) neu[size / 4 + i] = (uint8_t)Ota_Rand();
+			newSize = size + 512;
+		}
+		else if (s == 4)
+		{
+			for (i = size / 2; i + 4 <= size; i += 64) W25Qxx_Put32(neu + i, W25Qxx_Get32(neu + i) + 0x100);
+		}
+
+		/* first install on an empty chip, else update of the installed old image */
+		Ota_Chip(&err);
+		if (err == W25Qxx_ERR_NONE && s != 0) Ota_Install(old, size, &err);
+		if (err != W25Qxx_ERR_NONE) return 1;
+		if (s == 0) Ota_Diff(NULL, 0, neu, newSize, &p);
+		else        Ota_Diff(old, size, neu, newSize, &p);
+		Ota_Update(&p, &ns, &err);
+		if (err != W25Qxx_ERR_NONE || !Ota_Check(neu, newSize, buf, &err))
+		{
+			fprintf(stderr, "%s : update failed, err %d\n", name[s], err);
+			ret = 1;
+		}
+
+		printf("%s,%u,%u,%u,%u,%.1f,%u,%u,%u\n", name[s], newSize, p.size, p.numLiteral, p.numNonZero,
+		       ns / 1e6, ota.numProgram, ota.numErase, ota.numSkip);
+		free(p.data);
+		W25Qxx_EMU_DeInit(&emu);
+	}
+
+	free(old);
+	free(neu);
+	free(buf);
+	return ret;
+}
+/* Main */
+int main(int argc, char *argv[])
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	OTA_PATCH_t p;
+	uint8_t *old = NULL;
+	uint8_t *neu = NULL;
+	uint8_t *buf = NULL;
+	uint32_t oldSize = 0;
+	uint32_t newSize = 0;
+	uint64_t ns = 0;
+	int ret = 0;
+
+	if (argc >= 2 && strcmp(argv[1], "bench") == 0)
+	{
+		return Ota_Bench(argc >= 3 && strcmp(argv[2], "quick") == 0);
+	}
+	if (argc == 5 && strcmp(argv[1], "diff") == 0)
+	{
+		old = Ota_Load(argv[2], &oldSize);
+		neu = Ota_Load(argv[3], &newSize);
+		if (old == NULL || neu == NULL)
+		{
+			fprintf(stderr, "%s : cannot read %s\n", argv[0], old == NULL ? argv[2] : argv[3]);
+			return 1;
+		}
+		Ota_Diff(old, oldSize, neu, newSize, &p);
+		ret = Ota_Save(argv[4], p.data, p.size);
+		printf("image %u patch %u literal %u delta %u delta_nonzero %u\n", newSize, p.size, p.numLiteral, p.numDelta, p.numNonZero);
+		free(p.data);
+		free(old);
+		free(neu);
+		return ret;
+	}
+	if ((argc == 4 || argc == 5) && strcmp(argv[1], "apply") == 0)
+	{
+		old = Ota_Load(argv[2], &oldSize);
+		memset(&p, 0, sizeof(p));
+		p.data = Ota_Load(argv[3], &p.size);
+		if (old == NULL || p.data == NULL)
+		{
+			fprintf(stderr, "%s : cannot read %s\n", argv[0], old == NULL ? argv[2] : argv[3]);
+			return 1;
+		}
+		Ota_Chip(&err);
+		if (err == W25Qxx_ERR_NONE && oldSize) Ota_Install(old, oldSize, &err);
+		if (err == W25Qxx_ERR_NONE) Ota_Update(&p, &ns, &err);
+		if (err != W25Qxx_ERR_NONE)
+		{
+			fprintf(stderr, "%s : update failed, err %d\n", argv[0], err);
+			return 1;
+		}
+		printf("image %u update %.1f ms programmed %u erased %u skipped %u\n", ota.size, ns / 1e6, ota.numProgram, ota.numErase, ota.numSkip);
+
+		/* the new image */
+		if (argc == 5)
+		{
+			buf = (uint8_t *)malloc(ota.size ? ota.size : 1);
+			if (buf != NULL) Ota_Active(buf, &err);
+			ret = (buf == NULL || err != W25Qxx_ERR_NONE) ? 1 : Ota_Save(argv[4], buf, ota.size);
+			free(buf);
+		}
+		W25Qxx_EMU_DeInit(&emu);
+		free(p.data);
+		free(old);
+		return ret;
+	}
+
+	fprintf(stderr, "usage : %s diff <old.bin> <new.bin> <patch.bin>\n", argv[0]);
+	fprintf(stderr, "        %s apply <old.bin> <patch.bin> [new.bin]\n", argv[0]);
+	fprintf(stderr, "        %s bench [quick]\n", argv[0]);
+	return 2;
+}
@@ -0,0 +1,210 @@
+/**
+  * @file  : powercut.c
+  * @brief : W25Qxx power-cut fuzz of W25Qxx_Atomic_Program on the emulated chip (host)
+  *
+  * Build : cc -O2 -o powercut powercut.c W25Qxx.c W25Qxx_Emu.c W25Qxx_Atomic.c W25Qxx_CRC.c
+  * Usage : powercut [plain] [writes [seed]]
+  *
+  *         writes : random writes over PCUT_SECTOR sectors (default 3000), every other one followed
+  *                  by W25Qxx_Atomic_Idle until the scratch sector is erased, two of three are cut
+  *                  after a random number of SPI bytes, then W25Qxx_EMU_PowerCycle, W25Qxx_config
+  *                  and W25Qxx_Atomic_Mount
+  *         seed   : random seed (default 1)
+  *         plain  : the same fuzz on W25Qxx_Program, to see the torn sectors it leaves
+  *
+  * After every cut each sector must read as the data before or after the write, a sector
+  * that is neither is torn. The last lines are the emulator time per write of
+  * W25Qxx_Atomic_Program (with and without W25Qxx_Atomic_Idle between the writes) against
+  * W25Qxx_Program. Exit code 1 : torn sector or driver error.
+  */
+#include "W25Qxx.h"
+#include "W25Qxx_Emu.h"
+#include "W25Qxx_Atomic.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#define PCUT_CLKHZ          50000000					/* Emulated SPI clock */
+#define PCUT_SECTOR         4							/* Sectors written by the fuzz (from sector 0) */
+#define PCUT_SCRATCH        100							/* Scratch sector of W25Qxx_Atomic_Mount */
+#define PCUT_RECORD         101							/* Record sector of W25Qxx_Atomic_Mount */
+#define PCUT_MAXWRITE       6000						/* Largest write (Byte), crosses up to 3 sectors */
+#define PCUT_MAXCUT         40000						/* Cut point : 1 - PCUT_MAXCUT SPI bytes into the write */
+#define PCUT_SIZE           (PCUT_SECTOR * W25Qxx_SECTORSIZE)
+
+static W25Qxx_EMU_t emu;
+static W25Qxx_t dev;
+static W25Qxx_ATOMIC_t at;
+static jmp_buf cutJmp;
+static uint8_t (*cutRW)(uint8_t data);					/* Emulator spi_rw */
+static uint32_t cutByte = 0;							/* SPI bytes to the cut (0 : no cut) */
+static uint32_t seed = 1;
+static uint8_t ref[PCUT_SIZE];							/* Data before the write */
+static uint8_t want[PCUT_SIZE];							/* Data after the write */
+static uint8_t buf[PCUT_MAXWRITE];
+
+static uint32_t Pcut_Rand(void)																		/* xorshift32 */
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+static uint8_t Pcut_RW(uint8_t data)																/* spi_rw with power cut */
+{
+	if (cutByte && --cutByte == 0) longjmp(cutJmp, 1);
+	return cutRW(data);
+}
+static void Pcut_Write(uint8_t plain, uint32_t addr, uint32_t size, W25Qxx_ERR *err)				/* Write under test */
+{
+	if (plain) W25Qxx_Program(&dev, buf, addr, size, err);
+	else       W25Qxx_Atomic_Program(&at, buf, addr, size, err);
+}
+static void Pcut_Idle(W25Qxx_ERR *err)																/* Scratch sector erased in idle time */
+{
+	do
+	{
+		W25Qxx_Atomic_Idle(&at, err);
+	} while (*err == W25Qxx_ERR_NONE && at.erased == 0);
+}
+static int Pcut_Fuzz(uint32_t writes, uint8_t plain)												/* Random writes with power cuts, check every sector */
+{
+	/* volatile : kept across the longjmp of the cut */
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	volatile uint32_t cuts = 0;
+	volatile uint32_t torn = 0;
+	volatile uint32_t old = 0;
+	volatile uint32_t neu = 0;
+	volatile uint32_t recovered = 0;
+	volatile uint32_t stale = 0;
+	volatile uint32_t size = 0;
+	volatile uint32_t i = 0;
+	uint32_t addr = 0;
+	uint32_t s = 0;
+
+	memset(ref, 0xFF, sizeof(ref));
+	for (i = 0; i < writes; i++)
+	{
+		addr = Pcut_Rand() % (PCUT_SIZE - 1);
+		size = 1 + Pcut_Rand() % PCUT_MAXWRITE;
+		if (addr + size > PCUT_SIZE) size = PCUT_SIZE - addr;
+		for (s = 0; s < size; s++) buf[s] = (uint8_t)Pcut_Rand();
+		memcpy(want, ref, sizeof(want));
+		memcpy(want + addr, buf, size);
+
+		/* write and every other time the idle erase of the scratch sector, two of three are cut */
+		cutByte = (Pcut_Rand() % 3) ? 1 + Pcut_Rand() % PCUT_MAXCUT : 0;
+		if (setjmp(cutJmp) == 0)
+		{
+			Pcut_Write(plain, addr, size, &err);
+			if (err == W25Qxx_ERR_NONE && !plain && (i & 1)) Pcut_Idle(&err);
+			cutByte = 0;
+			if (err != W25Qxx_ERR_NONE)
+			{
+				fprintf(stderr, "write %u : err %d\n", i, err);
+				return 1;
+			}
+			memcpy(ref, want, sizeof(ref));
+			continue;
+		}
+
+		/* power loss, the next boot */
+		cutByte = 0;
+		cuts++;
+		W25Qxx_EMU_PowerCycle(&emu);
+		W25Qxx_config(&dev, &err);
+		if (err == W25Qxx_ERR_NONE && !plain) W25Qxx_Atomic_Mount(&at, &dev, PCUT_SCRATCH, PCUT_RECORD, &err);
+		if (err != W25Qxx_ERR_NONE)
+		{
+			fprintf(stderr, "write %u : boot err %d\n", i, err);
+			return 1;
+		}
+		if (!plain) recovered += at.numRecover;
+		if (!plain) stale += at.numStale;
+
+		/* every sector has the old or the new data */
+		for (s = 0; s < PCUT_SECTOR; s++)
+		{
+			W25Qxx_Read(&dev, buf, s * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE, &err);
+			if (err != W25Qxx_ERR_NONE) return 1;
+
+			if (memcmp(buf, want + s * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE) == 0)
+			{
+				if (memcmp(ref + s * W25Qxx_SECTORSIZE, buf, W25Qxx_SECTORSIZE) != 0) neu++;
+			}
+			else if (memcmp(buf, ref + s * W25Qxx_SECTORSIZE, W25Qxx_SECTORSIZE) == 0)
+			{
+				old++;
+			}
+			else
+			{
+				torn++;
+				if (torn <= 8) printf("write %u : sector %u torn\n", i, s);
+			}
+			memcpy(ref + s * W25Qxx_SECTORSIZE, buf, W25Qxx_SECTORSIZE);
+		}
+	}
+
+	printf("%s : writes %u cuts %u torn %u old %u new %u recovered %u stale %u\n",
+	       plain ? "W25Qxx_Program" : "W25Qxx_Atomic_Program", writes, cuts, torn, old, neu, recovered, stale);
+
+	return torn ? 1 : 0;
+}
+static void Pcut_Cost(uint8_t plain, uint8_t idle)													/* Emulator time per 512 Byte write into a written sector (idle : not counted) */
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	uint64_t total = 0;
+	uint64_t t0 = 0;
+	uint32_t i = 0;
+
+	for (i = 0; i < 20; i++)
+	{
+		memset(buf, (uint8_t)(i + plain + idle), 512);
+		t0 = W25Qxx_EMU_Now;
+		Pcut_Write(plain, (i % PCUT_SECTOR) * W25Qxx_SECTORSIZE + 100, 512, &err);
+		total += W25Qxx_EMU_Now - t0;
+		if (err == W25Qxx_ERR_NONE && idle) Pcut_Idle(&err);
+		if (err != W25Qxx_ERR_NONE) exit(1);
+	}
+
+	printf("%s : %.1f ms/write%s\n", plain ? "W25Qxx_Program" : "W25Qxx_Atomic_Program", total / 20 / 1e6,
+	       idle ? " (scratch sector erased in idle time)" : "");
+}
+/* Main */
+int main(int argc, char *argv[])
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	uint32_t writes = 3000;
+	uint8_t plain = 0;
+	uint8_t num = 0;
+	int ret = 0;
+	int i = 0;
+
+	for (i = 1; i < argc; i++)
+	{
+		if      (strcmp(argv[i], "plain") == 0) plain = 1;
+		else if (num++ == 0)                    writes = (uint32_t)strtoul(argv[i], NULL, 0);
+		else                                    seed = (uint32_t)strtoul(argv[i], NULL, 0);
+	}
+	if (seed == 0) seed = 1;
+
+	W25Qxx_EMU_Init(&emu, W25Q64, PCUT_CLKHZ, &err);
+	if (err != W25Qxx_ERR_NONE) return 1;
+	W25Qxx_EMU_Port(&emu, &dev.port);
+	cutRW = dev.port.spi_rw;
+	dev.port.spi_rw = Pcut_RW;
+	W25Qxx_config(&dev, &err);
+	if (err == W25Qxx_ERR_NONE) W25Qxx_Atomic_Mount(&at, &dev, PCUT_SCRATCH, PCUT_RECORD, &err);
+	if (err != W25Qxx_ERR_NONE) return 1;
+
+	ret = Pcut_Fuzz(writes, plain);
+
+	/* throughput cost */
+	Pcut_Cost(0, 1);
+	Pcut_Cost(0, 0);
+	Pcut_Cost(1, 0);
+
+	W25Qxx_EMU_DeInit(&emu);
+	return ret;
+}
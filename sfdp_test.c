@@ -0,0 +1,260 @@
+/**
+  * @file  : sfdp_test.c
+  * @brief : W25Qxx_QuerySFDP test with SFDP dumps fed through the emulated chip (host)
+  *
+  * Build : set W25QXX_SUPPORT_SFDP 1 in W25Qxx.h
+  *         cc -O2 -o sfdp_test sfdp_test.c W25Qxx.c W25Qxx_Emu.c
+  * Usage : sfdp_test
+  *         sfdp_test dump <sfdp.bin> [chip]
+  *         sfdp_test save <sfdp.bin> [chip]
+  *
+  *         (none) : run the fixtures below, every one is the SFDP table of the emulated chip
+  *                  (JESD216B, 16 DWORDs, 4 Byte address instruction table > 16MB) with a few
+  *                  bytes patched to the layout of an older or different chip
+  *         dump   : load a 256 Byte SFDP dump (W25Qxx_Read_SFDP 0x00 - 0xFF of a real chip) into
+  *                  emu.sfdp of the emulated chip (default W25Q128) and print the parsed parameter
+  *         save   : write emu.sfdp of the emulated chip, the start of a new fixture
+  *
+  * Every fixture checks W25Qxx_config (error, geometry, max time) and dev->sfdp against the
+  * expected values, then programs, erases and reads the top of the chip and across 16MB.
+  * Exit code 1 : a fixture does not match.
+  */
+#include "W25Qxx.h"
+#include "W25Qxx_Emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !W25QXX_SUPPORT_SFDP
+#error "sfdp_test needs W25QXX_SUPPORT_SFDP 1 in W25Qxx.h"
+#endif
+
+#define SFDP_CLKHZ          50000000					/* Emulated SPI clock */
+#define SFDP_MAXPATCH       6							/* Patched bytes per fixture */
+
+typedef struct
+{
+	const char *name;
+	W25Qxx_CHIP chip;									/* Emulated chip */
+	uint32_t IDJEDEC;									/* JEDEC ID (0 : the emulated chip) */
+	uint8_t numPatch;
+	struct { uint8_t addr; uint8_t data; } patch[SFDP_MAXPATCH];
+	/* expected */
+	W25Qxx_ERR err;										/* W25Qxx_config */
+	uint8_t rev;										/* SFDP revision major << 4 | minor (0 : no SFDP, the chip list) */
+	uint8_t numDword;
+	uint32_t sizeChip;
+	uint8_t addr4B;
+	uint8_t cmdErase4B;									/* 4 Byte address sector erase */
+	uint32_t EraseMaxTimeSector;						/* ms */
+} SFDP_FIXTURE_t;
+
+static const SFDP_FIXTURE_t Fixture[] = {
+	/* the emulated chip as is, max time of DWORD10/11 */
+	{ "W25Q16",                W25Q16,  0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x0200000, 0, 0x00, 480 },
+	{ "W25Q64",                W25Q64,  0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x0800000, 0, 0x00, 480 },
+	{ "W25Q128",               W25Q128, 0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x1000000, 0, 0x00, 480 },
+	{ "W25Q256",               W25Q256, 0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x2000000, 1, 0x21, 480 },
+	{ "W25Q512",               W25Q512, 0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x4000000, 1, 0x21, 480 },
+	{ "W25Q01",                W25Q01,  0, 0, { { 0 } },                                        W25Qxx_ERR_NONE,         0x16, 16, 0x8000000, 1, 0x21, 480 },
+	/* no signature : the chip list */
+	{ "no signature",          W25Q256, 0, 1, { { 0x00, 0x00 } },                               W25Qxx_ERR_NONE,         0x00,  0, 0x2000000, 0, 0x00, 400 },
+	/* JESD216 : 9 DWORDs, no 4 Byte address instruction table, time of the chip list */
+	{ "JESD216 9 DWORDs",      W25Q256, 0, 4, { { 0x04, 0x00 }, { 0x06, 0x00 },
+	                                            { 0x09, 0x00 }, { 0x0B, 0x09 } },               W25Qxx_ERR_NONE,         0x10,  9, 0x2000000, 0, 0x00, 400 },
+	/* JESD216B : no 4 Byte address instruction table, DWORD16 dedicated 4 Byte instruction set */
+	{ "DWORD16 4B set",        W25Q256, 0, 5, { { 0x06, 0x00 }, { 0xBC, 0x00 }, { 0xBD, 0x50 },
+	                                            { 0xBE, 0x00 }, { 0xBF, 0x21 } },               W25Qxx_ERR_NONE,         0x16, 16, 0x2000000, 1, 0x21, 480 },
+	/* JESD216B : extended address register only */
+	{ "DWORD16 no 4B set",     W25Q256, 0, 5, { { 0x06, 0x00 }, { 0xBC, 0x00 }, { 0xBD, 0x10 },
+	                                            { 0xBE, 0x00 }, { 0xBF, 0x00 } },               W25Qxx_ERR_NONE,         0x16, 16, 0x2000000, 0, 0x00, 480 },
+	/* erase type 1 is 64KB : no 4KB erase, the chip list */
+	{ "no 4KB erase",          W25Q256, 0, 2, { { 0x9C, 0x10 }, { 0x9D, 0xD8 } },               W25Qxx_ERR_NONE,         0x16, 16, 0x2000000, 0, 0x00, 400 },
+	/* JEDEC ID not in the chip list : geometry and time of SFDP */
+	{ "JEDEC not in list",     W25Q256, 0xEF4099, 0, { { 0 } },                                 W25Qxx_ERR_NONE,         0x16, 16, 0x2000000, 1, 0x21, 480 },
+	/* JEDEC ID not in the chip list, JESD216 has no time */
+	{ "not in list, JESD216",  W25Q256, 0xEF4099, 2, { { 0x06, 0x00 }, { 0x0B, 0x09 } },       W25Qxx_ERR_CHIPNOTFOUND, 0x16,  9, 0,         0, 0x00, 0   },
+};
+
+static W25Qxx_EMU_t emu;
+static W25Qxx_t dev;
+static uint8_t wbuf[W25Qxx_SECTORSIZE];
+static uint8_t rbuf[W25Qxx_SECTORSIZE];
+
+static const struct { const char *name; W25Qxx_CHIP type; } SfdpChip[] = {
+	{ "W25Q16", W25Q16 }, { "W25Q32", W25Q32 }, { "W25Q64", W25Q64 }, { "W25Q128", W25Q128 },
+	{ "W25Q256", W25Q256 }, { "W25Q512", W25Q512 }, { "W25Q01", W25Q01 }, { "W25Q02", W25Q02 },
+};
+static W25Qxx_CHIP Sfdp_Chip(const char *name)
+{
+	uint8_t c = 0;
+
+	for (c = 0; c < sizeof(SfdpChip) / sizeof(SfdpChip[0]); c++)
+	{
+		if (strcmp(name, SfdpChip[c].name) == 0) return SfdpChip[c].type;
+	}
+	return UNKNOWN;
+}
+static void Sfdp_Print(const char *name, W25Qxx_ERR err)											/* Parsed parameter */
+{
+	const W25Qxx_SFDP_t *sfdp = &dev.sfdp;
+	uint8_t i = 0;
+
+	printf("%-22s : err %d size %u page %u sector %u die %u | max time page %ums sector %ums block32 %ums block64 %ums chip %ums\n",
+	       name, err, dev.sizeChip, dev.sizePage, dev.numSector, dev.numDie, dev.info.ProgrMaxTimePage,
+	       dev.info.EraseMaxTimeSector, dev.info.EraseMaxTimeBlock32, dev.info.EraseMaxTimeBlock64, dev.info.EraseMaxTimeChip);
+	printf("%-22s   SFDP %u.%u %u DWORDs address %u 4B %u (%02X/%02X/%02X)", "",
+	       sfdp->revMajor, sfdp->revMinor, sfdp->numDword, sfdp->addrBytes, sfdp->addr4B,
+	       sfdp->cmdRead4B, sfdp->cmdFastRead4B, sfdp->cmdProgram4B);
+	for (i = 0; i < 4; i++)
+	{
+		if (sfdp->erase[i].size) printf(" erase %uKB %02X/%02X", sfdp->erase[i].size >> 10, sfdp->erase[i].cmd, sfdp->erase[i].cmd4B);
+	}
+	if (sfdp->fastRead != W25QXX_SFDP_NONE)
+	{
+		printf(" fast read %02X dummy %u mode %u", sfdp->read[sfdp->fastRead].cmd,
+		       sfdp->read[sfdp->fastRead].numDummy, sfdp->read[sfdp->fastRead].numMode);
+	}
+	printf("\n");
+}
+static int Sfdp_Access(void)																		/* Program, erase and read with the parsed parameter (0 : ok) */
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	uint32_t addr[3] = { 0 };
+	uint32_t i = 0;
+	uint8_t k = 0;
+
+	/* top of the chip, across 16MB (3 Byte address and extended address register / 4 Byte address), the middle */
+	addr[0] = dev.sizeChip - 2 * W25Qxx_SECTORSIZE;
+	addr[1] = (dev.sizeChip > 0x1000000) ? 0x1000000 - W25Qxx_SECTORSIZE : 2 * W25Qxx_SECTORSIZE;
+	addr[2] = dev.sizeChip / 2;
+
+	for (k = 0; k < 3; k++)
+	{
+		for (i = 0; i < W25Qxx_SECTORSIZE; i++) wbuf[i] = (uint8_t)(i * 7 + k + (addr[k] >> 12));
+
+		W25Qxx_Erase_Sector(&dev, addr[k] / W25Qxx_SECTORSIZE, &err);
+		if (err == W25Qxx_ERR_NONE) W25Qxx_Erase_Sector(&dev, addr[k] / W25Qxx_SECTORSIZE + 1, &err);
+		if (err == W25Qxx_ERR_NONE) W25Qxx_DIR_Program(&dev, wbuf, addr[k] + W25Qxx_SECTORSIZE / 2, W25Qxx_SECTORSIZE, &err);
+		if (err == W25Qxx_ERR_NONE) W25Qxx_Read(&dev, rbuf, addr[k] + W25Qxx_SECTORSIZE / 2, W25Qxx_SECTORSIZE, &err);
+		if (err != W25Qxx_ERR_NONE || memcmp(wbuf, rbuf, W25Qxx_SECTORSIZE) != 0) return 1;
+
+		/* erase the 32KB block with the programmed data */
+		W25Qxx_Erase_Block32(&dev, (addr[k] + W25Qxx_SECTORSIZE / 2) / (W25Qxx_BLOCKSIZE / 2), &err);
+		if (err == W25Qxx_ERR_NONE) W25Qxx_Read(&dev, rbuf, (addr[k] + W25Qxx_SECTORSIZE / 2) & ~(W25Qxx_BLOCKSIZE / 2 - 1), W25Qxx_PAGESIZE, &err);
+		if (err != W25Qxx_ERR_NONE) return 1;
+		for (i = 0; i < W25Qxx_PAGESIZE; i++)
+		{
+			if (rbuf[i] != 0xFF) return 1;
+		}
+	}
+
+	return 0;
+}
+static int Sfdp_Fixture(const SFDP_FIXTURE_t *fix)													/* Run a fixture (0 : pass) */
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	uint8_t rev = 0;
+	uint8_t i = 0;
+	int fail = 0;
+
+	W25Qxx_EMU_Init(&emu, fix->chip, SFDP_CLKHZ, &err);
+	if (err != W25Qxx_ERR_NONE) return 1;
+	if (fix->IDJEDEC) emu.IDJEDEC = fix->IDJEDEC;
+	for (i = 0; i < fix->numPatch; i++) emu.sfdp[fix->patch[i].addr] = fix->patch[i].data;
+
+	memset(&dev, 0, sizeof(dev));
+	W25Qxx_EMU_Port(&emu, &dev.port);
+	W25Qxx_config(&dev, &err);
+	Sfdp_Print(fix->name, err);
+
+	rev = (uint8_t)(dev.sfdp.revMajor << 4 | dev.sfdp.revMinor);
+	if (err != fix->err || rev != fix->rev || dev.sfdp.numDword != fix->numDword) fail = 1;
+	if (err == W25Qxx_ERR_NONE)
+	{
+		if (dev.sizeChip != fix->sizeChip || dev.sfdp.addr4B != fix->addr4B || dev.sfdp.erase[0].cmd4B != fix->cmdErase4B) fail = 1;
+		if (dev.info.EraseMaxTimeSector != fix->EraseMaxTimeSector) fail = 1;
+		if (!fail && Sfdp_Access()) fail = 2;
+	}
+	if (fail) printf("%-22s   FAIL (%s)\n", "", (fail == 2) ? "program/erase/read" : "parameter");
+
+	W25Qxx_EMU_DeInit(&emu);
+	return fail;
+}
+static int Sfdp_Dump(const char *file, W25Qxx_CHIP type, uint8_t save)								/* Parse or save a 256 Byte SFDP dump */
+{
+	W25Qxx_ERR err = W25Qxx_ERR_NONE;
+	FILE *f = NULL;
+	size_t n = 0;
+	int ret = 0;
+
+	W25Qxx_EMU_Init(&emu, type, SFDP_CLKHZ, &err);
+	if (err != W25Qxx_ERR_NONE) return 1;
+
+	f = fopen(file, save ? "wb" : "rb");
+	if (f == NULL)
+	{
+		perror(file);
+		W25Qxx_EMU_DeInit(&emu);
+		return 1;
+	}
+	if (save)
+	{
+		n = fwrite(emu.sfdp, 1, sizeof(emu.sfdp), f);
+		printf("%s : %u bytes\n", file, (unsigned)n);
+		ret = (n == sizeof(emu.sfdp)) ? 0 : 1;
+		fclose(f);
+		W25Qxx_EMU_DeInit(&emu);
+		return ret;
+	}
+
+	/* the bytes after a short dump read as 0xFF */
+	memset(emu.sfdp, 0xFF, sizeof(emu.sfdp));
+	n = fread(emu.sfdp, 1, sizeof(emu.sfdp), f);
+	fclose(f);
+
+	memset(&dev, 0, sizeof(dev));
+	W25Qxx_EMU_Port(&emu, &dev.port);
+	W25Qxx_config(&dev, &err);
+	Sfdp_Print(file, err);
+	if (err == W25Qxx_ERR_NONE && dev.sizeChip <= emu.sizeChip)
+	{
+		ret = Sfdp_Access();
+		printf("%-22s   program/erase/read %s\n", "", ret ? "FAIL" : "ok");
+	}
+	else
+	{
+		ret = 1;
+	}
+	printf("%-22s   %u bytes, chip list %s\n", "", (unsigned)n, (dev.info.type == UNKNOWN) ? "no" : "yes");
+
+	W25Qxx_EMU_DeInit(&emu);
+	return ret;
+}
+/* Main */
+int main(int argc, char *argv[])
+{
+	W25Qxx_CHIP type = W25Q128;
+	uint8_t numFail = 0;
+	uint8_t i = 0;
+
+	if (argc >= 3 && (strcmp(argv[1], "dump") == 0 || strcmp(argv[1], "save") == 0))
+	{
+		if (argc >= 4) type = Sfdp_Chip(argv[3]);
+		if (type != UNKNOWN) return Sfdp_Dump(argv[2], type, strcmp(argv[1], "save") == 0);
+	}
+	if (argc == 1)
+	{
+		for (i = 0; i < sizeof(Fixture) / sizeof(Fixture[0]); i++)
+		{
+			if (Sfdp_Fixture(&Fixture[i])) numFail++;
+		}
+		printf("%u fixtures, %u failed\n", (unsigned)(sizeof(Fixture) / sizeof(Fixture[0])), numFail);
+		return numFail ? 1 : 0;
+	}
+
+	fprintf(stderr, "usage : %s\n", argv[0]);
+	fprintf(stderr, "        %s dump <sfdp.bin> [chip]\n", argv[0]);
+	fprintf(stderr, "        %s save <sfdp.bin> [chip]\n", argv[0]);
+	return 2;
+}
@@ -0,0 +1,433 @@
+/**
+  * @file  : trace_tool.c
+  * @brief : W25Qxx SPI transaction trace decoder and replay (host)
+  *
+  * Build : cc -O2 -o trace_tool trace_tool.c W25Qxx.c W25Qxx_Emu.c W25Qxx_Trace.c
+  * Usage : trace_tool decode <trace.bin> [list]
+  *         trace_tool replay <trace.bin> <chip> [clkHz]
+  *         trace_tool record <trace.bin> [chip] [ringsize]
+  *
+  *         decode : command time per class (bus time of the transactions, BUSY time from the end
+  *                  of a program/erase/status write to the first status read with BUSY = 0)
+  *         list   : also print every transaction
+  *         replay : run the transactions on the emulated chip with the recorded gaps, a status
+  *                  read that saw BUSY = 0 on the target is repeated until the emulated chip is
+  *                  idle, the rest of the trace is shifted by the extra wait
+  *         record : sample workload on the emulated chip through W25Qxx_Trace_Attach, exported
+  *                  as the target would do (W25Qxx_Trace_Export)
+  *
+  * The trace file is the W25Qxx_Trace_Export output. Data bytes are not in the trace, the
+  * replay sends 0xFF after the recorded head bytes. The chip state before the first record
+  * (4 byte address mode, lock, data) is not in the trace, the emulated chip starts erased.
+  */
+#include "W25Qxx.h"
+#include "W25Qxx_Emu.h"
+#include "W25Qxx_Trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOOL_POLLNS         10000						/* Replay : interval of the repeated status read (ns) */
+#define TOOL_TIMEOUTNS      400000000000ULL				/* Replay : give up a status read after 400s */
+
+typedef enum
+{
+	CLS_READ = 0,
+	CLS_PROGRAM,
+	CLS_ERASE_SECTOR,
+	CLS_ERASE_BLOCK32,
+	CLS_ERASE_BLOCK64,
+	CLS_ERASE_CHIP,
+	CLS_SECURITY,
+	CLS_STATUS_READ,
+	CLS_STATUS_WRITE,
+	CLS_WRITE_ENABLE,
+	CLS_EXT_REGISTER,
+	CLS_IDENTIFY,
+	CLS_SFDP,
+	CLS_LOCK,
+	CLS_POWER,
+	CLS_SUSPEND,
+	CLS_RESET,
+	CLS_DIE_SELECT,
+	CLS_ADDR_MODE,
+	CLS_OTHER,
+	CLS_NUM,
+	CLS_NONE = 0xFF,
+} TOOL_CLASS;
+
+static const char *ClassName[CLS_NUM] = {
+	"Read", "Program", "Erase_Sector", "Erase_Block32", "Erase_Block64", "Erase_Chip", "Security",
+	"Status_Read", "Status_Write", "Write_Enable", "Ext_Register", "Identify", "SFDP", "Lock",
+	"Power", "Suspend_Resume", "Reset", "Die_Select", "Addr_Mode", "Other",
+};
+
+static const struct { uint8_t cmd; uint8_t cls; uint8_t addr; } CmdTable[] = {			/* addr : 3 = 3/4 byte by address mode, 4 = always 4 byte */
+	{ W25Q_CMD_READ,            CLS_READ,          3 }, { W25Q_CMD_FASTREAD,        CLS_READ,          3 },
+	{ W25Q_CMD_4BREAD,          CLS_READ,          4 }, { W25Q_CMD_4BFASTREAD,      CLS_READ,          4 },
+	{ W25Q_CMD_WPAGE,           CLS_PROGRAM,       3 }, { W25Q_CMD_4BWPAGE,         CLS_PROGRAM,       4 },
+	{ W25Q_CMD_ESECTOR,         CLS_ERASE_SECTOR,  3 }, { W25Q_CMD_4BESECTOR,       CLS_ERASE_SECTOR,  4 },
+	{ W25Q_CMD_E32KBLOCK,       CLS_ERASE_BLOCK32, 3 }, { W25Q_CMD_E64KBLOCK,       CLS_ERASE_BLOCK64, 3 },
+	{ W25Q_CMD_4BE64KBLOCK,     CLS_ERASE_BLOCK64, 4 }, { W25Q_CMD_ECHIP,           CLS_ERASE_CHIP,    0 },
+	{ 0x60,                     CLS_ERASE_CHIP,    0 }, { W25Q_CMD_ESECREG,         CLS_SECURITY,      3 },
+	{ W25Q_CMD_WSECREG,         CLS_SECURITY,      3 }, { W25Q_CMD_RSECREG,         CLS_SECURITY,      3 },
+	{ W25Q_CMD_RSREG1,          CLS_STATUS_READ,   0 }, { W25Q_CMD_RSREG2,          CLS_STATUS_READ,   0 },
+	{ W25Q_CMD_RSREG3,          CLS_STATUS_READ,   0 }, { W25Q_CMD_WSREG1,          CLS_STATUS_WRITE,  0 },
+	{ W25Q_CMD_WSREG2,          CLS_STATUS_WRITE,  0 }, { W25Q_CMD_WSREG3,          CLS_STATUS_WRITE,  0 },
+	{ W25Q_CMD_WEN,             CLS_WRITE_ENABLE,  0 }, { W25Q_CMD_WDEN,            CLS_WRITE_ENABLE,  0 },
+	{ W25Q_CMD_VOLATILESREN,    CLS_WRITE_ENABLE,  0 }, { W25Q_CMD_REXTREG,         CLS_EXT_REGISTER,  0 },
+	{ W25Q_CMD_WEXTREG,         CLS_EXT_REGISTER,  0 }, { W25Q_CMD_MANUFACTURER,    CLS_IDENTIFY,      0 },
+	{ W25Q_CMD_JEDECID,         CLS_IDENTIFY,      0 }, { W25Q_CMD_UNIQUEID,        CLS_IDENTIFY,      0 },
+	{ W25Q_CMD_RSFDP,           CLS_SFDP,          3 }, { W25Q_CMD_WALLBLOCKLOCK,   CLS_LOCK,          0 },
+	{ W25Q_CMD_WALLBLOCKUNLOCK, CLS_LOCK,          0 }, { W25Q_CMD_RBLOCKLOCK,      CLS_LOCK,          3 },
+	{ W25Q_CMD_WSIGBLOCKLOCK,   CLS_LOCK,          3 }, { W25Q_CMD_WSIGBLOCKUNLOCK, CLS_LOCK,          3 },
+	{ W25Q_CMD_POWEREN,         CLS_POWER,         0 }, { W25Q_CMD_POWERDEN,        CLS_POWER,         0 },
+	{ W25Q_CMD_EWSUSPEND,       CLS_SUSPEND,       0 }, { W25Q_CMD_EWRESUME,        CLS_SUSPEND,       0 },
+	{ W25Q_CMD_ENRESET,         CLS_RESET,         0 }, { W25Q_CMD_RESETDEV,        CLS_RESET,         0 },
+	{ W25Q_CMD_DIESELECT,       CLS_DIE_SELECT,    0 }, { W25Q_CMD_4ByteAddrEN,     CLS_ADDR_MODE,     0 },
+	{ W25Q_CMD_4ByteAddrDEN,    CLS_ADDR_MODE,     0 },
+};
+
+typedef struct
+{
+	uint32_t total;								/* Transactions of all classes */
+	uint32_t num[CLS_NUM];						/* Transactions */
+	uint64_t bytes[CLS_NUM];					/* SPI bytes */
+	uint64_t bus[CLS_NUM];						/* Bus time, CS low (us) */
+	uint64_t busy[CLS_NUM];						/* BUSY time after the command (us) */
+	uint64_t first;								/* Start of the first transaction (us) */
+	uint64_t last;								/* End of the last transaction (us) */
+	uint8_t pending;							/* Class of the running program/erase */
+	uint64_t pendingEnd;						/* End of the command of the running program/erase (us) */
+	uint8_t addr4;								/* 4 byte address mode */
+} TOOL_STAT_t;
+
+static uint8_t Tool_Class(uint8_t cmd, uint8_t *addr)												/* Command class and address size */
+{
+	uint8_t i = 0;
+
+	for (i = 0; i < sizeof(CmdTable) / sizeof(CmdTable[0]); i++)
+	{
+		if (CmdTable[i].cmd == cmd)
+		{
+			*addr = CmdTable[i].addr;
+			return CmdTable[i].cls;
+		}
+	}
+	*addr = 0;
+	return CLS_OTHER;
+}
+static void Tool_Account(TOOL_STAT_t *s, W25Qxx_TRACE_REC_t *rec, uint64_t start, uint64_t end, uint8_t miso)	/* Add one transaction */
+{
+	uint8_t addr = 0;
+	uint8_t cls = CLS_OTHER;
+
+	if (rec->numHead == 0) return;
+	cls = Tool_Class(rec->head[0], &addr);
+
+	if (s->total++ == 0) s->first = start;
+	s->num[cls]++;
+	s->bytes[cls] += rec->len;
+	s->bus[cls] += end - start;
+	s->last = end;
+
+	switch (cls)
+	{
+		case CLS_PROGRAM:
+		case CLS_ERASE_SECTOR:
+		case CLS_ERASE_BLOCK32:
+		case CLS_ERASE_BLOCK64:
+		case CLS_ERASE_CHIP:
+		case CLS_STATUS_WRITE:
+			s->pending = cls;
+			s->pendingEnd = end;
+			break;
+		case CLS_SECURITY:
+			if (rec->head[0] != W25Q_CMD_RSECREG)
+			{
+				s->pending = cls;
+				s->pendingEnd = end;
+			}
+			break;
+		case CLS_STATUS_READ:
+			if (rec->head[0] == W25Q_CMD_RSREG1 && rec->len >= 2 && (miso & 0x01) == 0 && s->pending != CLS_NONE)
+			{
+				s->busy[s->pending] += end - s->pendingEnd;
+				s->pending = CLS_NONE;
+			}
+			break;
+		case CLS_ADDR_MODE:
+			s->addr4 = rec->head[0] == W25Q_CMD_4ByteAddrEN;
+			break;
+		default:
+			break;
+	}
+}
+static void Tool_Print(TOOL_STAT_t *s, const char *title)											/* Time per class */
+{
+	uint8_t c = 0;
+	uint64_t bus = 0;
+	uint64_t busy = 0;
+
+	printf("%s : %.3f ms\n", title, (s->last - s->first) / 1e3);
+	printf("%-15s %8s %10s %12s %12s %10s\n", "class", "count", "bytes", "bus_us", "busy_us", "avg_us");
+	for (c = 0; c < CLS_NUM; c++)
+	{
+		if (s->num[c] == 0) continue;
+		printf("%-15s %8u %10llu %12llu %12llu %10.1f\n", ClassName[c], s->num[c], (unsigned long long)s->bytes[c],
+		       (unsigned long long)s->bus[c], (unsigned long long)s->busy[c], (double)(s->bus[c] + s->busy[c]) / s->num[c]);
+		bus += s->bus[c];
+		busy += s->busy[c];
+	}
+	printf("%-15s %8s %10s %12llu %12llu\n", "total", "", "", (unsigned long long)bus, (unsigned long long)busy);
+}
+static uint8_t *Tool_Load(const char *name, uint32_t *size)											/* Read trace file, check header */
+{
+	FILE *f = fopen(name, "rb");
+	uint8_t *p = NULL;
+	long n = 0;
+
+	if (f == NULL) return NULL;
+	fseek(f, 0, SEEK_END);
+	n = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (n >= W25QXX_TRACE_HDRSIZE) p = (uint8_t *)malloc((size_t)n);
+	if (p != NULL && fread(p, 1, (size_t)n, f) != (size_t)n)
+	{
+		free(p);
+		p = NULL;
+	}
+	fclose(f);
+	if (p == NULL) return NULL;
+
+	if ((p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24) != W25QXX_TRACE_MAGIC || p[4] != W25QXX_TRACE_VERSION || p[5] != W25QXX_TRACE_HEAD)
+	{
+		free(p);
+		return NULL;
+	}
+	*size = (uint32_t)n;
+	return p;
+}
+static void Tool_Init(TOOL_STAT_t *s)
+{
+	memset(s, 0, sizeof(TOOL_STAT_t));
+	s->pending = CLS_NONE;
+}
+static int Tool_Decode(const char *name, uint8_t list)												/* Decode trace */
+{
+	W25Qxx_TRACE_REC_t rec;
+	TOOL_STAT_t s;
+	uint8_t *p = NULL;
+	uint32_t size = 0;
+	uint32_t pos = W25QXX_TRACE_HDRSIZE;
+	uint32_t addr = 0;
+	uint64_t t = 0;
+	uint64_t start = 0;
+	uint8_t n = 0;
+	uint8_t na = 0;
+	uint8_t i = 0;
+
+	p = Tool_Load(name, &size);
+	if (p == NULL)
+	{
+		fprintf(stderr, "%s : not a W25Qxx trace\n", name);
+		return 1;
+	}
+	Tool_Init(&s);
+
+	printf("records %u dropped %u\n", p[8] | p[9] << 8 | p[10] << 16 | (uint32_t)p[11] << 24, p[12] | p[13] << 8 | p[14] << 16 | (uint32_t)p[15] << 24);
+	if (list) printf("%12s %-15s %4s %10s %8s %4s %8s\n", "start_us", "class", "cmd", "addr", "len", "miso", "time_us");
+	while (pos < size)
+	{
+		n = W25Qxx_Trace_Decode(&p[pos], size - pos, &rec);
+		if (n == 0)
+		{
+			fprintf(stderr, "%s : bad record at %u\n", name, pos);
+			break;
+		}
+		pos += n;
+		t += rec.gap;
+		start = t;
+		t += rec.time;
+
+		if (list && rec.numHead)
+		{
+			Tool_Class(rec.head[0], &na);
+			if (na == 3 && s.addr4) na = 4;
+			addr = 0;
+			for (i = 1; i <= na && i < rec.numHead; i++) addr = addr << 8 | rec.head[i];
+			printf("%12llu %-15s   %02X ", (unsigned long long)start, ClassName[Tool_Class(rec.head[0], &i)], rec.head[0]);
+			if (na) printf("%10X", addr);
+			else    printf("%10s", "-");
+			printf(" %8u   %02X %8u\n", rec.len, rec.miso, rec.time);
+		}
+		Tool_Account(&s, &rec, start, t, rec.miso);
+	}
+	Tool_Print(&s, "trace");
+
+	free(p);
+	return 0;
+}
+static int Tool_Replay(const char *name, W25Qxx_CHIP type, uint32_t clkHz)							/* Replay trace on the emulator */
+{
+	W25Qxx_TRACE_REC_t rec;
+	W25Qxx_EMU_t emu;
+	W25Qxx_ERR err;
+	TOOL_STAT_t target;
+	TOOL_STAT_t replay;
+	uint8_t *p = NULL;
+	uint32_t size = 0;
+	uint32_t pos = W25QXX_TRACE_HDRSIZE;
+	uint32_t i = 0;
+	uint64_t t = 0;
+	uint64_t start = 0;
+	uint64_t shift = 0;					/* Replay delay against the target schedule (ns) */
+	uint64_t wait = 0;
+	uint64_t begin = 0;
+	uint32_t extra = 0;
+	uint32_t early = 0;
+	uint8_t miso = 0;
+	uint8_t n = 0;
+
+	p = Tool_Load(name, &size);
+	if (p == NULL)
+	{
+		fprintf(stderr, "%s : not a W25Qxx trace\n", name);
+		return 1;
+	}
+	W25Qxx_EMU_Init(&emu, type, clkHz, &err);
+	if (err != W25Qxx_ERR_NONE)
+	{
+		free(p);
+		return 1;
+	}
+	Tool_Init(&target);
+	Tool_Init(&replay);
+	begin = W25Qxx_EMU_Now;
+
+	while (pos < size)
+	{
+		n = W25Qxx_Trace_Decode(&p[pos], size - pos, &rec);
+		if (n == 0) break;
+		pos += n;
+		t += rec.gap;
+		start = t;
+		t += rec.time;
+		Tool_Account(&target, &rec, start, t, rec.miso);
+		if (rec.numHead == 0) continue;
+
+		/* keep the target schedule, late when the emulated chip was slower */
+		if (W25Qxx_EMU_Now < begin + start * 1000 + shift) W25Qxx_EMU_Now = begin + start * 1000 + shift;
+		wait = W25Qxx_EMU_Now;
+		for (;;)
+		{
+			start = W25Qxx_EMU_Now;
+			W25Qxx_EMU_CS_L(&emu);
+			for (i = 0; i < rec.len; i++) miso = W25Qxx_EMU_RW(&emu, (i < rec.numHead) ? rec.head[i] : 0xFF);
+			W25Qxx_EMU_CS_H(&emu);
+
+			/* the target saw the chip idle : wait for the emulated chip */
+			if (rec.head[0] != W25Q_CMD_RSREG1 || rec.len < 2 || (rec.miso & 0x01) || (miso & 0x01) == 0) break;
+			if (W25Qxx_EMU_Now - wait > TOOL_TIMEOUTNS) break;
+			W25Qxx_EMU_Now += TOOL_POLLNS;
+			extra++;
+		}
+		if (rec.head[0] == W25Q_CMD_RSREG1 && rec.len >= 2 && (rec.miso & 0x01) && (miso & 0x01) == 0) early++;
+		if (W25Qxx_EMU_Now - wait > (uint64_t)rec.time * 1000) shift += W25Qxx_EMU_Now - wait - (uint64_t)rec.time * 1000;
+		Tool_Account(&replay, &rec, (start - begin) / 1000, (W25Qxx_EMU_Now - begin) / 1000, miso);
+	}
+
+	Tool_Print(&target, "target");
+	Tool_Print(&replay, "replay");
+	printf("status reads repeated %u, BUSY on target but idle on replay %u, commands ignored (busy/no WEL) %u, replay delay %.3f ms\n",
+	       extra, early, emu.stat.ignored, shift / 1e6);
+
+	W25Qxx_EMU_DeInit(&emu);
+	free(p);
+	return 0;
+}
+static int Tool_Record(const char *name, W25Qxx_CHIP type, uint32_t ringsize)						/* Sample workload through the recorder */
+{
+	static uint8_t data[0x4000];
+	W25Qxx_TRACE_t trace;
+	W25Qxx_EMU_t emu;
+	W25Qxx_ERR err;
+	W25Qxx_t dev;
+	uint8_t *ring = NULL;
+	uint8_t *out = NULL;
+	uint32_t n = 0;
+	uint32_t i = 0;
+	FILE *f = NULL;
+
+	ring = (uint8_t *)malloc(ringsize);
+	W25Qxx_EMU_Init(&emu, type, 50000000, &err);
+	if (ring == NULL || err != W25Qxx_ERR_NONE) return 1;
+	memset(&dev, 0, sizeof(dev));
+	W25Qxx_EMU_Port(&emu, &dev.port);
+	W25Qxx_Trace_Attach(&trace, &dev, ring, ringsize, &err);
+	if (err != W25Qxx_ERR_NONE) return 1;
+
+	for (i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + 3);
+	W25Qxx_config(&dev, &err);
+	W25Qxx_Read(&dev, data, 0x10000, sizeof(data), &err);
+	W25Qxx_DIR_Program(&dev, data, 0x10000, sizeof(data), &err);			/* erased : direct program */
+	W25Qxx_Program(&dev, data, 0x10000, sizeof(data), &err);				/* same data : skip */
+	data[0x1234] ^= 0x55;
+	W25Qxx_Program(&dev, data, 0x10000, sizeof(data), &err);				/* bit 0 -> 1 : erase sector */
+	W25Qxx_Erase_Block32(&dev, 1, &err);
+	W25Qxx_Erase_Block64(&dev, 2, &err);
+	W25Qxx_Read(&dev, data, 0x10000, sizeof(data), &err);
+	W25Qxx_Trace_Detach(&trace, &dev);
+
+	n = W25Qxx_Trace_Export(&trace, NULL, 0);
+	out = (uint8_t *)malloc(n);
+	if (out != NULL) n = W25Qxx_Trace_Export(&trace, out, n);
+	f = fopen(name, "wb");
+	if (out == NULL || f == NULL || fwrite(out, 1, n, f) != n) return 1;
+	fclose(f);
+	printf("%u records, %u dropped, %u bytes\n", trace.numRecord, trace.numDrop, n);
+
+	W25Qxx_EMU_DeInit(&emu);
+	free(out);
+	free(ring);
+	return 0;
+}
+static const struct { const char *name; W25Qxx_CHIP type; } ToolChip[] = {
+	{ "W25Q16", W25Q16 }, { "W25Q32", W25Q32 }, { "W25Q64", W25Q64 }, { "W25Q128", W25Q128 },
+	{ "W25Q256", W25Q256 }, { "W25Q512", W25Q512 }, { "W25Q01", W25Q01 }, { "W25Q02", W25Q02 },
+};
+static W25Qxx_CHIP Tool_Chip(const char *name)
+{
+	uint8_t c = 0;
+
+	for (c = 0; c < sizeof(ToolChip) / sizeof(ToolChip[0]); c++)
+	{
+		if (strcmp(name, ToolChip[c].name) == 0) return ToolChip[c].type;
+	}
+	return UNKNOWN;
+}
+/* Main */
+int main(int argc, char *argv[])
+{
+	W25Qxx_CHIP type = W25Q64;
+
+	if (argc >= 3 && strcmp(argv[1], "decode") == 0)
+	{
+		return Tool_Decode(argv[2], argc >= 4 && strcmp(argv[3], "list") == 0);
+	}
+	if (argc >= 4 && strcmp(argv[1], "replay") == 0)
+	{
+		type = Tool_Chip(argv[3]);
+		if (type != UNKNOWN) return Tool_Replay(argv[2], type, (argc >= 5) ? (uint32_t)strtoul(argv[4], NULL, 0) : 50000000);
+	}
+	if (argc >= 3 && strcmp(argv[1], "record") == 0)
+	{
+		if (argc >= 4) type = Tool_Chip(argv[3]);
+		if (type != UNKNOWN) return Tool_Record(argv[2], type, (argc >= 5) ? (uint32_t)strtoul(argv[4], NULL, 0) : 0x10000);
+	}
+
+	fprintf(stderr, "usage : %s decode <trace.bin> [list]\n", argv[0]);
+	fprintf(stderr, "        %s replay <trace.bin> <chip> [clkHz]\n", argv[0]);
+	fprintf(stderr, "        %s record <trace.bin> [chip] [ringsize]\n", argv[0]);
+	return 2;
+}